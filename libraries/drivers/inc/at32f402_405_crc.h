@@ -33,6 +33,9 @@ extern "C" {
 
 /* includes ------------------------------------------------------------------*/
 #include "at32f402_405.h"
+#ifdef DMA_MODULE_ENABLED
+#include "at32f402_405_dma.h"
+#endif
 
 /** @addtogroup AT32F402_405_periph_driver
   * @{
@@ -77,6 +80,34 @@ typedef enum
   CRC_POLY_SIZE_7B                       = 0x03  /*!< polynomial size 7 bits */
 } crc_poly_size_type;
 
+/**
+  * @brief crc preset type, parameters of a crc algorithm
+  */
+typedef struct
+{
+  uint32_t                               poly;         /*!< polynomial value, normal representation */
+  uint32_t                               init;         /*!< initial value */
+  uint32_t                               xor_out;      /*!< value xor-ed to the final result */
+  crc_poly_size_type                     poly_size;    /*!< polynomial size */
+  confirm_state                          reflect_in;   /*!< input bytes are bit reversed */
+  confirm_state                          reflect_out;  /*!< result is bit reversed */
+} crc_preset_type;
+
+/**
+  * @brief crc stream type, state of a byte stream calculation
+  */
+typedef struct
+{
+  const crc_preset_type                  *preset;      /*!< crc algorithm of the stream */
+  uint32_t                               length;       /*!< bytes fed into the stream */
+  void                                   *dma_channel; /*!< dma channel feeding the crc, null when idle */
+  const uint8_t                          *dma_addr;    /*!< next address for dma */
+  uint32_t                               dma_left;     /*!< units left for dma */
+  uint8_t                                dma_unit;     /*!< dma unit size, 1 or 4 bytes */
+  const uint8_t                          *tail_addr;   /*!< bytes fed by cpu after dma */
+  uint8_t                                tail_len;     /*!< tail bytes */
+} crc_stream_type;
+
 /**
  * @brief type define crc register all
  */
@@ -161,6 +192,10 @@ typedef struct
 
 #define CRC                              ((crc_type *) CRC_BASE)
 
+extern const crc_preset_type crc_preset_crc32;
+extern const crc_preset_type crc_preset_crc16_ccitt;
+extern const crc_preset_type crc_preset_crc8;
+
 /** @defgroup CRC_exported_functions
   * @{
   */
@@ -178,6 +213,14 @@ void crc_poly_value_set(uint32_t value);
 uint32_t crc_poly_value_get(void);
 void crc_poly_size_set(crc_poly_size_type size);
 crc_poly_size_type crc_poly_size_get(void);
+void crc_stream_init(crc_stream_type *stream, const crc_preset_type *preset);
+void crc_stream_update(crc_stream_type *stream, const void *pdata, uint32_t length);
+uint32_t crc_stream_final(crc_stream_type *stream);
+uint32_t crc_stream_calculate(const crc_preset_type *preset, const void *pdata, uint32_t length);
+#ifdef DMA_MODULE_ENABLED
+void crc_stream_dma_start(crc_stream_type *stream, dma_channel_type *dmax_channely, const void *pdata, uint32_t length);
+flag_status crc_stream_dma_busy(crc_stream_type *stream);
+#endif
 
 /**
   * @}
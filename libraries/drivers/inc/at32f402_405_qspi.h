@@ -220,6 +220,21 @@ typedef struct
   uint8_t                                read_data_counter;             /*!< read count for mode d */
 } qspi_xip_type;
 
+/**
+  * @brief qspi xip performance mode type, read path only
+  */
+typedef struct
+{
+  uint8_t                                read_instruction_code;         /*!< read instruction code */
+  qspi_xip_addrlen_type                  read_address_length;           /*!< read address legnth */
+  qspi_operate_mode_type                 read_operation_mode;           /*!< read operation mode */
+  uint8_t                                read_second_dummy_cycle_num;   /*!< read number of second dummy state cycle 0~32 */
+  uint8_t                                burst_data_counter;            /*!< read burst length for mode d 0~31, prefetch wrap */
+  uint8_t                                burst_time_counter;            /*!< read burst time for mode t 0~127 */
+  qspi_xip_read_sel_type                 burst_select_mode;             /*!< burst ends on data count (d) or time (t) */
+  confirm_state                          cache_enable;                  /*!< xip read cache enable */
+} qspi_xip_perf_type;
+
 /**
   * @brief type define qspi register all
   */
@@ -542,6 +557,8 @@ void qspi_word_write(qspi_type* qspi_x, uint32_t value);
 void qspi_half_word_write(qspi_type* qspi_x, uint16_t value);
 void qspi_byte_write(qspi_type* qspi_x, uint8_t value);
 void qspi_auto_ispc_enable(qspi_type* qspi_x);
+void qspi_xip_perf_default_para_init(qspi_xip_perf_type* perf_struct);
+void qspi_xip_perf_init(qspi_type* qspi_x, qspi_xip_perf_type* perf_struct);
 /**
   * @}
   */
@@ -35,6 +35,30 @@
 
 #ifdef CRC_MODULE_ENABLED
 
+/**
+  * @brief crc-32 (ethernet, zip), check value 0xCBF43926
+  */
+const crc_preset_type crc_preset_crc32 =
+{
+  0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, CRC_POLY_SIZE_32B, TRUE, TRUE
+};
+
+/**
+  * @brief crc-16/ccitt-false, check value 0x29B1
+  */
+const crc_preset_type crc_preset_crc16_ccitt =
+{
+  0x1021, 0xFFFF, 0x0000, CRC_POLY_SIZE_16B, FALSE, FALSE
+};
+
+/**
+  * @brief crc-8 (smbus), check value 0xF4
+  */
+const crc_preset_type crc_preset_crc8 =
+{
+  0x07, 0x00, 0x00, CRC_POLY_SIZE_8B, FALSE, FALSE
+};
+
 /** @defgroup CRC_private_functions
   * @{
   */
@@ -193,6 +217,272 @@ crc_poly_size_type crc_poly_size_get(void)
   return (crc_poly_size_type)(CRC->ctrl_bit.poly_size);
 }
 
+/**
+  * @brief  return the crc width in bits of a polynomial size
+  * @param  size: polynomial size
+  * @retval crc width
+  */
+static uint8_t crc_width_get(crc_poly_size_type size)
+{
+  switch(size)
+  {
+    case CRC_POLY_SIZE_16B:
+      return 16;
+    case CRC_POLY_SIZE_8B:
+      return 8;
+    case CRC_POLY_SIZE_7B:
+      return 7;
+    default:
+      return 32;
+  }
+}
+
+/**
+  * @brief  feed bytes to the crc data register.
+  *         the unaligned head and the tail are written by byte, the middle
+  *         part by word in stream order.
+  * @param  pbyte: data address
+  * @param  length: data length in byte
+  * @retval none
+  */
+static void crc_stream_feed(const uint8_t *pbyte, uint32_t length)
+{
+  while(length > 0 && ((uint32_t)pbyte & 0x3))
+  {
+    *(__IO uint8_t *)&CRC->dt = *pbyte ++;
+    length --;
+  }
+
+  /* the first byte of the stream goes to the most significant byte */
+  while(length >= 4)
+  {
+    CRC->dt = __REV(*(const uint32_t *)pbyte);
+    pbyte += 4;
+    length -= 4;
+  }
+
+  while(length > 0)
+  {
+    *(__IO uint8_t *)&CRC->dt = *pbyte ++;
+    length --;
+  }
+}
+
+/**
+  * @brief  start a byte stream crc calculation, the crc unit is configured
+  *         from the preset and reset to the initial value.
+  * @note   the crc unit is shared: this rewrites the polynomial, polynomial
+  *         size, initial value and both reverse settings for every user of
+  *         the unit, crc_block_calculate callers included. one stream at a
+  *         time, and other users configure the unit again after it.
+  * @param  stream: crc stream state
+  * @param  preset: crc algorithm, for example crc_preset_crc32
+  * @retval none
+  */
+void crc_stream_init(crc_stream_type *stream, const crc_preset_type *preset)
+{
+  stream->preset = preset;
+  stream->length = 0;
+  stream->dma_channel = 0;
+  stream->dma_left = 0;
+  stream->tail_len = 0;
+
+  CRC->poly = preset->poly;
+  CRC->ctrl_bit.poly_size = preset->poly_size;
+  CRC->idt = preset->init;
+  CRC->ctrl_bit.revid = (preset->reflect_in == TRUE) ? CRC_REVERSE_INPUT_BY_BYTE : CRC_REVERSE_INPUT_NO_AFFECTE;
+
+  /* output reflection is done in crc_stream_final on the crc width */
+  CRC->ctrl_bit.revod = CRC_REVERSE_OUTPUT_NO_AFFECTE;
+  CRC->ctrl_bit.rst = 0x1;
+}
+
+/**
+  * @brief  feed a block of any length and alignment to the crc stream.
+  * @param  stream: crc stream state
+  * @param  pdata: data address
+  * @param  length: data length in byte
+  * @retval none
+  */
+void crc_stream_update(crc_stream_type *stream, const void *pdata, uint32_t length)
+{
+  crc_stream_feed((const uint8_t *)pdata, length);
+  stream->length += length;
+}
+
+/**
+  * @brief  finish the crc stream and return the crc.
+  * @param  stream: crc stream state
+  * @retval crc value, right aligned on the crc width
+  */
+uint32_t crc_stream_final(crc_stream_type *stream)
+{
+  uint8_t width = crc_width_get(stream->preset->poly_size);
+  uint32_t value = CRC->dt;
+
+  if(stream->preset->reflect_out == TRUE)
+  {
+    value = __RBIT(value) >> (32 - width);
+  }
+  value ^= stream->preset->xor_out;
+  if(width < 32)
+  {
+    value &= (1UL << width) - 1;
+  }
+  return value;
+}
+
+/**
+  * @brief  compute the crc of a byte block in one call.
+  * @param  preset: crc algorithm, for example crc_preset_crc32
+  * @param  pdata: data address
+  * @param  length: data length in byte
+  * @retval crc value
+  */
+uint32_t crc_stream_calculate(const crc_preset_type *preset, const void *pdata, uint32_t length)
+{
+  crc_stream_type stream;
+  crc_stream_init(&stream, preset);
+  crc_stream_update(&stream, pdata, length);
+  return crc_stream_final(&stream);
+}
+
+#ifdef DMA_MODULE_ENABLED
+/**
+  * @brief  start the next dma chunk of a crc stream.
+  * @param  stream: crc stream state
+  * @retval none
+  */
+static void crc_stream_dma_next(crc_stream_type *stream)
+{
+  dma_channel_type *dmax_channely = (dma_channel_type *)stream->dma_channel;
+  dma_init_type dma_init_struct;
+  uint16_t count = (stream->dma_left > 0xFFFF) ? 0xFFFF : (uint16_t)stream->dma_left;
+
+  dma_channel_enable(dmax_channely, FALSE);
+  dma_default_para_init(&dma_init_struct);
+  /* memory to memory: peripheral address is the source, crc data register the destination */
+  dma_init_struct.direction = DMA_DIR_MEMORY_TO_MEMORY;
+  dma_init_struct.peripheral_base_addr = (uint32_t)stream->dma_addr;
+  dma_init_struct.peripheral_inc_enable = TRUE;
+  dma_init_struct.memory_base_addr = (uint32_t)&CRC->dt;
+  dma_init_struct.memory_inc_enable = FALSE;
+  dma_init_struct.buffer_size = count;
+  if(stream->dma_unit == 4)
+  {
+    dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_WORD;
+    dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_WORD;
+  }
+  else
+  {
+    dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_BYTE;
+    dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_BYTE;
+  }
+  dma_init_struct.priority = DMA_PRIORITY_MEDIUM;
+  dma_init(dmax_channely, &dma_init_struct);
+
+  stream->dma_addr += (uint32_t)count * stream->dma_unit;
+  stream->dma_left -= count;
+  dma_channel_enable(dmax_channely, TRUE);
+}
+
+/**
+  * @brief  feed a large block to the crc stream by dma, the cpu is free
+  *         until crc_stream_dma_busy returns RESET. the crc unit must not
+  *         be used by others meanwhile.
+  *         reflected algorithms are fed by word (input reversed by word
+  *         gives the stream byte order), others by byte.
+  * @param  stream: crc stream state
+  * @param  dmax_channely: dma channel, clock must be enabled
+  *         this parameter can be one of the following values:
+  *         DMA1_CHANNEL1...DMA1_CHANNEL7, DMA2_CHANNEL1...DMA2_CHANNEL7
+  * @param  pdata: data address
+  * @param  length: data length in byte
+  * @retval none
+  */
+void crc_stream_dma_start(crc_stream_type *stream, dma_channel_type *dmax_channely, const void *pdata, uint32_t length)
+{
+  const uint8_t *pbyte = (const uint8_t *)pdata;
+  uint32_t head = 0;
+
+  stream->length += length;
+  stream->tail_len = 0;
+
+  if(stream->preset->reflect_in == TRUE)
+  {
+    head = (4 - ((uint32_t)pbyte & 0x3)) & 0x3;
+    if(head > length)
+    {
+      head = length;
+    }
+    crc_stream_feed(pbyte, head);
+    pbyte += head;
+    length -= head;
+
+    stream->dma_unit = 4;
+    stream->tail_len = length & 0x3;
+    stream->tail_addr = pbyte + (length & ~0x3);
+    stream->dma_left = length >> 2;
+  }
+  else
+  {
+    stream->dma_unit = 1;
+    stream->tail_addr = pbyte;
+    stream->dma_left = length;
+  }
+
+  stream->dma_addr = pbyte;
+  if(stream->dma_left == 0)
+  {
+    crc_stream_feed(stream->tail_addr, stream->tail_len);
+    stream->tail_len = 0;
+    return;
+  }
+
+  if(stream->dma_unit == 4)
+  {
+    CRC->ctrl_bit.revid = CRC_REVERSE_INPUT_BY_WORD;
+  }
+  stream->dma_channel = dmax_channely;
+  crc_stream_dma_next(stream);
+}
+
+/**
+  * @brief  poll the dma feeding of a crc stream, the next chunk and the
+  *         tail bytes are started from here.
+  * @param  stream: crc stream state
+  * @retval SET while the dma is feeding the crc, RESET when done
+  */
+flag_status crc_stream_dma_busy(crc_stream_type *stream)
+{
+  dma_channel_type *dmax_channely = (dma_channel_type *)stream->dma_channel;
+
+  if(dmax_channely == 0)
+  {
+    return RESET;
+  }
+  if(dma_data_number_get(dmax_channely) != 0)
+  {
+    return SET;
+  }
+  if(stream->dma_left != 0)
+  {
+    crc_stream_dma_next(stream);
+    return SET;
+  }
+
+  dma_channel_enable(dmax_channely, FALSE);
+  stream->dma_channel = 0;
+  if(stream->dma_unit == 4)
+  {
+    CRC->ctrl_bit.revid = CRC_REVERSE_INPUT_BY_BYTE;
+  }
+  crc_stream_feed(stream->tail_addr, stream->tail_len);
+  stream->tail_len = 0;
+  return RESET;
+}
+#endif
+
 /**
   * @}
   */
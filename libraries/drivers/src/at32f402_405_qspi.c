@@ -470,6 +470,51 @@ void qspi_auto_ispc_enable(qspi_type* qspi_x)
   qspi_x->ctrl3_bit.ispc = TRUE;
 }
 
+/**
+  * @brief  fill each qspi_xip_perf_type member with its default value,
+  *         quad i/o read 0xEB with 6 dummy cycles, longest burst, cache on.
+  * @param  perf_struct: pointer to a qspi_xip_perf_type structure
+  * @retval none.
+  */
+void qspi_xip_perf_default_para_init(qspi_xip_perf_type* perf_struct)
+{
+  perf_struct->read_instruction_code = 0xEB;
+  perf_struct->read_address_length = QSPI_XIP_ADDRLEN_3_BYTE;
+  perf_struct->read_operation_mode = QSPI_OPERATE_MODE_144;
+  perf_struct->read_second_dummy_cycle_num = 6;
+  perf_struct->burst_data_counter = 0x1F;
+  perf_struct->burst_time_counter = 0x7F;
+  perf_struct->burst_select_mode = QSPI_XIPR_SEL_MODED;
+  perf_struct->cache_enable = TRUE;
+}
+
+/**
+  * @brief  configure the xip read path for performance: read command, dummy
+  *         cycles, burst length used for prefetch and the read cache.
+  *         the xip write configuration is kept.
+  * @param  qspi_x: select the qspi peripheral.
+  * @param  perf_struct: pointer to a qspi_xip_perf_type structure
+  * @retval none.
+  */
+void qspi_xip_perf_init(qspi_type* qspi_x, qspi_xip_perf_type* perf_struct)
+{
+  uint32_t xc0_val = 0, xc2_val = 0;
+
+  xc0_val = (uint32_t)perf_struct->read_second_dummy_cycle_num;
+  xc0_val |= (uint32_t)(perf_struct->read_operation_mode << 8);
+  xc0_val |= (uint32_t)(perf_struct->read_address_length << 11);
+  xc0_val |= (uint32_t)(perf_struct->read_instruction_code << 12);
+  qspi_x->xip_cmd_w0 = xc0_val;
+
+  xc2_val = qspi_x->xip_cmd_w2 & 0xFFFF0000;
+  xc2_val |= (uint32_t)(perf_struct->burst_data_counter & 0x1F);
+  xc2_val |= (uint32_t)((perf_struct->burst_time_counter & 0x7F) << 8);
+  xc2_val |= (uint32_t)(perf_struct->burst_select_mode << 15);
+  qspi_x->xip_cmd_w2 = xc2_val;
+
+  qspi_x->xip_cmd_w3_bit.bypassc = (perf_struct->cache_enable == TRUE) ? FALSE : TRUE;
+}
+
 /**
   * @}
   */
@@ -424,6 +424,27 @@ void usb_write_packet(otg_global_type *usbx, uint8_t *pusr_buf, uint16_t num, ui
   uint32_t n_index;
   uint32_t nhbytes = (nbytes + 3) / 4;
   uint32_t *pbuf = (uint32_t *)pusr_buf;
+  __IO uint32_t *pfifo = &USB_FIFO(usbx, num);
+  uint32_t data0, data1, data2, data3;
+
+  if(((uint32_t)pusr_buf & 0x3) == 0)
+  {
+    /* word aligned buffer, load four words at once (ldm) then push to fifo */
+    for(n_index = nhbytes >> 2; n_index > 0; n_index --)
+    {
+      data0 = pbuf[0];
+      data1 = pbuf[1];
+      data2 = pbuf[2];
+      data3 = pbuf[3];
+      *pfifo = data0;
+      *pfifo = data1;
+      *pfifo = data2;
+      *pfifo = data3;
+      pbuf += 4;
+    }
+    nhbytes &= 0x3;
+  }
+
   for(n_index = 0; n_index < nhbytes; n_index ++)
   {
 #if defined (__ICCARM__) && (__VER__ < 7000000)
@@ -447,8 +468,28 @@ void usb_read_packet(otg_global_type *usbx, uint8_t *pusr_buf, uint16_t num, uin
   uint32_t n_index;
   uint32_t nhbytes = (nbytes + 3) / 4;
   uint32_t *pbuf = (uint32_t *)pusr_buf;
+  __IO uint32_t *pfifo = &USB_FIFO(usbx, 0);
+  uint32_t data0, data1, data2, data3;
   
   UNUSED(num);
+  if(((uint32_t)pusr_buf & 0x3) == 0)
+  {
+    /* word aligned buffer, pop four words from fifo then store at once (stm) */
+    for(n_index = nhbytes >> 2; n_index > 0; n_index --)
+    {
+      data0 = *pfifo;
+      data1 = *pfifo;
+      data2 = *pfifo;
+      data3 = *pfifo;
+      pbuf[0] = data0;
+      pbuf[1] = data1;
+      pbuf[2] = data2;
+      pbuf[3] = data3;
+      pbuf += 4;
+    }
+    nhbytes &= 0x3;
+  }
+
   for(n_index = 0; n_index < nhbytes; n_index ++)
   {
 #if defined (__ICCARM__) && (__VER__ < 7000000)
@@ -0,0 +1,252 @@
+/**
+  **************************************************************************
+  * @file     adc_capture.c
+  * @brief    adc event capture library source file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "adc_capture.h"
+
+/** @addtogroup AT32F402_405_middlewares_adc_capture_library
+  * @{
+  */
+
+/** @defgroup ADC_capture_library
+  * @brief fault waveform capture on an adc stream. the stream ring is the
+  *        pre-trigger buffer, the voltage monitor trips on the monitored
+  *        channel and its interrupt only notes the ring position and the
+  *        timestamp. once the post-trigger conversions are in the ring a
+  *        memory to memory dma copies the window into the snapshot, the
+  *        cpu never polls and never copies samples.
+  * @{
+  */
+
+/**
+  * @brief  copy channel event, the snapshot is complete or failed.
+  * @param  hdma: copy channel handle.
+  * @param  event: dma application events.
+  * @retval none.
+  */
+static void adc_capture_dma_event(dma_app_handle_type *hdma, uint32_t event)
+{
+  adc_capture_type *cap = (adc_capture_type *)hdma->user;
+
+  if(event & (DMA_APP_EVENT_FULL | DMA_APP_EVENT_ERROR))
+  {
+    if(event & DMA_APP_EVENT_ERROR)
+    {
+      cap->state = ADC_CAPTURE_STATE_ERROR;
+      cap->error_count ++;
+    }
+    else
+    {
+      cap->state = ADC_CAPTURE_STATE_DONE;
+      cap->capture_count ++;
+    }
+    if(cap->callback != 0)
+    {
+      cap->callback(cap);
+    }
+  }
+}
+
+/**
+  * @brief  stream ring event, starts the copy once the post-trigger
+  *         conversions are written.
+  * @param  st: the handle points to the stream information.
+  * @param  arg: capture handle.
+  * @retval none.
+  */
+static void adc_capture_ring_event(adc_stream_type *st, void *arg)
+{
+  adc_capture_type *cap = (adc_capture_type *)arg;
+  uint32_t length = (uint32_t)st->block_size * st->channel_num * 2;
+  uint32_t size = (uint32_t)(cap->pre_samples + cap->post_samples) * st->channel_num;
+  uint32_t start, first;
+
+  if(cap->state != ADC_CAPTURE_STATE_POST ||
+     (int32_t)(st->ring_count - cap->trigger_count) < (int32_t)(cap->post_samples * st->channel_num))
+  {
+    return;
+  }
+
+  start = (cap->trigger_offset + length - (uint32_t)cap->pre_samples * st->channel_num) % length;
+  first = length - start;
+  if(first > size)
+  {
+    first = size;
+  }
+
+  /* memory to memory: the peripheral address is the source */
+  cap->desc[0].peripheral_addr = (uint32_t)&st->ring[start];
+  cap->desc[0].memory_addr = (uint32_t)cap->snapshot;
+  cap->desc[0].count = (uint16_t)first;
+  cap->desc[0].next = 0;
+  if(first < size)
+  {
+    cap->desc[1].peripheral_addr = (uint32_t)st->ring;
+    cap->desc[1].memory_addr = (uint32_t)&cap->snapshot[first];
+    cap->desc[1].count = (uint16_t)(size - first);
+    cap->desc[1].next = 0;
+    cap->desc[0].next = &cap->desc[1];
+  }
+
+  cap->state = ADC_CAPTURE_STATE_COPY;
+  dma_app_start_chain(cap->hdma, &cap->desc[0]);
+}
+
+/**
+  * @brief  set up the voltage monitor and the copy channel. call it after
+  *         adc_stream_init, the adc1 interrupt takes the stream priority.
+  * @param  cap: the handle points to the capture information.
+  * @param  st: the handle points to the stream information.
+  * @retval ERROR if the channel is not in the sequence, the window and
+  *         ADC_CAPTURE_MARGIN do not fit in half of the ring or no dma
+  *         channel is free.
+  */
+error_status adc_capture_init(adc_capture_type *cap, adc_stream_type *st)
+{
+  dma_init_type dma_init_struct;
+  uint8_t index;
+
+  for(index = 0; index < st->channel_num; index ++)
+  {
+    if(st->channel[index] == cap->channel)
+    {
+      break;
+    }
+  }
+  if(index == st->channel_num || cap->post_samples == 0 ||
+     (uint32_t)cap->pre_samples + cap->post_samples + ADC_CAPTURE_MARGIN > st->block_size)
+  {
+    return ERROR;
+  }
+
+  dma_default_para_init(&dma_init_struct);
+  dma_init_struct.direction = DMA_DIR_MEMORY_TO_MEMORY;
+  dma_init_struct.memory_inc_enable = TRUE;
+  dma_init_struct.peripheral_inc_enable = TRUE;
+  dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_HALFWORD;
+  dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_HALFWORD;
+  dma_init_struct.priority = DMA_PRIORITY_LOW;
+  if(cap->hdma == 0)
+  {
+    cap->hdma = dma_app_channel_alloc(DMAMUX_DMAREQ_ID_REQ_G1, &dma_init_struct, adc_capture_dma_event, st->priority);
+    if(cap->hdma == 0)
+    {
+      return ERROR;
+    }
+  }
+  cap->hdma->user = cap;
+  cap->st = st;
+  cap->state = ADC_CAPTURE_STATE_IDLE;
+  cap->capture_count = 0;
+  cap->error_count = 0;
+
+  if(cap->ts_tmr == 0)
+  {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  }
+
+  st->ring_callback = adc_capture_ring_event;
+  st->ring_arg = cap;
+
+  adc_voltage_monitor_threshold_value_set(ADC1, cap->high_threshold, cap->low_threshold);
+  adc_voltage_monitor_single_channel_select(ADC1, cap->channel);
+  adc_voltage_monitor_enable(ADC1, ADC_VMONITOR_SINGLE_ORDINARY);
+  adc_interrupt_enable(ADC1, ADC_VMOR_INT, FALSE);
+  nvic_irq_enable(ADC1_IRQn, st->priority, 0);
+
+  return SUCCESS;
+}
+
+/**
+  * @brief  arm the capture, the previous snapshot is given up.
+  * @param  cap: the handle points to the capture information.
+  * @retval none.
+  */
+void adc_capture_arm(adc_capture_type *cap)
+{
+  if(cap->state == ADC_CAPTURE_STATE_COPY)
+  {
+    return;
+  }
+  cap->state = ADC_CAPTURE_STATE_ARMED;
+  adc_flag_clear(ADC1, ADC_VMOR_FLAG);
+  adc_interrupt_enable(ADC1, ADC_VMOR_INT, TRUE);
+}
+
+/**
+  * @brief  check the snapshot, a failed copy leaves the state
+  *         ADC_CAPTURE_STATE_ERROR and needs a new adc_capture_arm.
+  * @param  cap: the handle points to the capture information.
+  * @retval SET once the snapshot is complete.
+  */
+flag_status adc_capture_ready(adc_capture_type *cap)
+{
+  return (cap->state == ADC_CAPTURE_STATE_DONE) ? SET : RESET;
+}
+
+/**
+  * @brief  adc interrupt handler, call it from ADC1_IRQHandler. the trip is
+  *         placed on the sequence of the last written conversion, so the
+  *         interrupt latency must stay below one sequence period.
+  * @param  cap: the handle points to the capture information.
+  * @retval none.
+  */
+void adc_capture_irq_handler(adc_capture_type *cap)
+{
+  adc_stream_type *st = cap->st;
+  uint32_t length, count, offset, last;
+
+  if(adc_interrupt_flag_get(ADC1, ADC_VMOR_FLAG) == RESET)
+  {
+    return;
+  }
+
+  cap->timestamp = (cap->ts_tmr != 0) ? tmr_counter_value_get(cap->ts_tmr) : DWT->CYCCNT;
+
+  /* one shot, the monitor keeps flagging while the input is out of range */
+  adc_interrupt_enable(ADC1, ADC_VMOR_INT, FALSE);
+  adc_flag_clear(ADC1, ADC_VMOR_FLAG);
+
+  if(cap->state != ADC_CAPTURE_STATE_ARMED)
+  {
+    return;
+  }
+
+  length = (uint32_t)st->block_size * st->channel_num * 2;
+  count = adc_stream_position_get(st, &offset);
+  last = (offset + length - 1) % length;
+
+  /* sequences start on multiples of channel_num in the ring */
+  cap->trigger_offset = last - last % st->channel_num;
+  cap->trigger_count = count - 1 - last % st->channel_num;
+  cap->state = ADC_CAPTURE_STATE_POST;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
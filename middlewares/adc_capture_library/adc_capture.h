@@ -0,0 +1,134 @@
+/**
+  **************************************************************************
+  * @file     adc_capture.h
+  * @brief    adc event capture library header file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __ADC_CAPTURE_H
+#define __ADC_CAPTURE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "adc_stream.h"
+
+/** @addtogroup AT32F402_405_middlewares_adc_capture_library
+  * @{
+  */
+
+/** @defgroup ADC_capture_library_config
+  * @{
+  */
+
+/**
+  * @brief sequences kept free in a ring half. the copy starts at a half
+  *        boundary, when the next slot the adc dma writes can be the
+  *        oldest pre-trigger sample. the margin covers the interrupt entry
+  *        and the chain setup before the low priority copy reads it.
+  */
+#ifndef ADC_CAPTURE_MARGIN
+#define ADC_CAPTURE_MARGIN               16
+#endif
+
+/**
+  * @}
+  */
+
+/** @defgroup ADC_capture_library_types
+  * @{
+  */
+
+/**
+  * @brief adc capture state
+  */
+typedef enum
+{
+  ADC_CAPTURE_STATE_IDLE = 0,            /*!< not armed */
+  ADC_CAPTURE_STATE_ARMED,               /*!< waiting for the voltage monitor */
+  ADC_CAPTURE_STATE_POST,                /*!< tripped, post-trigger conversions running */
+  ADC_CAPTURE_STATE_COPY,                /*!< snapshot copy by dma */
+  ADC_CAPTURE_STATE_DONE,                /*!< snapshot ready */
+  ADC_CAPTURE_STATE_ERROR                /*!< snapshot copy failed */
+} adc_capture_state_type;
+
+struct adc_capture_struct;
+
+typedef void (*adc_capture_callback_type)(struct adc_capture_struct *cap);
+
+/**
+  * @brief adc capture handle, the fields up to user are filled in before
+  *        adc_capture_init
+  */
+typedef struct adc_capture_struct
+{
+  adc_channel_select_type                channel;                 /*!< monitored channel, in the stream sequence */
+  uint16_t                               high_threshold;          /*!< trip above this value           */
+  uint16_t                               low_threshold;           /*!< trip below this value           */
+  uint16_t                               pre_samples;             /*!< sequences before the trip       */
+  uint16_t                               post_samples;            /*!< sequences from the trip on, pre + post <=
+                                                                       block_size - ADC_CAPTURE_MARGIN  */
+  uint16_t                               *snapshot;               /*!< (pre + post) * channel_num conversions,
+                                                                       interleaved like the ring         */
+  tmr_type                               *ts_tmr;                 /*!< free running timestamp timer, 0 for the
+                                                                       core cycle counter                */
+  adc_capture_callback_type              callback;                /*!< snapshot ready or failed, in interrupt, can be 0 */
+  void                                   *user;                   /*!< user data for the callback      */
+
+  adc_stream_type                        *st;                     /*!< stream with the ring            */
+  dma_app_handle_type                    *hdma;                   /*!< memory to memory copy channel   */
+  dma_app_desc_type                      desc[2];                 /*!< copy of the ring, two parts on a wrap */
+  __IO adc_capture_state_type            state;                   /*!< capture state                   */
+  uint32_t                               trigger_count;           /*!< stream position of the trip sequence */
+  uint32_t                               trigger_offset;          /*!< ring index of the trip sequence */
+  uint32_t                               timestamp;               /*!< timestamp timer at the trip     */
+  uint32_t                               capture_count;           /*!< snapshots taken                 */
+  uint32_t                               error_count;             /*!< snapshot copies failed          */
+} adc_capture_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup ADC_capture_library_exported_functions
+  * @{
+  */
+
+error_status adc_capture_init            (adc_capture_type *cap, adc_stream_type *st);
+void         adc_capture_arm             (adc_capture_type *cap);
+flag_status  adc_capture_ready           (adc_capture_type *cap);
+void         adc_capture_irq_handler     (adc_capture_type *cap);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
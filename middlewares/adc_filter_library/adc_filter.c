@@ -0,0 +1,243 @@
+/**
+  **************************************************************************
+  * @file     adc_filter.c
+  * @brief    adc filter chain library source file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "adc_filter.h"
+
+/** @addtogroup AT32F402_405_middlewares_adc_filter_library
+  * @{
+  */
+
+/** @defgroup ADC_filter_library
+  * @brief cmsis-dsp decimation and iir chains on adc stream channels. each
+  *        half of the dma ring is read in place from the dma interrupt,
+  *        the samples of a channel are converted to the chain format in
+  *        one pass and the stages ping-pong between two work buffers. the
+  *        hardware oversampler of the stream is the first decimation stage.
+  * @{
+  */
+
+static void adc_filter_stream_event(adc_stream_type *st, uint16_t *block);
+
+/**
+  * @brief  convert the samples of the chain channel to q15.
+  * @param  filter: the handle points to the filter information.
+  * @param  src: first sample of the channel in the ring.
+  * @param  dst: work buffer.
+  * @retval none.
+  */
+static void adc_filter_convert_q15(adc_filter_type *filter, const uint16_t *src, q15_t *dst)
+{
+  uint32_t stride = filter->st->channel_num;
+  uint32_t shift = 16 - filter->bits;
+  uint32_t count = filter->st->block_size;
+  int32_t value;
+
+  while(count--)
+  {
+    value = (((int32_t)*src - filter->offset) << shift) - 0x8000;
+    *dst++ = (q15_t)__SSAT(value, 16);
+    src += stride;
+  }
+}
+
+/**
+  * @brief  convert the samples of the chain channel to float.
+  * @param  filter: the handle points to the filter information.
+  * @param  src: first sample of the channel in the ring.
+  * @param  dst: work buffer.
+  * @retval none.
+  */
+static void adc_filter_convert_f32(adc_filter_type *filter, const uint16_t *src, float32_t *dst)
+{
+  uint32_t stride = filter->st->channel_num;
+  uint32_t count = filter->st->block_size;
+  float32_t scale = 2.0f / (float32_t)(1UL << filter->bits);
+
+  while(count--)
+  {
+    *dst++ = (float32_t)((int32_t)*src - filter->offset) * scale - 1.0f;
+    src += stride;
+  }
+}
+
+/**
+  * @brief  run the chain on one ring half.
+  * @param  filter: the handle points to the filter information.
+  * @param  ring: ring half passed by the stream.
+  * @retval none.
+  */
+static void adc_filter_run(adc_filter_type *filter, uint16_t *ring)
+{
+  const uint16_t *src = ring + filter->channel;
+  void *in = filter->buffer[0];
+  void *out = filter->buffer[1];
+  void *swap;
+  uint32_t length = filter->st->block_size;
+  uint8_t index;
+
+  if(filter->format == ADC_FILTER_FORMAT_Q15)
+  {
+    adc_filter_convert_q15(filter, src, (q15_t *)in);
+  }
+  else
+  {
+    adc_filter_convert_f32(filter, src, (float32_t *)in);
+  }
+
+  for(index = 0; index < filter->stage_num; index ++)
+  {
+    if(filter->format == ADC_FILTER_FORMAT_Q15)
+    {
+      if(filter->stage[index].kind == ADC_FILTER_FIR_DECIMATE)
+      {
+        arm_fir_decimate_q15((const arm_fir_decimate_instance_q15 *)filter->stage[index].instance, (const q15_t *)in, (q15_t *)out, length);
+        length /= ((arm_fir_decimate_instance_q15 *)filter->stage[index].instance)->M;
+      }
+      else
+      {
+        arm_biquad_cascade_df1_q15((const arm_biquad_casd_df1_inst_q15 *)filter->stage[index].instance, (const q15_t *)in, (q15_t *)out, length);
+      }
+    }
+    else
+    {
+      if(filter->stage[index].kind == ADC_FILTER_FIR_DECIMATE)
+      {
+        arm_fir_decimate_f32((const arm_fir_decimate_instance_f32 *)filter->stage[index].instance, (const float32_t *)in, (float32_t *)out, length);
+        length /= ((arm_fir_decimate_instance_f32 *)filter->stage[index].instance)->M;
+      }
+      else
+      {
+        arm_biquad_cascade_df2T_f32((const arm_biquad_cascade_df2T_instance_f32 *)filter->stage[index].instance, (const float32_t *)in, (float32_t *)out, length);
+      }
+    }
+    swap = in;
+    in = out;
+    out = swap;
+  }
+
+  filter->block_count ++;
+  if(filter->callback != 0)
+  {
+    filter->callback(filter, in, length);
+  }
+}
+
+/**
+  * @brief  stream block callback, runs every chain of the stream.
+  * @param  st: the handle points to the stream information.
+  * @param  block: ring half in place.
+  * @retval none.
+  */
+static void adc_filter_stream_event(adc_stream_type *st, uint16_t *block)
+{
+  adc_filter_type *filter;
+
+  for(filter = (adc_filter_type *)st->user; filter != 0; filter = filter->next)
+  {
+    adc_filter_run(filter, block);
+  }
+}
+
+/**
+  * @brief  attach a filter chain to a stream. call it after adc_stream_init
+  *         and before adc_stream_start, the stream callback and user data
+  *         are taken over and the ring is read in place. the fir decimate
+  *         instances are set up for the block length they receive.
+  * @param  filter: the handle points to the filter information.
+  * @param  st: the handle points to the stream information.
+  * @retval ERROR if the channel is not in the sequence or a decimation
+  *         factor does not divide the block.
+  */
+error_status adc_filter_init(adc_filter_type *filter, adc_stream_type *st)
+{
+  adc_filter_type *last;
+  uint32_t length = st->block_size;
+  uint32_t factor;
+  uint8_t index;
+
+  if(filter->channel >= st->channel_num || filter->stage_num > ADC_FILTER_STAGE_MAX)
+  {
+    return ERROR;
+  }
+
+  for(index = 0; index < filter->stage_num; index ++)
+  {
+    if(filter->stage[index].kind == ADC_FILTER_FIR_DECIMATE)
+    {
+      if(filter->format == ADC_FILTER_FORMAT_Q15)
+      {
+        factor = ((arm_fir_decimate_instance_q15 *)filter->stage[index].instance)->M;
+      }
+      else
+      {
+        factor = ((arm_fir_decimate_instance_f32 *)filter->stage[index].instance)->M;
+      }
+      if(factor == 0 || (length % factor) != 0)
+      {
+        return ERROR;
+      }
+      length /= factor;
+    }
+  }
+
+  /* width after the hardware oversampler, ratio 2^(n+1) adds n+1 bits */
+  filter->bits = 12;
+  if(st->oversample_enable == TRUE)
+  {
+    filter->bits += (uint8_t)st->oversample_ratio + 1 - (uint8_t)st->oversample_shift;
+    if(filter->bits > 16)
+    {
+      filter->bits = 16;
+    }
+  }
+
+  filter->st = st;
+  filter->length = length;
+  filter->rate = st->rate / (st->block_size / length);
+  filter->block_count = 0;
+  filter->next = 0;
+
+  /* link behind the chains already on the stream */
+  if(st->callback != adc_filter_stream_event)
+  {
+    st->callback = adc_filter_stream_event;
+    st->user = filter;
+  }
+  else
+  {
+    for(last = (adc_filter_type *)st->user; last->next != 0; last = last->next);
+    last->next = filter;
+  }
+  st->block = 0;
+
+  return SUCCESS;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,136 @@
+/**
+  **************************************************************************
+  * @file     adc_filter.h
+  * @brief    adc filter chain library header file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __ADC_FILTER_H
+#define __ADC_FILTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "adc_stream.h"
+#include "arm_math.h"
+
+/** @addtogroup AT32F402_405_middlewares_adc_filter_library
+  * @{
+  */
+
+/** @defgroup ADC_filter_library_config
+  * @{
+  */
+
+#define ADC_FILTER_STAGE_MAX             4           /*!< stages of a filter chain */
+
+/**
+  * @}
+  */
+
+/** @defgroup ADC_filter_library_types
+  * @{
+  */
+
+/**
+  * @brief sample format of a filter chain
+  */
+typedef enum
+{
+  ADC_FILTER_FORMAT_Q15 = 0,             /*!< q15, full scale is -1 to 1 */
+  ADC_FILTER_FORMAT_F32                  /*!< float, full scale is -1 to 1 */
+} adc_filter_format_type;
+
+/**
+  * @brief filter stage kind, the instance is set up by the cmsis-dsp init
+  *        function of the chain format
+  */
+typedef enum
+{
+  ADC_FILTER_FIR_DECIMATE = 0,           /*!< arm_fir_decimate_instance_q15 or arm_fir_decimate_instance_f32 */
+  ADC_FILTER_BIQUAD                      /*!< arm_biquad_casd_df1_inst_q15 or arm_biquad_cascade_df2T_instance_f32 */
+} adc_filter_kind_type;
+
+/**
+  * @brief filter stage
+  */
+typedef struct
+{
+  adc_filter_kind_type                   kind;                    /*!< stage kind                      */
+  void                                   *instance;               /*!< cmsis-dsp instance              */
+} adc_filter_stage_type;
+
+struct adc_filter_struct;
+
+/**
+  * @brief output callback, output holds length samples in the chain format
+  *        and is valid until the callback returns
+  */
+typedef void (*adc_filter_callback_type)(struct adc_filter_struct *filter, void *output, uint32_t length);
+
+/**
+  * @brief adc filter chain, the fields up to user are filled in before
+  *        adc_filter_init
+  */
+typedef struct adc_filter_struct
+{
+  uint8_t                                channel;                 /*!< channel position in the sequence */
+  adc_filter_format_type                 format;                  /*!< sample format of the chain      */
+  adc_filter_stage_type                  stage[ADC_FILTER_STAGE_MAX]; /*!< stages in processing order  */
+  uint8_t                                stage_num;               /*!< stages in use                   */
+  int16_t                                offset;                  /*!< raw offset removed before the conversion */
+  void                                   *buffer[2];              /*!< work buffers, block_size samples each */
+  adc_filter_callback_type               callback;                /*!< output callback, in interrupt   */
+  void                                   *user;                   /*!< user data for the callback      */
+
+  adc_stream_type                        *st;                     /*!< stream feeding the chain        */
+  uint8_t                                bits;                    /*!< raw sample width                */
+  uint32_t                               length;                  /*!< output samples per block        */
+  uint32_t                               rate;                    /*!< output samples per second       */
+  uint32_t                               block_count;             /*!< output blocks                   */
+  struct adc_filter_struct               *next;                   /*!< next chain on the stream        */
+} adc_filter_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup ADC_filter_library_exported_functions
+  * @{
+  */
+
+error_status adc_filter_init             (adc_filter_type *filter, adc_stream_type *st);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,318 @@
+/**
+  **************************************************************************
+  * @file     adc_stream.c
+  * @brief    adc acquisition stream library source file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "adc_stream.h"
+
+/** @addtogroup AT32F402_405_middlewares_adc_stream_library
+  * @{
+  */
+
+/** @defgroup ADC_stream_library
+  * @brief continuous acquisition of an adc1 ordinary sequence. a timer
+  *        triggers one sequence per sample period, circular dma fills an
+  *        interleaved ring and each half of the ring is split into one
+  *        block per channel before the callback. the cpu only takes two
+  *        dma interrupts per ring.
+  * @{
+  */
+
+static void adc_stream_dma_event(dma_app_handle_type *hdma, uint32_t event);
+
+/**
+  * @brief  get the ordinary trigger and the counting clock of a timer.
+  * @param  tmr_x: trigger timer.
+  * @param  trigger: ordinary trigger of the timer trgout.
+  * @retval timer counting clock, 0 if the timer cannot trigger adc1.
+  */
+static uint32_t adc_stream_tmr_get(tmr_type *tmr_x, adc_ordinary_trig_select_type *trigger)
+{
+  crm_clocks_freq_type clocks;
+  uint32_t apb_freq;
+
+  crm_clocks_freq_get(&clocks);
+
+  if(tmr_x == TMR1 || tmr_x == TMR9)
+  {
+    crm_periph_clock_enable((tmr_x == TMR1) ? CRM_TMR1_PERIPH_CLOCK : CRM_TMR9_PERIPH_CLOCK, TRUE);
+    *trigger = (tmr_x == TMR1) ? ADC12_ORDINARY_TRIG_TMR1TRGOUT : ADC12_ORDINARY_TRIG_TMR9TRGOUT;
+    apb_freq = clocks.apb2_freq;
+  }
+  else if(tmr_x == TMR2 || tmr_x == TMR3)
+  {
+    crm_periph_clock_enable((tmr_x == TMR2) ? CRM_TMR2_PERIPH_CLOCK : CRM_TMR3_PERIPH_CLOCK, TRUE);
+    *trigger = (tmr_x == TMR2) ? ADC12_ORDINARY_TRIG_TMR2TRGOUT : ADC12_ORDINARY_TRIG_TMR3TRGOUT;
+    apb_freq = clocks.apb1_freq;
+  }
+  else
+  {
+    return 0;
+  }
+
+  /* timers run at twice the apb clock when the apb is divided */
+  return (apb_freq == clocks.ahb_freq) ? apb_freq : apb_freq * 2;
+}
+
+/**
+  * @brief  split one half of the ring into channel blocks.
+  * @param  st: the handle points to the stream information.
+  * @param  half: 0 for the first half, 1 for the second.
+  * @retval none.
+  */
+static void adc_stream_block_split(adc_stream_type *st, uint32_t half)
+{
+  uint32_t length = (uint32_t)st->block_size * st->channel_num;
+  uint16_t *src = st->ring + half * length;
+  uint16_t *dst, *out;
+  uint32_t ch, index;
+
+  st->ring_count += length;
+  st->ring_offset = (half == 0) ? length : 0;
+  if(st->ring_callback != 0)
+  {
+    st->ring_callback(st, st->ring_arg);
+  }
+
+  st->block_count ++;
+  if(st->block == 0)
+  {
+    if(st->callback != 0)
+    {
+      st->callback(st, src);
+    }
+    return;
+  }
+
+  dst = st->block + half * length;
+  for(ch = 0; ch < st->channel_num; ch ++)
+  {
+    out = dst + ch * st->block_size;
+    for(index = ch; index < length; index += st->channel_num)
+    {
+      *out++ = src[index];
+    }
+  }
+
+  if(st->callback != 0)
+  {
+    st->callback(st, dst);
+  }
+}
+
+/**
+  * @brief  ring channel event.
+  * @param  hdma: ring channel handle.
+  * @param  event: dma application events.
+  * @retval none.
+  */
+static void adc_stream_dma_event(dma_app_handle_type *hdma, uint32_t event)
+{
+  adc_stream_type *st = (adc_stream_type *)hdma->user;
+
+  if(event & DMA_APP_EVENT_ERROR)
+  {
+    st->error_count ++;
+    return;
+  }
+  if(event & DMA_APP_EVENT_HALF)
+  {
+    adc_stream_block_split(st, 0);
+  }
+  if(event & DMA_APP_EVENT_FULL)
+  {
+    adc_stream_block_split(st, 1);
+  }
+}
+
+/**
+  * @brief  configure adc1, the trigger timer and the ring channel. the
+  *         analog pins and the adc clock divider are set by the user,
+  *         dma_app_init must be called before. the sequence with its
+  *         oversampling must convert within one sample period.
+  * @param  st: the handle points to the stream information.
+  * @retval ERROR if a parameter is invalid or no dma channel is free.
+  */
+error_status adc_stream_init(adc_stream_type *st)
+{
+  adc_base_config_type adc_base_struct;
+  adc_ordinary_trig_select_type trigger;
+  dma_init_type dma_init_struct;
+  uint32_t tmr_freq, ticks, div;
+  uint8_t index;
+
+  if(st->channel_num == 0 || st->channel_num > ADC_STREAM_CHANNEL_MAX || st->block_size == 0 ||
+     (uint32_t)st->block_size * st->channel_num * 2 > 0xFFFF || st->sample_rate == 0)
+  {
+    return ERROR;
+  }
+
+  tmr_freq = adc_stream_tmr_get(st->tmr_x, &trigger);
+  if(tmr_freq == 0 || st->sample_rate > tmr_freq)
+  {
+    return ERROR;
+  }
+
+  /* sample period, the prescaler keeps the period on 16 bits */
+  ticks = tmr_freq / st->sample_rate;
+  div = ticks / 0x10000 + 1;
+  ticks /= div;
+  st->rate = tmr_freq / (ticks * div);
+
+  tmr_counter_enable(st->tmr_x, FALSE);
+  tmr_base_init(st->tmr_x, ticks - 1, div - 1);
+  tmr_cnt_dir_set(st->tmr_x, TMR_COUNT_UP);
+  tmr_primary_mode_select(st->tmr_x, TMR_PRIMARY_SEL_OVERFLOW);
+
+  dma_default_para_init(&dma_init_struct);
+  dma_init_struct.direction = DMA_DIR_PERIPHERAL_TO_MEMORY;
+  dma_init_struct.memory_inc_enable = TRUE;
+  dma_init_struct.peripheral_inc_enable = FALSE;
+  dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_HALFWORD;
+  dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_HALFWORD;
+  dma_init_struct.priority = DMA_PRIORITY_VERY_HIGH;
+  if(st->hdma == 0)
+  {
+    st->hdma = dma_app_channel_alloc(DMAMUX_DMAREQ_ID_ADC1, &dma_init_struct, adc_stream_dma_event, st->priority);
+    if(st->hdma == 0)
+    {
+      return ERROR;
+    }
+  }
+  st->hdma->user = st;
+  st->block_count = 0;
+  st->error_count = 0;
+
+  crm_periph_clock_enable(CRM_ADC1_PERIPH_CLOCK, TRUE);
+  adc_enable(ADC1, FALSE);
+
+  adc_base_default_para_init(&adc_base_struct);
+  adc_base_struct.sequence_mode = TRUE;
+  adc_base_struct.repeat_mode = FALSE;
+  adc_base_struct.data_align = ADC_RIGHT_ALIGNMENT;
+  adc_base_struct.ordinary_channel_length = st->channel_num;
+  adc_base_config(ADC1, &adc_base_struct);
+
+  for(index = 0; index < st->channel_num; index ++)
+  {
+    adc_ordinary_channel_set(ADC1, st->channel[index], index + 1, st->sampletime);
+  }
+
+  if(st->oversample_enable == TRUE)
+  {
+    adc_oversample_ratio_shift_set(ADC1, st->oversample_ratio, st->oversample_shift);
+    adc_ordinary_oversample_trig_enable(ADC1, FALSE);
+    adc_ordinary_oversample_enable(ADC1, TRUE);
+  }
+  else
+  {
+    adc_ordinary_oversample_enable(ADC1, FALSE);
+  }
+
+  adc_ordinary_conversion_trigger_set(ADC1, trigger, TRUE);
+  adc_dma_mode_enable(ADC1, TRUE);
+
+  adc_enable(ADC1, TRUE);
+  adc_calibration_init(ADC1);
+  while(adc_calibration_init_status_get(ADC1));
+  adc_calibration_start(ADC1);
+  while(adc_calibration_status_get(ADC1));
+
+  return SUCCESS;
+}
+
+/**
+  * @brief  start the acquisition, the first callback follows one block period.
+  * @param  st: the handle points to the stream information.
+  * @retval none.
+  */
+void adc_stream_start(adc_stream_type *st)
+{
+  st->ring_count = 0;
+  st->ring_offset = 0;
+  dma_app_start_stream(st->hdma, (uint32_t)&ADC1->odt, (uint32_t)st->ring,
+                       (uint16_t)(st->block_size * st->channel_num * 2));
+  tmr_counter_value_set(st->tmr_x, 0);
+  tmr_counter_enable(st->tmr_x, TRUE);
+}
+
+/**
+  * @brief  stop the acquisition. a sequence already triggered completes in
+  *         the adc, adc_stream_start restarts on a ring boundary.
+  * @param  st: the handle points to the stream information.
+  * @retval none.
+  */
+void adc_stream_stop(adc_stream_type *st)
+{
+  tmr_counter_enable(st->tmr_x, FALSE);
+  dma_app_stop(st->hdma);
+}
+
+/**
+  * @brief  get the samples of one channel in a block.
+  * @param  st: the handle points to the stream information.
+  * @param  block: block passed to the callback.
+  * @param  index: channel position in the sequence.
+  * @retval block_size samples of the channel.
+  */
+uint16_t* adc_stream_channel_get(adc_stream_type *st, uint16_t *block, uint8_t index)
+{
+  return block + (uint32_t)index * st->block_size;
+}
+
+/**
+  * @brief  get the conversions written since adc_stream_start. the count is
+  *         exact between the ring interrupts, one pending ring interrupt is
+  *         taken into account.
+  * @param  st: the handle points to the stream information.
+  * @param  offset: ring index of the next conversion, can be 0.
+  * @retval conversions written, wraps around on 32 bits.
+  */
+uint32_t adc_stream_position_get(adc_stream_type *st, uint32_t *offset)
+{
+  uint32_t length = (uint32_t)st->block_size * st->channel_num * 2;
+  uint32_t pos, count, primask;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  pos = length - dma_data_number_get(st->hdma->channel);
+  if(pos >= length)
+  {
+    pos = 0;
+  }
+  count = st->ring_count + (pos + length - st->ring_offset) % length;
+  __set_PRIMASK(primask);
+
+  if(offset != 0)
+  {
+    *offset = pos;
+  }
+  return count;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,129 @@
+/**
+  **************************************************************************
+  * @file     adc_stream.h
+  * @brief    adc acquisition stream library header file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __ADC_STREAM_H
+#define __ADC_STREAM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "dma_application.h"
+
+/** @addtogroup AT32F402_405_middlewares_adc_stream_library
+  * @{
+  */
+
+/** @defgroup ADC_stream_library_config
+  * @{
+  */
+
+#define ADC_STREAM_CHANNEL_MAX           16          /*!< ordinary sequence length of the adc */
+
+/**
+  * @}
+  */
+
+/** @defgroup ADC_stream_library_types
+  * @{
+  */
+
+struct adc_stream_struct;
+
+/**
+  * @brief block callback, block holds block_size samples of each channel,
+  *        channel k starts at block + k * block_size. the block stays valid
+  *        for one block period after the callback. without a block buffer
+  *        the callback gets the ring half in place, channel k at sample k
+  *        with a stride of channel_num, valid until the callback returns.
+  */
+typedef void (*adc_stream_callback_type)(struct adc_stream_struct *st, uint16_t *block);
+
+/**
+  * @brief ring callback, called for each written half of the ring before
+  *        the block callback
+  */
+typedef void (*adc_stream_ring_callback_type)(struct adc_stream_struct *st, void *arg);
+
+/**
+  * @brief adc stream handle, the fields up to user are filled in before
+  *        adc_stream_init
+  */
+typedef struct adc_stream_struct
+{
+  adc_channel_select_type                channel[ADC_STREAM_CHANNEL_MAX]; /*!< ordinary sequence        */
+  uint8_t                                channel_num;             /*!< channels in the sequence        */
+  adc_sampletime_select_type             sampletime;              /*!< sample time of all channels     */
+  tmr_type                               *tmr_x;                  /*!< trigger timer, TMR1, TMR2, TMR3 or TMR9 */
+  uint32_t                               sample_rate;             /*!< sequences per second            */
+  confirm_state                          oversample_enable;       /*!< oversample each conversion      */
+  adc_oversample_ratio_type              oversample_ratio;        /*!< oversample ratio                */
+  adc_oversample_shift_type              oversample_shift;        /*!< oversample shift                */
+  uint16_t                               block_size;              /*!< samples per channel and block   */
+  uint16_t                               *ring;                   /*!< dma ring, 2 * block_size * channel_num */
+  uint16_t                               *block;                  /*!< channel blocks, 2 * block_size * channel_num,
+                                                                       0 to get the ring in place */
+  adc_stream_callback_type               callback;                /*!< block callback, in interrupt    */
+  uint8_t                                priority;                /*!< dma interrupt preemption priority */
+  void                                   *user;                   /*!< user data for the callback      */
+
+  adc_stream_ring_callback_type          ring_callback;           /*!< ring half written, in interrupt, set by extensions */
+  void                                   *ring_arg;               /*!< argument of the ring callback   */
+  dma_app_handle_type                    *hdma;                   /*!< ring channel                    */
+  uint32_t                               rate;                    /*!< sequences per second after timer rounding */
+  uint32_t                               block_count;             /*!< blocks delivered                */
+  uint32_t                               ring_count;              /*!< conversions accounted at the last ring half */
+  uint32_t                               ring_offset;             /*!< ring index of ring_count        */
+  uint32_t                               error_count;             /*!< dma errors                      */
+} adc_stream_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup ADC_stream_library_exported_functions
+  * @{
+  */
+
+error_status adc_stream_init             (adc_stream_type *st);
+void         adc_stream_start            (adc_stream_type *st);
+void         adc_stream_stop             (adc_stream_type *st);
+uint16_t*    adc_stream_channel_get      (adc_stream_type *st, uint16_t *block, uint8_t index);
+uint32_t     adc_stream_position_get     (adc_stream_type *st, uint32_t *offset);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,407 @@
+/**
+  **************************************************************************
+  * @file     dma_application.c
+  * @brief    dma application libray source
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "dma_application.h"
+
+/** @addtogroup AT32F402_405_middlewares_dma_application_library
+  * @{
+  */
+
+/** @defgroup DMA_library
+  * @brief dma channel allocation, completion callbacks, streaming and
+  *        software chained descriptors on top of the dma driver.
+  *        call dma_app_irq_handler from the channel interrupt handler, for
+  *        example DMA1_Channel1_IRQHandler:
+  *          dma_app_irq_handler(dma_app_handle_get(DMA1_CHANNEL1));
+  * @{
+  */
+
+#define DMA_APP_FLAG_GL                  ((uint32_t)0x00000001)
+#define DMA_APP_FLAG_FDT                 ((uint32_t)0x00000002)
+#define DMA_APP_FLAG_HDT                 ((uint32_t)0x00000004)
+#define DMA_APP_FLAG_DTERR               ((uint32_t)0x00000008)
+
+static dma_app_handle_type dma_app_handle[DMA_APP_CHANNEL_NUM];
+
+static dma_channel_type * const dma_app_channel[DMA_APP_CHANNEL_NUM] =
+{
+  DMA1_CHANNEL1, DMA1_CHANNEL2, DMA1_CHANNEL3, DMA1_CHANNEL4, DMA1_CHANNEL5, DMA1_CHANNEL6, DMA1_CHANNEL7,
+  DMA2_CHANNEL1, DMA2_CHANNEL2, DMA2_CHANNEL3, DMA2_CHANNEL4, DMA2_CHANNEL5, DMA2_CHANNEL6, DMA2_CHANNEL7,
+};
+
+static dmamux_channel_type * const dma_app_dmamux[DMA_APP_CHANNEL_NUM] =
+{
+  DMA1MUX_CHANNEL1, DMA1MUX_CHANNEL2, DMA1MUX_CHANNEL3, DMA1MUX_CHANNEL4, DMA1MUX_CHANNEL5, DMA1MUX_CHANNEL6, DMA1MUX_CHANNEL7,
+  DMA2MUX_CHANNEL1, DMA2MUX_CHANNEL2, DMA2MUX_CHANNEL3, DMA2MUX_CHANNEL4, DMA2MUX_CHANNEL5, DMA2MUX_CHANNEL6, DMA2MUX_CHANNEL7,
+};
+
+static const IRQn_Type dma_app_irqn[DMA_APP_CHANNEL_NUM] =
+{
+  DMA1_Channel1_IRQn, DMA1_Channel2_IRQn, DMA1_Channel3_IRQn, DMA1_Channel4_IRQn, DMA1_Channel5_IRQn, DMA1_Channel6_IRQn, DMA1_Channel7_IRQn,
+  DMA2_Channel1_IRQn, DMA2_Channel2_IRQn, DMA2_Channel3_IRQn, DMA2_Channel4_IRQn, DMA2_Channel5_IRQn, DMA2_Channel6_IRQn, DMA2_Channel7_IRQn,
+};
+
+/**
+  * @brief  initialize the dma application library, all channels are free.
+  *         dma clocks and the cycle counter for the statistics are enabled.
+  * @param  none
+  * @retval none
+  */
+void dma_app_init(void)
+{
+  uint32_t i_index;
+
+  crm_periph_clock_enable(CRM_DMA1_PERIPH_CLOCK, TRUE);
+  crm_periph_clock_enable(CRM_DMA2_PERIPH_CLOCK, TRUE);
+
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  for(i_index = 0; i_index < DMA_APP_CHANNEL_NUM; i_index ++)
+  {
+    dma_app_handle[i_index].dma_x = (i_index < 7) ? DMA1 : DMA2;
+    dma_app_handle[i_index].channel = dma_app_channel[i_index];
+    dma_app_handle[i_index].dmamux_channel = dma_app_dmamux[i_index];
+    dma_app_handle[i_index].irqn = dma_app_irqn[i_index];
+    dma_app_handle[i_index].flag_shift = (i_index % 7) * 4;
+    dma_app_handle[i_index].used = 0;
+    dma_app_handle[i_index].busy = 0;
+  }
+}
+
+/**
+  * @brief  allocate a free dma channel and route a dmamux request to it.
+  * @param  req: dmamux request, DMAMUX_DMAREQ_ID_REQ_G1 etc. is unused for
+  *         memory to memory transfers
+  * @param  dma_init_struct: direction, data width, increment and priority,
+  *         address, buffer size and loop mode are set by the start functions
+  * @param  callback: event callback, can be 0
+  * @param  priority: channel interrupt preemption priority
+  * @retval channel handle, 0 if no channel is free
+  */
+dma_app_handle_type* dma_app_channel_alloc(dmamux_requst_id_sel_type req, dma_init_type *dma_init_struct, dma_app_callback_type callback, uint8_t priority)
+{
+  dma_app_handle_type *hdma = 0;
+  uint32_t i_index;
+
+  for(i_index = 0; i_index < DMA_APP_CHANNEL_NUM; i_index ++)
+  {
+    if(dma_app_handle[i_index].used == 0)
+    {
+      hdma = &dma_app_handle[i_index];
+      break;
+    }
+  }
+  if(hdma == 0)
+  {
+    return 0;
+  }
+
+  hdma->used = 1;
+  hdma->busy = 0;
+  hdma->callback = callback;
+  hdma->user = 0;
+  hdma->desc = 0;
+  hdma->unit = 1 << dma_init_struct->memory_data_width;
+
+  dma_reset(hdma->channel);
+  dma_init(hdma->channel, dma_init_struct);
+  if(dma_init_struct->direction != DMA_DIR_MEMORY_TO_MEMORY)
+  {
+    dma_flexible_config(hdma->dma_x, hdma->dmamux_channel, req);
+  }
+  hdma->dma_x->clr = (DMA_APP_FLAG_GL | DMA_APP_FLAG_FDT | DMA_APP_FLAG_HDT | DMA_APP_FLAG_DTERR) << hdma->flag_shift;
+  dma_app_stat_reset(hdma);
+
+  nvic_irq_enable(hdma->irqn, priority, 0);
+  return hdma;
+}
+
+/**
+  * @brief  stop and free a dma channel.
+  * @param  hdma: channel handle
+  * @retval none
+  */
+void dma_app_channel_free(dma_app_handle_type *hdma)
+{
+  dma_app_stop(hdma);
+  nvic_irq_disable(hdma->irqn);
+  hdma->used = 0;
+}
+
+/**
+  * @brief  load the addresses and count and enable the channel.
+  * @param  hdma: channel handle
+  * @param  peripheral_addr: peripheral address
+  * @param  memory_addr: memory address
+  * @param  count: data number
+  * @param  dma_int: channel interrupts
+  * @retval none
+  */
+static void dma_app_arm(dma_app_handle_type *hdma, uint32_t peripheral_addr, uint32_t memory_addr, uint16_t count, uint32_t dma_int)
+{
+  dma_channel_type *channel = hdma->channel;
+
+  hdma->count = count;
+  channel->ctrl_bit.chen = FALSE;
+  channel->paddr = peripheral_addr;
+  channel->maddr = memory_addr;
+  channel->dtcnt = count;
+  channel->ctrl_bit.lm = (hdma->mode == DMA_APP_MODE_STREAM) ? TRUE : FALSE;
+  channel->ctrl = (channel->ctrl & ~(DMA_FDT_INT | DMA_HDT_INT | DMA_DTERR_INT)) | dma_int;
+  channel->ctrl_bit.chen = TRUE;
+}
+
+/**
+  * @brief  start one transfer, DMA_APP_EVENT_FULL is reported when done.
+  * @param  hdma: channel handle
+  * @param  peripheral_addr: peripheral address, source in memory to memory mode
+  * @param  memory_addr: memory address
+  * @param  count: data number
+  * @retval ERROR if the channel is busy
+  */
+error_status dma_app_start(dma_app_handle_type *hdma, uint32_t peripheral_addr, uint32_t memory_addr, uint16_t count)
+{
+  if(hdma->busy)
+  {
+    return ERROR;
+  }
+  hdma->busy = 1;
+  hdma->mode = DMA_APP_MODE_SINGLE;
+  hdma->arm_cycle = DWT->CYCCNT;
+  dma_app_arm(hdma, peripheral_addr, memory_addr, count, DMA_FDT_INT | DMA_DTERR_INT);
+  return SUCCESS;
+}
+
+/**
+  * @brief  start a circular stream, DMA_APP_EVENT_HALF and DMA_APP_EVENT_FULL
+  *         are reported for each half of the buffer until dma_app_stop.
+  * @param  hdma: channel handle
+  * @param  peripheral_addr: peripheral address
+  * @param  memory_addr: memory address of the stream buffer
+  * @param  count: data number of the whole buffer
+  * @retval ERROR if the channel is busy
+  */
+error_status dma_app_start_stream(dma_app_handle_type *hdma, uint32_t peripheral_addr, uint32_t memory_addr, uint16_t count)
+{
+  if(hdma->busy)
+  {
+    return ERROR;
+  }
+  hdma->busy = 1;
+  hdma->mode = DMA_APP_MODE_STREAM;
+  hdma->arm_cycle = DWT->CYCCNT;
+  dma_app_arm(hdma, peripheral_addr, memory_addr, count, DMA_FDT_INT | DMA_HDT_INT | DMA_DTERR_INT);
+  return SUCCESS;
+}
+
+/**
+  * @brief  start a descriptor chain. the next descriptor is loaded from the
+  *         full transfer interrupt before any callback runs, so the gap
+  *         between two descriptors is the interrupt entry time only.
+  *         DMA_APP_EVENT_DESC is reported per descriptor and
+  *         DMA_APP_EVENT_FULL after the last one.
+  * @param  hdma: channel handle
+  * @param  desc: first descriptor
+  * @retval ERROR if the channel is busy
+  */
+error_status dma_app_start_chain(dma_app_handle_type *hdma, dma_app_desc_type *desc)
+{
+  if(hdma->busy || desc == 0)
+  {
+    return ERROR;
+  }
+  hdma->busy = 1;
+  hdma->mode = DMA_APP_MODE_CHAIN;
+  hdma->desc = desc;
+  hdma->arm_cycle = DWT->CYCCNT;
+  dma_app_arm(hdma, desc->peripheral_addr, desc->memory_addr, desc->count, DMA_FDT_INT | DMA_DTERR_INT);
+  return SUCCESS;
+}
+
+/**
+  * @brief  stop the channel, no event is reported.
+  * @param  hdma: channel handle
+  * @retval none
+  */
+void dma_app_stop(dma_app_handle_type *hdma)
+{
+  hdma->channel->ctrl_bit.chen = FALSE;
+  hdma->channel->ctrl &= ~(DMA_FDT_INT | DMA_HDT_INT | DMA_DTERR_INT);
+  hdma->dma_x->clr = DMA_APP_FLAG_GL << hdma->flag_shift;
+  if(hdma->busy)
+  {
+    hdma->stat.busy_cycles += DWT->CYCCNT - hdma->arm_cycle;
+    hdma->busy = 0;
+  }
+}
+
+/**
+  * @brief  check if a transfer is in progress.
+  * @param  hdma: channel handle
+  * @retval SET or RESET
+  */
+flag_status dma_app_busy(dma_app_handle_type *hdma)
+{
+  return hdma->busy ? SET : RESET;
+}
+
+/**
+  * @brief  clear the utilization counters and start a new measure window.
+  * @param  hdma: channel handle
+  * @retval none
+  */
+void dma_app_stat_reset(dma_app_handle_type *hdma)
+{
+  hdma->stat.xfer_count = 0;
+  hdma->stat.desc_count = 0;
+  hdma->stat.bytes = 0;
+  hdma->stat.error_count = 0;
+  hdma->stat.busy_cycles = 0;
+  hdma->stat.start_cycle = DWT->CYCCNT;
+  hdma->arm_cycle = hdma->stat.start_cycle;
+}
+
+/**
+  * @brief  channel utilization since the last dma_app_stat_reset, the time
+  *         the channel was armed over the measure window. the window must
+  *         be shorter than the cycle counter period.
+  * @param  hdma: channel handle
+  * @retval utilization in 1/1000
+  */
+uint32_t dma_app_utilization_get(dma_app_handle_type *hdma)
+{
+  uint32_t now = DWT->CYCCNT;
+  uint32_t window = now - hdma->stat.start_cycle;
+  uint32_t busy = hdma->stat.busy_cycles;
+
+  if(hdma->busy)
+  {
+    busy += now - hdma->arm_cycle;
+  }
+  if(window == 0)
+  {
+    return 0;
+  }
+  return (uint32_t)(((uint64_t)busy * 1000) / window);
+}
+
+/**
+  * @brief  get the handle of a channel, for the interrupt handlers.
+  * @param  dmax_channely: dma channel
+  * @retval channel handle, 0 if not a dma channel
+  */
+dma_app_handle_type* dma_app_handle_get(dma_channel_type *dmax_channely)
+{
+  uint32_t i_index;
+  for(i_index = 0; i_index < DMA_APP_CHANNEL_NUM; i_index ++)
+  {
+    if(dma_app_channel[i_index] == dmax_channely)
+    {
+      return &dma_app_handle[i_index];
+    }
+  }
+  return 0;
+}
+
+/**
+  * @brief  dma channel interrupt handler.
+  * @param  hdma: channel handle
+  * @retval none
+  */
+void dma_app_irq_handler(dma_app_handle_type *hdma)
+{
+  uint32_t sts, event = 0;
+  dma_app_desc_type *desc;
+
+  if(hdma == 0)
+  {
+    return;
+  }
+  sts = (hdma->dma_x->sts >> hdma->flag_shift) & (DMA_APP_FLAG_FDT | DMA_APP_FLAG_HDT | DMA_APP_FLAG_DTERR);
+  hdma->dma_x->clr = (sts | DMA_APP_FLAG_GL) << hdma->flag_shift;
+
+  if(sts & DMA_APP_FLAG_DTERR)
+  {
+    hdma->stat.error_count ++;
+    dma_app_stop(hdma);
+    event = DMA_APP_EVENT_ERROR;
+  }
+  else
+  {
+    if(sts & DMA_APP_FLAG_HDT)
+    {
+      event |= DMA_APP_EVENT_HALF;
+    }
+    if(sts & DMA_APP_FLAG_FDT)
+    {
+      if(hdma->mode == DMA_APP_MODE_CHAIN)
+      {
+        desc = hdma->desc;
+        hdma->stat.desc_count ++;
+        hdma->stat.bytes += (uint32_t)desc->count * hdma->unit;
+        if(desc->next != 0)
+        {
+          /* re-arm first, the callback may take time */
+          hdma->desc = desc->next;
+          hdma->channel->ctrl_bit.chen = FALSE;
+          hdma->channel->paddr = hdma->desc->peripheral_addr;
+          hdma->channel->maddr = hdma->desc->memory_addr;
+          hdma->channel->dtcnt = hdma->desc->count;
+          hdma->channel->ctrl_bit.chen = TRUE;
+          event |= DMA_APP_EVENT_DESC;
+        }
+        else
+        {
+          hdma->stat.xfer_count ++;
+          dma_app_stop(hdma);
+          event |= DMA_APP_EVENT_DESC | DMA_APP_EVENT_FULL;
+        }
+      }
+      else
+      {
+        hdma->stat.xfer_count ++;
+        hdma->stat.bytes += (uint32_t)hdma->count * hdma->unit;
+        if(hdma->mode == DMA_APP_MODE_SINGLE)
+        {
+          dma_app_stop(hdma);
+        }
+        event |= DMA_APP_EVENT_FULL;
+      }
+    }
+  }
+
+  if(event != 0 && hdma->callback != 0)
+  {
+    hdma->callback(hdma, event);
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
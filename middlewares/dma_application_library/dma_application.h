@@ -0,0 +1,160 @@
+/**
+  **************************************************************************
+  * @file     dma_application.h
+  * @brief    dma application libray header file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DMA_APPLICATION_H
+#define __DMA_APPLICATION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "at32f402_405.h"
+
+/** @addtogroup AT32F402_405_middlewares_dma_application_library
+  * @{
+  */
+
+/** @defgroup DMA_library_config
+  * @{
+  */
+
+#define DMA_APP_CHANNEL_NUM              14          /*!< dma1 channel1~7 and dma2 channel1~7 */
+
+/**
+  * @}
+  */
+
+/** @defgroup DMA_library_event
+  * @{
+  */
+
+#define DMA_APP_EVENT_HALF               ((uint32_t)0x00000001)    /*!< half of the transfer done */
+#define DMA_APP_EVENT_FULL               ((uint32_t)0x00000002)    /*!< transfer or stream buffer done */
+#define DMA_APP_EVENT_DESC               ((uint32_t)0x00000004)    /*!< one descriptor of a chain done */
+#define DMA_APP_EVENT_ERROR              ((uint32_t)0x00000008)    /*!< transfer error, channel stopped */
+
+/**
+  * @}
+  */
+
+/** @defgroup DMA_library_types
+  * @{
+  */
+
+/**
+  * @brief dma transfer mode
+  */
+typedef enum
+{
+  DMA_APP_MODE_SINGLE = 0,               /*!< one transfer, channel stops */
+  DMA_APP_MODE_STREAM,                   /*!< loop mode, half and full events */
+  DMA_APP_MODE_CHAIN,                    /*!< descriptor list, re-armed in the interrupt */
+} dma_app_mode_type;
+
+/**
+  * @brief dma transfer descriptor, a chain ends with next = 0,
+  *        a chain pointing back to a previous descriptor loops
+  */
+typedef struct dma_app_desc_struct
+{
+  uint32_t                               peripheral_addr;         /*!< peripheral address, source in memory to memory mode */
+  uint32_t                               memory_addr;             /*!< memory address */
+  uint16_t                               count;                   /*!< data number */
+  struct dma_app_desc_struct             *next;                   /*!< next descriptor */
+} dma_app_desc_type;
+
+/**
+  * @brief dma channel utilization counters
+  */
+typedef struct
+{
+  uint32_t                               xfer_count;              /*!< finished transfers and stream buffers */
+  uint32_t                               desc_count;              /*!< finished descriptors */
+  uint32_t                               bytes;                   /*!< transferred bytes */
+  uint32_t                               error_count;             /*!< transfer errors */
+  uint32_t                               busy_cycles;             /*!< core cycles with the channel armed */
+  uint32_t                               start_cycle;             /*!< cycle counter at the statistics reset */
+} dma_app_stat_type;
+
+struct dma_app_handle_struct;
+typedef void (*dma_app_callback_type)(struct dma_app_handle_struct *hdma, uint32_t event);
+
+/**
+  * @brief dma channel handle
+  */
+typedef struct dma_app_handle_struct
+{
+  dma_type                               *dma_x;                  /*!< dma controller */
+  dma_channel_type                       *channel;                /*!< dma channel registers */
+  dmamux_channel_type                    *dmamux_channel;         /*!< dmamux channel registers */
+  IRQn_Type                              irqn;                    /*!< channel interrupt number */
+  uint8_t                                flag_shift;              /*!< channel flag position in sts */
+  uint8_t                                used;                    /*!< channel allocated */
+  __IO uint8_t                           busy;                    /*!< transfer in progress */
+  dma_app_mode_type                      mode;                    /*!< transfer mode */
+  uint8_t                                unit;                    /*!< memory data width in byte */
+  uint16_t                               count;                   /*!< data number of a single or stream transfer */
+  dma_app_desc_type                      *desc;                   /*!< current descriptor of a chain */
+  dma_app_callback_type                  callback;                /*!< event callback, called in interrupt */
+  void                                   *user;                   /*!< user data for the callback */
+  uint32_t                               arm_cycle;               /*!< cycle counter when armed */
+  dma_app_stat_type                      stat;                    /*!< utilization counters */
+} dma_app_handle_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup DMA_library_exported_functions
+  * @{
+  */
+
+void                 dma_app_init                (void);
+dma_app_handle_type* dma_app_channel_alloc       (dmamux_requst_id_sel_type req, dma_init_type *dma_init_struct, dma_app_callback_type callback, uint8_t priority);
+void                 dma_app_channel_free        (dma_app_handle_type *hdma);
+error_status         dma_app_start               (dma_app_handle_type *hdma, uint32_t peripheral_addr, uint32_t memory_addr, uint16_t count);
+error_status         dma_app_start_stream        (dma_app_handle_type *hdma, uint32_t peripheral_addr, uint32_t memory_addr, uint16_t count);
+error_status         dma_app_start_chain         (dma_app_handle_type *hdma, dma_app_desc_type *desc);
+void                 dma_app_stop                (dma_app_handle_type *hdma);
+flag_status          dma_app_busy                (dma_app_handle_type *hdma);
+void                 dma_app_stat_reset          (dma_app_handle_type *hdma);
+uint32_t             dma_app_utilization_get     (dma_app_handle_type *hdma);
+void                 dma_app_irq_handler         (dma_app_handle_type *hdma);
+dma_app_handle_type* dma_app_handle_get          (dma_channel_type *dmax_channely);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,215 @@
+/**
+  **************************************************************************
+  * @file     flash_job.c
+  * @brief    flash background job library
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "flash_job.h"
+
+/** @addtogroup AT32F402_405_middlewares_flash_job_library
+  * @{
+  */
+
+/** @defgroup FLASH_job_library
+  * @brief sector erase and word program jobs run from the flash interrupt,
+  *        so the caller does not wait in flash_operation_wait_for. the jobs
+  *        are queued, each ends with a status and an optional callback,
+  *        which may queue the next job of a sequence, e.g. erase and then
+  *        program a sector of a firmware update.
+  *
+  *        the odf and error interrupts are enabled only while a job runs,
+  *        the blocking functions of the flash driver must not be used
+  *        then. the cpu stalls on any flash access while a job runs, code
+  *        that has to keep running, its interrupt handlers and the vector
+  *        table must be placed in sram.
+  * @{
+  */
+
+static flash_job_type *flash_job_head = 0;
+static flash_job_type *flash_job_tail = 0;
+
+/**
+  * @brief  start the operation of the job at the head of the queue.
+  * @param  none
+  * @retval none
+  */
+static void flash_job_start(void)
+{
+  flash_job_type *job = flash_job_head;
+
+  if(job->op == FLASH_JOB_SECTOR_ERASE)
+  {
+    FLASH->ctrl_bit.secers = TRUE;
+    FLASH->addr = job->address;
+    FLASH->ctrl_bit.erstr = TRUE;
+  }
+  else
+  {
+    FLASH->ctrl_bit.fprgm = TRUE;
+    *(__IO uint32_t*)(job->address + job->done * 4) = job->pdata[job->done];
+  }
+}
+
+/**
+  * @brief  end the job at the head of the queue and start the next one.
+  * @param  status: job result.
+  * @retval none
+  */
+static void flash_job_finish(flash_status_type status)
+{
+  flash_job_type *job = flash_job_head;
+
+  FLASH->ctrl_bit.secers = FALSE;
+  FLASH->ctrl_bit.fprgm = FALSE;
+
+  flash_job_head = job->next;
+  if(flash_job_head == 0)
+  {
+    flash_job_tail = 0;
+  }
+
+  job->status = status;
+  if(job->callback != 0)
+  {
+    job->callback(job);
+  }
+
+  if(flash_job_head != 0)
+  {
+    flash_job_start();
+  }
+  else
+  {
+    flash_interrupt_enable(FLASH_ERR_INT | FLASH_ODF_INT, FALSE);
+  }
+}
+
+/**
+  * @brief  empty the job queue. the flash must be unlocked and FLASH_IRQn
+  *         enabled in the nvic before jobs are submitted.
+  * @param  none
+  * @retval none
+  */
+void flash_job_init(void)
+{
+  flash_interrupt_enable(FLASH_ERR_INT | FLASH_ODF_INT, FALSE);
+  flash_job_head = 0;
+  flash_job_tail = 0;
+}
+
+/**
+  * @brief  queue an erase or program job, it starts at once if the flash
+  *         is idle. the function returns without waiting for the flash.
+  * @param  job: the job, must stay valid until it ends.
+  * @retval SUCCESS or ERROR if the job has nothing to do.
+  */
+error_status flash_job_submit(flash_job_type *job)
+{
+  uint32_t primask;
+
+  if(job->op == FLASH_JOB_WORD_PROGRAM && (job->count == 0 || job->pdata == 0))
+  {
+    return ERROR;
+  }
+
+  job->status = FLASH_OPERATE_BUSY;
+  job->done = 0;
+  job->next = 0;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  if(flash_job_head == 0)
+  {
+    flash_job_head = job;
+    flash_job_tail = job;
+    flash_flag_clear(FLASH_ODF_FLAG | FLASH_PRGMERR_FLAG | FLASH_EPPERR_FLAG);
+    flash_interrupt_enable(FLASH_ERR_INT | FLASH_ODF_INT, TRUE);
+    flash_job_start();
+  }
+  else
+  {
+    flash_job_tail->next = job;
+    flash_job_tail = job;
+  }
+  __set_PRIMASK(primask);
+
+  return SUCCESS;
+}
+
+/**
+  * @brief  check if background jobs are queued or running.
+  * @param  none
+  * @retval SET or RESET
+  */
+flag_status flash_job_busy(void)
+{
+  return (flash_job_head != 0) ? SET : RESET;
+}
+
+/**
+  * @brief  flash interrupt processing for the background jobs, call it from
+  *         FLASH_IRQHandler. without a job the flags are left to their
+  *         owner.
+  * @param  none
+  * @retval none
+  */
+void flash_job_irq_handler(void)
+{
+  flash_job_type *job = flash_job_head;
+  flash_status_type status;
+
+  if(job == 0)
+  {
+    return;
+  }
+
+  status = flash_operation_status_get();
+  if(status == FLASH_OPERATE_BUSY)
+  {
+    return;
+  }
+
+  flash_flag_clear(FLASH_ODF_FLAG | FLASH_PRGMERR_FLAG | FLASH_EPPERR_FLAG);
+
+  if(status != FLASH_OPERATE_DONE || job->op == FLASH_JOB_SECTOR_ERASE)
+  {
+    flash_job_finish(status);
+    return;
+  }
+
+  /* one word per interrupt, fprgm stays set */
+  if(++job->done < job->count)
+  {
+    *(__IO uint32_t*)(job->address + job->done * 4) = job->pdata[job->done];
+  }
+  else
+  {
+    flash_job_finish(FLASH_OPERATE_DONE);
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
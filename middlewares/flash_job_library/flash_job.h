@@ -0,0 +1,93 @@
+/**
+  **************************************************************************
+  * @file     flash_job.h
+  * @brief    flash background job library header file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FLASH_JOB_H
+#define __FLASH_JOB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "at32f402_405.h"
+
+/** @addtogroup AT32F402_405_middlewares_flash_job_library
+  * @{
+  */
+
+/** @defgroup FLASH_job_library_types
+  * @{
+  */
+
+/**
+  * @brief  flash background job operation type
+  */
+typedef enum
+{
+  FLASH_JOB_SECTOR_ERASE                 = 0x00, /*!< erase the sector at address */
+  FLASH_JOB_WORD_PROGRAM                 = 0x01  /*!< program count words from pdata at address */
+} flash_job_op_type;
+
+/**
+  * @brief  flash background job type, queued by flash_job_submit
+  */
+typedef struct flash_job_struct
+{
+  flash_job_op_type                      op;          /*!< operation */
+  uint32_t                               address;     /*!< sector or word address */
+  const uint32_t                         *pdata;      /*!< words to program */
+  uint32_t                               count;       /*!< number of words to program */
+  void                                   (*callback)(struct flash_job_struct *job); /*!< completion, in the flash interrupt */
+  __IO flash_status_type                 status;      /*!< FLASH_OPERATE_BUSY until the job ends */
+  __IO uint32_t                          done;        /*!< words programmed */
+  struct flash_job_struct                *next;       /*!< queue link */
+} flash_job_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup FLASH_job_library_exported_functions
+  * @{
+  */
+
+void         flash_job_init         (void);
+error_status flash_job_submit       (flash_job_type *job);
+flag_status  flash_job_busy         (void);
+void         flash_job_irq_handler  (void);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
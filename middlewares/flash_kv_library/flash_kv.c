@@ -0,0 +1,770 @@
+/**
+  **************************************************************************
+  * @file     flash_kv.c
+  * @brief    flash key/value store library
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include <string.h>
+#include "flash_kv.h"
+
+/** @addtogroup AT32F402_405_middlewares_flash_kv_library
+  * @{
+  */
+
+/** @defgroup FLASH_kv_library
+  * @brief log structured key/value store over two flash areas. a write
+  *        appends a record with flash_word_program, a ram index gives the
+  *        latest record of each key. when the area runs low the live
+  *        records move to the other area a step at a time, so no single
+  *        write waits for more than one sector erase, and the two areas
+  *        wear evenly. the crc unit is shared, each record crc programs
+  *        the crc-32/mpeg-2 configuration into it first.
+  *
+  *        area:   magic, sequence, state, reserved, records...
+  *        record: key | length << 16, value words, crc32 of both
+  *
+  *        the header word of a record is programmed first and the crc
+  *        last, a record cut by a reset fails its crc, the mount clears
+  *        it to zero word pairs and appends behind it. a new area is
+  *        marked active only after all live records are copied, an
+  *        interrupted collection resumes after reset. the magic word of
+  *        an area is cleared before it is erased.
+  * @{
+  */
+
+#define FLASH_KV_MAGIC                   ((uint32_t)0x4B564C47)
+#define FLASH_KV_STATE_ACTIVE            ((uint32_t)0x00000000)
+#define FLASH_KV_HEADER_SIZE             16
+#define FLASH_KV_TOMBSTONE               ((uint16_t)0x8000)
+#define FLASH_KV_KEY_FREE                ((uint16_t)0xFFFF)
+#define FLASH_KV_ERASED                  ((uint32_t)0xFFFFFFFF)
+#define FLASH_KV_CRC_POLY                ((uint32_t)0x04C11DB7)
+#define FLASH_KV_CRC_INIT                ((uint32_t)0xFFFFFFFF)
+
+#define FLASH_KV_WORD(addr)              (*(__IO uint32_t *)(addr))
+
+/**
+  * @brief  erase one flash sector, can be replaced, e.g. by a simulator.
+  * @param  sector_address: sector address.
+  * @retval flash status.
+  */
+__WEAK flash_status_type flash_kv_erase(uint32_t sector_address)
+{
+  return flash_sector_erase(sector_address);
+}
+
+/**
+  * @brief  program one flash word, can be replaced, e.g. by a simulator.
+  * @param  address: word address.
+  * @param  data: word.
+  * @retval flash status.
+  */
+__WEAK flash_status_type flash_kv_program(uint32_t address, uint32_t data)
+{
+  return flash_word_program(address, data);
+}
+
+/**
+  * @brief  record size in bytes.
+  * @param  length: value length field.
+  * @retval bytes.
+  */
+static uint32_t flash_kv_record_size(uint16_t length)
+{
+  if(length & FLASH_KV_TOMBSTONE)
+  {
+    length = 0;
+  }
+
+  return 8 + ((length + 3) & ~3U);
+}
+
+/**
+  * @brief  first index slot of a key.
+  * @param  key: key.
+  * @retval slot.
+  */
+static uint32_t flash_kv_hash(uint16_t key)
+{
+  return ((key * 2654435761U) >> 16) & (FLASH_KV_INDEX_SIZE - 1);
+}
+
+/**
+  * @brief  find the slot of a key.
+  * @param  kv: the kv handle.
+  * @param  key: key.
+  * @param  insert: 1 to take a free slot if the key is not there.
+  * @retval slot or 0 if not found or the index is full.
+  */
+static flash_kv_slot_type *flash_kv_slot_find(flash_kv_type *kv, uint16_t key, uint8_t insert)
+{
+  uint32_t pos = flash_kv_hash(key);
+  uint32_t i;
+
+  for(i = 0; i < FLASH_KV_INDEX_SIZE; i++)
+  {
+    flash_kv_slot_type *slot = &kv->index[pos];
+
+    if(slot->key == key)
+    {
+      return slot;
+    }
+    if(slot->key == FLASH_KV_KEY_FREE)
+    {
+      if(insert)
+      {
+        slot->key = key;
+        slot->address = 0;
+        return slot;
+      }
+      return 0;
+    }
+    pos = (pos + 1) & (FLASH_KV_INDEX_SIZE - 1);
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  crc of a record image.
+  * @param  header: record header word.
+  * @param  pdata: value bytes, any alignment.
+  * @param  length: value length.
+  * @retval crc32.
+  */
+static uint32_t flash_kv_crc(uint32_t header, const uint8_t *pdata, uint16_t length)
+{
+  uint32_t word;
+  uint16_t i;
+
+  /* other users may have changed the unit, e.g. crc_stream_init */
+  crc_poly_size_set(CRC_POLY_SIZE_32B);
+  crc_poly_value_set(FLASH_KV_CRC_POLY);
+  crc_init_data_set(FLASH_KV_CRC_INIT);
+  crc_reverse_input_data_set(CRC_REVERSE_INPUT_NO_AFFECTE);
+  crc_reverse_output_data_set(CRC_REVERSE_OUTPUT_NO_AFFECTE);
+  crc_data_reset();
+  crc_block_calculate(&header, 1);
+
+  for(i = 0; i < length; i += 4)
+  {
+    word = FLASH_KV_ERASED;
+    memcpy(&word, pdata + i, (length - i < 4) ? (length - i) : 4);
+    crc_block_calculate(&word, 1);
+  }
+
+  return crc_data_get();
+}
+
+/**
+  * @brief  check the crc of a stored record.
+  * @param  address: record address.
+  * @retval SET if valid.
+  */
+static flag_status flash_kv_record_valid(uint32_t address)
+{
+  uint32_t header = FLASH_KV_WORD(address);
+  uint16_t length = header >> 16;
+  uint32_t size = flash_kv_record_size(length);
+
+  if(length & FLASH_KV_TOMBSTONE)
+  {
+    length = 0;
+  }
+
+  return (flash_kv_crc(header, (const uint8_t *)(address + 4), length) == FLASH_KV_WORD(address + size - 4)) ? SET : RESET;
+}
+
+/**
+  * @brief  program words, stops at the first failure.
+  * @param  address: start address.
+  * @param  pword: words.
+  * @param  count: number of words.
+  * @retval flash kv status.
+  */
+static flash_kv_status_type flash_kv_program_words(uint32_t address, const uint32_t *pword, uint32_t count)
+{
+  while(count--)
+  {
+    if(flash_kv_program(address, *pword++) != FLASH_OPERATE_DONE)
+    {
+      return FLASH_KV_FLASH_ERROR;
+    }
+    address += 4;
+  }
+
+  return FLASH_KV_OK;
+}
+
+/**
+  * @brief  append a record to the write area.
+  * @param  kv: the kv handle.
+  * @param  key: key.
+  * @param  pdata: value bytes, any alignment.
+  * @param  length: value length or FLASH_KV_TOMBSTONE.
+  * @param  address: set to the record address.
+  * @retval flash kv status.
+  */
+static flash_kv_status_type flash_kv_append(flash_kv_type *kv, uint16_t key, const uint8_t *pdata, uint16_t length, uint32_t *address)
+{
+  uint16_t data_length = (length & FLASH_KV_TOMBSTONE) ? 0 : length;
+  uint32_t header = key | ((uint32_t)length << 16);
+  uint32_t crc = flash_kv_crc(header, pdata, data_length);
+  uint32_t addr = kv->write_addr;
+  flash_kv_status_type status;
+  uint32_t word;
+  uint16_t i;
+
+  *address = addr;
+
+  /* the record is used from here on even if it fails, its words are not erased */
+  kv->write_addr += flash_kv_record_size(length);
+  kv->write_count++;
+
+  flash_unlock();
+
+  status = flash_kv_program_words(addr, &header, 1);
+  addr += 4;
+
+  for(i = 0; i < data_length && status == FLASH_KV_OK; i += 4)
+  {
+    word = FLASH_KV_ERASED;
+    memcpy(&word, pdata + i, (data_length - i < 4) ? (data_length - i) : 4);
+    status = flash_kv_program_words(addr, &word, 1);
+    addr += 4;
+  }
+
+  if(status == FLASH_KV_OK)
+  {
+    status = flash_kv_program_words(addr, &crc, 1);
+  }
+
+  flash_lock();
+
+  return status;
+}
+
+/**
+  * @brief  erase a sector of an area, the area header is cleared first: a
+  *         reset during the erase can leave the magic and state words with
+  *         an erased sequence, which would win the next mount.
+  * @param  kv: the kv handle.
+  * @param  address: sector address.
+  * @retval flash status.
+  */
+static flash_status_type flash_kv_sector_erase(flash_kv_type *kv, uint32_t address)
+{
+  if((address == kv->area[0] || address == kv->area[1]) && FLASH_KV_WORD(address) == FLASH_KV_MAGIC)
+  {
+    if(flash_kv_program(address, 0) != FLASH_OPERATE_DONE)
+    {
+      return FLASH_PROGRAM_ERROR;
+    }
+  }
+
+  return flash_kv_erase(address);
+}
+
+/**
+  * @brief  bytes left in the write area.
+  * @param  kv: the kv handle.
+  * @retval bytes.
+  */
+uint32_t flash_kv_free_get(flash_kv_type *kv)
+{
+  return kv->area[kv->write_area] + kv->area_size - kv->write_addr;
+}
+
+/**
+  * @brief  erase an area and write its header.
+  * @param  kv: the kv handle.
+  * @param  area: 0 or 1.
+  * @param  sequence: sequence number.
+  * @retval flash kv status.
+  */
+static flash_kv_status_type flash_kv_area_start(flash_kv_type *kv, uint8_t area, uint32_t sequence)
+{
+  uint32_t header[2] = {FLASH_KV_MAGIC, sequence};
+  flash_kv_status_type status;
+
+  flash_unlock();
+  status = flash_kv_program_words(kv->area[area], header, 2);
+  flash_lock();
+
+  kv->write_area = area;
+  kv->write_addr = kv->area[area] + FLASH_KV_HEADER_SIZE;
+
+  return status;
+}
+
+/**
+  * @brief  mark an area active, the other area is garbage from now on.
+  * @param  kv: the kv handle.
+  * @param  area: 0 or 1.
+  * @retval flash kv status.
+  */
+static flash_kv_status_type flash_kv_area_activate(flash_kv_type *kv, uint8_t area)
+{
+  uint32_t state = FLASH_KV_STATE_ACTIVE;
+  flash_kv_status_type status;
+
+  flash_unlock();
+  status = flash_kv_program_words(kv->area[area] + 8, &state, 1);
+  flash_lock();
+
+  kv->active = area;
+  kv->sequence = FLASH_KV_WORD(kv->area[area] + 4);
+
+  return status;
+}
+
+/**
+  * @brief  load the records of an area into the index. a record cut by a
+  *         reset is cleared in word pairs, which read as empty records
+  *         with a wrong crc, so that the log goes on behind it.
+  * @param  kv: the kv handle.
+  * @param  area: 0 or 1.
+  * @retval end of the log.
+  */
+static uint32_t flash_kv_area_load(flash_kv_type *kv, uint8_t area)
+{
+  uint32_t address = kv->area[area] + FLASH_KV_HEADER_SIZE;
+  uint32_t end = kv->area[area] + kv->area_size;
+  uint32_t last = end;
+  flash_kv_slot_type *slot;
+  uint32_t header, size;
+  uint16_t length;
+
+  /* end of the programmed words */
+  while(last > address && FLASH_KV_WORD(last - 4) == FLASH_KV_ERASED)
+  {
+    last -= 4;
+  }
+
+  while(address < last)
+  {
+    header = FLASH_KV_WORD(address);
+    length = header >> 16;
+    size = flash_kv_record_size(length);
+    if(((length & ~FLASH_KV_TOMBSTONE) > FLASH_KV_VALUE_MAX) || (address + size > last))
+    {
+      break;
+    }
+
+    if(flash_kv_record_valid(address) == SET)
+    {
+      slot = flash_kv_slot_find(kv, header & 0xFFFF, 1);
+      if(slot != 0)
+      {
+        slot->address = (length & FLASH_KV_TOMBSTONE) ? 0 : address;
+      }
+    }
+    else if(header != 0 || FLASH_KV_WORD(address + 4) != 0)
+    {
+      break;
+    }
+
+    address += size;
+  }
+
+  if(address < last)
+  {
+    flash_unlock();
+    while(address < last && address + 8 <= end)
+    {
+      flash_kv_program(address, 0);
+      flash_kv_program(address + 4, 0);
+      address += 8;
+    }
+    flash_lock();
+  }
+
+  return (address > last) ? address : last;
+}
+
+/**
+  * @brief  check if an address is inside an area.
+  * @param  kv: the kv handle.
+  * @param  area: 0 or 1.
+  * @param  address: address.
+  * @retval SET if inside.
+  */
+static flag_status flash_kv_in_area(flash_kv_type *kv, uint8_t area, uint32_t address)
+{
+  return (address >= kv->area[area] && address < kv->area[area] + kv->area_size) ? SET : RESET;
+}
+
+/**
+  * @brief  mount the store, an empty or unknown flash is formatted.
+  * @param  kv: the kv handle.
+  * @param  area0: first area address, sector aligned.
+  * @param  area1: second area address, sector aligned.
+  * @param  area_size: size of each area, a multiple of sector_size.
+  * @param  sector_size: flash sector size.
+  * @retval flash kv status.
+  */
+flash_kv_status_type flash_kv_init(flash_kv_type *kv, uint32_t area0, uint32_t area1, uint32_t area_size, uint32_t sector_size)
+{
+  uint8_t valid[2], active[2];
+  uint32_t sequence[2];
+  uint8_t i, a, b;
+
+  kv->area[0] = area0;
+  kv->area[1] = area1;
+  kv->area_size = area_size;
+  kv->sector_size = sector_size;
+  kv->gc_state = FLASH_KV_GC_IDLE;
+  kv->gc_position = 0;
+  kv->erase_count = 0;
+  kv->write_count = 0;
+
+  for(i = 0; i < FLASH_KV_INDEX_SIZE; i++)
+  {
+    kv->index[i].key = FLASH_KV_KEY_FREE;
+    kv->index[i].address = 0;
+  }
+
+  for(i = 0; i < 2; i++)
+  {
+    valid[i] = (FLASH_KV_WORD(kv->area[i]) == FLASH_KV_MAGIC);
+    active[i] = valid[i] && (FLASH_KV_WORD(kv->area[i] + 8) == FLASH_KV_STATE_ACTIVE);
+    sequence[i] = FLASH_KV_WORD(kv->area[i] + 4);
+  }
+
+  if(!valid[0] && !valid[1])
+  {
+    return flash_kv_format(kv);
+  }
+
+  /* a: area with the complete data, b: newer area being filled, if any */
+  if(active[0] && active[1])
+  {
+    a = (sequence[1] > sequence[0]) ? 1 : 0;
+  }
+  else if(active[0] || active[1])
+  {
+    a = active[1] ? 1 : 0;
+  }
+  else
+  {
+    a = valid[1] ? 1 : 0;
+  }
+  b = 1 - a;
+
+  kv->active = a;
+  kv->sequence = sequence[a];
+  kv->write_area = a;
+  kv->write_addr = flash_kv_area_load(kv, a);
+
+  if(!active[a])
+  {
+    /* reset during the first collection after a format */
+    return flash_kv_area_activate(kv, a);
+  }
+
+  if(valid[b] && !active[b] && sequence[b] == sequence[a] + 1)
+  {
+    /* reset during a collection, newer records win */
+    kv->write_area = b;
+    kv->write_addr = flash_kv_area_load(kv, b);
+    kv->gc_state = FLASH_KV_GC_COPY;
+  }
+
+  return FLASH_KV_OK;
+}
+
+/**
+  * @brief  erase both areas and start an empty store.
+  * @param  kv: the kv handle.
+  * @retval flash kv status.
+  */
+flash_kv_status_type flash_kv_format(flash_kv_type *kv)
+{
+  uint32_t address;
+  uint8_t i;
+
+  flash_unlock();
+  for(i = 0; i < 2; i++)
+  {
+    for(address = kv->area[i]; address < kv->area[i] + kv->area_size; address += kv->sector_size)
+    {
+      if(flash_kv_sector_erase(kv, address) != FLASH_OPERATE_DONE)
+      {
+        flash_lock();
+        return FLASH_KV_FLASH_ERROR;
+      }
+      kv->erase_count++;
+    }
+  }
+  flash_lock();
+
+  for(i = 0; i < FLASH_KV_INDEX_SIZE; i++)
+  {
+    kv->index[i].key = FLASH_KV_KEY_FREE;
+    kv->index[i].address = 0;
+  }
+  kv->gc_state = FLASH_KV_GC_IDLE;
+
+  if(flash_kv_area_start(kv, 0, 1) != FLASH_KV_OK)
+  {
+    return FLASH_KV_FLASH_ERROR;
+  }
+
+  return flash_kv_area_activate(kv, 0);
+}
+
+/**
+  * @brief  do one step of garbage collection: erase one sector of the
+  *         other area or copy one live record into it. a write starts the
+  *         collection when the area runs low and does one step itself, an
+  *         idle loop can call this to finish it early.
+  * @param  kv: the kv handle.
+  * @retval SET while collecting.
+  */
+flag_status flash_kv_gc_step(flash_kv_type *kv)
+{
+  uint8_t target = 1 - kv->active;
+  flash_kv_slot_type *slot;
+  uint32_t address, header;
+  flash_status_type status;
+
+  switch(kv->gc_state)
+  {
+    case FLASH_KV_GC_ERASE:
+      address = kv->area[target] + kv->gc_position * kv->sector_size;
+      flash_unlock();
+      status = flash_kv_sector_erase(kv, address);
+      flash_lock();
+      kv->erase_count++;
+      if(status != FLASH_OPERATE_DONE)
+      {
+        kv->gc_state = FLASH_KV_GC_IDLE;
+        break;
+      }
+
+      if(++kv->gc_position * kv->sector_size >= kv->area_size)
+      {
+        /* new records go to the new area from now on */
+        if(flash_kv_area_start(kv, target, kv->sequence + 1) != FLASH_KV_OK)
+        {
+          kv->write_area = kv->active;
+          kv->gc_state = FLASH_KV_GC_IDLE;
+          break;
+        }
+        kv->gc_position = 0;
+        kv->gc_state = FLASH_KV_GC_COPY;
+      }
+      break;
+
+    case FLASH_KV_GC_COPY:
+      /* the next slot still pointing into the old area */
+      while(kv->gc_position < FLASH_KV_INDEX_SIZE)
+      {
+        slot = &kv->index[kv->gc_position];
+        if(slot->key != FLASH_KV_KEY_FREE && flash_kv_in_area(kv, kv->active, slot->address) == SET)
+        {
+          break;
+        }
+        kv->gc_position++;
+      }
+
+      if(kv->gc_position < FLASH_KV_INDEX_SIZE)
+      {
+        slot = &kv->index[kv->gc_position];
+        header = FLASH_KV_WORD(slot->address);
+        if(flash_kv_record_size(header >> 16) > flash_kv_free_get(kv))
+        {
+          break;
+        }
+        if(flash_kv_append(kv, slot->key, (const uint8_t *)(slot->address + 4), header >> 16, &address) == FLASH_KV_OK)
+        {
+          slot->address = address;
+        }
+        kv->gc_position++;
+      }
+      else
+      {
+        flash_kv_area_activate(kv, target);
+        kv->gc_state = FLASH_KV_GC_IDLE;
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  return (kv->gc_state != FLASH_KV_GC_IDLE) ? SET : RESET;
+}
+
+/**
+  * @brief  start a collection if the write area runs low.
+  * @param  kv: the kv handle.
+  * @retval none.
+  */
+static void flash_kv_gc_check(flash_kv_type *kv)
+{
+  if(kv->gc_state == FLASH_KV_GC_IDLE && flash_kv_free_get(kv) < kv->area_size / FLASH_KV_GC_THRESHOLD)
+  {
+    kv->gc_position = 0;
+    kv->gc_state = FLASH_KV_GC_ERASE;
+  }
+}
+
+/**
+  * @brief  append a record, collecting first if it does not fit.
+  * @param  kv: the kv handle.
+  * @param  key: key.
+  * @param  pdata: value.
+  * @param  length: value length or FLASH_KV_TOMBSTONE.
+  * @retval flash kv status.
+  */
+static flash_kv_status_type flash_kv_put(flash_kv_type *kv, uint16_t key, const uint8_t *pdata, uint16_t length)
+{
+  flash_kv_slot_type *slot;
+  uint32_t size = flash_kv_record_size(length);
+  flash_kv_gc_type gc_state;
+  flash_kv_status_type status;
+  uint32_t address, position;
+
+  flash_kv_gc_check(kv);
+  flash_kv_gc_step(kv);
+
+  while(size > flash_kv_free_get(kv))
+  {
+    if(kv->gc_state == FLASH_KV_GC_IDLE)
+    {
+      flash_kv_gc_check(kv);
+      if(kv->gc_state == FLASH_KV_GC_IDLE)
+      {
+        return FLASH_KV_FULL;
+      }
+    }
+
+    gc_state = kv->gc_state;
+    position = kv->gc_position;
+    flash_kv_gc_step(kv);
+
+    /* no progress: the live records do not fit into the new area */
+    if((kv->gc_state == gc_state && kv->gc_position == position) ||
+       (kv->gc_state == FLASH_KV_GC_IDLE && size > flash_kv_free_get(kv)))
+    {
+      return FLASH_KV_FULL;
+    }
+  }
+
+  /* the slot of a new key is taken only once its record fits */
+  slot = flash_kv_slot_find(kv, key, 1);
+  if(slot == 0)
+  {
+    return FLASH_KV_FULL;
+  }
+
+  status = flash_kv_append(kv, key, pdata, length, &address);
+  if(status == FLASH_KV_OK)
+  {
+    slot->address = (length & FLASH_KV_TOMBSTONE) ? 0 : address;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  read the value of a key.
+  * @param  kv: the kv handle.
+  * @param  key: key.
+  * @param  pdata: value buffer.
+  * @param  size: buffer size, a longer value is cut.
+  * @param  length: set to the stored value length, can be 0.
+  * @retval flash kv status.
+  */
+flash_kv_status_type flash_kv_read(flash_kv_type *kv, uint16_t key, void *pdata, uint16_t size, uint16_t *length)
+{
+  flash_kv_slot_type *slot = flash_kv_slot_find(kv, key, 0);
+  uint16_t value_length;
+
+  if(slot == 0 || slot->address == 0)
+  {
+    return FLASH_KV_NOT_FOUND;
+  }
+
+  value_length = FLASH_KV_WORD(slot->address) >> 16;
+  memcpy(pdata, (const void *)(slot->address + 4), (value_length < size) ? value_length : size);
+
+  if(length != 0)
+  {
+    *length = value_length;
+  }
+
+  return FLASH_KV_OK;
+}
+
+/**
+  * @brief  store the value of a key. an unchanged value is not written.
+  * @param  kv: the kv handle.
+  * @param  key: key, 0xFFFF is reserved.
+  * @param  pdata: value.
+  * @param  length: value length, up to FLASH_KV_VALUE_MAX.
+  * @retval flash kv status.
+  */
+flash_kv_status_type flash_kv_write(flash_kv_type *kv, uint16_t key, const void *pdata, uint16_t length)
+{
+  flash_kv_slot_type *slot;
+
+  if(key == FLASH_KV_KEY_FREE || length > FLASH_KV_VALUE_MAX)
+  {
+    return FLASH_KV_PARAM_ERROR;
+  }
+
+  slot = flash_kv_slot_find(kv, key, 0);
+  if(slot != 0 && slot->address != 0 && (FLASH_KV_WORD(slot->address) >> 16) == length &&
+     memcmp((const void *)(slot->address + 4), pdata, length) == 0)
+  {
+    return FLASH_KV_OK;
+  }
+
+  return flash_kv_put(kv, key, (const uint8_t *)pdata, length);
+}
+
+/**
+  * @brief  delete a key.
+  * @param  kv: the kv handle.
+  * @param  key: key.
+  * @retval flash kv status.
+  */
+flash_kv_status_type flash_kv_delete(flash_kv_type *kv, uint16_t key)
+{
+  flash_kv_slot_type *slot = flash_kv_slot_find(kv, key, 0);
+
+  if(slot == 0 || slot->address == 0)
+  {
+    return FLASH_KV_NOT_FOUND;
+  }
+
+  return flash_kv_put(kv, key, 0, FLASH_KV_TOMBSTONE);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,137 @@
+/**
+  **************************************************************************
+  * @file     flash_kv.h
+  * @brief    flash key/value store library header file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FLASH_KV_H
+#define __FLASH_KV_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "at32f402_405.h"
+
+/** @addtogroup AT32F402_405_middlewares_flash_kv_library
+  * @{
+  */
+
+/** @defgroup FLASH_kv_library_config
+  * @{
+  */
+
+#define FLASH_KV_INDEX_SIZE              64          /*!< index slots, power of 2, more than the number of keys */
+#define FLASH_KV_VALUE_MAX               1024        /*!< longest value in bytes */
+#define FLASH_KV_GC_THRESHOLD            4           /*!< start collecting when less than 1/n of an area is free */
+
+/**
+  * @}
+  */
+
+/** @defgroup FLASH_kv_library_types
+  * @{
+  */
+
+/**
+  * @brief flash kv status
+  */
+typedef enum
+{
+  FLASH_KV_OK = 0,                       /*!< done */
+  FLASH_KV_NOT_FOUND,                    /*!< key not stored */
+  FLASH_KV_FULL,                         /*!< live data does not fit into one area */
+  FLASH_KV_PARAM_ERROR,                  /*!< bad key or length */
+  FLASH_KV_FLASH_ERROR,                  /*!< erase or program failed */
+} flash_kv_status_type;
+
+/**
+  * @brief garbage collection state
+  */
+typedef enum
+{
+  FLASH_KV_GC_IDLE = 0,                  /*!< not collecting */
+  FLASH_KV_GC_ERASE,                     /*!< erasing the other area, one sector per step */
+  FLASH_KV_GC_COPY,                      /*!< copying live records, one per step */
+} flash_kv_gc_type;
+
+/**
+  * @brief index slot, key 0xFFFF is free, address 0 is a deleted key
+  */
+typedef struct
+{
+  uint16_t                               key;                     /*!< key                             */
+  uint32_t                               address;                 /*!< latest record of the key        */
+} flash_kv_slot_type;
+
+/**
+  * @brief flash kv handle
+  */
+typedef struct
+{
+  uint32_t                               area[2];                 /*!< area start addresses, sector aligned */
+  uint32_t                               area_size;               /*!< area size, a multiple of sector_size */
+  uint32_t                               sector_size;             /*!< flash sector size               */
+  uint8_t                                active;                  /*!< area holding the complete data  */
+  uint8_t                                write_area;              /*!< area receiving new records      */
+  uint32_t                               write_addr;              /*!< next free word                  */
+  uint32_t                               sequence;                /*!< sequence number of the active area */
+  flash_kv_gc_type                       gc_state;                /*!< garbage collection state        */
+  uint32_t                               gc_position;             /*!< sector or index slot to process */
+  uint32_t                               erase_count;             /*!< sectors erased since init       */
+  uint32_t                               write_count;             /*!< records written since init      */
+  flash_kv_slot_type                     index[FLASH_KV_INDEX_SIZE]; /*!< key index                    */
+} flash_kv_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup FLASH_kv_library_exported_functions
+  * @{
+  */
+
+flash_kv_status_type flash_kv_init      (flash_kv_type *kv, uint32_t area0, uint32_t area1, uint32_t area_size, uint32_t sector_size);
+flash_kv_status_type flash_kv_format    (flash_kv_type *kv);
+flash_kv_status_type flash_kv_read      (flash_kv_type *kv, uint16_t key, void *pdata, uint16_t size, uint16_t *length);
+flash_kv_status_type flash_kv_write     (flash_kv_type *kv, uint16_t key, const void *pdata, uint16_t length);
+flash_kv_status_type flash_kv_delete    (flash_kv_type *kv, uint16_t key);
+flag_status          flash_kv_gc_step   (flash_kv_type *kv);
+uint32_t             flash_kv_free_get  (flash_kv_type *kv);
+
+flash_status_type    flash_kv_erase     (uint32_t sector_address);
+flash_status_type    flash_kv_program   (uint32_t address, uint32_t data);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -2128,6 +2128,322 @@ i2c_status_type i2c_slave_irq_handler_dma(i2c_handle_type* hi2c)
   return I2C_OK;
 }
 
+/**
+  * @brief  start the read phase of a queued transaction. with pec the pec
+  *         byte is received by dma behind the data. a block read gets the
+  *         length byte first and sets up the rest when it arrives.
+  * @param  hi2c: the handle points to the operation information.
+  * @param  trans: running transaction.
+  * @param  start: I2C_GEN_START_READ.
+  * @retval none.
+  */
+static void i2c_queue_read_start(i2c_handle_type* hi2c, i2c_trans_type* trans, i2c_start_mode_type start)
+{
+  if(trans->block)
+  {
+    i2c_interrupt_enable(hi2c->i2cx, I2C_RD_INT | I2C_TDC_INT, TRUE);
+    i2c_transmit_set(hi2c->i2cx, trans->address, 1, I2C_RELOAD_MODE, start);
+  }
+  else
+  {
+    hi2c->pcount = trans->size + (trans->pec ? 1 : 0);
+    i2c_dma_config(hi2c, hi2c->dma_rx_channel, trans->pdata, hi2c->pcount);
+    i2c_pec_transmit_enable(hi2c->i2cx, trans->pec ? TRUE : FALSE);
+    i2c_transmit_set(hi2c->i2cx, trans->address, hi2c->pcount, I2C_AUTO_STOP_MODE, start);
+    i2c_dma_enable(hi2c->i2cx, I2C_DMA_REQUEST_RX, TRUE);
+  }
+}
+
+/**
+  * @brief  start a queued transaction. the memory address goes out in the
+  *         interrupt, the data phase is done by dma.
+  * @param  hi2c: the handle points to the operation information.
+  * @param  trans: transaction to start.
+  * @retval none.
+  */
+static void i2c_queue_start(i2c_handle_type* hi2c, i2c_trans_type* trans)
+{
+  uint8_t pec = trans->pec ? 1 : 0;
+
+  hi2c->trans = trans;
+  hi2c->mode = I2C_DMA_MA_QUEUE;
+  hi2c->status = I2C_START;
+  hi2c->error_code = I2C_OK;
+  hi2c->pbuff = trans->pdata;
+  hi2c->pcount = 0;
+  hi2c->psize = trans->mem_address_width;
+
+  /* flags left by an aborted transaction */
+  i2c_flag_clear(hi2c->i2cx, I2C_STOPF_FLAG | I2C_ACKFAIL_FLAG);
+
+  i2c_dma_enable(hi2c->i2cx, I2C_DMA_REQUEST_TX | I2C_DMA_REQUEST_RX, FALSE);
+  i2c_pec_transmit_enable(hi2c->i2cx, FALSE);
+  i2c_pec_calculate_enable(hi2c->i2cx, pec ? TRUE : FALSE);
+  i2c_interrupt_enable(hi2c->i2cx, I2C_ERR_INT | I2C_ACKFIAL_INT | I2C_STOP_INT, TRUE);
+
+  if(trans->dir == I2C_TRANS_READ && trans->mem_address_width != 0)
+  {
+    /* memory address with soft stop, the read starts on tdc */
+    i2c_interrupt_enable(hi2c->i2cx, I2C_TD_INT | I2C_TDC_INT, TRUE);
+    i2c_transmit_set(hi2c->i2cx, trans->address, trans->mem_address_width, I2C_SOFT_STOP_MODE, I2C_GEN_START_WRITE);
+  }
+  else if(trans->dir == I2C_TRANS_READ && trans->tx_size != 0)
+  {
+    /* write phase by dma with soft stop, the read starts on tdc */
+    i2c_interrupt_enable(hi2c->i2cx, I2C_TDC_INT, TRUE);
+    i2c_dma_config(hi2c, hi2c->dma_tx_channel, trans->ptx, trans->tx_size);
+    i2c_transmit_set(hi2c->i2cx, trans->address, trans->tx_size, I2C_SOFT_STOP_MODE, I2C_GEN_START_WRITE);
+    i2c_dma_enable(hi2c->i2cx, I2C_DMA_REQUEST_TX, TRUE);
+  }
+  else if(trans->dir == I2C_TRANS_READ)
+  {
+    i2c_queue_read_start(hi2c, trans, I2C_GEN_START_READ);
+  }
+  else if(trans->mem_address_width != 0)
+  {
+    /* memory address and data in one transfer */
+    i2c_interrupt_enable(hi2c->i2cx, I2C_TD_INT, TRUE);
+    i2c_pec_transmit_enable(hi2c->i2cx, pec ? TRUE : FALSE);
+    i2c_transmit_set(hi2c->i2cx, trans->address, trans->mem_address_width + trans->size + pec, I2C_AUTO_STOP_MODE, I2C_GEN_START_WRITE);
+  }
+  else if(trans->size == 0)
+  {
+    /* address only, used to probe a device */
+    i2c_transmit_set(hi2c->i2cx, trans->address, 0, I2C_AUTO_STOP_MODE, I2C_GEN_START_WRITE);
+  }
+  else
+  {
+    /* data phase only, the pec byte is appended by hardware */
+    i2c_dma_config(hi2c, hi2c->dma_tx_channel, trans->pdata, trans->size);
+    i2c_pec_transmit_enable(hi2c->i2cx, pec ? TRUE : FALSE);
+    i2c_transmit_set(hi2c->i2cx, trans->address, trans->size + pec, I2C_AUTO_STOP_MODE, I2C_GEN_START_WRITE);
+    i2c_dma_enable(hi2c->i2cx, I2C_DMA_REQUEST_TX, TRUE);
+  }
+}
+
+/**
+  * @brief  finish the running transaction, call its callback and start
+  *         the next one without leaving the interrupt.
+  * @param  hi2c: the handle points to the operation information.
+  * @retval none.
+  */
+static void i2c_queue_complete(i2c_handle_type* hi2c)
+{
+  i2c_trans_type* trans = hi2c->trans;
+
+  i2c_interrupt_enable(hi2c->i2cx, I2C_ERR_INT | I2C_TDC_INT | I2C_STOP_INT | I2C_ACKFIAL_INT | I2C_TD_INT | I2C_RD_INT, FALSE);
+  i2c_dma_enable(hi2c->i2cx, I2C_DMA_REQUEST_TX | I2C_DMA_REQUEST_RX, FALSE);
+  dma_channel_enable(hi2c->dma_tx_channel, FALSE);
+  dma_channel_enable(hi2c->dma_rx_channel, FALSE);
+
+  hi2c->trans = 0;
+  hi2c->status = I2C_END;
+  if(trans == 0)
+  {
+    return;
+  }
+  trans->error_code = hi2c->error_code;
+  trans->pending = 0;
+
+  /* the callback may submit again, e.g. to poll a sensor continuously.
+     such a submit goes to the tail, so the waiting transactions run first */
+  if(trans->callback != 0)
+  {
+    hi2c->completing = 1;
+    trans->callback(hi2c, trans);
+    hi2c->completing = 0;
+  }
+
+  if(hi2c->queue_head != 0)
+  {
+    trans = hi2c->queue_head;
+    hi2c->queue_head = trans->next;
+    if(hi2c->queue_head == 0)
+    {
+      hi2c->queue_tail = 0;
+    }
+    i2c_queue_start(hi2c, trans);
+  }
+}
+
+/**
+  * @brief  queue interrupt processing function.
+  * @param  hi2c: the handle points to the operation information.
+  * @retval i2c status.
+  */
+static i2c_status_type i2c_queue_irq_handler(i2c_handle_type* hi2c)
+{
+  i2c_trans_type* trans = hi2c->trans;
+  uint8_t pec;
+  uint8_t len;
+
+  if(trans == 0)
+  {
+    return I2C_OK;
+  }
+
+  pec = trans->pec ? 1 : 0;
+
+  if (i2c_flag_get(hi2c->i2cx, I2C_ACKFAIL_FLAG) != RESET)
+  {
+    /* clear ackfail flag, the stop is generated by hardware */
+    i2c_flag_clear(hi2c->i2cx, I2C_ACKFAIL_FLAG);
+    i2c_interrupt_enable(hi2c->i2cx, I2C_TD_INT | I2C_TDC_INT | I2C_RD_INT, FALSE);
+    i2c_refresh_txdt_register(hi2c);
+    hi2c->error_code = I2C_ERR_ACKFAIL;
+  }
+  else if (i2c_flag_get(hi2c->i2cx, I2C_TDIS_FLAG) != RESET && hi2c->psize > 0)
+  {
+    /* send memory address, high byte first */
+    hi2c->psize--;
+    if(hi2c->psize == 1)
+    {
+      i2c_data_send(hi2c->i2cx, (trans->mem_address >> 8) & 0xFF);
+    }
+    else
+    {
+      i2c_data_send(hi2c->i2cx, trans->mem_address & 0xFF);
+    }
+
+    if(hi2c->psize == 0)
+    {
+      i2c_interrupt_enable(hi2c->i2cx, I2C_TD_INT, FALSE);
+      if(trans->dir == I2C_TRANS_WRITE && trans->size > 0)
+      {
+        /* the data follows by dma in the same transfer */
+        i2c_dma_config(hi2c, hi2c->dma_tx_channel, trans->pdata, trans->size);
+        i2c_dma_enable(hi2c->i2cx, I2C_DMA_REQUEST_TX, TRUE);
+      }
+    }
+  }
+  else if (i2c_flag_get(hi2c->i2cx, I2C_RDBF_FLAG) != RESET && hi2c->i2cx->ctrl1_bit.rdien)
+  {
+    /* block length, the rest follows on tcrld */
+    i2c_interrupt_enable(hi2c->i2cx, I2C_RD_INT, FALSE);
+    len = i2c_data_receive(hi2c->i2cx);
+    trans->pdata[0] = len;
+    hi2c->psize = (len < trans->size) ? len : trans->size;
+  }
+  else if (i2c_flag_get(hi2c->i2cx, I2C_TCRLD_FLAG) != RESET)
+  {
+    i2c_interrupt_enable(hi2c->i2cx, I2C_TDC_INT, FALSE);
+    hi2c->pcount = hi2c->psize + pec;
+    hi2c->psize = 0;
+
+    if(hi2c->pcount == 0)
+    {
+      /* empty block */
+      i2c_transmit_set(hi2c->i2cx, trans->address, 0, I2C_SOFT_STOP_MODE, I2C_WITHOUT_START);
+      i2c_stop_generate(hi2c->i2cx);
+    }
+    else
+    {
+      i2c_dma_config(hi2c, hi2c->dma_rx_channel, trans->pdata + 1, hi2c->pcount);
+      i2c_pec_transmit_enable(hi2c->i2cx, pec ? TRUE : FALSE);
+      i2c_transmit_set(hi2c->i2cx, trans->address, hi2c->pcount, I2C_AUTO_STOP_MODE, I2C_WITHOUT_START);
+      i2c_dma_enable(hi2c->i2cx, I2C_DMA_REQUEST_RX, TRUE);
+    }
+  }
+  else if (i2c_flag_get(hi2c->i2cx, I2C_TDC_FLAG) != RESET)
+  {
+    /* write phase done, restart for reading */
+    i2c_interrupt_enable(hi2c->i2cx, I2C_TDC_INT, FALSE);
+    i2c_dma_enable(hi2c->i2cx, I2C_DMA_REQUEST_TX, FALSE);
+    i2c_queue_read_start(hi2c, trans, I2C_GEN_START_READ);
+  }
+  else if (i2c_flag_get(hi2c->i2cx, I2C_STOPF_FLAG) != RESET)
+  {
+    /* clear stop flag */
+    i2c_flag_clear(hi2c->i2cx, I2C_STOPF_FLAG);
+
+    /* reset ctrl2 register */
+    i2c_reset_ctrl2_register(hi2c);
+
+    /* refresh tx dt register */
+    i2c_refresh_txdt_register(hi2c);
+
+    /* the last byte may still be on its way to memory */
+    if(trans->dir == I2C_TRANS_READ && hi2c->pcount != 0 && hi2c->error_code == I2C_OK)
+    {
+      while(dma_data_number_get(hi2c->dma_rx_channel) != 0);
+    }
+
+    i2c_queue_complete(hi2c);
+  }
+
+  return I2C_OK;
+}
+
+/**
+  * @brief  initialize the transaction queue of a bus. the dma channels and
+  *         dma_init_struct of the handle must be set as for the _dma
+  *         functions, and the i2c event and error interrupts enabled.
+  * @param  hi2c: the handle points to the operation information.
+  * @retval none.
+  */
+void i2c_queue_init(i2c_handle_type* hi2c)
+{
+  hi2c->trans = 0;
+  hi2c->queue_head = 0;
+  hi2c->queue_tail = 0;
+  hi2c->completing = 0;
+  hi2c->status = I2C_END;
+}
+
+/**
+  * @brief  add a transaction to the queue of the bus, it starts at once if
+  *         the bus is idle. can be called from a transaction callback, then
+  *         it is added at the tail and started after the callback returns.
+  * @param  hi2c: the handle points to the operation information.
+  * @param  trans: transaction, must stay valid until its callback. fields
+  *         that are not used must be 0.
+  * @retval i2c status.
+  */
+i2c_status_type i2c_queue_submit(i2c_handle_type* hi2c, i2c_trans_type* trans)
+{
+  uint32_t primask;
+
+  if(trans->pending || (trans->mem_address_width + trans->size + (trans->pec ? 1 : 0)) > MAX_TRANSFER_CNT ||
+     (trans->dir == I2C_TRANS_READ && trans->size == 0))
+  {
+    return I2C_ERR_STEP_1;
+  }
+
+  trans->error_code = I2C_OK;
+  trans->pending = 1;
+  trans->next = 0;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  if(hi2c->trans == 0 && hi2c->status == I2C_END && hi2c->completing == 0)
+  {
+    i2c_queue_start(hi2c, trans);
+  }
+  else if(hi2c->queue_tail == 0)
+  {
+    hi2c->queue_head = trans;
+    hi2c->queue_tail = trans;
+  }
+  else
+  {
+    hi2c->queue_tail->next = trans;
+    hi2c->queue_tail = trans;
+  }
+  __set_PRIMASK(primask);
+
+  return I2C_OK;
+}
+
+/**
+  * @brief  check if the queue of the bus has work.
+  * @param  hi2c: the handle points to the operation information.
+  * @retval SET or RESET.
+  */
+flag_status i2c_queue_busy(i2c_handle_type* hi2c)
+{
+  return (hi2c->trans != 0 || hi2c->queue_head != 0) ? SET : RESET;
+}
+
 /**
   * @brief  dma processing function.
   * @param  hi2c: the handle points to the operation information.
@@ -2247,6 +2563,10 @@ void i2c_evt_irq_handler(i2c_handle_type* hi2c)
     {
       i2c_slave_irq_handler_dma(hi2c);
     }break;
+    case I2C_DMA_MA_QUEUE:
+    {
+      i2c_queue_irq_handler(hi2c);
+    }break;
 
     default:break;
   }
@@ -2259,6 +2579,8 @@ void i2c_evt_irq_handler(i2c_handle_type* hi2c)
   */
 void i2c_err_irq_handler(i2c_handle_type* hi2c)
 { 
+  flag_status pec_error = i2c_flag_get(hi2c->i2cx, I2C_PECERR_FLAG);
+
   /* buserr */
   if (i2c_flag_get(hi2c->i2cx, I2C_BUSERR_FLAG) != RESET)
   {
@@ -2331,6 +2653,22 @@ void i2c_err_irq_handler(i2c_handle_type* hi2c)
     /* disable interrupts */
     i2c_interrupt_enable(hi2c->i2cx, I2C_ERR_INT, FALSE);
   }
+
+  /* a queued transaction is dropped and the queue goes on */
+  if (hi2c->mode == I2C_DMA_MA_QUEUE && hi2c->trans != 0 && hi2c->error_code != I2C_OK)
+  {
+    if (pec_error != RESET)
+    {
+      /* the pec byte is nacked, the transfer still ends with a stop */
+      hi2c->error_code = I2C_ERR_PEC;
+    }
+    else
+    {
+      i2c_reset_ctrl2_register(hi2c);
+      i2c_refresh_txdt_register(hi2c);
+      i2c_queue_complete(hi2c);
+    }
+  }
 }
 
 /**
@@ -78,6 +78,7 @@ typedef enum
   I2C_DMA_MA_RX,
   I2C_DMA_SLA_TX,
   I2C_DMA_SLA_RX,
+  I2C_DMA_MA_QUEUE,
 } i2c_mode_type;
 
 /**
@@ -110,8 +111,46 @@ typedef enum
   I2C_ERR_ACKFAIL,     /*!< ackfail error */
   I2C_ERR_TIMEOUT,     /*!< timeout error */
   I2C_ERR_INTERRUPT,   /*!< interrupt error */
+  I2C_ERR_PEC,         /*!< pec error */
 } i2c_status_type;
 
+/**
+  * @}
+  */
+
+/** @defgroup I2C_library_transaction
+  * @{
+  */
+
+#define I2C_TRANS_WRITE                  0           /*!< write memory address and data */
+#define I2C_TRANS_READ                   1           /*!< write memory address, then read data */
+
+struct i2c_handle_struct;
+struct i2c_trans_struct;
+
+typedef void (*i2c_trans_callback_type)(struct i2c_handle_struct *hi2c, struct i2c_trans_struct *trans);
+
+typedef struct i2c_trans_struct
+{
+  uint16_t                               address;                 /*!< slave address                   */
+  uint8_t                                dir;                     /*!< I2C_TRANS_WRITE or I2C_TRANS_READ */
+  uint8_t                                mem_address_width;       /*!< 0 (none), I2C_MEM_ADDR_WIDIH_8 or _16 */
+  uint16_t                               mem_address;             /*!< memory or register address      */
+  uint8_t                                *pdata;                  /*!< data buffer                     */
+  uint16_t                               size;                    /*!< data size, up to MAX_TRANSFER_CNT in total */
+  uint8_t                                *ptx;                    /*!< read: bytes written before the restart */
+  uint8_t                                tx_size;                 /*!< read: ptx size, 0 if not used   */
+  uint8_t                                pec;                     /*!< 1: hardware pec, a read receives the
+                                                                       pec byte into pdata behind the data */
+  uint8_t                                block;                   /*!< read: first byte is the length, the
+                                                                       buffer holds length, size data, pec */
+  i2c_trans_callback_type                callback;                /*!< completion callback, in interrupt */
+  void                                   *user;                   /*!< user data for the callback      */
+  __IO i2c_status_type                   error_code;              /*!< transaction result              */
+  __IO uint8_t                           pending;                 /*!< queued or running               */
+  struct i2c_trans_struct                *next;                   /*!< queue link                      */
+} i2c_trans_type;
+
 /**
   * @}
   */
@@ -120,7 +159,7 @@ typedef enum
   * @{
   */
 
-typedef struct
+typedef struct i2c_handle_struct
 {
   i2c_type                               *i2cx;                   /*!< i2c registers base address      */
   uint8_t                                *pbuff;                  /*!< pointer to i2c transfer buffer  */
@@ -132,6 +171,10 @@ typedef struct
   dma_channel_type                       *dma_tx_channel;         /*!< dma transmit channel            */
   dma_channel_type                       *dma_rx_channel;         /*!< dma receive channel             */
   dma_init_type                          dma_init_struct;         /*!< dma init parameters             */
+  i2c_trans_type                         *trans;                  /*!< running queued transaction      */
+  i2c_trans_type                         *queue_head;             /*!< first waiting transaction       */
+  i2c_trans_type                         *queue_tail;             /*!< last waiting transaction        */
+  __IO uint8_t                           completing;              /*!< in a transaction callback       */
 } i2c_handle_type;
 
 /**
@@ -175,6 +218,10 @@ i2c_status_type i2c_memory_read           (i2c_handle_type* hi2c, i2c_mem_addres
 i2c_status_type i2c_memory_read_int       (i2c_handle_type* hi2c, i2c_mem_address_width_type mem_address_width, uint16_t address, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout);
 i2c_status_type i2c_memory_read_dma       (i2c_handle_type* hi2c, i2c_mem_address_width_type mem_address_width, uint16_t address, uint16_t mem_address, uint8_t* pdata, uint16_t size, uint32_t timeout);
 
+void            i2c_queue_init            (i2c_handle_type* hi2c);
+i2c_status_type i2c_queue_submit          (i2c_handle_type* hi2c, i2c_trans_type* trans);
+flag_status     i2c_queue_busy            (i2c_handle_type* hi2c);
+
 void            i2c_evt_irq_handler       (i2c_handle_type* hi2c);
 void            i2c_err_irq_handler       (i2c_handle_type* hi2c);
 void            i2c_dma_tx_irq_handler    (i2c_handle_type* hi2c);
@@ -0,0 +1,343 @@
+/**
+  **************************************************************************
+  * @file     i2c_memory.c
+  * @brief    i2c memory device library
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "i2c_memory.h"
+
+/** @addtogroup AT32F402_405_middlewares_i2c_memory_library
+  * @{
+  */
+
+/** @defgroup I2C_memory_library
+  * @brief page aware writes and ack polling for 24cxx eeprom and fram
+  *        devices, running on the i2c transaction queue. the next page is
+  *        prepared in the completion interrupt of the previous one, while
+  *        the device runs its write cycle, and issued at once: a nack on
+  *        its address is the ack poll of the write cycle, so the bus follows
+  *        the device without fixed delays. the dma of a page is armed after
+  *        its address bytes, a page transfer can not overlap the previous
+  *        one as both share the bus and the tx channel.
+  *        a nacked poll is repeated from the queue tail, so other devices
+  *        on the bus go first, or after poll_interval calls of i2c_mem_tick
+  *        to keep the bus free during the write cycle.
+  * @{
+  */
+
+const i2c_mem_device_type i2c_mem_24c02    = {0xA0, I2C_MEM_ADDR_WIDIH_8,  8,   256,   1};
+const i2c_mem_device_type i2c_mem_24c16    = {0xA0, I2C_MEM_ADDR_WIDIH_8,  16,  2048,  1};
+const i2c_mem_device_type i2c_mem_24c256   = {0xA0, I2C_MEM_ADDR_WIDIH_16, 64,  32768, 1};
+const i2c_mem_device_type i2c_mem_24c512   = {0xA0, I2C_MEM_ADDR_WIDIH_16, 128, 65536, 1};
+const i2c_mem_device_type i2c_mem_fm24cl64 = {0xA0, I2C_MEM_ADDR_WIDIH_16, 128, 8192,  0};
+
+static void i2c_mem_trans_callback(i2c_handle_type *hi2c, i2c_trans_type *trans);
+
+/**
+  * @brief  fill the transaction for the next chunk. a write chunk ends on
+  *         a page boundary, any chunk ends where the memory address rolls
+  *         over into the block bits of the device address.
+  * @param  hmem: the handle points to the memory information.
+  * @param  dir: I2C_TRANS_WRITE or I2C_TRANS_READ.
+  * @retval none.
+  */
+static void i2c_mem_trans_prepare(i2c_mem_type *hmem, uint8_t dir)
+{
+  const i2c_mem_device_type *dev = hmem->dev;
+  uint32_t shift = dev->mem_address_width * 8;
+  uint32_t limit = MAX_TRANSFER_CNT - dev->mem_address_width;
+  uint32_t span;
+
+  span = (1U << shift) - (hmem->mem_address & ((1U << shift) - 1));
+  if(span < limit)
+  {
+    limit = span;
+  }
+
+  if(dir == I2C_TRANS_WRITE && dev->page_size != 0)
+  {
+    span = dev->page_size - (hmem->mem_address % dev->page_size);
+    if(span < limit)
+    {
+      limit = span;
+    }
+  }
+
+  hmem->chunk = (hmem->left < limit) ? hmem->left : limit;
+
+  hmem->trans.address = dev->address | (((hmem->mem_address >> shift) << 1) & 0x0E);
+  hmem->trans.dir = dir;
+  hmem->trans.mem_address_width = dev->mem_address_width;
+  hmem->trans.mem_address = (uint16_t)hmem->mem_address;
+  hmem->trans.pdata = hmem->pdata;
+  hmem->trans.size = hmem->chunk;
+  hmem->trans.ptx = 0;
+  hmem->trans.tx_size = 0;
+  hmem->trans.pec = 0;
+  hmem->trans.block = 0;
+  hmem->trans.callback = i2c_mem_trans_callback;
+  hmem->trans.user = hmem;
+  hmem->poll_count = 0;
+}
+
+/**
+  * @brief  fill the transaction for an address only ack poll.
+  * @param  hmem: the handle points to the memory information.
+  * @retval none.
+  */
+static void i2c_mem_poll_prepare(i2c_mem_type *hmem)
+{
+  hmem->trans.dir = I2C_TRANS_WRITE;
+  hmem->trans.mem_address_width = 0;
+  hmem->trans.pdata = 0;
+  hmem->trans.size = 0;
+  hmem->poll_count = 0;
+}
+
+/**
+  * @brief  end the operation.
+  * @param  hmem: the handle points to the memory information.
+  * @param  status: operation result.
+  * @retval none.
+  */
+static void i2c_mem_finish(i2c_mem_type *hmem, i2c_status_type status)
+{
+  hmem->error_code = status;
+  hmem->state = I2C_MEM_STATE_IDLE;
+
+  if(hmem->callback != 0)
+  {
+    hmem->callback(hmem);
+  }
+}
+
+/**
+  * @brief  transaction completion, runs in the i2c interrupt.
+  * @param  hi2c: the handle points to the operation information.
+  * @param  trans: completed transaction.
+  * @retval none.
+  */
+static void i2c_mem_trans_callback(i2c_handle_type *hi2c, i2c_trans_type *trans)
+{
+  i2c_mem_type *hmem = (i2c_mem_type *)trans->user;
+
+  /* a nack on the address means the device is still in its write cycle */
+  if(trans->error_code == I2C_ERR_ACKFAIL && hmem->state != I2C_MEM_STATE_READ &&
+     hmem->dev->write_cycle && hmem->poll_count < I2C_MEM_POLL_MAX)
+  {
+    hmem->poll_count++;
+    hmem->poll_total++;
+    if(hmem->poll_interval != 0)
+    {
+      /* back off, i2c_mem_tick polls again */
+      hmem->poll_wait = hmem->poll_interval;
+    }
+    else
+    {
+      i2c_queue_submit(hi2c, trans);
+    }
+    return;
+  }
+
+  if(trans->error_code != I2C_OK)
+  {
+    i2c_mem_finish(hmem, (trans->error_code == I2C_ERR_ACKFAIL) ? I2C_ERR_TIMEOUT : trans->error_code);
+    return;
+  }
+
+  if(hmem->state == I2C_MEM_STATE_POLL)
+  {
+    i2c_mem_finish(hmem, I2C_OK);
+    return;
+  }
+
+  hmem->pdata += hmem->chunk;
+  hmem->mem_address += hmem->chunk;
+  hmem->left -= hmem->chunk;
+
+  if(hmem->left != 0)
+  {
+    /* next chunk goes out at once, the device acks it when it is ready */
+    i2c_mem_trans_prepare(hmem, trans->dir);
+    i2c_queue_submit(hi2c, trans);
+  }
+  else if(hmem->state == I2C_MEM_STATE_WRITE && hmem->dev->write_cycle)
+  {
+    /* wait for the last page so the data is stored when the callback runs */
+    hmem->state = I2C_MEM_STATE_POLL;
+    i2c_mem_poll_prepare(hmem);
+    i2c_queue_submit(hi2c, trans);
+  }
+  else
+  {
+    i2c_mem_finish(hmem, I2C_OK);
+  }
+}
+
+/**
+  * @brief  start an operation.
+  * @param  hmem: the handle points to the memory information.
+  * @param  state: I2C_MEM_STATE_WRITE or I2C_MEM_STATE_READ.
+  * @param  mem_address: memory address.
+  * @param  pdata: data buffer.
+  * @param  size: data size.
+  * @param  callback: completion callback, can be 0.
+  * @retval i2c status.
+  */
+static i2c_status_type i2c_mem_start(i2c_mem_type *hmem, i2c_mem_state_type state, uint32_t mem_address, uint8_t *pdata, uint32_t size, i2c_mem_callback_type callback)
+{
+  i2c_status_type status;
+
+  if(hmem->state != I2C_MEM_STATE_IDLE)
+  {
+    return I2C_ERR_STEP_1;
+  }
+
+  if(size == 0 || mem_address + size > hmem->dev->capacity)
+  {
+    return I2C_ERR_STEP_2;
+  }
+
+  hmem->pdata = pdata;
+  hmem->mem_address = mem_address;
+  hmem->left = size;
+  hmem->poll_total = 0;
+  hmem->callback = callback;
+  hmem->error_code = I2C_OK;
+  hmem->state = state;
+
+  i2c_mem_trans_prepare(hmem, (state == I2C_MEM_STATE_WRITE) ? I2C_TRANS_WRITE : I2C_TRANS_READ);
+
+  status = i2c_queue_submit(hmem->hi2c, &hmem->trans);
+  if(status != I2C_OK)
+  {
+    hmem->state = I2C_MEM_STATE_IDLE;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  initialize a memory device handle. the bus must be set up with
+  *         its dma channels and i2c_queue_init. set poll_interval after it
+  *         to back off the ack polls with i2c_mem_tick.
+  * @param  hmem: the handle points to the memory information.
+  * @param  hi2c: the handle points to the operation information.
+  * @param  dev: device description, for example &i2c_mem_24c02.
+  * @retval none.
+  */
+void i2c_mem_init(i2c_mem_type *hmem, i2c_handle_type *hi2c, const i2c_mem_device_type *dev)
+{
+  hmem->hi2c = hi2c;
+  hmem->dev = dev;
+  hmem->trans.pending = 0;
+  hmem->poll_interval = 0;
+  hmem->poll_wait = 0;
+  hmem->state = I2C_MEM_STATE_IDLE;
+  hmem->error_code = I2C_OK;
+  hmem->callback = 0;
+}
+
+/**
+  * @brief  start writing a buffer of any size and alignment. the write is
+  *         split at page boundaries, each page is sent by dma and the
+  *         device write cycle is detected by ack polling.
+  * @param  hmem: the handle points to the memory information.
+  * @param  mem_address: memory address.
+  * @param  pdata: data buffer, must stay valid until the end.
+  * @param  size: data size.
+  * @param  callback: completion callback, runs in the i2c interrupt, can be 0.
+  * @retval i2c status.
+  */
+i2c_status_type i2c_mem_write_start(i2c_mem_type *hmem, uint32_t mem_address, uint8_t *pdata, uint32_t size, i2c_mem_callback_type callback)
+{
+  return i2c_mem_start(hmem, I2C_MEM_STATE_WRITE, mem_address, pdata, size, callback);
+}
+
+/**
+  * @brief  start reading a buffer of any size. a read right after a write
+  *         is acked once the write cycle ends.
+  * @param  hmem: the handle points to the memory information.
+  * @param  mem_address: memory address.
+  * @param  pdata: data buffer.
+  * @param  size: data size.
+  * @param  callback: completion callback, runs in the i2c interrupt, can be 0.
+  * @retval i2c status.
+  */
+i2c_status_type i2c_mem_read_start(i2c_mem_type *hmem, uint32_t mem_address, uint8_t *pdata, uint32_t size, i2c_mem_callback_type callback)
+{
+  return i2c_mem_start(hmem, I2C_MEM_STATE_READ, mem_address, pdata, size, callback);
+}
+
+/**
+  * @brief  check if an operation is running.
+  * @param  hmem: the handle points to the memory information.
+  * @retval SET or RESET.
+  */
+flag_status i2c_mem_busy(i2c_mem_type *hmem)
+{
+  return (hmem->state != I2C_MEM_STATE_IDLE) ? SET : RESET;
+}
+
+/**
+  * @brief  ack poll back off, call it from a periodic interrupt, for
+  *         example a 1 ms timer, when poll_interval is set.
+  * @param  hmem: the handle points to the memory information.
+  * @retval none.
+  */
+void i2c_mem_tick(i2c_mem_type *hmem)
+{
+  if(hmem->poll_wait != 0)
+  {
+    hmem->poll_wait--;
+    if(hmem->poll_wait == 0)
+    {
+      i2c_queue_submit(hmem->hi2c, &hmem->trans);
+    }
+  }
+}
+
+/**
+  * @brief  wait for the running operation to end.
+  * @param  hmem: the handle points to the memory information.
+  * @param  timeout: maximum waiting time.
+  * @retval i2c status.
+  */
+i2c_status_type i2c_mem_wait(i2c_mem_type *hmem, uint32_t timeout)
+{
+  while(hmem->state != I2C_MEM_STATE_IDLE)
+  {
+    if((timeout--) == 0)
+    {
+      return I2C_ERR_TIMEOUT;
+    }
+  }
+
+  return hmem->error_code;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,146 @@
+/**
+  **************************************************************************
+  * @file     i2c_memory.h
+  * @brief    i2c memory device library header file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __I2C_MEMORY_H
+#define __I2C_MEMORY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "i2c_application.h"
+
+/** @addtogroup AT32F402_405_middlewares_i2c_memory_library
+  * @{
+  */
+
+/** @defgroup I2C_memory_library_config
+  * @{
+  */
+
+#define I2C_MEM_POLL_MAX                 2000        /*!< ack polls before a write cycle times out */
+
+/**
+  * @}
+  */
+
+/** @defgroup I2C_memory_library_types
+  * @{
+  */
+
+/**
+  * @brief i2c memory device description
+  */
+typedef struct
+{
+  uint16_t                               address;                 /*!< device address, block bits cleared */
+  i2c_mem_address_width_type             mem_address_width;       /*!< memory address width            */
+  uint16_t                               page_size;               /*!< write page size in bytes        */
+  uint32_t                               capacity;                /*!< capacity in bytes, extra address bits
+                                                                       go into the device address        */
+  uint8_t                                write_cycle;             /*!< 1: ack polling after a write (eeprom),
+                                                                       0: no write cycle (fram)          */
+} i2c_mem_device_type;
+
+/**
+  * @brief i2c memory operation state
+  */
+typedef enum
+{
+  I2C_MEM_STATE_IDLE = 0,                /*!< no operation */
+  I2C_MEM_STATE_WRITE,                   /*!< page writes in progress */
+  I2C_MEM_STATE_POLL,                    /*!< waiting for the last write cycle */
+  I2C_MEM_STATE_READ,                    /*!< reads in progress */
+} i2c_mem_state_type;
+
+struct i2c_mem_struct;
+
+typedef void (*i2c_mem_callback_type)(struct i2c_mem_struct *hmem);
+
+/**
+  * @brief i2c memory handle
+  */
+typedef struct i2c_mem_struct
+{
+  i2c_handle_type                        *hi2c;                   /*!< bus, queue initialized          */
+  const i2c_mem_device_type              *dev;                    /*!< device description              */
+  i2c_trans_type                         trans;                   /*!< running transaction             */
+  uint8_t                                *pdata;                  /*!< next data                       */
+  uint32_t                               mem_address;             /*!< next memory address             */
+  uint32_t                               left;                    /*!< bytes left                      */
+  uint16_t                               chunk;                   /*!< bytes of the running transaction */
+  uint16_t                               poll_count;              /*!< ack polls of the running page   */
+  uint32_t                               poll_total;              /*!< ack polls of the operation      */
+  uint16_t                               poll_interval;           /*!< i2c_mem_tick calls between ack polls,
+                                                                       0: poll again from the queue tail */
+  __IO uint16_t                          poll_wait;               /*!< ticks to the next ack poll      */
+  __IO i2c_mem_state_type                state;                   /*!< operation state                 */
+  __IO i2c_status_type                   error_code;              /*!< operation result                */
+  i2c_mem_callback_type                  callback;                /*!< completion callback, in interrupt */
+} i2c_mem_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup I2C_memory_library_devices
+  * @{
+  */
+
+extern const i2c_mem_device_type i2c_mem_24c02;
+extern const i2c_mem_device_type i2c_mem_24c16;
+extern const i2c_mem_device_type i2c_mem_24c256;
+extern const i2c_mem_device_type i2c_mem_24c512;
+extern const i2c_mem_device_type i2c_mem_fm24cl64;
+
+/**
+  * @}
+  */
+
+/** @defgroup I2C_memory_library_exported_functions
+  * @{
+  */
+
+void            i2c_mem_init               (i2c_mem_type *hmem, i2c_handle_type *hi2c, const i2c_mem_device_type *dev);
+i2c_status_type i2c_mem_write_start        (i2c_mem_type *hmem, uint32_t mem_address, uint8_t *pdata, uint32_t size, i2c_mem_callback_type callback);
+i2c_status_type i2c_mem_read_start         (i2c_mem_type *hmem, uint32_t mem_address, uint8_t *pdata, uint32_t size, i2c_mem_callback_type callback);
+flag_status     i2c_mem_busy               (i2c_mem_type *hmem);
+void            i2c_mem_tick               (i2c_mem_type *hmem);
+i2c_status_type i2c_mem_wait               (i2c_mem_type *hmem, uint32_t timeout);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
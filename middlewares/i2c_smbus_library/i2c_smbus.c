@@ -0,0 +1,357 @@
+/**
+  **************************************************************************
+  * @file     i2c_smbus.c
+  * @brief    i2c smbus command library
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "i2c_smbus.h"
+
+/** @addtogroup AT32F402_405_middlewares_i2c_smbus_library
+  * @{
+  */
+
+/** @defgroup I2C_smbus_library
+  * @brief smbus/pmbus protocol commands as queued dma transactions with
+  *        pec calculated and checked by the i2c peripheral. the i2c must be
+  *        configured for smbus host mode and its queue initialized, the
+  *        command callbacks run in the i2c interrupt.
+  * @{
+  */
+
+static void smbus_trans_callback(i2c_handle_type *hi2c, i2c_trans_type *trans);
+
+/**
+  * @brief  initialize a command.
+  * @param  cmd: the command.
+  * @param  protocol: smbus protocol.
+  * @param  address: slave address.
+  * @param  command: command code, the data byte for SMBUS_SEND_BYTE.
+  * @param  pec: 1 to send and check pec.
+  * @retval none.
+  */
+void smbus_cmd_init(smbus_cmd_type *cmd, smbus_protocol_type protocol, uint16_t address, uint8_t command, uint8_t pec)
+{
+  cmd->protocol = protocol;
+  cmd->address = address;
+  cmd->command = command;
+  cmd->pec = pec;
+  cmd->tx[0] = command;
+  cmd->tx_size = (protocol == SMBUS_RECEIVE_BYTE) ? 0 : 1;
+  cmd->callback = 0;
+  cmd->user = 0;
+  cmd->list = 0;
+  cmd->error_code = I2C_OK;
+  cmd->trans.pending = 0;
+}
+
+/**
+  * @brief  set the data written by a command. block protocols get the
+  *         count byte in front of the data.
+  * @param  cmd: the command.
+  * @param  pdata: data.
+  * @param  size: data size, 1 for bytes, 2 for words, up to SMBUS_BLOCK_MAX for blocks.
+  * @retval SUCCESS or ERROR.
+  */
+error_status smbus_cmd_data_set(smbus_cmd_type *cmd, const uint8_t *pdata, uint8_t size)
+{
+  uint8_t *p = &cmd->tx[1];
+  uint8_t i;
+
+  if(cmd->protocol == SMBUS_BLOCK_WRITE || cmd->protocol == SMBUS_BLOCK_PROCESS_CALL)
+  {
+    if(size > SMBUS_BLOCK_MAX)
+    {
+      return ERROR;
+    }
+    *p++ = size;
+  }
+  else if(size > 2)
+  {
+    return ERROR;
+  }
+
+  for(i = 0; i < size; i++)
+  {
+    *p++ = pdata[i];
+  }
+  cmd->tx_size = p - cmd->tx;
+
+  return SUCCESS;
+}
+
+/**
+  * @brief  set the word of SMBUS_WRITE_WORD or SMBUS_PROCESS_CALL.
+  * @param  cmd: the command.
+  * @param  value: word, sent low byte first.
+  * @retval none.
+  */
+void smbus_cmd_word_set(smbus_cmd_type *cmd, uint16_t value)
+{
+  cmd->tx[1] = value & 0xFF;
+  cmd->tx[2] = value >> 8;
+  cmd->tx_size = 3;
+}
+
+/**
+  * @brief  queue a command on the bus.
+  * @param  hi2c: the handle points to the operation information.
+  * @param  cmd: the command, must stay valid until its callback.
+  * @param  callback: completion callback, runs in the i2c interrupt, can be 0.
+  * @retval i2c status.
+  */
+i2c_status_type smbus_cmd_submit(i2c_handle_type *hi2c, smbus_cmd_type *cmd, smbus_cmd_callback_type callback)
+{
+  i2c_trans_type *trans = &cmd->trans;
+
+  trans->address = cmd->address;
+  trans->mem_address_width = 0;
+  trans->mem_address = 0;
+  trans->pec = cmd->pec;
+  trans->block = 0;
+  trans->ptx = 0;
+  trans->tx_size = 0;
+  trans->callback = smbus_trans_callback;
+  trans->user = cmd;
+
+  switch(cmd->protocol)
+  {
+    case SMBUS_SEND_BYTE:
+    case SMBUS_WRITE_BYTE:
+    case SMBUS_WRITE_WORD:
+    case SMBUS_BLOCK_WRITE:
+      trans->dir = I2C_TRANS_WRITE;
+      trans->pdata = cmd->tx;
+      trans->size = cmd->tx_size;
+      break;
+    case SMBUS_RECEIVE_BYTE:
+    case SMBUS_READ_BYTE:
+    case SMBUS_READ_WORD:
+    case SMBUS_PROCESS_CALL:
+      trans->dir = I2C_TRANS_READ;
+      trans->ptx = cmd->tx;
+      trans->tx_size = cmd->tx_size;
+      trans->pdata = cmd->rx;
+      trans->size = (cmd->protocol == SMBUS_READ_WORD || cmd->protocol == SMBUS_PROCESS_CALL) ? 2 : 1;
+      break;
+    case SMBUS_BLOCK_READ:
+    case SMBUS_BLOCK_PROCESS_CALL:
+      trans->dir = I2C_TRANS_READ;
+      trans->ptx = cmd->tx;
+      trans->tx_size = cmd->tx_size;
+      trans->pdata = cmd->rx;
+      trans->size = SMBUS_BLOCK_MAX;
+      trans->block = 1;
+      break;
+    default:
+      return I2C_ERR_STEP_1;
+  }
+
+  cmd->callback = callback;
+  cmd->error_code = I2C_OK;
+
+  return i2c_queue_submit(hi2c, trans);
+}
+
+/**
+  * @brief  byte read by SMBUS_READ_BYTE or SMBUS_RECEIVE_BYTE.
+  * @param  cmd: the command.
+  * @retval byte.
+  */
+uint8_t smbus_cmd_byte_get(smbus_cmd_type *cmd)
+{
+  return cmd->rx[0];
+}
+
+/**
+  * @brief  word read by SMBUS_READ_WORD or SMBUS_PROCESS_CALL.
+  * @param  cmd: the command.
+  * @retval word.
+  */
+uint16_t smbus_cmd_word_get(smbus_cmd_type *cmd)
+{
+  return cmd->rx[0] | ((uint16_t)cmd->rx[1] << 8);
+}
+
+/**
+  * @brief  block read by SMBUS_BLOCK_READ or SMBUS_BLOCK_PROCESS_CALL.
+  * @param  cmd: the command.
+  * @param  pdata: set to the block data.
+  * @retval block length, limited to SMBUS_BLOCK_MAX.
+  */
+uint8_t smbus_cmd_block_get(smbus_cmd_type *cmd, uint8_t **pdata)
+{
+  *pdata = &cmd->rx[1];
+
+  return (cmd->rx[0] < SMBUS_BLOCK_MAX) ? cmd->rx[0] : SMBUS_BLOCK_MAX;
+}
+
+/**
+  * @brief  transaction completion, runs in the i2c interrupt.
+  * @param  hi2c: the handle points to the operation information.
+  * @param  trans: completed transaction.
+  * @retval none.
+  */
+static void smbus_trans_callback(i2c_handle_type *hi2c, i2c_trans_type *trans)
+{
+  smbus_cmd_type *cmd = (smbus_cmd_type *)trans->user;
+  smbus_poll_type *list = cmd->list;
+
+  cmd->error_code = trans->error_code;
+
+  /* a longer block than the buffer is cut, the pec check fails then */
+  if(trans->block && cmd->error_code == I2C_OK && cmd->rx[0] > SMBUS_BLOCK_MAX)
+  {
+    cmd->error_code = I2C_ERR_STEP_2;
+  }
+
+  if(cmd->callback != 0)
+  {
+    cmd->callback(cmd);
+  }
+
+  if(list != 0)
+  {
+    if(cmd->error_code != I2C_OK)
+    {
+      list->errors++;
+    }
+
+    if(--list->pending == 0)
+    {
+      list->cycles++;
+      if(list->callback != 0)
+      {
+        list->callback(list);
+      }
+    }
+  }
+}
+
+/**
+  * @brief  initialize a polling list. the commands must be initialized
+  *         with smbus_cmd_init, their callback is taken from cmd->callback.
+  * @param  list: the polling list.
+  * @param  hi2c: the handle points to the operation information.
+  * @param  cmd: command array.
+  * @param  count: number of commands.
+  * @param  period: cycle period in smbus_poll_tick calls, 0 for smbus_poll_trigger only.
+  * @param  callback: end of cycle callback, runs in the i2c interrupt, can be 0.
+  * @retval none.
+  */
+void smbus_poll_init(smbus_poll_type *list, i2c_handle_type *hi2c, smbus_cmd_type *cmd, uint16_t count, uint16_t period, smbus_poll_callback_type callback)
+{
+  uint16_t i;
+
+  list->hi2c = hi2c;
+  list->cmd = cmd;
+  list->count = count;
+  list->period = period;
+  list->tick = 0;
+  list->pending = 0;
+  list->cycles = 0;
+  list->errors = 0;
+  list->overruns = 0;
+  list->callback = callback;
+
+  for(i = 0; i < count; i++)
+  {
+    cmd[i].list = list;
+  }
+}
+
+/**
+  * @brief  queue all commands of the list at once. the bus runs them back
+  *         to back from its interrupt.
+  * @param  list: the polling list.
+  * @retval i2c status, I2C_ERR_STEP_1 if the previous cycle is still running.
+  */
+i2c_status_type smbus_poll_trigger(smbus_poll_type *list)
+{
+  i2c_status_type status = I2C_OK;
+  uint32_t primask;
+  uint16_t i;
+
+  if(list->pending != 0)
+  {
+    list->overruns++;
+    return I2C_ERR_STEP_1;
+  }
+
+  /* one extra count so the cycle cannot end while it is queued */
+  list->pending = list->count + 1;
+
+  for(i = 0; i < list->count; i++)
+  {
+    if(smbus_cmd_submit(list->hi2c, &list->cmd[i], list->cmd[i].callback) != I2C_OK)
+    {
+      /* the interrupt updates the same counters for the queued commands */
+      primask = __get_PRIMASK();
+      __disable_irq();
+      list->errors++;
+      list->pending--;
+      __set_PRIMASK(primask);
+      status = I2C_ERR_STEP_2;
+    }
+  }
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  i = --list->pending;
+  if(i == 0)
+  {
+    list->cycles++;
+  }
+  __set_PRIMASK(primask);
+
+  if(i == 0 && list->callback != 0)
+  {
+    list->callback(list);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  advance the list schedule, call it from a periodic timer.
+  * @param  list: the polling list.
+  * @retval none.
+  */
+void smbus_poll_tick(smbus_poll_type *list)
+{
+  if(list->period == 0)
+  {
+    return;
+  }
+
+  if(++list->tick >= list->period)
+  {
+    list->tick = 0;
+    smbus_poll_trigger(list);
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,145 @@
+/**
+  **************************************************************************
+  * @file     i2c_smbus.h
+  * @brief    i2c smbus command library header file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __I2C_SMBUS_H
+#define __I2C_SMBUS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "i2c_application.h"
+
+/** @addtogroup AT32F402_405_middlewares_i2c_smbus_library
+  * @{
+  */
+
+/** @defgroup I2C_smbus_library_config
+  * @{
+  */
+
+#define SMBUS_BLOCK_MAX                  32          /*!< block size limit of smbus 2.0 */
+
+/**
+  * @}
+  */
+
+/** @defgroup I2C_smbus_library_types
+  * @{
+  */
+
+/**
+  * @brief smbus protocol
+  */
+typedef enum
+{
+  SMBUS_SEND_BYTE = 0,                   /*!< command byte only */
+  SMBUS_RECEIVE_BYTE,                    /*!< one byte, no command */
+  SMBUS_WRITE_BYTE,                      /*!< command, byte */
+  SMBUS_READ_BYTE,                       /*!< command, restart, byte */
+  SMBUS_WRITE_WORD,                      /*!< command, word */
+  SMBUS_READ_WORD,                       /*!< command, restart, word */
+  SMBUS_BLOCK_WRITE,                     /*!< command, count, data */
+  SMBUS_BLOCK_READ,                      /*!< command, restart, count, data */
+  SMBUS_PROCESS_CALL,                    /*!< command, word, restart, word */
+  SMBUS_BLOCK_PROCESS_CALL,              /*!< command, count, data, restart, count, data */
+} smbus_protocol_type;
+
+struct smbus_cmd_struct;
+struct smbus_poll_struct;
+
+typedef void (*smbus_cmd_callback_type)(struct smbus_cmd_struct *cmd);
+typedef void (*smbus_poll_callback_type)(struct smbus_poll_struct *list);
+
+/**
+  * @brief smbus command, one protocol transaction on the i2c queue
+  */
+typedef struct smbus_cmd_struct
+{
+  i2c_trans_type                         trans;                   /*!< queued transaction              */
+  smbus_protocol_type                    protocol;                /*!< protocol                        */
+  uint16_t                               address;                 /*!< slave address                   */
+  uint8_t                                command;                 /*!< command code                    */
+  uint8_t                                pec;                     /*!< 1: pec checked by hardware      */
+  uint8_t                                tx_size;                 /*!< bytes in tx                     */
+  uint8_t                                tx[SMBUS_BLOCK_MAX + 2]; /*!< command, count, data           */
+  uint8_t                                rx[SMBUS_BLOCK_MAX + 2]; /*!< count, data, pec                */
+  smbus_cmd_callback_type                callback;                /*!< completion callback, in interrupt */
+  void                                   *user;                   /*!< user data for the callback      */
+  struct smbus_poll_struct               *list;                   /*!< polling list of the command     */
+  __IO i2c_status_type                   error_code;              /*!< result of the last run          */
+} smbus_cmd_type;
+
+/**
+  * @brief smbus polling list, all commands run back to back every period
+  */
+typedef struct smbus_poll_struct
+{
+  i2c_handle_type                        *hi2c;                   /*!< bus, queue initialized          */
+  smbus_cmd_type                         *cmd;                    /*!< command array                   */
+  uint16_t                               count;                   /*!< number of commands              */
+  uint16_t                               period;                  /*!< period in ticks, 0: triggered only */
+  uint16_t                               tick;                    /*!< ticks since the last cycle      */
+  __IO uint16_t                          pending;                 /*!< commands of the running cycle   */
+  __IO uint32_t                          cycles;                  /*!< completed cycles                */
+  __IO uint32_t                          errors;                  /*!< failed commands                 */
+  __IO uint32_t                          overruns;                /*!< periods missed, cycle still running */
+  smbus_poll_callback_type               callback;                /*!< end of cycle callback, in interrupt */
+} smbus_poll_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup I2C_smbus_library_exported_functions
+  * @{
+  */
+
+void            smbus_cmd_init             (smbus_cmd_type *cmd, smbus_protocol_type protocol, uint16_t address, uint8_t command, uint8_t pec);
+error_status    smbus_cmd_data_set         (smbus_cmd_type *cmd, const uint8_t *pdata, uint8_t size);
+void            smbus_cmd_word_set         (smbus_cmd_type *cmd, uint16_t value);
+i2c_status_type smbus_cmd_submit           (i2c_handle_type *hi2c, smbus_cmd_type *cmd, smbus_cmd_callback_type callback);
+uint8_t         smbus_cmd_byte_get         (smbus_cmd_type *cmd);
+uint16_t        smbus_cmd_word_get         (smbus_cmd_type *cmd);
+uint8_t         smbus_cmd_block_get        (smbus_cmd_type *cmd, uint8_t **pdata);
+
+void            smbus_poll_init            (smbus_poll_type *list, i2c_handle_type *hi2c, smbus_cmd_type *cmd, uint16_t count, uint16_t period, smbus_poll_callback_type callback);
+i2c_status_type smbus_poll_trigger         (smbus_poll_type *list);
+void            smbus_poll_tick            (smbus_poll_type *list);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
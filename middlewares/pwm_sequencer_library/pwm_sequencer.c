@@ -0,0 +1,263 @@
+/**
+  **************************************************************************
+  * @file     pwm_sequencer.c
+  * @brief    pwm sequencer library source file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "pwm_sequencer.h"
+
+/** @addtogroup AT32F402_405_middlewares_pwm_sequencer_library
+  * @{
+  */
+
+/** @defgroup PWM_sequencer_library
+  * @brief per period compare values from a ring of frames. each overflow
+  *        request makes the dma burst one frame into the compare registers
+  *        through the timer dma data register, the compare buffers apply
+  *        it at the next overflow. the two tables of the ring are swapped
+  *        from the half and full transfer interrupts, so the cpu takes two
+  *        interrupts per ring instead of one per period.
+  * @{
+  */
+
+/**
+  * @brief  a table has been played, the other one starts now.
+  * @param  seq: the handle points to the sequencer information.
+  * @param  table: table just played.
+  * @retval none.
+  */
+static void pwm_seq_table_done(pwm_seq_type *seq, uint8_t table)
+{
+  uint8_t next = table ^ 1;
+
+  seq->table_count ++;
+  if(seq->ready[next] == 0)
+  {
+    /* the dma replays stale values */
+    seq->underruns ++;
+  }
+  seq->ready[next] = 0;
+  seq->free_table = table;
+
+  if(seq->callback != 0)
+  {
+    seq->callback(seq, seq->ring + (uint32_t)table * seq->frame_num * seq->channel_num);
+    seq->ready[table] = 1;
+    seq->free_table = 0xFF;
+  }
+}
+
+/**
+  * @brief  burst channel event.
+  * @param  hdma: burst channel handle.
+  * @param  event: dma application events.
+  * @retval none.
+  */
+static void pwm_seq_dma_event(dma_app_handle_type *hdma, uint32_t event)
+{
+  pwm_seq_type *seq = (pwm_seq_type *)hdma->user;
+
+  if(event & DMA_APP_EVENT_ERROR)
+  {
+    seq->error_count ++;
+    return;
+  }
+  if(event & DMA_APP_EVENT_HALF)
+  {
+    pwm_seq_table_done(seq, 0);
+  }
+  if(event & DMA_APP_EVENT_FULL)
+  {
+    pwm_seq_table_done(seq, 1);
+  }
+}
+
+/**
+  * @brief  set up the dma burst of the timer. the timer base, the pwm modes
+  *         and the outputs are configured before, dma_app_init is called
+  *         before.
+  * @param  seq: the handle points to the sequencer information.
+  * @retval ERROR if a parameter is invalid or no dma channel is free.
+  */
+error_status pwm_seq_init(pwm_seq_type *seq)
+{
+  dmamux_requst_id_sel_type req;
+  dma_init_type dma_init_struct;
+  uint8_t index;
+
+  if(seq->tmr_x == TMR1)
+  {
+    req = DMAMUX_DMAREQ_ID_TMR1_OVERFLOW;
+  }
+  else if(seq->tmr_x == TMR2)
+  {
+    req = DMAMUX_DMAREQ_ID_TMR2_OVERFLOW;
+  }
+  else if(seq->tmr_x == TMR3)
+  {
+    req = DMAMUX_DMAREQ_ID_TMR3_OVERFLOW;
+  }
+  else if(seq->tmr_x == TMR4)
+  {
+    req = DMAMUX_DMAREQ_ID_TMR4_OVERFLOW;
+  }
+  else
+  {
+    return ERROR;
+  }
+
+  if(seq->channel_num == 0 || seq->channel_num > PWM_SEQ_CHANNEL_MAX || seq->frame_num == 0 ||
+     (uint32_t)seq->frame_num * seq->channel_num * 2 > 0xFFFF)
+  {
+    return ERROR;
+  }
+
+  dma_default_para_init(&dma_init_struct);
+  dma_init_struct.direction = DMA_DIR_MEMORY_TO_PERIPHERAL;
+  dma_init_struct.memory_inc_enable = TRUE;
+  dma_init_struct.peripheral_inc_enable = FALSE;
+  dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_HALFWORD;
+  dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_HALFWORD;
+  dma_init_struct.priority = DMA_PRIORITY_VERY_HIGH;
+  if(seq->hdma == 0)
+  {
+    seq->hdma = dma_app_channel_alloc(req, &dma_init_struct, pwm_seq_dma_event, seq->priority);
+    if(seq->hdma == 0)
+    {
+      return ERROR;
+    }
+  }
+  seq->hdma->user = seq;
+
+  /* a frame takes effect at the overflow after its burst */
+  for(index = 0; index < seq->channel_num; index ++)
+  {
+    tmr_output_channel_buffer_enable(seq->tmr_x, (tmr_channel_select_type)(TMR_SELECT_CHANNEL_1 + index * 2), TRUE);
+  }
+  tmr_dma_control_config(seq->tmr_x, (tmr_dma_transfer_length_type)(TMR_DMA_TRANSFER_1BYTE + seq->channel_num - 1), TMR_C1DT_ADDRESS);
+  tmr_dma_request_enable(seq->tmr_x, TMR_OVERFLOW_DMA_REQUEST, TRUE);
+
+  seq->ready[0] = 0;
+  seq->ready[1] = 0;
+  seq->free_table = 0xFF;
+  seq->table_count = 0;
+  seq->get_count = 0;
+  seq->underruns = 0;
+  seq->error_count = 0;
+
+  return SUCCESS;
+}
+
+/**
+  * @brief  start the sequence with both tables of the ring. the first
+  *         period runs the compare values set before the start, frame 0
+  *         plays from the first overflow on, one period later.
+  * @param  seq: the handle points to the sequencer information.
+  * @retval none.
+  */
+void pwm_seq_start(pwm_seq_type *seq)
+{
+  seq->ready[0] = 1;
+  seq->ready[1] = 1;
+  seq->free_table = 0xFF;
+
+  dma_app_start_stream(seq->hdma, (uint32_t)&seq->tmr_x->dmadt, (uint32_t)seq->ring,
+                       (uint16_t)(seq->frame_num * seq->channel_num * 2));
+
+  /* the software overflow loads the current buffers and bursts frame 0 into
+     them, frame 0 applies at the first overflow of the counter */
+  tmr_event_sw_trigger(seq->tmr_x, TMR_OVERFLOW_SWTRIG);
+  tmr_counter_enable(seq->tmr_x, TRUE);
+}
+
+/**
+  * @brief  stop the counter and the burst channel, the outputs keep the
+  *         last compare values.
+  * @param  seq: the handle points to the sequencer information.
+  * @retval none.
+  */
+void pwm_seq_stop(pwm_seq_type *seq)
+{
+  tmr_counter_enable(seq->tmr_x, FALSE);
+  dma_app_stop(seq->hdma);
+  seq->free_table = 0xFF;
+}
+
+/**
+  * @brief  get the table open for filling, when no callback is used. it
+  *         must be committed within one table period.
+  * @param  seq: the handle points to the sequencer information.
+  * @retval table of frame_num frames, 0 if both tables are pending.
+  */
+uint16_t* pwm_seq_table_get(pwm_seq_type *seq)
+{
+  uint32_t primask;
+  uint8_t table;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  table = seq->free_table;
+  seq->get_count = seq->table_count;
+  __set_PRIMASK(primask);
+
+  if(table > 1)
+  {
+    return 0;
+  }
+  return seq->ring + (uint32_t)table * seq->frame_num * seq->channel_num;
+}
+
+/**
+  * @brief  commit the table returned by pwm_seq_table_get. the table is
+  *         stale when a table swap came after the get, the dma has played
+  *         or is playing it then.
+  * @param  seq: the handle points to the sequencer information.
+  * @param  table: table returned by pwm_seq_table_get.
+  * @retval ERROR if the table is stale or not open for filling.
+  */
+error_status pwm_seq_table_commit(pwm_seq_type *seq, uint16_t *table)
+{
+  error_status status = ERROR;
+  uint32_t primask;
+  uint8_t index;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  index = seq->free_table;
+  if(index <= 1 && seq->table_count == seq->get_count &&
+     table == seq->ring + (uint32_t)index * seq->frame_num * seq->channel_num)
+  {
+    seq->ready[index] = 1;
+    seq->free_table = 0xFF;
+    status = SUCCESS;
+  }
+  __set_PRIMASK(primask);
+
+  return status;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,115 @@
+/**
+  **************************************************************************
+  * @file     pwm_sequencer.h
+  * @brief    pwm sequencer library header file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PWM_SEQUENCER_H
+#define __PWM_SEQUENCER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "dma_application.h"
+
+/** @addtogroup AT32F402_405_middlewares_pwm_sequencer_library
+  * @{
+  */
+
+/** @defgroup PWM_sequencer_library_config
+  * @{
+  */
+
+#define PWM_SEQ_CHANNEL_MAX              4           /*!< compare channels updated by a burst */
+
+/**
+  * @}
+  */
+
+/** @defgroup PWM_sequencer_library_types
+  * @{
+  */
+
+struct pwm_seq_struct;
+
+/**
+  * @brief table callback, table is free and must be filled before the
+  *        callback returns
+  */
+typedef void (*pwm_seq_callback_type)(struct pwm_seq_struct *seq, uint16_t *table);
+
+/**
+  * @brief pwm sequencer handle, the fields up to user are filled in before
+  *        pwm_seq_init. a frame holds the compare values of channel 1 to
+  *        channel_num for one period, a table holds frame_num frames and
+  *        the ring holds two tables.
+  */
+typedef struct pwm_seq_struct
+{
+  tmr_type                               *tmr_x;                  /*!< TMR1, TMR2, TMR3 or TMR4, base and outputs
+                                                                       configured by the user             */
+  uint8_t                                channel_num;             /*!< channels from channel 1, 1 to 4 */
+  uint16_t                               frame_num;               /*!< frames per table                */
+  uint16_t                               *ring;                   /*!< 2 * frame_num * channel_num compare values */
+  pwm_seq_callback_type                  callback;                /*!< fill a free table, in interrupt, 0 to
+                                                                       use pwm_seq_table_get and commit  */
+  uint8_t                                priority;                /*!< dma interrupt preemption priority */
+  void                                   *user;                   /*!< user data for the callback      */
+
+  dma_app_handle_type                    *hdma;                   /*!< burst channel                   */
+  __IO uint8_t                           ready[2];                /*!< table filled and not played yet */
+  __IO uint8_t                           free_table;              /*!< table open for filling, 0xFF if none */
+  uint32_t                               table_count;             /*!< tables played                   */
+  uint32_t                               get_count;               /*!< table_count at the last table get */
+  uint32_t                               underruns;               /*!< tables replayed without refill  */
+  uint32_t                               error_count;             /*!< dma transfer errors             */
+} pwm_seq_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup PWM_sequencer_library_exported_functions
+  * @{
+  */
+
+error_status pwm_seq_init                (pwm_seq_type *seq);
+void         pwm_seq_start               (pwm_seq_type *seq);
+void         pwm_seq_stop                (pwm_seq_type *seq);
+uint16_t*    pwm_seq_table_get           (pwm_seq_type *seq);
+error_status pwm_seq_table_commit        (pwm_seq_type *seq, uint16_t *table);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
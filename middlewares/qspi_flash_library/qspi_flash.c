@@ -0,0 +1,736 @@
+/**
+  **************************************************************************
+  * @file     qspi_flash.c
+  * @brief    qspi nor flash libray source
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "qspi_flash.h"
+
+/** @addtogroup AT32F402_405_middlewares_qspi_flash_library
+  * @{
+  */
+
+/** @defgroup QSPI_flash_library
+  * @brief qspi nor flash driver on the command port.
+  *        the gpio, qspi clock and sck mode are configured by the
+  *        application before qspi_flash_init. for qspi_flash_write_start
+  *        enable the qspi interrupt in nvic and call qspi_flash_irq_handler
+  *        from QSPI1_IRQHandler.
+  * @{
+  */
+
+#define QSPI_FLASH_CMD_WREN              0x06
+#define QSPI_FLASH_CMD_RDSR1             0x05
+#define QSPI_FLASH_CMD_RDSR2             0x35
+#define QSPI_FLASH_CMD_WRSR1             0x01
+#define QSPI_FLASH_CMD_WRSR2             0x31
+#define QSPI_FLASH_CMD_RDID              0x9F
+#define QSPI_FLASH_CMD_RDSFDP            0x5A
+
+#define QSPI_FLASH_SFDP_SIGNATURE        0x50444653
+
+/**
+  * @brief known devices, used before sfdp. quad program instructions are
+  *        not described by sfdp, so listed parts get the faster program.
+  */
+static const qspi_flash_device_type qspi_flash_device_table[] =
+{
+  /* en25qh128a */
+  {0x1C7018, 0x1000000, 0x1000, 256, 0x20, 0xEB, 6, QSPI_OPERATE_MODE_144, 0x32, QSPI_OPERATE_MODE_114, QSPI_FLASH_QE_NONE},
+  /* w25q128jv */
+  {0xEF4018, 0x1000000, 0x1000, 256, 0x20, 0xEB, 6, QSPI_OPERATE_MODE_144, 0x32, QSPI_OPERATE_MODE_114, QSPI_FLASH_QE_SR2_BIT1},
+  /* gd25q128 */
+  {0xC84018, 0x1000000, 0x1000, 256, 0x20, 0xEB, 6, QSPI_OPERATE_MODE_144, 0x32, QSPI_OPERATE_MODE_114, QSPI_FLASH_QE_SR2_BIT1},
+  /* mx25l12835f */
+  {0xC22018, 0x1000000, 0x1000, 256, 0x20, 0xEB, 6, QSPI_OPERATE_MODE_144, 0x38, QSPI_OPERATE_MODE_144, QSPI_FLASH_QE_SR1_BIT6},
+};
+
+/**
+  * @brief  fill a command with default values.
+  * @param  cmd: command to fill
+  * @param  code: instruction code
+  * @retval none
+  */
+static void qspi_flash_cmd_init(qspi_cmd_type *cmd, uint8_t code)
+{
+  cmd->pe_mode_enable = FALSE;
+  cmd->pe_mode_operate_code = 0;
+  cmd->instruction_code = code;
+  cmd->instruction_length = QSPI_CMD_INSLEN_1_BYTE;
+  cmd->address_code = 0;
+  cmd->address_length = QSPI_CMD_ADRLEN_0_BYTE;
+  cmd->data_counter = 0;
+  cmd->second_dummy_cycle_num = 0;
+  cmd->operation_mode = QSPI_OPERATE_MODE_111;
+  cmd->read_status_config = QSPI_RSTSC_HW_AUTO;
+  cmd->read_status_enable = FALSE;
+  cmd->write_data_enable = TRUE;
+}
+
+/**
+  * @brief  kick a command and wait until it completes.
+  * @param  hflash: qspi flash handle
+  * @param  cmd: command
+  * @retval none
+  */
+static void qspi_flash_cmd_send(qspi_flash_handle_type *hflash, qspi_cmd_type *cmd)
+{
+  qspi_cmd_operation_kick(hflash->qspi_x, cmd);
+  while(qspi_flag_get(hflash->qspi_x, QSPI_CMDSTS_FLAG) == RESET);
+  qspi_flag_clear(hflash->qspi_x, QSPI_CMDSTS_FLAG);
+}
+
+/**
+  * @brief  kick a simple command, the write enable or the status polling.
+  *         the status polling is done by the controller, it reads the
+  *         status register until the busy bit clears.
+  * @param  hflash: qspi flash handle
+  * @param  code: QSPI_FLASH_CMD_WREN or QSPI_FLASH_CMD_RDSR1
+  * @retval none
+  */
+static void qspi_flash_simple_kick(qspi_flash_handle_type *hflash, uint8_t code)
+{
+  qspi_cmd_type cmd;
+  qspi_flash_cmd_init(&cmd, code);
+  if(code == QSPI_FLASH_CMD_RDSR1)
+  {
+    cmd.read_status_enable = TRUE;
+    cmd.write_data_enable = FALSE;
+  }
+  qspi_cmd_operation_kick(hflash->qspi_x, &cmd);
+}
+
+/**
+  * @brief  send a simple command and wait.
+  * @param  hflash: qspi flash handle
+  * @param  code: QSPI_FLASH_CMD_WREN or QSPI_FLASH_CMD_RDSR1
+  * @retval none
+  */
+static void qspi_flash_simple_send(qspi_flash_handle_type *hflash, uint8_t code)
+{
+  qspi_flash_simple_kick(hflash, code);
+  while(qspi_flag_get(hflash->qspi_x, QSPI_CMDSTS_FLAG) == RESET);
+  qspi_flag_clear(hflash->qspi_x, QSPI_CMDSTS_FLAG);
+}
+
+/**
+  * @brief  read a few bytes through the fifo, for id, sfdp and status.
+  * @param  hflash: qspi flash handle
+  * @param  cmd: read command, data_counter is the length
+  * @param  pdata: data buffer
+  * @retval none
+  */
+static void qspi_flash_fifo_read(qspi_flash_handle_type *hflash, qspi_cmd_type *cmd, uint8_t *pdata)
+{
+  uint32_t i_index;
+  cmd->write_data_enable = FALSE;
+  qspi_flash_cmd_send(hflash, cmd);
+  for(i_index = 0; i_index < cmd->data_counter; i_index ++)
+  {
+    pdata[i_index] = qspi_byte_read(hflash->qspi_x);
+  }
+}
+
+/**
+  * @brief  configure the dma channel for a data phase and enable it.
+  * @param  hflash: qspi flash handle
+  * @param  dir: DMA_DIR_PERIPHERAL_TO_MEMORY or DMA_DIR_MEMORY_TO_PERIPHERAL
+  * @param  pdata: data buffer
+  * @param  size: data length in byte
+  * @retval none
+  */
+static void qspi_flash_dma_set(qspi_flash_handle_type *hflash, dma_dir_type dir, const uint8_t *pdata, uint32_t size)
+{
+  dma_init_type dma_init_struct;
+
+  dma_reset(hflash->dma_channel);
+  dma_default_para_init(&dma_init_struct);
+  dma_init_struct.direction = dir;
+  dma_init_struct.memory_base_addr = (uint32_t)pdata;
+  dma_init_struct.memory_inc_enable = TRUE;
+  dma_init_struct.peripheral_base_addr = (uint32_t)(&(hflash->qspi_x->dt));
+  dma_init_struct.peripheral_inc_enable = FALSE;
+  dma_init_struct.priority = DMA_PRIORITY_HIGH;
+  /* word unit when possible */
+  if(((size | (uint32_t)pdata) & 0x3) == 0)
+  {
+    dma_init_struct.buffer_size = size / 4;
+    dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_WORD;
+    dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_WORD;
+  }
+  else
+  {
+    dma_init_struct.buffer_size = size;
+    dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_BYTE;
+    dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_BYTE;
+  }
+  dma_init(hflash->dma_channel, &dma_init_struct);
+
+  dmamux_init(hflash->dmamux_channel, hflash->dma_request);
+  dmamux_enable(hflash->dma_x, TRUE);
+
+  if(dir == DMA_DIR_PERIPHERAL_TO_MEMORY)
+  {
+    qspi_dma_rx_threshold_set(hflash->qspi_x, QSPI_DMA_FIFO_THOD_WORD08);
+  }
+  else
+  {
+    qspi_dma_tx_threshold_set(hflash->qspi_x, QSPI_DMA_FIFO_THOD_WORD08);
+  }
+  qspi_dma_enable(hflash->qspi_x, TRUE);
+  dma_channel_enable(hflash->dma_channel, TRUE);
+}
+
+/**
+  * @brief  read the basic flash parameter table and fill the device.
+  * @param  hflash: qspi flash handle
+  * @retval QSPI_FLASH_OK or QSPI_FLASH_ERR_ID
+  */
+static qspi_flash_status_type qspi_flash_sfdp_parse(qspi_flash_handle_type *hflash)
+{
+  qspi_flash_device_type *dev = &hflash->device;
+  uint32_t dword[QSPI_FLASH_SFDP_DWORDS];
+  uint32_t header[4], len, value, erase_type;
+  qspi_cmd_type cmd;
+
+  qspi_flash_cmd_init(&cmd, QSPI_FLASH_CMD_RDSFDP);
+  cmd.address_length = QSPI_CMD_ADRLEN_3_BYTE;
+  cmd.second_dummy_cycle_num = 8;
+  cmd.data_counter = sizeof(header);
+  qspi_flash_fifo_read(hflash, &cmd, (uint8_t *)header);
+  if(header[0] != QSPI_FLASH_SFDP_SIGNATURE)
+  {
+    return QSPI_FLASH_ERR_ID;
+  }
+
+  /* first parameter header: length in dword and table pointer */
+  len = header[2] >> 24;
+  if(len > QSPI_FLASH_SFDP_DWORDS)
+  {
+    len = QSPI_FLASH_SFDP_DWORDS;
+  }
+  if(len < 9)
+  {
+    return QSPI_FLASH_ERR_ID;
+  }
+  qspi_flash_cmd_init(&cmd, QSPI_FLASH_CMD_RDSFDP);
+  cmd.address_length = QSPI_CMD_ADRLEN_3_BYTE;
+  cmd.address_code = header[3] & 0xFFFFFF;
+  cmd.second_dummy_cycle_num = 8;
+  cmd.data_counter = len * 4;
+  qspi_flash_fifo_read(hflash, &cmd, (uint8_t *)dword);
+
+  /* density in bit */
+  if(dword[1] & 0x80000000)
+  {
+    value = dword[1] & 0x7FFFFFFF;
+    dev->size = (value >= 35) ? 0 : (1UL << (value - 3));
+  }
+  else
+  {
+    dev->size = (dword[1] + 1) / 8;
+  }
+  if(dev->size == 0 || dev->size > 0x1000000)
+  {
+    /* 4-byte address parts are not handled by this driver */
+    return QSPI_FLASH_ERR_ID;
+  }
+
+  /* 4k erase when bits 1:0 say it is supported, else the smallest of the
+     erase types in dwords 8 and 9, for example the 64k block erase */
+  dev->sector_size = 0;
+  if((dword[0] & 0x3) == 0x1)
+  {
+    dev->sector_size = 0x1000;
+    dev->erase_code = (dword[0] >> 8) & 0xFF;
+  }
+  else
+  {
+    for(value = 0; value < 4; value ++)
+    {
+      /* size exponent in bits 7:0, instruction in bits 15:8 */
+      erase_type = (dword[7 + value / 2] >> ((value & 1) * 16)) & 0xFFFF;
+      if((erase_type & 0xFF) != 0 && (erase_type & 0xFF) < 32 &&
+         (dev->sector_size == 0 || (1UL << (erase_type & 0xFF)) < dev->sector_size))
+      {
+        dev->sector_size = 1UL << (erase_type & 0xFF);
+        dev->erase_code = erase_type >> 8;
+      }
+    }
+  }
+  if(dev->sector_size == 0)
+  {
+    return QSPI_FLASH_ERR_ID;
+  }
+  dev->page_size = 256;
+  if(len >= 11)
+  {
+    dev->page_size = 1 << ((dword[10] >> 4) & 0xF);
+  }
+
+  /* 1-4-4 fast read when supported, else 1-1-1 fast read. the 1-4-4 fields
+     are the low half of dword 3: wait states in bits 4:0, mode clocks in
+     bits 7:5 and the instruction in bits 15:8 */
+  if(dword[0] & (1UL << 21))
+  {
+    dev->read_code = (dword[2] >> 8) & 0xFF;
+    dev->read_dummy = (dword[2] & 0x1F) + ((dword[2] >> 5) & 0x7);
+    dev->read_mode = QSPI_OPERATE_MODE_144;
+  }
+  else
+  {
+    dev->read_code = 0x0B;
+    dev->read_dummy = 8;
+    dev->read_mode = QSPI_OPERATE_MODE_111;
+  }
+  dev->program_code = 0x02;
+  dev->program_mode = QSPI_OPERATE_MODE_111;
+
+  dev->qe = QSPI_FLASH_QE_NONE;
+  if(len >= 15)
+  {
+    /* quad enable requirements, bits 22:20 of dword 15 */
+    switch((dword[14] >> 20) & 0x7)
+    {
+      case 1:
+      case 4:
+      case 5:
+        /* status register 2 bit 1, both registers written by 0x01 */
+        dev->qe = QSPI_FLASH_QE_SR2_BIT1_WRSR;
+        break;
+      case 2:
+        dev->qe = QSPI_FLASH_QE_SR1_BIT6;
+        break;
+      case 6:
+        /* status register 2 bit 1, written alone by 0x31 */
+        dev->qe = QSPI_FLASH_QE_SR2_BIT1;
+        break;
+      default:
+        break;
+    }
+  }
+  if(dev->qe == QSPI_FLASH_QE_NONE && dev->read_mode == QSPI_OPERATE_MODE_144 && len < 15)
+  {
+    /* jesd216 rev 0 does not tell, keep to single line */
+    dev->read_code = 0x0B;
+    dev->read_dummy = 8;
+    dev->read_mode = QSPI_OPERATE_MODE_111;
+  }
+  return QSPI_FLASH_OK;
+}
+
+/**
+  * @brief  set the quad enable bit if the device needs it.
+  * @param  hflash: qspi flash handle
+  * @retval none
+  */
+static void qspi_flash_quad_enable(qspi_flash_handle_type *hflash)
+{
+  uint8_t sr[2];
+  qspi_cmd_type cmd;
+  uint32_t i_index, len = 1;
+
+  if(hflash->device.qe == QSPI_FLASH_QE_NONE)
+  {
+    return;
+  }
+
+  qspi_flash_cmd_init(&cmd, QSPI_FLASH_CMD_RDSR1);
+  cmd.data_counter = 1;
+  qspi_flash_fifo_read(hflash, &cmd, &sr[0]);
+  qspi_flash_cmd_init(&cmd, QSPI_FLASH_CMD_RDSR2);
+  cmd.data_counter = 1;
+  qspi_flash_fifo_read(hflash, &cmd, &sr[1]);
+
+  if(hflash->device.qe == QSPI_FLASH_QE_SR1_BIT6)
+  {
+    if(sr[0] & 0x40)
+    {
+      return;
+    }
+    sr[0] |= 0x40;
+    qspi_flash_cmd_init(&cmd, QSPI_FLASH_CMD_WRSR1);
+  }
+  else
+  {
+    if(sr[1] & 0x02)
+    {
+      return;
+    }
+    sr[1] |= 0x02;
+    if(hflash->device.qe == QSPI_FLASH_QE_SR2_BIT1)
+    {
+      qspi_flash_cmd_init(&cmd, QSPI_FLASH_CMD_WRSR2);
+      sr[0] = sr[1];
+    }
+    else
+    {
+      qspi_flash_cmd_init(&cmd, QSPI_FLASH_CMD_WRSR1);
+      len = 2;
+    }
+  }
+
+  qspi_flash_simple_send(hflash, QSPI_FLASH_CMD_WREN);
+  cmd.data_counter = len;
+  qspi_cmd_operation_kick(hflash->qspi_x, &cmd);
+  for(i_index = 0; i_index < len; i_index ++)
+  {
+    while(qspi_flag_get(hflash->qspi_x, QSPI_TXFIFORDY_FLAG) == RESET);
+    qspi_byte_write(hflash->qspi_x, sr[i_index]);
+  }
+  while(qspi_flag_get(hflash->qspi_x, QSPI_CMDSTS_FLAG) == RESET);
+  qspi_flag_clear(hflash->qspi_x, QSPI_CMDSTS_FLAG);
+  qspi_flash_simple_send(hflash, QSPI_FLASH_CMD_RDSR1);
+}
+
+/**
+  * @brief  identify the device and prepare it for quad access. the device
+  *         table is searched by jedec id first, then sfdp is used.
+  * @param  hflash: qspi flash handle, qspi_x and the dma fields must be set
+  * @retval QSPI_FLASH_OK or QSPI_FLASH_ERR_ID
+  */
+qspi_flash_status_type qspi_flash_init(qspi_flash_handle_type *hflash)
+{
+  qspi_cmd_type cmd;
+  uint8_t id[3];
+  uint32_t i_index, jedec_id;
+
+  hflash->state = QSPI_FLASH_STATE_IDLE;
+
+  /* command port, wip in bit 0, sampling phase correction */
+  qspi_xip_enable(hflash->qspi_x, FALSE);
+  qspi_busy_config(hflash->qspi_x, QSPI_BUSY_OFFSET_0);
+  qspi_auto_ispc_enable(hflash->qspi_x);
+  qspi_interrupt_enable(hflash->qspi_x, FALSE);
+
+  qspi_flash_cmd_init(&cmd, QSPI_FLASH_CMD_RDID);
+  cmd.data_counter = 3;
+  qspi_flash_fifo_read(hflash, &cmd, id);
+  jedec_id = ((uint32_t)id[0] << 16) | ((uint32_t)id[1] << 8) | id[2];
+
+  for(i_index = 0; i_index < sizeof(qspi_flash_device_table) / sizeof(qspi_flash_device_type); i_index ++)
+  {
+    if(qspi_flash_device_table[i_index].jedec_id == jedec_id)
+    {
+      hflash->device = qspi_flash_device_table[i_index];
+      qspi_flash_quad_enable(hflash);
+      return QSPI_FLASH_OK;
+    }
+  }
+
+  if(qspi_flash_sfdp_parse(hflash) != QSPI_FLASH_OK)
+  {
+    return QSPI_FLASH_ERR_ID;
+  }
+  hflash->device.jedec_id = jedec_id;
+  qspi_flash_quad_enable(hflash);
+  return QSPI_FLASH_OK;
+}
+
+/**
+  * @brief  read data by dma.
+  * @param  hflash: qspi flash handle
+  * @param  addr: flash address
+  * @param  pdata: data buffer
+  * @param  size: data length
+  * @retval status code
+  */
+qspi_flash_status_type qspi_flash_read(qspi_flash_handle_type *hflash, uint32_t addr, uint8_t *pdata, uint32_t size)
+{
+  qspi_cmd_type cmd;
+  uint32_t len;
+
+  if(hflash->state != QSPI_FLASH_STATE_IDLE)
+  {
+    return QSPI_FLASH_ERR_BUSY;
+  }
+  if(addr + size > hflash->device.size)
+  {
+    return QSPI_FLASH_ERR_PARAM;
+  }
+
+  while(size > 0)
+  {
+    len = (size > QSPI_FLASH_DMA_CHUNK) ? QSPI_FLASH_DMA_CHUNK : size;
+    qspi_flash_dma_set(hflash, DMA_DIR_PERIPHERAL_TO_MEMORY, pdata, len);
+
+    qspi_flash_cmd_init(&cmd, hflash->device.read_code);
+    cmd.address_code = addr;
+    cmd.address_length = QSPI_CMD_ADRLEN_3_BYTE;
+    cmd.data_counter = len;
+    cmd.second_dummy_cycle_num = hflash->device.read_dummy;
+    cmd.operation_mode = hflash->device.read_mode;
+    cmd.write_data_enable = FALSE;
+    qspi_flash_cmd_send(hflash, &cmd);
+
+    /* the fifo may still hold data after the command completes */
+    while(dma_data_number_get(hflash->dma_channel) != 0);
+    dma_channel_enable(hflash->dma_channel, FALSE);
+    qspi_dma_enable(hflash->qspi_x, FALSE);
+
+    addr += len;
+    pdata += len;
+    size -= len;
+  }
+  return QSPI_FLASH_OK;
+}
+
+/**
+  * @brief  erase the sector containing the address.
+  * @param  hflash: qspi flash handle
+  * @param  addr: flash address
+  * @retval status code
+  */
+qspi_flash_status_type qspi_flash_erase_sector(qspi_flash_handle_type *hflash, uint32_t addr)
+{
+  qspi_cmd_type cmd;
+
+  if(hflash->state != QSPI_FLASH_STATE_IDLE)
+  {
+    return QSPI_FLASH_ERR_BUSY;
+  }
+  if(addr >= hflash->device.size)
+  {
+    return QSPI_FLASH_ERR_PARAM;
+  }
+  qspi_flash_simple_send(hflash, QSPI_FLASH_CMD_WREN);
+  qspi_flash_cmd_init(&cmd, hflash->device.erase_code);
+  cmd.address_code = addr & ~(hflash->device.sector_size - 1);
+  cmd.address_length = QSPI_CMD_ADRLEN_3_BYTE;
+  qspi_flash_cmd_send(hflash, &cmd);
+  qspi_flash_simple_send(hflash, QSPI_FLASH_CMD_RDSR1);
+  return QSPI_FLASH_OK;
+}
+
+/**
+  * @brief  kick the next command of the asynchronous write.
+  * @param  hflash: qspi flash handle
+  * @retval none
+  */
+static void qspi_flash_write_next(qspi_flash_handle_type *hflash)
+{
+  qspi_flash_device_type *dev = &hflash->device;
+  qspi_cmd_type cmd;
+  uint32_t sector;
+
+  switch(hflash->state)
+  {
+    case QSPI_FLASH_STATE_ERASE_WREN:
+      qspi_flash_cmd_init(&cmd, dev->erase_code);
+      sector = hflash->addr & ~(dev->sector_size - 1);
+      cmd.address_code = sector;
+      cmd.address_length = QSPI_CMD_ADRLEN_3_BYTE;
+      hflash->erased_end = sector + dev->sector_size;
+      hflash->state = QSPI_FLASH_STATE_ERASE;
+      qspi_cmd_operation_kick(hflash->qspi_x, &cmd);
+      return;
+
+    case QSPI_FLASH_STATE_ERASE:
+      hflash->state = QSPI_FLASH_STATE_ERASE_POLL;
+      qspi_flash_simple_kick(hflash, QSPI_FLASH_CMD_RDSR1);
+      return;
+
+    case QSPI_FLASH_STATE_PROGRAM_WREN:
+      /* up to one page */
+      hflash->chunk = dev->page_size - (hflash->addr & (dev->page_size - 1));
+      if(hflash->chunk > hflash->left)
+      {
+        hflash->chunk = hflash->left;
+      }
+      qspi_flash_dma_set(hflash, DMA_DIR_MEMORY_TO_PERIPHERAL, hflash->pbuff, hflash->chunk);
+      qspi_flash_cmd_init(&cmd, dev->program_code);
+      cmd.address_code = hflash->addr;
+      cmd.address_length = QSPI_CMD_ADRLEN_3_BYTE;
+      cmd.data_counter = hflash->chunk;
+      cmd.operation_mode = dev->program_mode;
+      hflash->state = QSPI_FLASH_STATE_PROGRAM;
+      qspi_cmd_operation_kick(hflash->qspi_x, &cmd);
+      return;
+
+    case QSPI_FLASH_STATE_PROGRAM:
+      dma_channel_enable(hflash->dma_channel, FALSE);
+      qspi_dma_enable(hflash->qspi_x, FALSE);
+      hflash->state = QSPI_FLASH_STATE_PROGRAM_POLL;
+      qspi_flash_simple_kick(hflash, QSPI_FLASH_CMD_RDSR1);
+      return;
+
+    case QSPI_FLASH_STATE_PROGRAM_POLL:
+      hflash->addr += hflash->chunk;
+      hflash->pbuff += hflash->chunk;
+      hflash->left -= hflash->chunk;
+      break;
+
+    default:
+      break;
+  }
+
+  /* after an erase poll, a program poll or at start */
+  if(hflash->left == 0)
+  {
+    hflash->state = QSPI_FLASH_STATE_IDLE;
+    if(hflash->async == TRUE)
+    {
+      hflash->async = FALSE;
+      qspi_interrupt_enable(hflash->qspi_x, FALSE);
+      qspi_flash_write_complete(hflash);
+    }
+    return;
+  }
+  if(hflash->erase == TRUE && hflash->addr >= hflash->erased_end)
+  {
+    hflash->state = QSPI_FLASH_STATE_ERASE_WREN;
+  }
+  else
+  {
+    hflash->state = QSPI_FLASH_STATE_PROGRAM_WREN;
+  }
+  qspi_flash_simple_kick(hflash, QSPI_FLASH_CMD_WREN);
+}
+
+/**
+  * @brief  check and store the parameters of a write.
+  * @param  hflash: qspi flash handle
+  * @param  addr: flash address
+  * @param  pdata: data buffer
+  * @param  size: data length
+  * @param  erase: erase the written sectors first
+  * @retval status code
+  */
+static qspi_flash_status_type qspi_flash_write_setup(qspi_flash_handle_type *hflash, uint32_t addr, const uint8_t *pdata, uint32_t size, confirm_state erase)
+{
+  if(hflash->state != QSPI_FLASH_STATE_IDLE)
+  {
+    return QSPI_FLASH_ERR_BUSY;
+  }
+  if(addr + size > hflash->device.size)
+  {
+    return QSPI_FLASH_ERR_PARAM;
+  }
+  hflash->addr = addr;
+  hflash->pbuff = pdata;
+  hflash->left = size;
+  hflash->erase = erase;
+  hflash->erased_end = addr;
+  hflash->chunk = 0;
+  hflash->async = FALSE;
+  qspi_flag_clear(hflash->qspi_x, QSPI_CMDSTS_FLAG);
+  return QSPI_FLASH_OK;
+}
+
+/**
+  * @brief  start an asynchronous write of any size. the pages are
+  *         programmed by dma and every command completion is handled in
+  *         the qspi interrupt, so the cpu is free until the end.
+  *         with erase, each sector is erased just before its first page.
+  * @param  hflash: qspi flash handle
+  * @param  addr: flash address
+  * @param  pdata: data buffer, must stay valid until the end
+  * @param  size: data length
+  * @param  erase: erase the written sectors first, a sector that is only
+  *         partly written loses the rest of its data
+  * @retval status code
+  */
+qspi_flash_status_type qspi_flash_write_start(qspi_flash_handle_type *hflash, uint32_t addr, const uint8_t *pdata, uint32_t size, confirm_state erase)
+{
+  qspi_flash_status_type status = qspi_flash_write_setup(hflash, addr, pdata, size, erase);
+  if(status != QSPI_FLASH_OK)
+  {
+    return status;
+  }
+  hflash->async = TRUE;
+  qspi_interrupt_enable(hflash->qspi_x, TRUE);
+  qspi_flash_write_next(hflash);
+  return QSPI_FLASH_OK;
+}
+
+/**
+  * @brief  write data and wait until it is done, the commands are chained
+  *         by polling and the qspi interrupt is not used.
+  *         qspi_flash_write_complete is not called.
+  * @param  hflash: qspi flash handle
+  * @param  addr: flash address
+  * @param  pdata: data buffer
+  * @param  size: data length
+  * @param  erase: erase the written sectors first
+  * @retval status code
+  */
+qspi_flash_status_type qspi_flash_write(qspi_flash_handle_type *hflash, uint32_t addr, const uint8_t *pdata, uint32_t size, confirm_state erase)
+{
+  qspi_flash_status_type status = qspi_flash_write_setup(hflash, addr, pdata, size, erase);
+  if(status != QSPI_FLASH_OK)
+  {
+    return status;
+  }
+  qspi_flash_write_next(hflash);
+  while(hflash->state != QSPI_FLASH_STATE_IDLE)
+  {
+    while(qspi_flag_get(hflash->qspi_x, QSPI_CMDSTS_FLAG) == RESET);
+    qspi_flag_clear(hflash->qspi_x, QSPI_CMDSTS_FLAG);
+    qspi_flash_write_next(hflash);
+  }
+  return QSPI_FLASH_OK;
+}
+
+/**
+  * @brief  check if an asynchronous write is running.
+  * @param  hflash: qspi flash handle
+  * @retval SET or RESET
+  */
+flag_status qspi_flash_busy(qspi_flash_handle_type *hflash)
+{
+  return (hflash->state != QSPI_FLASH_STATE_IDLE) ? SET : RESET;
+}
+
+/**
+  * @brief  qspi interrupt handler, advances the asynchronous write.
+  * @param  hflash: qspi flash handle
+  * @retval none
+  */
+void qspi_flash_irq_handler(qspi_flash_handle_type *hflash)
+{
+  if(qspi_interrupt_flag_get(hflash->qspi_x, QSPI_CMDSTS_FLAG) != RESET)
+  {
+    qspi_flag_clear(hflash->qspi_x, QSPI_CMDSTS_FLAG);
+    if(hflash->state != QSPI_FLASH_STATE_IDLE)
+    {
+      qspi_flash_write_next(hflash);
+    }
+  }
+}
+
+/**
+  * @brief  write complete callback, called from the qspi interrupt when
+  *         started by qspi_flash_write_start, never for qspi_flash_write.
+  * @param  hflash: qspi flash handle
+  * @retval none
+  */
+__WEAK void qspi_flash_write_complete(qspi_flash_handle_type *hflash)
+{
+
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
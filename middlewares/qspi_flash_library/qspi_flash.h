@@ -0,0 +1,159 @@
+/**
+  **************************************************************************
+  * @file     qspi_flash.h
+  * @brief    qspi nor flash libray header file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __QSPI_FLASH_H
+#define __QSPI_FLASH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "at32f402_405.h"
+
+/** @addtogroup AT32F402_405_middlewares_qspi_flash_library
+  * @{
+  */
+
+/** @defgroup QSPI_flash_library_config
+  * @{
+  */
+
+#define QSPI_FLASH_DMA_CHUNK             0xFFFC      /*!< max bytes of one dma data phase */
+#define QSPI_FLASH_SFDP_DWORDS           16          /*!< basic parameter table dwords read */
+
+/**
+  * @}
+  */
+
+/** @defgroup QSPI_flash_library_types
+  * @{
+  */
+
+/**
+  * @brief quad enable requirement
+  */
+typedef enum
+{
+  QSPI_FLASH_QE_NONE = 0,                /*!< no quad enable bit */
+  QSPI_FLASH_QE_SR1_BIT6,                /*!< status register 1 bit 6, written by 0x01 */
+  QSPI_FLASH_QE_SR2_BIT1,                /*!< status register 2 bit 1, written by 0x31 */
+  QSPI_FLASH_QE_SR2_BIT1_WRSR,           /*!< status register 2 bit 1, written by 0x01 with two bytes */
+} qspi_flash_qe_type;
+
+/**
+  * @brief status code
+  */
+typedef enum
+{
+  QSPI_FLASH_OK = 0,                     /*!< no error */
+  QSPI_FLASH_ERR_BUSY,                   /*!< an asynchronous write is running */
+  QSPI_FLASH_ERR_ID,                     /*!< unknown device without sfdp */
+  QSPI_FLASH_ERR_PARAM,                  /*!< address or length out of the device */
+} qspi_flash_status_type;
+
+/**
+  * @brief asynchronous write state
+  */
+typedef enum
+{
+  QSPI_FLASH_STATE_IDLE = 0,             /*!< no operation */
+  QSPI_FLASH_STATE_ERASE_WREN,           /*!< write enable for sector erase */
+  QSPI_FLASH_STATE_ERASE,                /*!< sector erase command */
+  QSPI_FLASH_STATE_ERASE_POLL,           /*!< status polling after erase */
+  QSPI_FLASH_STATE_PROGRAM_WREN,         /*!< write enable for page program */
+  QSPI_FLASH_STATE_PROGRAM,              /*!< page program with dma */
+  QSPI_FLASH_STATE_PROGRAM_POLL,         /*!< status polling after program */
+} qspi_flash_state_type;
+
+/**
+  * @brief device parameters, from the device table or from sfdp
+  */
+typedef struct
+{
+  uint32_t                               jedec_id;                /*!< manufacturer, type and capacity */
+  uint32_t                               size;                    /*!< size in byte */
+  uint32_t                               sector_size;             /*!< erase sector size in byte */
+  uint16_t                               page_size;               /*!< program page size in byte */
+  uint8_t                                erase_code;              /*!< sector erase instruction */
+  uint8_t                                read_code;               /*!< read instruction */
+  uint8_t                                read_dummy;              /*!< read dummy and mode cycles */
+  qspi_operate_mode_type                 read_mode;               /*!< read operation mode */
+  uint8_t                                program_code;            /*!< page program instruction */
+  qspi_operate_mode_type                 program_mode;            /*!< page program operation mode */
+  qspi_flash_qe_type                     qe;                      /*!< quad enable requirement */
+} qspi_flash_device_type;
+
+/**
+  * @brief qspi flash handle
+  */
+typedef struct
+{
+  qspi_type                              *qspi_x;                 /*!< qspi registers base address */
+  dma_type                               *dma_x;                  /*!< dma controller of the data channel */
+  dma_channel_type                       *dma_channel;            /*!< dma channel for the data phases */
+  dmamux_channel_type                    *dmamux_channel;         /*!< dmamux channel of the dma channel */
+  dmamux_requst_id_sel_type              dma_request;             /*!< dmamux request of the qspi */
+  qspi_flash_device_type                 device;                  /*!< device parameters */
+  __IO qspi_flash_state_type             state;                   /*!< asynchronous write state */
+  uint32_t                               addr;                    /*!< next write address */
+  const uint8_t                          *pbuff;                  /*!< next write data */
+  uint32_t                               left;                    /*!< bytes left to write */
+  uint32_t                               chunk;                   /*!< bytes of the current page program */
+  confirm_state                          erase;                   /*!< erase sectors before programming */
+  uint32_t                               erased_end;              /*!< end of the erased area */
+  confirm_state                          async;                   /*!< started by qspi_flash_write_start */
+} qspi_flash_handle_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup QSPI_flash_library_exported_functions
+  * @{
+  */
+
+qspi_flash_status_type qspi_flash_init          (qspi_flash_handle_type *hflash);
+qspi_flash_status_type qspi_flash_read          (qspi_flash_handle_type *hflash, uint32_t addr, uint8_t *pdata, uint32_t size);
+qspi_flash_status_type qspi_flash_erase_sector  (qspi_flash_handle_type *hflash, uint32_t addr);
+qspi_flash_status_type qspi_flash_write         (qspi_flash_handle_type *hflash, uint32_t addr, const uint8_t *pdata, uint32_t size, confirm_state erase);
+qspi_flash_status_type qspi_flash_write_start   (qspi_flash_handle_type *hflash, uint32_t addr, const uint8_t *pdata, uint32_t size, confirm_state erase);
+flag_status            qspi_flash_busy          (qspi_flash_handle_type *hflash);
+void                   qspi_flash_irq_handler   (qspi_flash_handle_type *hflash);
+void                   qspi_flash_write_complete(qspi_flash_handle_type *hflash);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
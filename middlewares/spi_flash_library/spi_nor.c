@@ -0,0 +1,488 @@
+/**
+  **************************************************************************
+  * @file     spi_nor.c
+  * @brief    spi nor flash library
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "spi_nor.h"
+
+/** @addtogroup AT32F402_405_middlewares_spi_flash_library
+  * @{
+  */
+
+/** @defgroup SPI_nor_library
+  * @brief spi nor flash driver. data phases run as full duplex dma bursts,
+  *        only the command and address bytes go through the data register.
+  *        program and erase do not wait for the device, the busy check is
+  *        done before the next command, so the cpu prepares the next page
+  *        while the device programs the previous one.
+  * @{
+  */
+
+static const uint8_t spi_nor_dummy = SPI_NOR_DUMMY_BYTE;
+static uint8_t spi_nor_sink;
+static uint32_t spi_nor_check_buf[SPI_NOR_CHECK_SIZE / 4];
+
+/**
+  * @brief  exchange one byte through the data register.
+  * @param  nor: the spi nor handle.
+  * @param  data: byte to send.
+  * @retval byte received.
+  */
+static uint8_t spi_nor_byte(spi_nor_type *nor, uint8_t data)
+{
+  spi_i2s_data_transmit(nor->spi_x, data);
+  while(spi_i2s_flag_get(nor->spi_x, SPI_I2S_RDBF_FLAG) == RESET);
+  return (uint8_t)spi_i2s_data_receive(nor->spi_x);
+}
+
+/**
+  * @brief  select the device and send a command with a 24 bit address.
+  * @param  nor: the spi nor handle.
+  * @param  cmd: command.
+  * @param  address: address.
+  * @retval none.
+  */
+static void spi_nor_command(spi_nor_type *nor, uint8_t cmd, uint32_t address)
+{
+  gpio_bits_reset(nor->cs_gpio, nor->cs_pin);
+  spi_nor_byte(nor, cmd);
+  spi_nor_byte(nor, (uint8_t)(address >> 16));
+  spi_nor_byte(nor, (uint8_t)(address >> 8));
+  spi_nor_byte(nor, (uint8_t)address);
+}
+
+/**
+  * @brief  send a one byte command.
+  * @param  nor: the spi nor handle.
+  * @param  cmd: command.
+  * @retval none.
+  */
+static void spi_nor_command_only(spi_nor_type *nor, uint8_t cmd)
+{
+  gpio_bits_reset(nor->cs_gpio, nor->cs_pin);
+  spi_nor_byte(nor, cmd);
+  gpio_bits_set(nor->cs_gpio, nor->cs_pin);
+}
+
+/**
+  * @brief  start a full duplex dma burst.
+  * @param  nor: the spi nor handle.
+  * @param  tx: data to send, 0 to send dummy bytes.
+  * @param  rx: receive buffer, 0 to drop the received bytes.
+  * @param  length: burst length, up to SPI_NOR_BURST_MAX.
+  * @retval none.
+  */
+static void spi_nor_burst_start(spi_nor_type *nor, const uint8_t *tx, uint8_t *rx, uint16_t length)
+{
+  dma_init_type dma_init_struct;
+
+  dma_channel_enable(nor->dma_rx_channel, FALSE);
+  dma_channel_enable(nor->dma_tx_channel, FALSE);
+
+  dma_default_para_init(&dma_init_struct);
+  dma_init_struct.buffer_size = length;
+  dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_BYTE;
+  dma_init_struct.peripheral_base_addr = (uint32_t)&nor->spi_x->dt;
+  dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_BYTE;
+  dma_init_struct.peripheral_inc_enable = FALSE;
+  dma_init_struct.priority = DMA_PRIORITY_VERY_HIGH;
+  dma_init_struct.loop_mode_enable = FALSE;
+
+  dma_init_struct.direction = DMA_DIR_PERIPHERAL_TO_MEMORY;
+  dma_init_struct.memory_base_addr = (rx != 0) ? (uint32_t)rx : (uint32_t)&spi_nor_sink;
+  dma_init_struct.memory_inc_enable = (rx != 0) ? TRUE : FALSE;
+  dma_init(nor->dma_rx_channel, &dma_init_struct);
+
+  dma_init_struct.direction = DMA_DIR_MEMORY_TO_PERIPHERAL;
+  dma_init_struct.memory_base_addr = (tx != 0) ? (uint32_t)tx : (uint32_t)&spi_nor_dummy;
+  dma_init_struct.memory_inc_enable = (tx != 0) ? TRUE : FALSE;
+  dma_init(nor->dma_tx_channel, &dma_init_struct);
+
+  spi_i2s_dma_receiver_enable(nor->spi_x, TRUE);
+  spi_i2s_dma_transmitter_enable(nor->spi_x, TRUE);
+
+  /* receive first so no byte is lost */
+  dma_channel_enable(nor->dma_rx_channel, TRUE);
+  dma_channel_enable(nor->dma_tx_channel, TRUE);
+}
+
+/**
+  * @brief  check if a dma burst is done.
+  * @param  nor: the spi nor handle.
+  * @retval SET if all bytes are received.
+  */
+static flag_status spi_nor_burst_done(spi_nor_type *nor)
+{
+  return (dma_data_number_get(nor->dma_rx_channel) == 0) ? SET : RESET;
+}
+
+/**
+  * @brief  end a dma burst.
+  * @param  nor: the spi nor handle.
+  * @retval none.
+  */
+static void spi_nor_burst_end(spi_nor_type *nor)
+{
+  while(spi_nor_burst_done(nor) == RESET);
+  while(spi_i2s_flag_get(nor->spi_x, SPI_I2S_BF_FLAG) != RESET);
+
+  dma_channel_enable(nor->dma_tx_channel, FALSE);
+  dma_channel_enable(nor->dma_rx_channel, FALSE);
+  spi_i2s_dma_transmitter_enable(nor->spi_x, FALSE);
+  spi_i2s_dma_receiver_enable(nor->spi_x, FALSE);
+}
+
+/**
+  * @brief  read status register 1.
+  * @param  nor: the spi nor handle.
+  * @retval status register 1.
+  */
+static uint8_t spi_nor_status_get(spi_nor_type *nor)
+{
+  uint8_t status;
+
+  gpio_bits_reset(nor->cs_gpio, nor->cs_pin);
+  spi_nor_byte(nor, SPI_NOR_CMD_RDSR1);
+  status = spi_nor_byte(nor, SPI_NOR_DUMMY_BYTE);
+  gpio_bits_set(nor->cs_gpio, nor->cs_pin);
+
+  return status;
+}
+
+/**
+  * @brief  issue one page program. the device is ready and the page does
+  *         not cross a page boundary.
+  * @param  nor: the spi nor handle.
+  * @param  address: address.
+  * @param  pdata: data.
+  * @param  length: bytes.
+  * @retval none.
+  */
+static void spi_nor_page_start(spi_nor_type *nor, uint32_t address, const uint8_t *pdata, uint16_t length)
+{
+  spi_nor_command_only(nor, SPI_NOR_CMD_WREN);
+  spi_nor_command(nor, SPI_NOR_CMD_PAGE_PROGRAM, address);
+  spi_nor_burst_start(nor, pdata, 0, length);
+}
+
+/**
+  * @brief  bytes up to the end of the page.
+  * @param  nor: the spi nor handle.
+  * @param  address: address.
+  * @param  length: bytes left.
+  * @retval bytes of the page.
+  */
+static uint16_t spi_nor_page_chunk(spi_nor_type *nor, uint32_t address, uint32_t length)
+{
+  uint32_t chunk = nor->page_size - (address % nor->page_size);
+
+  return (uint16_t)((length < chunk) ? length : chunk);
+}
+
+/**
+  * @brief  configure the dma requests and read the device id. the spi, its
+  *         pins, the cs pin and the dma clock must be set up by the user.
+  * @param  nor: the spi nor handle.
+  * @retval jedec id, manufacturer in bits 23:16.
+  */
+uint32_t spi_nor_init(spi_nor_type *nor)
+{
+  dmamux_enable(nor->dma_x, TRUE);
+  dmamux_init(nor->dmamux_tx_channel, nor->dmamux_tx_req);
+  dmamux_init(nor->dmamux_rx_channel, nor->dmamux_rx_req);
+
+  gpio_bits_set(nor->cs_gpio, nor->cs_pin);
+
+  nor->flash_busy = 1;
+  nor->state = SPI_NOR_STATE_IDLE;
+  nor->erase_count = 0;
+  nor->erase_skipped = 0;
+
+  return spi_nor_read_id(nor);
+}
+
+/**
+  * @brief  read the jedec id.
+  * @param  nor: the spi nor handle.
+  * @retval jedec id, manufacturer in bits 23:16.
+  */
+uint32_t spi_nor_read_id(spi_nor_type *nor)
+{
+  uint32_t id;
+
+  spi_nor_wait(nor);
+
+  gpio_bits_reset(nor->cs_gpio, nor->cs_pin);
+  spi_nor_byte(nor, SPI_NOR_CMD_JEDEC_ID);
+  id = (uint32_t)spi_nor_byte(nor, SPI_NOR_DUMMY_BYTE) << 16;
+  id |= (uint32_t)spi_nor_byte(nor, SPI_NOR_DUMMY_BYTE) << 8;
+  id |= spi_nor_byte(nor, SPI_NOR_DUMMY_BYTE);
+  gpio_bits_set(nor->cs_gpio, nor->cs_pin);
+
+  return id;
+}
+
+/**
+  * @brief  read data. one command for the whole range, the data comes in
+  *         dma bursts of up to SPI_NOR_BURST_MAX bytes.
+  * @param  nor: the spi nor handle.
+  * @param  address: address.
+  * @param  pdata: data buffer.
+  * @param  length: bytes.
+  * @retval none.
+  */
+void spi_nor_read(spi_nor_type *nor, uint32_t address, uint8_t *pdata, uint32_t length)
+{
+  uint16_t burst;
+
+  spi_nor_wait(nor);
+
+  if(nor->fast_read)
+  {
+    spi_nor_command(nor, SPI_NOR_CMD_FAST_READ, address);
+    spi_nor_byte(nor, SPI_NOR_DUMMY_BYTE);
+  }
+  else
+  {
+    spi_nor_command(nor, SPI_NOR_CMD_READ, address);
+  }
+
+  while(length > 0)
+  {
+    burst = (length < SPI_NOR_BURST_MAX) ? length : SPI_NOR_BURST_MAX;
+    spi_nor_burst_start(nor, 0, pdata, burst);
+    spi_nor_burst_end(nor);
+    pdata += burst;
+    length -= burst;
+  }
+
+  gpio_bits_set(nor->cs_gpio, nor->cs_pin);
+}
+
+/**
+  * @brief  check if a range is erased.
+  * @param  nor: the spi nor handle.
+  * @param  address: address.
+  * @param  length: bytes.
+  * @retval SET if all bytes are 0xFF.
+  */
+flag_status spi_nor_blank_check(spi_nor_type *nor, uint32_t address, uint32_t length)
+{
+  uint32_t chunk, i;
+  uint8_t *pbyte = (uint8_t *)spi_nor_check_buf;
+
+  while(length > 0)
+  {
+    chunk = (length < SPI_NOR_CHECK_SIZE) ? length : SPI_NOR_CHECK_SIZE;
+    spi_nor_read(nor, address, pbyte, chunk);
+
+    for(i = 0; i < chunk / 4; i++)
+    {
+      if(spi_nor_check_buf[i] != 0xFFFFFFFF)
+      {
+        return RESET;
+      }
+    }
+    for(i = i * 4; i < chunk; i++)
+    {
+      if(pbyte[i] != 0xFF)
+      {
+        return RESET;
+      }
+    }
+
+    address += chunk;
+    length -= chunk;
+  }
+
+  return SET;
+}
+
+/**
+  * @brief  erase the sector of an address. a blank sector is not erased,
+  *         reading it costs far less than the erase time.
+  * @param  nor: the spi nor handle.
+  * @param  address: any address in the sector.
+  * @retval SET if the erase was issued, RESET if the sector was blank.
+  */
+flag_status spi_nor_erase_sector(spi_nor_type *nor, uint32_t address)
+{
+  address -= address % nor->sector_size;
+
+  if(spi_nor_blank_check(nor, address, nor->sector_size) == SET)
+  {
+    nor->erase_skipped++;
+    return RESET;
+  }
+
+  spi_nor_wait(nor);
+  spi_nor_command_only(nor, SPI_NOR_CMD_WREN);
+  spi_nor_command(nor, SPI_NOR_CMD_SECTOR_ERASE, address);
+  gpio_bits_set(nor->cs_gpio, nor->cs_pin);
+
+  nor->flash_busy = 1;
+  nor->erase_count++;
+
+  return SET;
+}
+
+/**
+  * @brief  program erased memory. pages are split at page boundaries, the
+  *         function returns once the last page is issued.
+  * @param  nor: the spi nor handle.
+  * @param  address: address.
+  * @param  pdata: data.
+  * @param  length: bytes.
+  * @retval none.
+  */
+void spi_nor_write(spi_nor_type *nor, uint32_t address, const uint8_t *pdata, uint32_t length)
+{
+  uint16_t chunk;
+
+  while(length > 0)
+  {
+    chunk = spi_nor_page_chunk(nor, address, length);
+
+    spi_nor_wait(nor);
+    spi_nor_page_start(nor, address, pdata, chunk);
+    spi_nor_burst_end(nor);
+    gpio_bits_set(nor->cs_gpio, nor->cs_pin);
+    nor->flash_busy = 1;
+
+    address += chunk;
+    pdata += chunk;
+    length -= chunk;
+  }
+}
+
+/**
+  * @brief  start an asynchronous write of erased memory, spi_nor_task
+  *         moves it on without blocking.
+  * @param  nor: the spi nor handle.
+  * @param  address: address.
+  * @param  pdata: data, must stay valid until the end.
+  * @param  length: bytes.
+  * @retval SUCCESS or ERROR if a write is running.
+  */
+error_status spi_nor_write_start(spi_nor_type *nor, uint32_t address, const uint8_t *pdata, uint32_t length)
+{
+  if(nor->state != SPI_NOR_STATE_IDLE || length == 0 || address + length > nor->capacity)
+  {
+    return ERROR;
+  }
+
+  nor->address = address;
+  nor->pdata = pdata;
+  nor->left = length;
+  nor->state = SPI_NOR_STATE_WAIT;
+
+  spi_nor_task(nor);
+
+  return SUCCESS;
+}
+
+/**
+  * @brief  move the asynchronous write on, call it from the main loop or
+  *         a periodic timer. the device status is read once per call.
+  * @param  nor: the spi nor handle.
+  * @retval SET while the write is running, RESET when done.
+  */
+flag_status spi_nor_task(spi_nor_type *nor)
+{
+  if(nor->state == SPI_NOR_STATE_PROGRAM)
+  {
+    if(spi_nor_burst_done(nor) == RESET)
+    {
+      return SET;
+    }
+
+    spi_nor_burst_end(nor);
+    gpio_bits_set(nor->cs_gpio, nor->cs_pin);
+    nor->flash_busy = 1;
+
+    nor->address += nor->chunk;
+    nor->pdata += nor->chunk;
+    nor->left -= nor->chunk;
+    nor->state = SPI_NOR_STATE_WAIT;
+  }
+
+  if(nor->state == SPI_NOR_STATE_WAIT)
+  {
+    if(spi_nor_busy(nor) == SET)
+    {
+      return SET;
+    }
+
+    if(nor->left == 0)
+    {
+      nor->state = SPI_NOR_STATE_IDLE;
+      return RESET;
+    }
+
+    nor->chunk = spi_nor_page_chunk(nor, nor->address, nor->left);
+    spi_nor_page_start(nor, nor->address, nor->pdata, nor->chunk);
+    nor->state = SPI_NOR_STATE_PROGRAM;
+    return SET;
+  }
+
+  return RESET;
+}
+
+/**
+  * @brief  check if the device is still programming or erasing, without
+  *         waiting.
+  * @param  nor: the spi nor handle.
+  * @retval SET if busy.
+  */
+flag_status spi_nor_busy(spi_nor_type *nor)
+{
+  if(nor->flash_busy)
+  {
+    if(spi_nor_status_get(nor) & SPI_NOR_SR1_WIP)
+    {
+      return SET;
+    }
+    nor->flash_busy = 0;
+  }
+
+  return RESET;
+}
+
+/**
+  * @brief  wait for the device to finish programming or erasing, a running
+  *         asynchronous write is completed first.
+  * @param  nor: the spi nor handle.
+  * @retval none.
+  */
+void spi_nor_wait(spi_nor_type *nor)
+{
+  while(spi_nor_task(nor) == SET);
+  while(spi_nor_busy(nor) == SET);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,145 @@
+/**
+  **************************************************************************
+  * @file     spi_nor.h
+  * @brief    spi nor flash library header file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SPI_NOR_H
+#define __SPI_NOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "at32f402_405.h"
+
+/** @addtogroup AT32F402_405_middlewares_spi_flash_library
+  * @{
+  */
+
+/** @defgroup SPI_nor_library_config
+  * @{
+  */
+
+#define SPI_NOR_BURST_MAX                0xFFFF      /*!< bytes per dma burst */
+#define SPI_NOR_CHECK_SIZE               256         /*!< blank check chunk size */
+#define SPI_NOR_DUMMY_BYTE               0xFF        /*!< byte sent while reading */
+
+/**
+  * @}
+  */
+
+/** @defgroup SPI_nor_library_command
+  * @{
+  */
+
+#define SPI_NOR_CMD_WREN                 0x06
+#define SPI_NOR_CMD_RDSR1                0x05
+#define SPI_NOR_CMD_READ                 0x03
+#define SPI_NOR_CMD_FAST_READ            0x0B
+#define SPI_NOR_CMD_PAGE_PROGRAM         0x02
+#define SPI_NOR_CMD_SECTOR_ERASE         0x20
+#define SPI_NOR_CMD_JEDEC_ID             0x9F
+
+#define SPI_NOR_SR1_WIP                  0x01
+
+/**
+  * @}
+  */
+
+/** @defgroup SPI_nor_library_types
+  * @{
+  */
+
+/**
+  * @brief spi nor asynchronous write state
+  */
+typedef enum
+{
+  SPI_NOR_STATE_IDLE = 0,                /*!< no write running */
+  SPI_NOR_STATE_WAIT,                    /*!< device programming the previous page */
+  SPI_NOR_STATE_PROGRAM,                 /*!< page data on its way by dma */
+} spi_nor_state_type;
+
+/**
+  * @brief spi nor handle, the first group is set by the user
+  */
+typedef struct
+{
+  spi_type                               *spi_x;                  /*!< spi, configured master 8 bit mode 0 or 3 */
+  gpio_type                              *cs_gpio;                /*!< software cs port                */
+  uint16_t                               cs_pin;                  /*!< software cs pin                 */
+  dma_type                               *dma_x;                  /*!< dma of both channels            */
+  dma_channel_type                       *dma_tx_channel;         /*!< transmit channel                */
+  dmamux_channel_type                    *dmamux_tx_channel;      /*!< transmit dmamux channel         */
+  dmamux_requst_id_sel_type              dmamux_tx_req;           /*!< spi transmit request            */
+  dma_channel_type                       *dma_rx_channel;         /*!< receive channel                 */
+  dmamux_channel_type                    *dmamux_rx_channel;      /*!< receive dmamux channel          */
+  dmamux_requst_id_sel_type              dmamux_rx_req;           /*!< spi receive request             */
+  uint32_t                               capacity;                /*!< bytes                           */
+  uint16_t                               page_size;               /*!< program page size               */
+  uint16_t                               sector_size;             /*!< erase sector size               */
+  uint8_t                                fast_read;               /*!< 1: 0x0B with a dummy byte, needed above ~50 MHz */
+
+  __IO uint8_t                           flash_busy;              /*!< program or erase issued, not yet checked */
+  __IO spi_nor_state_type                state;                   /*!< asynchronous write state        */
+  const uint8_t                          *pdata;                  /*!< asynchronous write data         */
+  uint32_t                               address;                 /*!< asynchronous write address      */
+  uint32_t                               left;                    /*!< asynchronous write bytes left   */
+  uint16_t                               chunk;                   /*!< bytes of the running page       */
+  uint32_t                               erase_count;             /*!< sectors erased                  */
+  uint32_t                               erase_skipped;           /*!< blank sectors not erased        */
+} spi_nor_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup SPI_nor_library_exported_functions
+  * @{
+  */
+
+uint32_t     spi_nor_init                (spi_nor_type *nor);
+uint32_t     spi_nor_read_id             (spi_nor_type *nor);
+void         spi_nor_read                (spi_nor_type *nor, uint32_t address, uint8_t *pdata, uint32_t length);
+flag_status  spi_nor_blank_check         (spi_nor_type *nor, uint32_t address, uint32_t length);
+flag_status  spi_nor_erase_sector        (spi_nor_type *nor, uint32_t address);
+void         spi_nor_write               (spi_nor_type *nor, uint32_t address, const uint8_t *pdata, uint32_t length);
+error_status spi_nor_write_start         (spi_nor_type *nor, uint32_t address, const uint8_t *pdata, uint32_t length);
+flag_status  spi_nor_task                (spi_nor_type *nor);
+flag_status  spi_nor_busy                (spi_nor_type *nor);
+void         spi_nor_wait                (spi_nor_type *nor);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
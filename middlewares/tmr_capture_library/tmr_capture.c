@@ -0,0 +1,482 @@
+/**
+  **************************************************************************
+  * @file     tmr_capture.c
+  * @brief    timer capture timestamp library source file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "tmr_capture.h"
+
+/** @addtogroup AT32F402_405_middlewares_tmr_capture_library
+  * @{
+  */
+
+/** @defgroup TMR_capture_library
+  * @brief edge timestamps of several capture channels. every capture is
+  *        moved by dma into the ring of its channel. the counter overflow
+  *        extends the counter to 64 bits, the overflow and a free compare
+  *        channel at mid period drain the new captures of all channels as
+  *        one batch. a batch spans half a period plus the interrupt latency
+  *        jitter, so while the latency stays below half a period every
+  *        capture lies within one period before the counter read after the
+  *        ring positions: a raw value above that counter is from the
+  *        previous epoch.
+  * @{
+  */
+
+/**
+  * @brief  get the counting clock of a timer.
+  * @param  tmr_x: timer.
+  * @retval timer clock before division, 0 if the timer is not supported.
+  */
+static uint32_t tmr_capture_clock_get(tmr_type *tmr_x)
+{
+  crm_clocks_freq_type clocks;
+  uint32_t apb_freq;
+
+  crm_clocks_freq_get(&clocks);
+
+  if(tmr_x == TMR1)
+  {
+    crm_periph_clock_enable(CRM_TMR1_PERIPH_CLOCK, TRUE);
+    apb_freq = clocks.apb2_freq;
+  }
+  else if(tmr_x == TMR2 || tmr_x == TMR3 || tmr_x == TMR4)
+  {
+    crm_periph_clock_enable((tmr_x == TMR2) ? CRM_TMR2_PERIPH_CLOCK :
+                            (tmr_x == TMR3) ? CRM_TMR3_PERIPH_CLOCK : CRM_TMR4_PERIPH_CLOCK, TRUE);
+    apb_freq = clocks.apb1_freq;
+  }
+  else
+  {
+    return 0;
+  }
+
+  /* timers run at twice the apb clock when the apb is divided */
+  return (apb_freq == clocks.ahb_freq) ? apb_freq : apb_freq * 2;
+}
+
+/**
+  * @brief  get the dmamux request of a capture channel.
+  * @param  tmr_x: timer.
+  * @param  index: channel number minus 1.
+  * @retval dmamux request.
+  */
+static dmamux_requst_id_sel_type tmr_capture_request_get(tmr_type *tmr_x, uint8_t index)
+{
+  if(tmr_x == TMR1)
+  {
+    return (dmamux_requst_id_sel_type)(DMAMUX_DMAREQ_ID_TMR1_CH1 + index);
+  }
+  else if(tmr_x == TMR2)
+  {
+    return (dmamux_requst_id_sel_type)(DMAMUX_DMAREQ_ID_TMR2_CH1 + index);
+  }
+  else if(tmr_x == TMR3)
+  {
+    return (dmamux_requst_id_sel_type)(DMAMUX_DMAREQ_ID_TMR3_CH1 + index);
+  }
+  return (dmamux_requst_id_sel_type)(DMAMUX_DMAREQ_ID_TMR4_CH1 + index);
+}
+
+/**
+  * @brief  extend the new captures of a channel and update its statistics.
+  * @param  cap: the handle points to the capture information.
+  * @param  ch: capture channel.
+  * @param  pos: ring write position taken before the counter.
+  * @param  now: time read after the ring positions.
+  * @retval none.
+  */
+static void tmr_capture_channel_process(tmr_capture_type *cap, tmr_capture_channel_type *ch, uint32_t pos, uint64_t now)
+{
+  uint32_t size = ch->ring_size;
+  uint32_t count, period;
+  uint64_t ts;
+  uint16_t raw;
+
+  count = (pos + size - ch->read) % size;
+
+  ch->batch = 0;
+  ch->batch_last = ch->last;
+  while(count--)
+  {
+    raw = ch->ring[ch->read];
+    if(++ch->read == size)
+    {
+      ch->read = 0;
+    }
+
+    /* the capture lies within one period before now */
+    ts = (now & ~(uint64_t)0xFFFF) | raw;
+    if(raw > (uint16_t)now && ts >= 0x10000)
+    {
+      ts -= 0x10000;
+    }
+
+    if(ch->edges != 0)
+    {
+      period = (uint32_t)(ts - ch->last);
+      if(period < ch->period_min)
+      {
+        ch->period_min = period;
+      }
+      if(period > ch->period_max)
+      {
+        ch->period_max = period;
+      }
+      ch->period_sum += period;
+      ch->period_count ++;
+    }
+    ch->last = ts;
+    ch->edges ++;
+
+    if(ch->ts != 0)
+    {
+      ch->ts[ch->batch] = ts;
+    }
+    ch->batch ++;
+  }
+}
+
+/**
+  * @brief  pair the falling edges of a channel with the rising edges of its
+  *         duty reference, both batches are in time order.
+  * @param  fall: channel with the falling edges.
+  * @param  rise: channel with the rising edges.
+  * @retval none.
+  */
+static void tmr_capture_duty_process(tmr_capture_channel_type *fall, tmr_capture_channel_type *rise)
+{
+  uint64_t last_rise = rise->batch_last;
+  uint16_t r_index = 0, f_index;
+
+  for(f_index = 0; f_index < fall->batch; f_index ++)
+  {
+    while(r_index < rise->batch && rise->ts[r_index] <= fall->ts[f_index])
+    {
+      last_rise = rise->ts[r_index++];
+    }
+    if(last_rise != 0 && fall->ts[f_index] > last_rise)
+    {
+      fall->high_sum += fall->ts[f_index] - last_rise;
+      fall->high_count ++;
+    }
+  }
+}
+
+/**
+  * @brief  configure the timer as a free running 16 bit counter and the
+  *         capture channels with their dma rings. the first compare channel
+  *         not used for a capture drains the rings at mid period, its pin
+  *         stays free. dma_app_init is called before, the input pins are
+  *         configured by the user.
+  * @param  cap: the handle points to the capture information.
+  * @retval ERROR if a parameter is invalid or no dma channel is free.
+  */
+error_status tmr_capture_init(tmr_capture_type *cap)
+{
+  tmr_input_config_type input_struct;
+  tmr_output_config_type output_struct;
+  dma_init_type dma_init_struct;
+  tmr_capture_channel_type *ch;
+  uint32_t clock;
+  uint8_t index, number, used = 0;
+
+  clock = tmr_capture_clock_get(cap->tmr_x);
+  if(clock == 0 || cap->div == 0 || cap->div > 0x10000 ||
+     cap->channel_num == 0 || cap->channel_num > TMR_CAPTURE_CHANNEL_MAX)
+  {
+    return ERROR;
+  }
+  cap->clock = clock / cap->div;
+
+  tmr_counter_enable(cap->tmr_x, FALSE);
+  tmr_base_init(cap->tmr_x, 0xFFFF, cap->div - 1);
+  tmr_cnt_dir_set(cap->tmr_x, TMR_COUNT_UP);
+
+  dma_default_para_init(&dma_init_struct);
+  dma_init_struct.direction = DMA_DIR_PERIPHERAL_TO_MEMORY;
+  dma_init_struct.memory_inc_enable = TRUE;
+  dma_init_struct.peripheral_inc_enable = FALSE;
+  dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_HALFWORD;
+  dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_HALFWORD;
+  dma_init_struct.priority = DMA_PRIORITY_HIGH;
+
+  for(index = 0; index < cap->channel_num; index ++)
+  {
+    ch = &cap->ch[index];
+    number = (uint8_t)ch->channel / 2;
+    if(ch->ring_size < 2 || (ch->duty_ref >= 0 &&
+       (ch->duty_ref >= cap->channel_num || ch->ts == 0 || cap->ch[ch->duty_ref].ts == 0)))
+    {
+      return ERROR;
+    }
+
+    input_struct.input_channel_select = ch->channel;
+    input_struct.input_polarity_select = ch->polarity;
+    input_struct.input_mapped_select = ch->mapped;
+    input_struct.input_filter_value = ch->filter;
+    tmr_input_channel_init(cap->tmr_x, &input_struct, TMR_CHANNEL_INPUT_DIV_1);
+
+    /* the ring is read in batches, no dma interrupt */
+    if(ch->hdma == 0)
+    {
+      ch->hdma = dma_app_channel_alloc(tmr_capture_request_get(cap->tmr_x, number), &dma_init_struct, 0, cap->priority);
+      if(ch->hdma == 0)
+      {
+        return ERROR;
+      }
+    }
+    tmr_dma_request_enable(cap->tmr_x, (tmr_dma_request_type)(TMR_C1_DMA_REQUEST << number), TRUE);
+    used |= 1 << number;
+  }
+
+  /* mid period drain on a compare channel without output */
+  for(number = 0; number < 4 && (used & (1 << number)) != 0; number ++)
+  {
+  }
+  if(number == 4)
+  {
+    return ERROR;
+  }
+  cap->mid_channel = (tmr_channel_select_type)(TMR_SELECT_CHANNEL_1 + number * 2);
+  tmr_output_default_para_init(&output_struct);
+  tmr_output_channel_config(cap->tmr_x, cap->mid_channel, &output_struct);
+  tmr_channel_value_set(cap->tmr_x, cap->mid_channel, 0x8000);
+
+  tmr_interrupt_enable(cap->tmr_x, TMR_OVF_INT | (TMR_C1_INT << number), TRUE);
+  if(cap->tmr_x == TMR1)
+  {
+    nvic_irq_enable(TMR1_OVF_TMR10_IRQn, cap->priority, 0);
+    nvic_irq_enable(TMR1_CH_IRQn, cap->priority, 0);
+  }
+  else
+  {
+    nvic_irq_enable((cap->tmr_x == TMR2) ? TMR2_GLOBAL_IRQn :
+                    (cap->tmr_x == TMR3) ? TMR3_GLOBAL_IRQn : TMR4_GLOBAL_IRQn, cap->priority, 0);
+  }
+
+  return SUCCESS;
+}
+
+/**
+  * @brief  start the counter and the capture rings, the time starts at 0.
+  * @param  cap: the handle points to the capture information.
+  * @retval none.
+  */
+void tmr_capture_start(tmr_capture_type *cap)
+{
+  tmr_capture_channel_type *ch;
+  uint8_t index;
+
+  cap->epoch = 0;
+  tmr_counter_value_set(cap->tmr_x, 0);
+  tmr_flag_clear(cap->tmr_x, TMR_OVF_FLAG | (TMR_C1_FLAG << (cap->mid_channel / 2)));
+
+  for(index = 0; index < cap->channel_num; index ++)
+  {
+    ch = &cap->ch[index];
+    ch->read = 0;
+    ch->batch = 0;
+    ch->last = 0;
+    ch->edges = 0;
+    ch->lost = 0;
+    ch->period_min = 0xFFFFFFFF;
+    ch->period_max = 0;
+    ch->period_sum = 0;
+    ch->period_count = 0;
+    ch->high_sum = 0;
+    ch->high_count = 0;
+    dma_app_start_stream(ch->hdma, (uint32_t)&cap->tmr_x->c1dt + (ch->channel / 2) * 4,
+                         (uint32_t)ch->ring, ch->ring_size);
+    tmr_channel_enable(cap->tmr_x, ch->channel, TRUE);
+  }
+
+  tmr_counter_enable(cap->tmr_x, TRUE);
+}
+
+/**
+  * @brief  stop the counter and the capture rings.
+  * @param  cap: the handle points to the capture information.
+  * @retval none.
+  */
+void tmr_capture_stop(tmr_capture_type *cap)
+{
+  uint8_t index;
+
+  tmr_counter_enable(cap->tmr_x, FALSE);
+  for(index = 0; index < cap->channel_num; index ++)
+  {
+    tmr_channel_enable(cap->tmr_x, cap->ch[index].channel, FALSE);
+    dma_app_stop(cap->ch[index].hdma);
+  }
+}
+
+/**
+  * @brief  get the current time on the capture time base.
+  * @param  cap: the handle points to the capture information.
+  * @retval counter ticks since tmr_capture_start.
+  */
+uint64_t tmr_capture_now(tmr_capture_type *cap)
+{
+  uint64_t epoch;
+  uint32_t primask;
+  uint16_t cnt;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  cnt = (uint16_t)tmr_counter_value_get(cap->tmr_x);
+  epoch = cap->epoch;
+  /* overflow not yet handled */
+  if(tmr_flag_get(cap->tmr_x, TMR_OVF_FLAG) != RESET)
+  {
+    cnt = (uint16_t)tmr_counter_value_get(cap->tmr_x);
+    epoch ++;
+  }
+  __set_PRIMASK(primask);
+
+  return (epoch << 16) | cnt;
+}
+
+/**
+  * @brief  get the statistics of a channel and start a new batch of them.
+  * @param  cap: the handle points to the capture information.
+  * @param  index: channel index in the handle.
+  * @param  stat: statistics since the previous call.
+  * @retval none.
+  */
+void tmr_capture_stat_get(tmr_capture_type *cap, uint8_t index, tmr_capture_stat_type *stat)
+{
+  tmr_capture_channel_type *ch = &cap->ch[index];
+  uint64_t period_sum, high_sum;
+  uint32_t high_count, primask;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  stat->edges = ch->edges;
+  stat->lost = ch->lost;
+  stat->period_count = ch->period_count;
+  stat->period_min = ch->period_min;
+  stat->period_max = ch->period_max;
+  period_sum = ch->period_sum;
+  high_sum = ch->high_sum;
+  high_count = ch->high_count;
+  ch->period_min = 0xFFFFFFFF;
+  ch->period_max = 0;
+  ch->period_sum = 0;
+  ch->period_count = 0;
+  ch->high_sum = 0;
+  ch->high_count = 0;
+  __set_PRIMASK(primask);
+
+  stat->period_mean = 0;
+  stat->frequency = 0;
+  stat->duty = 0;
+  if(stat->period_count != 0)
+  {
+    stat->period_mean = (float)period_sum / stat->period_count;
+    stat->frequency = (float)cap->clock / stat->period_mean;
+    if(high_count != 0)
+    {
+      stat->duty = ((float)high_sum / high_count) / stat->period_mean;
+    }
+  }
+  else
+  {
+    stat->period_min = 0;
+  }
+}
+
+/**
+  * @brief  timer interrupt handler, call it from the overflow interrupt of
+  *         the timer, for TMR1 from the channel interrupt too. the latency
+  *         must stay below half an overflow period.
+  * @param  cap: the handle points to the capture information.
+  * @retval none.
+  */
+void tmr_capture_irq_handler(tmr_capture_type *cap)
+{
+  tmr_capture_channel_type *ch;
+  uint32_t pos[TMR_CAPTURE_CHANNEL_MAX];
+  uint32_t mid_flag = TMR_C1_FLAG << (cap->mid_channel / 2);
+  uint64_t now;
+  uint8_t index, number, drain = 0;
+
+  if(tmr_interrupt_flag_get(cap->tmr_x, TMR_OVF_FLAG) != RESET)
+  {
+    tmr_flag_clear(cap->tmr_x, TMR_OVF_FLAG);
+    cap->epoch ++;
+    drain = 1;
+  }
+  if(tmr_interrupt_flag_get(cap->tmr_x, mid_flag) != RESET)
+  {
+    tmr_flag_clear(cap->tmr_x, mid_flag);
+    drain = 1;
+  }
+  if(drain == 0)
+  {
+    return;
+  }
+
+  /* ring positions first, every capture of the batch is older than now */
+  for(index = 0; index < cap->channel_num; index ++)
+  {
+    ch = &cap->ch[index];
+    pos[index] = ch->ring_size - dma_data_number_get(ch->hdma->channel);
+    if(pos[index] >= ch->ring_size)
+    {
+      pos[index] = 0;
+    }
+  }
+  now = tmr_capture_now(cap);
+
+  for(index = 0; index < cap->channel_num; index ++)
+  {
+    ch = &cap->ch[index];
+    number = (uint8_t)ch->channel / 2;
+    if(tmr_flag_get(cap->tmr_x, TMR_C1_RECAPTURE_FLAG << number) != RESET)
+    {
+      tmr_flag_clear(cap->tmr_x, TMR_C1_RECAPTURE_FLAG << number);
+      ch->lost ++;
+    }
+    tmr_capture_channel_process(cap, ch, pos[index], now);
+  }
+
+  for(index = 0; index < cap->channel_num; index ++)
+  {
+    ch = &cap->ch[index];
+    if(ch->duty_ref >= 0)
+    {
+      tmr_capture_duty_process(ch, &cap->ch[ch->duty_ref]);
+    }
+    if(cap->callback != 0 && ch->ts != 0 && ch->batch != 0)
+    {
+      cap->callback(cap, index, ch->ts, ch->batch);
+    }
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,157 @@
+/**
+  **************************************************************************
+  * @file     tmr_capture.h
+  * @brief    timer capture timestamp library header file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __TMR_CAPTURE_H
+#define __TMR_CAPTURE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "dma_application.h"
+
+/** @addtogroup AT32F402_405_middlewares_tmr_capture_library
+  * @{
+  */
+
+/** @defgroup TMR_capture_library_config
+  * @{
+  */
+
+#define TMR_CAPTURE_CHANNEL_MAX          3           /*!< capture channels of a timer, one compare
+                                                          channel stays free for the drain */
+
+/**
+  * @}
+  */
+
+/** @defgroup TMR_capture_library_types
+  * @{
+  */
+
+/**
+  * @brief capture statistics of a channel, returned by tmr_capture_stat_get
+  *        for the edges since the previous call
+  */
+typedef struct
+{
+  uint32_t                               edges;                   /*!< edges since the start           */
+  uint32_t                               lost;                    /*!< edges lost, capture overrun     */
+  uint32_t                               period_count;            /*!< periods in the batch            */
+  uint32_t                               period_min;              /*!< shortest period in ticks        */
+  uint32_t                               period_max;              /*!< longest period in ticks         */
+  float                                  period_mean;             /*!< mean period in ticks            */
+  float                                  frequency;               /*!< mean frequency in hz            */
+  float                                  duty;                    /*!< mean duty 0 to 1, 0 without a duty pair */
+} tmr_capture_stat_type;
+
+/**
+  * @brief capture channel, the fields up to duty_ref are filled in before
+  *        tmr_capture_init
+  */
+typedef struct
+{
+  tmr_channel_select_type                channel;                 /*!< timer channel                   */
+  tmr_input_polarity_type                polarity;                /*!< rising or falling edge          */
+  tmr_input_direction_mapped_type        mapped;                  /*!< direct or indirect input        */
+  uint8_t                                filter;                  /*!< input filter value              */
+  uint16_t                               *ring;                   /*!< dma ring of raw captures        */
+  uint16_t                               ring_size;               /*!< entries, more than the edges of one
+                                                                       overflow period                  */
+  uint64_t                               *ts;                     /*!< timestamps of a batch, ring_size entries,
+                                                                       can be 0                          */
+  int8_t                                 duty_ref;                /*!< index of the channel with the rising edges
+                                                                       of the same signal, -1 if none    */
+
+  dma_app_handle_type                    *hdma;                   /*!< ring channel                    */
+  uint16_t                               read;                    /*!< next ring entry to process      */
+  uint16_t                               batch;                   /*!< timestamps in the last batch    */
+  uint64_t                               last;                    /*!< last edge timestamp             */
+  uint64_t                               batch_last;              /*!< last edge before the batch      */
+  uint32_t                               edges;                   /*!< edges since the start           */
+  uint32_t                               lost;                    /*!< capture overruns                */
+  uint32_t                               period_min;              /*!< batch statistics                */
+  uint32_t                               period_max;
+  uint64_t                               period_sum;
+  uint32_t                               period_count;
+  uint64_t                               high_sum;
+  uint32_t                               high_count;
+} tmr_capture_channel_type;
+
+struct tmr_capture_struct;
+
+/**
+  * @brief batch callback, ts holds count timestamps of the channel
+  */
+typedef void (*tmr_capture_callback_type)(struct tmr_capture_struct *cap, uint8_t index, const uint64_t *ts, uint16_t count);
+
+/**
+  * @brief timer capture handle, the fields up to user are filled in before
+  *        tmr_capture_init
+  */
+typedef struct tmr_capture_struct
+{
+  tmr_type                               *tmr_x;                  /*!< TMR1, TMR2, TMR3 or TMR4, 16 bit counting */
+  uint32_t                               div;                     /*!< counter clock division          */
+  uint8_t                                channel_num;             /*!< channels in use                 */
+  tmr_capture_channel_type               ch[TMR_CAPTURE_CHANNEL_MAX]; /*!< capture channels            */
+  tmr_capture_callback_type              callback;                /*!< batch callback, in interrupt, can be 0 */
+  uint8_t                                priority;                /*!< timer and dma interrupt preemption priority */
+  void                                   *user;                   /*!< user data for the callback      */
+
+  uint32_t                               clock;                   /*!< counter clock in hz             */
+  uint64_t                               epoch;                   /*!< counter overflows               */
+  tmr_channel_select_type                mid_channel;             /*!< compare channel of the mid period drain */
+} tmr_capture_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup TMR_capture_library_exported_functions
+  * @{
+  */
+
+error_status tmr_capture_init            (tmr_capture_type *cap);
+void         tmr_capture_start           (tmr_capture_type *cap);
+void         tmr_capture_stop            (tmr_capture_type *cap);
+uint64_t     tmr_capture_now             (tmr_capture_type *cap);
+void         tmr_capture_stat_get        (tmr_capture_type *cap, uint8_t index, tmr_capture_stat_type *stat);
+void         tmr_capture_irq_handler     (tmr_capture_type *cap);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
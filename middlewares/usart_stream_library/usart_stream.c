@@ -0,0 +1,398 @@
+/**
+  **************************************************************************
+  * @file     usart_stream.c
+  * @brief    usart dma stream library source file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "usart_stream.h"
+#include <string.h>
+
+/** @addtogroup AT32F402_405_middlewares_usart_stream_library
+  * @{
+  */
+
+/** @defgroup USART_stream_library
+  * @brief circular dma reception with idle line or receiver timeout framing
+  *        and queued dma transmission. received bytes are never copied, the
+  *        application gets views into the receive ring and releases them
+  *        when done. the cpu only takes the half/full ring interrupts and
+  *        one interrupt per frame, there is no per byte interrupt.
+  * @{
+  */
+
+static void usart_stream_rx_event(dma_app_handle_type *hdma, uint32_t event);
+static void usart_stream_tx_event(dma_app_handle_type *hdma, uint32_t event);
+
+/**
+  * @brief  account the bytes written by the receive channel since the last
+  *         update. the half/full interrupts bound the distance between two
+  *         updates to half of the ring, so the position difference is exact.
+  * @param  st: the handle points to the stream information.
+  * @retval none.
+  */
+static void usart_stream_rx_update(usart_stream_type *st)
+{
+  uint32_t primask, pos;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  pos = st->rx_size - dma_data_number_get(st->rx_dma->channel);
+  pos &= st->rx_size - 1;
+
+  st->rx_total += (pos - st->rx_pos) & (st->rx_size - 1);
+  st->rx_pos = pos;
+
+  if(st->rx_total - st->rx_released > st->rx_size)
+  {
+    /* the ring has overtaken frames not yet released */
+    st->stat.overruns ++;
+    st->rx_released = st->rx_total - st->rx_size;
+  }
+
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  close the open frame at the current receive position.
+  * @param  st: the handle points to the stream information.
+  * @retval none.
+  */
+static void usart_stream_frame_close(usart_stream_type *st)
+{
+  uint32_t length, index;
+
+  usart_stream_rx_update(st);
+
+  length = st->rx_total - st->rx_open;
+  if(length == 0)
+  {
+    return;
+  }
+
+  if(st->frame_head - st->frame_tail >= USART_STREAM_FRAME_NUM || length > st->rx_size)
+  {
+    st->stat.frame_drops ++;
+  }
+  else
+  {
+    index = st->frame_head & (USART_STREAM_FRAME_NUM - 1);
+    st->frame_start[index] = st->rx_open;
+    st->frame_size[index] = (uint16_t)length;
+    st->frame_head ++;
+    st->stat.frames ++;
+  }
+
+  st->stat.bytes += length;
+  st->rx_open = st->rx_total;
+
+  if(st->rx_callback != 0)
+  {
+    st->rx_callback(st);
+  }
+}
+
+/**
+  * @brief  receive channel event, the ring is accounted at each half.
+  * @param  hdma: receive channel handle.
+  * @param  event: dma application events.
+  * @retval none.
+  */
+static void usart_stream_rx_event(dma_app_handle_type *hdma, uint32_t event)
+{
+  usart_stream_type *st = (usart_stream_type *)hdma->user;
+
+  if(event & DMA_APP_EVENT_ERROR)
+  {
+    return;
+  }
+
+  usart_stream_rx_update(st);
+}
+
+/**
+  * @brief  transmit channel event, the next segment is started before the
+  *         callback of the finished one runs.
+  * @param  hdma: transmit channel handle.
+  * @param  event: dma application events.
+  * @retval none.
+  */
+static void usart_stream_tx_event(dma_app_handle_type *hdma, uint32_t event)
+{
+  usart_stream_type *st = (usart_stream_type *)hdma->user;
+  usart_stream_seg_type *seg = st->tx_head;
+
+  if(seg == 0)
+  {
+    return;
+  }
+
+  st->tx_head = seg->next;
+  if(st->tx_head == 0)
+  {
+    st->tx_tail = 0;
+  }
+  else
+  {
+    dma_app_start(st->tx_dma, (uint32_t)&st->usart_x->dt, (uint32_t)st->tx_head->pdata, st->tx_head->length);
+  }
+
+  seg->next = 0;
+  if(seg->callback != 0)
+  {
+    seg->callback(seg);
+  }
+}
+
+/**
+  * @brief  initialize the stream and start the circular reception. the usart
+  *         must be configured and enabled, its interrupt enabled in nvic and
+  *         dma_app_init called before.
+  * @param  st: the handle points to the stream information.
+  * @param  usart_x: usart or uart peripheral.
+  * @param  rx_req: dmamux request of the usart receiver.
+  * @param  tx_req: dmamux request of the usart transmitter.
+  * @param  rx_buf: receive ring.
+  * @param  rx_size: receive ring size, power of 2, at least twice the longest frame.
+  * @param  timeout_bits: 0 to delimit frames on idle line, otherwise
+  *         the receiver timeout in bit times.
+  * @param  priority: dma channel interrupt preemption priority.
+  * @retval ERROR if no dma channel is free or the ring size is invalid.
+  */
+error_status usart_stream_init(usart_stream_type *st, usart_type *usart_x, dmamux_requst_id_sel_type rx_req, dmamux_requst_id_sel_type tx_req,
+                               uint8_t *rx_buf, uint16_t rx_size, uint32_t timeout_bits, uint8_t priority)
+{
+  dma_init_type dma_init_struct;
+
+  if(rx_size < 2 || (rx_size & (rx_size - 1)) != 0)
+  {
+    return ERROR;
+  }
+
+  memset(st, 0, sizeof(usart_stream_type));
+  st->usart_x = usart_x;
+  st->rx_buf = rx_buf;
+  st->rx_size = rx_size;
+
+  dma_default_para_init(&dma_init_struct);
+  dma_init_struct.memory_inc_enable = TRUE;
+  dma_init_struct.peripheral_inc_enable = FALSE;
+  dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_BYTE;
+  dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_BYTE;
+  dma_init_struct.priority = DMA_PRIORITY_VERY_HIGH;
+  dma_init_struct.direction = DMA_DIR_PERIPHERAL_TO_MEMORY;
+  st->rx_dma = dma_app_channel_alloc(rx_req, &dma_init_struct, usart_stream_rx_event, priority);
+
+  dma_init_struct.priority = DMA_PRIORITY_MEDIUM;
+  dma_init_struct.direction = DMA_DIR_MEMORY_TO_PERIPHERAL;
+  st->tx_dma = dma_app_channel_alloc(tx_req, &dma_init_struct, usart_stream_tx_event, priority);
+
+  if(st->rx_dma == 0 || st->tx_dma == 0)
+  {
+    if(st->rx_dma != 0)
+    {
+      dma_app_channel_free(st->rx_dma);
+    }
+    if(st->tx_dma != 0)
+    {
+      dma_app_channel_free(st->tx_dma);
+    }
+    return ERROR;
+  }
+  st->rx_dma->user = st;
+  st->tx_dma->user = st;
+
+  usart_dma_receiver_enable(usart_x, TRUE);
+  usart_dma_transmitter_enable(usart_x, TRUE);
+  dma_app_start_stream(st->rx_dma, (uint32_t)&usart_x->dt, (uint32_t)rx_buf, rx_size);
+
+  if(timeout_bits != 0)
+  {
+    usart_receiver_timeout_value_set(usart_x, timeout_bits);
+    usart_receiver_timeout_detection_enable(usart_x, TRUE);
+    usart_flag_clear(usart_x, USART_RTODF_FLAG);
+    usart_interrupt_enable(usart_x, USART_RTOD_INT, TRUE);
+  }
+  else
+  {
+    usart_flag_clear(usart_x, USART_IDLEF_FLAG);
+    usart_interrupt_enable(usart_x, USART_IDLE_INT, TRUE);
+  }
+  usart_interrupt_enable(usart_x, USART_ERR_INT, TRUE);
+
+  return SUCCESS;
+}
+
+/**
+  * @brief  get the oldest received frame without removing it. the view is
+  *         valid until usart_stream_frame_release, provided the ring has not
+  *         overtaken it, see stat.overruns.
+  * @param  st: the handle points to the stream information.
+  * @param  frame: frame view.
+  * @retval ERROR if no frame is waiting.
+  */
+error_status usart_stream_frame_get(usart_stream_type *st, usart_stream_frame_type *frame)
+{
+  uint32_t index, offset, length;
+
+  while(st->frame_head != st->frame_tail)
+  {
+    index = st->frame_tail & (USART_STREAM_FRAME_NUM - 1);
+
+    if(st->rx_total - st->frame_start[index] > st->rx_size)
+    {
+      /* overwritten while waiting in the fifo */
+      st->frame_tail ++;
+      continue;
+    }
+
+    offset = st->frame_start[index] & (st->rx_size - 1);
+    length = st->frame_size[index];
+
+    frame->size = (uint16_t)length;
+    frame->pdata[0] = &st->rx_buf[offset];
+    frame->pdata[1] = st->rx_buf;
+    if(offset + length > st->rx_size)
+    {
+      frame->length[0] = (uint16_t)(st->rx_size - offset);
+      frame->length[1] = (uint16_t)(length - frame->length[0]);
+    }
+    else
+    {
+      frame->length[0] = (uint16_t)length;
+      frame->length[1] = 0;
+    }
+    return SUCCESS;
+  }
+
+  return ERROR;
+}
+
+/**
+  * @brief  release the oldest received frame, its ring space can be reused.
+  * @param  st: the handle points to the stream information.
+  * @retval none.
+  */
+void usart_stream_frame_release(usart_stream_type *st)
+{
+  uint32_t index, primask, end;
+
+  if(st->frame_head == st->frame_tail)
+  {
+    return;
+  }
+
+  index = st->frame_tail & (USART_STREAM_FRAME_NUM - 1);
+  end = st->frame_start[index] + st->frame_size[index];
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  if((int32_t)(end - st->rx_released) > 0)
+  {
+    st->rx_released = end;
+  }
+  __set_PRIMASK(primask);
+
+  st->frame_tail ++;
+}
+
+/**
+  * @brief  queue a segment for transmission, segments are sent back to back
+  *         in submission order.
+  * @param  st: the handle points to the stream information.
+  * @param  seg: segment, must not be queued already.
+  * @retval ERROR if the segment is empty, a dma transfer of no data never
+  *         completes and would stall the queue.
+  */
+error_status usart_stream_send(usart_stream_type *st, usart_stream_seg_type *seg)
+{
+  uint32_t primask;
+
+  if(seg->length == 0)
+  {
+    return ERROR;
+  }
+  seg->next = 0;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  if(st->tx_tail != 0)
+  {
+    st->tx_tail->next = seg;
+    st->tx_tail = seg;
+  }
+  else
+  {
+    st->tx_head = seg;
+    st->tx_tail = seg;
+    dma_app_start(st->tx_dma, (uint32_t)&st->usart_x->dt, (uint32_t)seg->pdata, seg->length);
+  }
+  __set_PRIMASK(primask);
+
+  return SUCCESS;
+}
+
+/**
+  * @brief  check the transmit queue.
+  * @param  st: the handle points to the stream information.
+  * @retval SET while segments are queued.
+  */
+flag_status usart_stream_tx_busy(usart_stream_type *st)
+{
+  return (st->tx_head != 0) ? SET : RESET;
+}
+
+/**
+  * @brief  usart interrupt handler, call it from the usart irq handler.
+  *         the end of a frame is the idle line or the receiver timeout.
+  * @param  st: the handle points to the stream information.
+  * @retval none.
+  */
+void usart_stream_irq_handler(usart_stream_type *st)
+{
+  usart_type *usart_x = st->usart_x;
+
+  if(usart_x->sts & (USART_FERR_FLAG | USART_NERR_FLAG | USART_ROERR_FLAG))
+  {
+    st->stat.line_errors ++;
+    usart_flag_clear(usart_x, USART_ROERR_FLAG);
+  }
+
+  if(usart_x->ctrl1_bit.idleien && usart_flag_get(usart_x, USART_IDLEF_FLAG) != RESET)
+  {
+    usart_flag_clear(usart_x, USART_IDLEF_FLAG);
+    usart_stream_frame_close(st);
+  }
+
+  if(usart_x->ctrl1_bit.retodie && usart_flag_get(usart_x, USART_RTODF_FLAG) != RESET)
+  {
+    usart_flag_clear(usart_x, USART_RTODF_FLAG);
+    usart_stream_frame_close(st);
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
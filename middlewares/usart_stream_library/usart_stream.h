@@ -0,0 +1,149 @@
+/**
+  **************************************************************************
+  * @file     usart_stream.h
+  * @brief    usart dma stream library header file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __USART_STREAM_H
+#define __USART_STREAM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "dma_application.h"
+
+/** @addtogroup AT32F402_405_middlewares_usart_stream_library
+  * @{
+  */
+
+/** @defgroup USART_stream_library_config
+  * @{
+  */
+
+#define USART_STREAM_FRAME_NUM           8           /*!< received frames waiting for the application, power of 2 */
+
+/**
+  * @}
+  */
+
+/** @defgroup USART_stream_library_types
+  * @{
+  */
+
+/**
+  * @brief received frame view, a frame crossing the end of the ring is
+  *        returned as two segments, length[1] is 0 otherwise
+  */
+typedef struct
+{
+  uint8_t                                *pdata[2];               /*!< segment start in the receive ring */
+  uint16_t                               length[2];               /*!< segment length                  */
+  uint16_t                               size;                    /*!< frame length                    */
+} usart_stream_frame_type;
+
+struct usart_stream_seg_struct;
+
+typedef void (*usart_stream_seg_callback_type)(struct usart_stream_seg_struct *seg);
+
+/**
+  * @brief transmit segment, the data must stay valid until the callback
+  */
+typedef struct usart_stream_seg_struct
+{
+  const uint8_t                          *pdata;                  /*!< segment data                    */
+  uint16_t                               length;                  /*!< segment length                  */
+  usart_stream_seg_callback_type         callback;                /*!< segment sent, in interrupt, can be 0 */
+  void                                   *user;                   /*!< user data for the callback      */
+  struct usart_stream_seg_struct         *next;                   /*!< next queued segment             */
+} usart_stream_seg_type;
+
+/**
+  * @brief usart stream statistics
+  */
+typedef struct
+{
+  uint32_t                               frames;                  /*!< frames delimited                */
+  uint32_t                               bytes;                   /*!< bytes received                  */
+  uint32_t                               frame_drops;             /*!< frames lost, frame fifo full    */
+  uint32_t                               overruns;                /*!< data overwritten before release */
+  uint32_t                               line_errors;             /*!< framing, noise and overflow errors */
+} usart_stream_stat_type;
+
+struct usart_stream_struct;
+
+typedef void (*usart_stream_callback_type)(struct usart_stream_struct *st);
+
+/**
+  * @brief usart stream handle
+  */
+typedef struct usart_stream_struct
+{
+  usart_type                             *usart_x;                /*!< usart, configured by the user   */
+  dma_app_handle_type                    *rx_dma;                 /*!< circular receive channel        */
+  dma_app_handle_type                    *tx_dma;                 /*!< transmit channel                */
+  uint8_t                                *rx_buf;                 /*!< receive ring                    */
+  uint16_t                               rx_size;                 /*!< receive ring size, power of 2   */
+  uint16_t                               rx_pos;                  /*!< dma position at the last update */
+  uint32_t                               rx_total;                /*!< free running received count     */
+  uint32_t                               rx_open;                 /*!< received count at the open frame start */
+  uint32_t                               rx_released;             /*!< received count released by the application */
+  uint32_t                               frame_start[USART_STREAM_FRAME_NUM]; /*!< frame fifo, start count */
+  uint16_t                               frame_size[USART_STREAM_FRAME_NUM];  /*!< frame fifo, length      */
+  __IO uint32_t                          frame_head;              /*!< frame fifo write index, interrupt */
+  __IO uint32_t                          frame_tail;              /*!< frame fifo read index, application */
+  usart_stream_seg_type                  *tx_head;                /*!< segment in transfer             */
+  usart_stream_seg_type                  *tx_tail;                /*!< last queued segment             */
+  usart_stream_callback_type             rx_callback;             /*!< frame received, in interrupt, can be 0 */
+  usart_stream_stat_type                 stat;                    /*!< statistics                      */
+} usart_stream_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup USART_stream_library_exported_functions
+  * @{
+  */
+
+error_status usart_stream_init            (usart_stream_type *st, usart_type *usart_x, dmamux_requst_id_sel_type rx_req, dmamux_requst_id_sel_type tx_req,
+                                           uint8_t *rx_buf, uint16_t rx_size, uint32_t timeout_bits, uint8_t priority);
+error_status usart_stream_frame_get       (usart_stream_type *st, usart_stream_frame_type *frame);
+void         usart_stream_frame_release   (usart_stream_type *st);
+error_status usart_stream_send            (usart_stream_type *st, usart_stream_seg_type *seg);
+flag_status  usart_stream_tx_busy         (usart_stream_type *st);
+void         usart_stream_irq_handler     (usart_stream_type *st);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -123,6 +123,45 @@ typedef struct
   void         *pdata;                                               /*!< usb class data pointer */
 }usbd_class_handler;
 
+#ifdef USBD_PERF_STATISTICS
+/**
+  * @brief usb device read cycle counter, dwt cycle counter is used unless
+  *        usb_conf.h provides another counter
+  */
+#ifndef USBD_PERF_CYCLES
+#define USBD_PERF_CYCLES()                (DWT->CYCCNT)
+#endif
+
+/**
+  * @brief usb device endpoint statistics struct
+  */
+typedef struct
+{
+  uint32_t                               xfer_count;                 /*!< number of completed transfers */
+  uint32_t                               pkt_count;                  /*!< number of packets moved through fifo */
+  uint32_t                               bytes;                      /*!< number of bytes moved through fifo */
+  uint32_t                               fifo_cycles;                /*!< cpu cycles spent in fifo read/write */
+  uint32_t                               xfer_cycles;                /*!< cycles from start to end of the last transfer */
+  uint32_t                               xfer_start;                 /*!< cycle count of the current transfer start */
+}usbd_ept_perf_type;
+
+/**
+  * @brief usb device performance statistics struct
+  */
+typedef struct
+{
+  uint32_t                               irq_count;                  /*!< number of usb interrupts */
+  uint32_t                               irq_cycles;                 /*!< total cpu cycles in usb interrupt */
+  uint32_t                               irq_max_cycles;             /*!< max cpu cycles of one usb interrupt */
+  uint32_t                               rxflvl_count;               /*!< number of rx fifo non-empty interrupt */
+  uint32_t                               inept_count;                /*!< number of in endpoint interrupt */
+  uint32_t                               outept_count;               /*!< number of out endpoint interrupt */
+  uint32_t                               sof_count;                  /*!< number of sof interrupt */
+  usbd_ept_perf_type                     ept_in[USB_EPT_MAX_NUM];    /*!< in endpoint statistics */
+  usbd_ept_perf_type                     ept_out[USB_EPT_MAX_NUM];   /*!< out endpoint statistics */
+}usbd_perf_type;
+#endif
+
 /**
   * @brief usb device core struct type
   */
@@ -153,6 +192,9 @@ typedef struct
   uint32_t                               config_status;              /*!< usb configure status */
   uint32_t                               dma_en;                     /*!< usb dma enable */
   uint8_t                                test_mode;
+#ifdef USBD_PERF_STATISTICS
+  usbd_perf_type                         perf;                       /*!< usb performance statistics */
+#endif
 }usbd_core_type;
 
 void usbd_core_in_handler(usbd_core_type *udev, uint8_t ept_num);
@@ -181,6 +223,9 @@ void usbd_remote_wakeup(usbd_core_type *udev);
 void usbd_enter_suspend(usbd_core_type *udev);
 void usbd_flush_tx_fifo(usbd_core_type *udev, uint8_t ept_num);
 void usbd_fifo_alloc(usbd_core_type *udev);
+#ifdef USBD_PERF_STATISTICS
+void usbd_perf_reset(usbd_core_type *udev);
+#endif
 usb_sts_type usbd_core_init(usbd_core_type *udev,
                             usb_reg_type *usb_reg,
                             usbd_class_handler *class_handler,
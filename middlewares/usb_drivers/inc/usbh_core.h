@@ -172,6 +172,42 @@ typedef enum
 #define HCH_ERROR                        0xFFFF      /*!< usb channel error */
 #define HCH_USED_MASK                    0x7FFF      /*!< usb channel use mask */
 
+#ifdef USBH_CHANNEL_SCHEDULER
+/**
+  * @brief  usb host channel scheduler config
+  */
+#ifndef USBH_PERIODIC_CHANNEL_NUM
+#define USBH_PERIODIC_CHANNEL_NUM        4           /*!< channels reserved for interrupt and isochronous endpoints */
+#endif
+#ifndef USBH_BULK_RETRY_PER_FRAME
+#define USBH_BULK_RETRY_PER_FRAME        8           /*!< bulk nak retries started per (micro)frame */
+#endif
+
+/**
+  * @brief usb host channel utilization counters
+  */
+typedef struct
+{
+  uint32_t                               xfer_count;                     /*!< completed transfers */
+  uint32_t                               bytes;                          /*!< transferred bytes */
+  uint32_t                               nak_count;                      /*!< nak retries */
+  uint32_t                               defer_count;                    /*!< retries deferred to the next frame */
+  uint32_t                               busy_frames;                    /*!< frames with the channel enabled */
+} usbh_hch_stat_type;
+
+/**
+  * @brief usb host channel scheduler type
+  */
+typedef struct
+{
+  uint32_t                               frame;                          /*!< frame counter */
+  uint32_t                               bulk_retry;                     /*!< bulk retries left in this frame */
+  uint8_t                                rr_index;                       /*!< round robin start channel */
+  uint8_t                                pending[USB_HOST_CHANNEL_NUM];  /*!< retry waits for the next frame */
+  usbh_hch_stat_type                     stat[USB_HOST_CHANNEL_NUM];     /*!< channel counters */
+} usbh_sched_type;
+#endif
+
 /**
   * @brief  channel pid
   */
@@ -245,6 +281,9 @@ typedef struct
   uint32_t                               timer;                          /*!< transfer timer */
   ctrl_sts_type                          sts;                            /*!< control transfer status */
   ctrl_ept0_sts_type                     state;                          /*!< endpoint 0 state */
+#ifdef USBH_CTRL_EVENT
+  void (*complete)(void *uhost, usb_sts_type status);                    /*!< control request complete callback */
+#endif
 } usbh_ctrl_type;
 
 /**
@@ -309,6 +348,9 @@ typedef struct
   hch_sts_type                           hch_state[USB_HOST_CHANNEL_NUM];/*!< channel state */
   urb_sts_type                           urb_state[USB_HOST_CHANNEL_NUM];/*!< usb request state */
   uint16_t                               channel[USB_HOST_CHANNEL_NUM];  /*!< channel array */
+#ifdef USBH_CHANNEL_SCHEDULER
+  usbh_sched_type                        sched;                          /*!< channel scheduler */
+#endif
 } usbh_core_type;
 
 
@@ -333,6 +375,12 @@ void usbh_enter_suspend(usbh_core_type *uhost);
 void usbh_resume(usbh_core_type *uhost);
 
 uint16_t usbh_alloc_channel(usbh_core_type *uhost, uint8_t ept_addr);
+uint16_t usbh_alloc_periodic_channel(usbh_core_type *uhost, uint8_t ept_addr);
+#ifdef USBH_CHANNEL_SCHEDULER
+void usbh_sched_reset(usbh_core_type *uhost);
+void usbh_sched_retry(usbh_core_type *uhost, uint8_t chn);
+void usbh_sched_sof(usbh_core_type *uhost);
+#endif
 urb_sts_type usbh_get_urb_status(usbh_core_type *uhost, uint8_t ch_num);
 usb_sts_type usbh_ctrl_result_check(usbh_core_type *uhost,
                                     ctrl_ept0_sts_type next_ctrl_state,
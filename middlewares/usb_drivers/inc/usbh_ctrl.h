@@ -67,6 +67,11 @@ usb_sts_type usbh_ctrl_stall_handler(usbh_core_type *uhost);
 usb_sts_type usbh_ctrl_complete_handler(usbh_core_type *uhost);
 usb_sts_type usbh_ctrl_transfer_loop(usbh_core_type *uhost);
 usb_sts_type usbh_ctrl_request(usbh_core_type *uhost, uint8_t *buffer, uint16_t length);
+#ifdef USBH_CTRL_EVENT
+usb_sts_type usbh_ctrl_request_cb(usbh_core_type *uhost, uint8_t *buffer, uint16_t length,
+                                  void (*complete)(void *uhost, usb_sts_type status));
+void usbh_ctrl_event_handler(usbh_core_type *uhost, uint8_t chn);
+#endif
 usb_sts_type usbh_get_descriptor(usbh_core_type *uhost, uint16_t length,
                             uint8_t req_type, uint16_t wvalue,
                             uint8_t *buffer);
@@ -507,6 +507,9 @@ void usbd_ept_send(usbd_core_type *udev, uint8_t ept_addr, uint8_t *buffer, uint
   ept_info->trans_buf = buffer;
   ept_info->total_len = len;
   ept_info->trans_len = 0;
+#ifdef USBD_PERF_STATISTICS
+  udev->perf.ept_in[ept_info->eptn].xfer_start = USBD_PERF_CYCLES();
+#endif
 
   /* transfer data len is zero */
   if(ept_info->total_len == 0)
@@ -623,6 +626,9 @@ void usbd_ept_recv(usbd_core_type *udev, uint8_t ept_addr, uint8_t *buffer, uint
   ept_info->trans_buf = buffer;
   ept_info->total_len = len;
   ept_info->trans_len = 0;
+#ifdef USBD_PERF_STATISTICS
+  udev->perf.ept_out[ept_info->eptn].xfer_start = USBD_PERF_CYCLES();
+#endif
 
   if((ept_addr & 0x7F) == 0 && len > 0)
   {
@@ -814,6 +820,29 @@ void usbd_fifo_alloc(usbd_core_type *udev)
 #endif
 }
 
+#ifdef USBD_PERF_STATISTICS
+/**
+  * @brief  usb device performance statistics reset, the dwt cycle
+  *         counter is enabled and all counters are cleared
+  * @param  udev: to the structure of usbd_core_type
+  * @retval none
+  */
+void usbd_perf_reset(usbd_core_type *udev)
+{
+  uint8_t *pbuf = (uint8_t *)&udev->perf;
+  uint32_t i_index;
+
+  /* enable dwt cycle counter */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  for(i_index = 0; i_index < sizeof(usbd_perf_type); i_index ++)
+  {
+    pbuf[i_index] = 0;
+  }
+}
+#endif
+
 /**
   * @brief  usb device core initialization
   * @param  udev: to the structure of usbd_core_type
@@ -859,6 +888,11 @@ usb_sts_type usbd_core_init(usbd_core_type *udev,
   udev->desc_handler = desc_handler;
   udev->test_mode = 0;
 
+#ifdef USBD_PERF_STATISTICS
+  /* enable cycle counter and clear statistics */
+  usbd_perf_reset(udev);
+#endif
+
   /* set device disconnect */
   usbd_disconnect(udev);
 
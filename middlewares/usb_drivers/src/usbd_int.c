@@ -52,6 +52,9 @@ void usbd_irq_handler(otg_core_type *otgdev)
   otg_global_type *usbx = otgdev->usb_reg;
   usbd_core_type *udev = &otgdev->dev;
   uint32_t intsts = usb_global_get_all_interrupt(usbx);
+#ifdef USBD_PERF_STATISTICS
+  uint32_t cycles = USBD_PERF_CYCLES();
+#endif
 
   /* check current device mode */
   if(usbx->gintsts_bit.curmode == 0)
@@ -140,6 +143,31 @@ void usbd_irq_handler(otg_core_type *otgdev)
       usb_global_clear_interrupt(usbx, USB_OTG_USBSUSP_FLAG);
     }
   }
+#ifdef USBD_PERF_STATISTICS
+  cycles = USBD_PERF_CYCLES() - cycles;
+  udev->perf.irq_count ++;
+  udev->perf.irq_cycles += cycles;
+  if(cycles > udev->perf.irq_max_cycles)
+  {
+    udev->perf.irq_max_cycles = cycles;
+  }
+  if(intsts & USB_OTG_RXFLVL_FLAG)
+  {
+    udev->perf.rxflvl_count ++;
+  }
+  if(intsts & USB_OTG_IEPT_FLAG)
+  {
+    udev->perf.inept_count ++;
+  }
+  if(intsts & USB_OTG_OEPT_FLAG)
+  {
+    udev->perf.outept_count ++;
+  }
+  if(intsts & USB_OTG_SOF_FLAG)
+  {
+    udev->perf.sof_count ++;
+  }
+#endif
 }
 
 /**
@@ -154,6 +182,10 @@ void usb_write_empty_txfifo(usbd_core_type *udev, uint32_t ept_num)
   usb_ept_info *ept_info = &udev->ept_in[ept_num];
   uint32_t length = ept_info->total_len - ept_info->trans_len;
   uint32_t wlen = 0;
+#ifdef USBD_PERF_STATISTICS
+  usbd_ept_perf_type *ept_perf = &udev->perf.ept_in[ept_num];
+  uint32_t cycles;
+#endif
 
   if(length > ept_info->maxpacket)
   {
@@ -170,7 +202,15 @@ void usb_write_empty_txfifo(usbd_core_type *udev, uint32_t ept_num)
       length = ept_info->maxpacket;
     }
     wlen = (length + 3) / 4;
+#ifdef USBD_PERF_STATISTICS
+    cycles = USBD_PERF_CYCLES();
     usb_write_packet(usbx, ept_info->trans_buf, ept_num, length);
+    ept_perf->fifo_cycles += USBD_PERF_CYCLES() - cycles;
+    ept_perf->pkt_count ++;
+    ept_perf->bytes += length;
+#else
+    usb_write_packet(usbx, ept_info->trans_buf, ept_num, length);
+#endif
 
     ept_info->trans_buf += length;
     ept_info->trans_len += length;
@@ -210,6 +250,10 @@ void usbd_inept_handler(usbd_core_type *udev)
       {
         OTG_DEVICE(usbx)->diepempmsk &= ~(1 << ept_num);
         usb_ept_in_clear(usbx, ept_num , USB_OTG_DIEPINT_XFERC_FLAG);
+#ifdef USBD_PERF_STATISTICS
+        udev->perf.ept_in[ept_num].xfer_count ++;
+        udev->perf.ept_in[ept_num].xfer_cycles = USBD_PERF_CYCLES() - udev->perf.ept_in[ept_num].xfer_start;
+#endif
 #ifdef OTG_USE_DMA
         if(udev->dma_en == TRUE)
         {
@@ -291,6 +335,10 @@ void usbd_outept_handler(usbd_core_type *udev)
       {
         usb_ept_out_clear(usbx, ept_num , USB_OTG_DOEPINT_XFERC_FLAG);
         epsts = USB_OUTEPT(usbx, ept_num)->doepint;
+#ifdef USBD_PERF_STATISTICS
+        udev->perf.ept_out[ept_num].xfer_count ++;
+        udev->perf.ept_out[ept_num].xfer_cycles = USBD_PERF_CYCLES() - udev->perf.ept_out[ept_num].xfer_start;
+#endif
 #ifdef OTG_USE_DMA        
         if (udev->dma_en == TRUE)
         {
@@ -443,6 +491,10 @@ void usbd_rxflvl_handler(usbd_core_type *udev)
   uint32_t count;
   uint32_t pktsts;
   usb_ept_info *ept_info;
+#ifdef USBD_PERF_STATISTICS
+  usbd_ept_perf_type *ept_perf;
+  uint32_t cycles;
+#endif
 
   /* disable rxflvl interrupt */
   usb_global_interrupt_enable(usbx, USB_OTG_RXFLVL_INT, FALSE);
@@ -465,7 +517,16 @@ void usbd_rxflvl_handler(usbd_core_type *udev)
     if(count != 0)
     {
       /* read packet to buffer */
+#ifdef USBD_PERF_STATISTICS
+      ept_perf = &udev->perf.ept_out[stsp & USB_OTG_GRXSTSP_EPTNUM];
+      cycles = USBD_PERF_CYCLES();
       usb_read_packet(usbx, ept_info->trans_buf, (stsp & USB_OTG_GRXSTSP_EPTNUM), count);
+      ept_perf->fifo_cycles += USBD_PERF_CYCLES() - cycles;
+      ept_perf->pkt_count ++;
+      ept_perf->bytes += count;
+#else
+      usb_read_packet(usbx, ept_info->trans_buf, (stsp & USB_OTG_GRXSTSP_EPTNUM), count);
+#endif
       ept_info->trans_buf += count;
       ept_info->trans_len += count;
 
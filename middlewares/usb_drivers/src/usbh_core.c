@@ -58,6 +58,9 @@ void usbh_free_channel(usbh_core_type *uhost, uint8_t index)
   {
     /* free host channel */
     uhost->channel[index] = 0x0;
+#ifdef USBH_CHANNEL_SCHEDULER
+    uhost->sched.pending[index] = 0;
+#endif
   }
 }
 
@@ -69,7 +72,12 @@ void usbh_free_channel(usbh_core_type *uhost, uint8_t index)
 uint16_t usbh_get_free_channel(usbh_core_type *uhost)
 {
   uint16_t i_index = 0;
+#ifdef USBH_CHANNEL_SCHEDULER
+  /* the last channels are kept for periodic endpoints */
+  for(i_index = 0; i_index < USB_HOST_CHANNEL_NUM - USBH_PERIODIC_CHANNEL_NUM; i_index ++)
+#else
   for(i_index = 0; i_index < USB_HOST_CHANNEL_NUM; i_index ++)
+#endif
   {
     /* find unuse channel */
     if((uhost->channel[i_index] & HCH_USED) == 0)
@@ -125,6 +133,9 @@ usb_sts_type usbh_in_out_request(usbh_core_type *uhost, uint8_t hc_num)
 
   /* set usb channel transmit count to zero */
   uhost->hch[hc_num].trans_count = 0;
+#ifdef USBH_CHANNEL_SCHEDULER
+  uhost->sched.pending[hc_num] = 0;
+#endif
 #ifdef USB_OTG_HS
   if(uhost->hch[hc_num].speed == USB_HIGH_SPEED)
   {
@@ -466,6 +477,10 @@ usb_sts_type usbh_cfg_default_init(usbh_core_type *uhost)
 
   uhost->ctrl.err_cnt = 0;
 
+#ifdef USBH_CHANNEL_SCHEDULER
+  usbh_sched_reset(uhost);
+#endif
+
   /* free all channel */
   usbh_free_channel(uhost, uhost->ctrl.hch_in);
   usbh_free_channel(uhost, uhost->ctrl.hch_out);
@@ -766,6 +781,107 @@ uint16_t usbh_alloc_channel(usbh_core_type *uhost, uint8_t ept_addr)
   return ch_num;
 }
 
+/**
+  * @brief  usb host alloc channel for interrupt or isochronous endpoint,
+  *         with the channel scheduler the reserved channels are used first
+  * @param  uhost: to the structure of usbh_core_type
+  * @param  ept_addr: endpoint address
+  * @retval channel number
+  */
+uint16_t usbh_alloc_periodic_channel(usbh_core_type *uhost, uint8_t ept_addr)
+{
+#ifdef USBH_CHANNEL_SCHEDULER
+  uint16_t i_index;
+  for(i_index = USB_HOST_CHANNEL_NUM - USBH_PERIODIC_CHANNEL_NUM; i_index < USB_HOST_CHANNEL_NUM; i_index ++)
+  {
+    if((uhost->channel[i_index] & HCH_USED) == 0)
+    {
+      uhost->channel[i_index] = HCH_USED | ept_addr;
+      return i_index;
+    }
+  }
+#endif
+  return usbh_alloc_channel(uhost, ept_addr);
+}
+
+#ifdef USBH_CHANNEL_SCHEDULER
+/**
+  * @brief  usb host channel scheduler reset, counters are cleared
+  * @param  uhost: to the structure of usbh_core_type
+  * @retval none
+  */
+void usbh_sched_reset(usbh_core_type *uhost)
+{
+  uint8_t *pdata = (uint8_t *)&uhost->sched;
+  uint32_t i_index;
+  for(i_index = 0; i_index < sizeof(usbh_sched_type); i_index ++)
+  {
+    pdata[i_index] = 0;
+  }
+  uhost->sched.bulk_retry = USBH_BULK_RETRY_PER_FRAME;
+}
+
+/**
+  * @brief  usb host channel nak retry, bulk retries above the per frame
+  *         budget wait for the next sof so other channels get the bus
+  * @param  uhost: to the structure of usbh_core_type
+  * @param  chn: channel number
+  * @retval none
+  */
+void usbh_sched_retry(usbh_core_type *uhost, uint8_t chn)
+{
+  otg_hchannel_type *ch = USB_CHL(uhost->usb_reg, chn);
+
+  uhost->sched.stat[chn].nak_count ++;
+  if(ch->hcchar_bit.eptype == EPT_BULK_TYPE)
+  {
+    if(uhost->sched.bulk_retry == 0)
+    {
+      uhost->sched.pending[chn] = 1;
+      uhost->sched.stat[chn].defer_count ++;
+      return;
+    }
+    uhost->sched.bulk_retry --;
+  }
+  ch->hcchar_bit.chdis = FALSE;
+  ch->hcchar_bit.chena = TRUE;
+}
+
+/**
+  * @brief  usb host channel scheduler sof handler, refills the bulk retry
+  *         budget and restarts deferred channels round robin
+  * @param  uhost: to the structure of usbh_core_type
+  * @retval none
+  */
+void usbh_sched_sof(usbh_core_type *uhost)
+{
+  otg_hchannel_type *ch;
+  uint32_t i_index;
+  uint8_t chn;
+
+  uhost->sched.frame ++;
+  uhost->sched.bulk_retry = USBH_BULK_RETRY_PER_FRAME;
+
+  for(i_index = 0; i_index < USB_HOST_CHANNEL_NUM; i_index ++)
+  {
+    chn = (uhost->sched.rr_index + i_index) % USB_HOST_CHANNEL_NUM;
+    ch = USB_CHL(uhost->usb_reg, chn);
+    if(ch->hcchar_bit.chena)
+    {
+      uhost->sched.stat[chn].busy_frames ++;
+    }
+    if(uhost->sched.pending[chn] && uhost->sched.bulk_retry > 0)
+    {
+      uhost->sched.pending[chn] = 0;
+      uhost->sched.bulk_retry --;
+      ch->hcchar_bit.chdis = FALSE;
+      ch->hcchar_bit.chena = TRUE;
+    }
+  }
+  uhost->sched.rr_index = (uhost->sched.rr_index + 1) % USB_HOST_CHANNEL_NUM;
+}
+#endif
+
 /**
   * @brief  usb host get urb status
   * @param  uhost: to the structure of usbh_core_type
@@ -41,6 +41,11 @@
 /* control timeout 5s */
 #define CTRL_TIMEOUT          10000
 
+#ifdef USBH_CTRL_EVENT
+static void usbh_ctrl_done(usbh_core_type *uhost, usb_sts_type status);
+static void usbh_ctrl_timeout_check(usbh_core_type *uhost);
+#endif
+
 /**
   * @brief  usb host control send setup packet
   * @param  uhost: to the structure of usbh_core_type
@@ -114,9 +119,10 @@ usb_sts_type usbh_ctrl_send_data(usbh_core_type *uhost, uint8_t *buffer,
   */
 usb_sts_type usbh_ctrl_setup_handler(usbh_core_type *uhost)
 {
+  /* state first, the setup stage may complete in the interrupt */
+  uhost->ctrl.state = CONTROL_SETUP_WAIT;
   usbh_ctrl_send_setup(uhost, (uint8_t *)(&uhost->ctrl.setup),
                        uhost->ctrl.hch_out);
-  uhost->ctrl.state = CONTROL_SETUP_WAIT;
   return USB_OK;
 }
 
@@ -416,6 +422,9 @@ usb_sts_type usbh_ctrl_error_handler(usbh_core_type *uhost)
     uhost->ctrl.err_cnt = 0;
     USBH_DEBUG("control error: ****    Device No Response    ****");
     status = USB_ERROR;
+#ifdef USBH_CTRL_EVENT
+    usbh_ctrl_done(uhost, status);
+#endif
   }
   return status;
 }
@@ -427,6 +436,9 @@ usb_sts_type usbh_ctrl_error_handler(usbh_core_type *uhost)
   */
 usb_sts_type usbh_ctrl_stall_handler(usbh_core_type *uhost)
 {
+#ifdef USBH_CTRL_EVENT
+  usbh_ctrl_done(uhost, USB_NOT_SUPPORT);
+#endif
   return USB_NOT_SUPPORT;
 }
 
@@ -437,9 +449,147 @@ usb_sts_type usbh_ctrl_stall_handler(usbh_core_type *uhost)
   */
 usb_sts_type usbh_ctrl_complete_handler(usbh_core_type *uhost)
 {
+#ifdef USBH_CTRL_EVENT
+  usbh_ctrl_done(uhost, USB_OK);
+#endif
   return USB_OK;
 }
 
+#ifdef USBH_CTRL_EVENT
+/**
+  * @brief  usb host control request finished, the complete callback
+  *         of the request is called once
+  * @param  uhost: to the structure of usbh_core_type
+  * @param  status: request result
+  * @retval none
+  */
+static void usbh_ctrl_done(usbh_core_type *uhost, usb_sts_type status)
+{
+  void (*complete)(void *uhost, usb_sts_type status) = uhost->ctrl.complete;
+  if(complete != NULL)
+  {
+    uhost->ctrl.complete = NULL;
+    complete(uhost, status);
+  }
+}
+
+/**
+  * @brief  usb host control stage timeout check, stage results are
+  *         handled in the channel interrupt, the loop only checks timeout
+  * @param  uhost: to the structure of usbh_core_type
+  * @retval none
+  */
+static void usbh_ctrl_timeout_check(usbh_core_type *uhost)
+{
+  if(uhost->timer - uhost->ctrl.timer > CTRL_TIMEOUT)
+  {
+    __disable_irq();
+    switch(uhost->ctrl.state)
+    {
+      case CONTROL_SETUP_WAIT:
+      case CONTROL_DATA_IN_WAIT:
+      case CONTROL_DATA_OUT_WAIT:
+      case CONTROL_STATUS_IN_WAIT:
+      case CONTROL_STATUS_OUT_WAIT:
+        uhost->ctrl.state = CONTROL_ERROR;
+        uhost->ctrl.sts = CTRL_XACTERR;
+        break;
+      default:
+        break;
+    }
+    __enable_irq();
+  }
+}
+
+/**
+  * @brief  usb host control channel event handler, called from the channel
+  *         interrupt, checks the result of the current stage and starts the
+  *         next stage at once
+  * @param  uhost: to the structure of usbh_core_type
+  * @param  chn: channel number
+  * @retval none
+  */
+void usbh_ctrl_event_handler(usbh_core_type *uhost, uint8_t chn)
+{
+  uint32_t timeout;
+
+  if(uhost->urb_state[chn] == URB_IDLE)
+  {
+    return;
+  }
+
+  switch(uhost->ctrl.state)
+  {
+    case CONTROL_SETUP_WAIT:
+      if(chn != uhost->ctrl.hch_out)
+      {
+        return;
+      }
+      usbh_ctrl_setup_wait_handler(uhost, &timeout);
+      break;
+
+    case CONTROL_DATA_IN_WAIT:
+      if(chn != uhost->ctrl.hch_in)
+      {
+        return;
+      }
+      usbh_ctrl_data_in_wait_handler(uhost, 0);
+      break;
+
+    case CONTROL_DATA_OUT_WAIT:
+      if(chn != uhost->ctrl.hch_out)
+      {
+        return;
+      }
+      usbh_ctrl_data_out_wait_handler(uhost, 0);
+      break;
+
+    case CONTROL_STATUS_IN_WAIT:
+      if(chn != uhost->ctrl.hch_in)
+      {
+        return;
+      }
+      usbh_ctrl_status_in_wait_handler(uhost, 0);
+      break;
+
+    case CONTROL_STATUS_OUT_WAIT:
+      if(chn != uhost->ctrl.hch_out)
+      {
+        return;
+      }
+      usbh_ctrl_status_out_wait_handler(uhost, 0);
+      break;
+
+    default:
+      return;
+  }
+
+  switch(uhost->ctrl.state)
+  {
+    case CONTROL_DATA_IN:
+      usbh_ctrl_data_in_handler(uhost);
+      break;
+    case CONTROL_DATA_OUT:
+      usbh_ctrl_data_out_handler(uhost);
+      break;
+    case CONTROL_STATUS_IN:
+      usbh_ctrl_status_in_handler(uhost);
+      break;
+    case CONTROL_STATUS_OUT:
+      usbh_ctrl_status_out_handler(uhost);
+      break;
+    case CONTROL_STALL:
+      usbh_ctrl_stall_handler(uhost);
+      break;
+    case CONTROL_COMPLETE:
+      usbh_ctrl_complete_handler(uhost);
+      break;
+    default:
+      break;
+  }
+}
+#endif
+
 /**
   * @brief  usb host control transfer loop function
   * @param  uhost: to the structure of usbh_core_type
@@ -448,7 +598,9 @@ usb_sts_type usbh_ctrl_complete_handler(usbh_core_type *uhost)
 usb_sts_type usbh_ctrl_transfer_loop(usbh_core_type *uhost)
 {
   usb_sts_type status = USB_WAIT;
+#ifndef USBH_CTRL_EVENT
   static uint32_t timeout = 0;
+#endif
   uhost->ctrl.sts = CTRL_START;
 
   switch(uhost->ctrl.state)
@@ -458,6 +610,16 @@ usb_sts_type usbh_ctrl_transfer_loop(usbh_core_type *uhost)
       uhost->ctrl.timer = uhost->timer;
       break;
 
+#ifdef USBH_CTRL_EVENT
+    case CONTROL_SETUP_WAIT:
+    case CONTROL_DATA_IN_WAIT:
+    case CONTROL_DATA_OUT_WAIT:
+    case CONTROL_STATUS_IN_WAIT:
+    case CONTROL_STATUS_OUT_WAIT:
+      /* stages are advanced by usbh_ctrl_event_handler */
+      usbh_ctrl_timeout_check(uhost);
+      break;
+#else
     case CONTROL_SETUP_WAIT:
       usbh_ctrl_setup_wait_handler(uhost, &timeout);
       break;
@@ -493,6 +655,7 @@ usb_sts_type usbh_ctrl_transfer_loop(usbh_core_type *uhost)
     case CONTROL_STATUS_OUT_WAIT:
       usbh_ctrl_status_out_wait_handler(uhost, timeout);
       break;
+#endif
     case CONTROL_STALL:
       status = usbh_ctrl_stall_handler(uhost);
       break;
@@ -519,6 +682,9 @@ usb_sts_type usbh_ctrl_transfer_loop(usbh_core_type *uhost)
   */
 usb_sts_type usbh_ctrl_request(usbh_core_type *uhost, uint8_t *buffer, uint16_t length)
 {
+#ifdef USBH_CTRL_EVENT
+  return usbh_ctrl_request_cb(uhost, buffer, length, NULL);
+#else
   usb_sts_type status = USB_OK;
   if(uhost->req_state == CMD_SEND)
   {
@@ -528,7 +694,37 @@ usb_sts_type usbh_ctrl_request(usbh_core_type *uhost, uint8_t *buffer, uint16_t
     uhost->ctrl.state = CONTROL_SETUP;
   }
   return status;
+#endif
+}
+
+#ifdef USBH_CTRL_EVENT
+/**
+  * @brief  usb host control request with complete callback, the setup
+  *         stage is sent at once and the following stages are started from
+  *         the channel interrupt. complete is called with USB_OK,
+  *         USB_NOT_SUPPORT (stall) or USB_ERROR, mostly in interrupt context
+  * @param  uhost: to the structure of usbh_core_type
+  * @param  buffer: usb request buffer
+  * @param  length: usb request length
+  * @param  complete: complete callback, can be NULL
+  * @retval status: usb_sts_type status
+  */
+usb_sts_type usbh_ctrl_request_cb(usbh_core_type *uhost, uint8_t *buffer, uint16_t length,
+                                  void (*complete)(void *uhost, usb_sts_type status))
+{
+  usb_sts_type status = USB_OK;
+  if(uhost->req_state == CMD_SEND)
+  {
+    uhost->req_state = CMD_WAIT;
+    uhost->ctrl.buffer = buffer;
+    uhost->ctrl.len = length;
+    uhost->ctrl.complete = complete;
+    uhost->ctrl.timer = uhost->timer;
+    usbh_ctrl_setup_handler(uhost);
+  }
+  return status;
 }
+#endif
 
 /**
   * @brief  usb host get device descriptor
@@ -22,6 +22,9 @@
   **************************************************************************
   */
 #include "usbh_int.h"
+#ifdef USBH_CTRL_EVENT
+#include "usbh_ctrl.h"
+#endif
 
 
 /** @addtogroup AT32F402_405_middlewares_usbh_drivers
@@ -119,6 +122,9 @@ void usbh_wakeup_handler(usbh_core_type *uhost)
 void usbh_sof_handler(usbh_core_type *uhost)
 {
   uhost->timer ++;
+#ifdef USBH_CHANNEL_SCHEDULER
+  usbh_sched_sof(uhost);
+#endif
 }
 
 /**
@@ -200,6 +206,10 @@ void usbh_hch_in_handler(usbh_core_type *uhost, uint8_t chn)
     {
        uhost->hch[chn].trans_count = uhost->hch[chn].trans_len - usb_chh->hctsiz_bit.xfersize;
     }
+#ifdef USBH_CHANNEL_SCHEDULER
+    uhost->sched.stat[chn].xfer_count ++;
+    uhost->sched.stat[chn].bytes += uhost->hch[chn].trans_count;
+#endif
     usb_chh->hcint = USB_OTG_HC_XFERC_FLAG;
 
     if(usb_chh->hcchar_bit.eptype == EPT_BULK_TYPE || usb_chh->hcchar_bit.eptype == EPT_CONTROL_TYPE)
@@ -264,8 +274,12 @@ void usbh_hch_in_handler(usbh_core_type *uhost, uint8_t chn)
     {
       if(usb_chh->hcchar_bit.eptype != EPT_INT_TYPE)
       {
+#ifdef USBH_CHANNEL_SCHEDULER
+        usbh_sched_retry(uhost, chn);
+#else
         usb_chh->hcchar_bit.chdis = FALSE;
         usb_chh->hcchar_bit.chena = TRUE;
+#endif
       }
       uhost->urb_state[chn] = URB_NOTREADY;
     }
@@ -304,6 +318,9 @@ void usbh_hch_in_handler(usbh_core_type *uhost, uint8_t chn)
   {
     usb_chh->hcint = USB_OTG_HC_BBLERR_FLAG;
   }
+#ifdef USBH_CTRL_EVENT
+  usbh_ctrl_event_handler(uhost, chn);
+#endif
 }
 
 /**
@@ -384,6 +401,10 @@ void usbh_hch_out_handler(usbh_core_type *uhost, uint8_t chn)
     if(uhost->hch[chn].state == HCH_XFRC)
     {
       uhost->urb_state[chn] = URB_DONE;
+#ifdef USBH_CHANNEL_SCHEDULER
+      uhost->sched.stat[chn].xfer_count ++;
+      uhost->sched.stat[chn].bytes += uhost->hch[chn].trans_len;
+#endif
       if(uhost->hch[chn].ept_type == EPT_BULK_TYPE ||
         uhost->hch[chn].ept_type == EPT_INT_TYPE)
       {
@@ -455,6 +476,9 @@ void usbh_hch_out_handler(usbh_core_type *uhost, uint8_t chn)
       }
     }
   }
+#ifdef USBH_CTRL_EVENT
+  usbh_ctrl_event_handler(uhost, chn);
+#endif
 }
 
 /**
@@ -54,6 +54,11 @@ static usb_sts_type class_event_handler(void *udev, usbd_event_type event);
 static usb_sts_type cdc_struct_init(cdc_struct_type *pcdc);
 extern void usb_usart_config( linecoding_type linecoding);
 static void usb_vcp_cmd_process(void *udev, uint8_t cmd, uint8_t *buff, uint16_t len);
+#ifdef USBD_CDC_STREAM_MODE
+static void cdc_stream_tx_start(usbd_core_type *pudev, cdc_struct_type *pcdc);
+static void cdc_stream_tx_done(usbd_core_type *pudev, cdc_struct_type *pcdc);
+static void cdc_stream_rx_start(usbd_core_type *pudev, cdc_struct_type *pcdc);
+#endif
 
 linecoding_type linecoding =
 {
@@ -70,6 +75,12 @@ cdc_struct_type cdc_struct;
 static uint32_t g_cdc_rx_buffer[512];
 static uint32_t g_cdc_cmd_buffer[16];
 
+#ifdef USBD_CDC_STREAM_MODE
+/*cdc stream mode tx ring and rx block ring define*/
+static uint32_t g_cdc_tx_ring[USBD_CDC_TX_RING_SIZE / 4];
+static uint32_t g_cdc_rx_block[USBD_CDC_RX_BLOCK_NUM * USBD_CDC_RX_BLOCK_SIZE / 4];
+#endif
+
 /* usb device class handler */
 usbd_class_handler cdc_class_handler =
 {
@@ -122,6 +133,10 @@ static usb_sts_type class_init_handler(void *udev)
   /* open in endpoint */
   usbd_ept_open(pudev, USBD_CDC_INT_EPT, EPT_INT_TYPE, USBD_CDC_CMD_MAXPACKET_SIZE);
   
+#ifdef USBD_CDC_STREAM_MODE
+  /* set out endpoint to receive the first rx block */
+  cdc_stream_rx_start(pudev, pcdc);
+#else
   if(pudev->speed == USB_HIGH_SPEED)
   {
     /* set out endpoint to receive status */
@@ -132,6 +147,7 @@ static usb_sts_type class_init_handler(void *udev)
     /* set out endpoint to receive status */
     usbd_ept_recv(pudev, USBD_CDC_BULK_OUT_EPT, pcdc->g_rx_buff, USBD_CDC_OUT_MAXPACKET_SIZE);
   }
+#endif
 
   return status;
 }
@@ -270,7 +286,15 @@ static usb_sts_type class_in_handler(void *udev, uint8_t ept_num)
     trans next packet data
   */
   usbd_flush_tx_fifo(pudev, ept_num);
+#ifdef USBD_CDC_STREAM_MODE
+  if(ept_num == (USBD_CDC_BULK_IN_EPT & 0x7F))
+  {
+    /* release the sent span and chain the next one */
+    cdc_stream_tx_done(pudev, pcdc);
+  }
+#else
   pcdc->g_tx_completed = 1;
+#endif
 
   return status;
 }
@@ -286,12 +310,22 @@ static usb_sts_type class_out_handler(void *udev, uint8_t ept_num)
   usb_sts_type status = USB_OK;
   usbd_core_type *pudev = (usbd_core_type *)udev;
   cdc_struct_type *pcdc = (cdc_struct_type *)pudev->class_handler->pdata;
+#ifdef USBD_CDC_STREAM_MODE
+  uint32_t blk = pcdc->rx_wr;
+
+  /* mark current block filled and receive into the next free block */
+  pcdc->rx_len[blk] = usbd_get_recv_len(pudev, ept_num);
+  pcdc->rx_state[blk] = USBD_CDC_RX_BLOCK_FILLED;
+  pcdc->rx_wr = (blk + 1) % USBD_CDC_RX_BLOCK_NUM;
+  cdc_stream_rx_start(pudev, pcdc);
+#else
 
   /* get endpoint receive data length  */
   pcdc->g_rxlen = usbd_get_recv_len(pudev, ept_num);
 
   /*set recv flag*/
   pcdc->g_rx_completed = 1;
+#endif
 
   return status;
 }
@@ -353,6 +387,9 @@ static usb_sts_type class_event_handler(void *udev, usbd_event_type event)
   */
 static usb_sts_type cdc_struct_init(cdc_struct_type *pcdc)
 {
+#ifdef USBD_CDC_STREAM_MODE
+  uint32_t i_index;
+#endif
   pcdc->g_tx_completed = 1;
   pcdc->g_rx_completed = 0;
   pcdc->alt_setting = 0;
@@ -362,6 +399,23 @@ static usb_sts_type cdc_struct_init(cdc_struct_type *pcdc)
   pcdc->linecoding.parity = linecoding.parity;
   pcdc->g_rx_buff = (uint8_t *)g_cdc_rx_buffer;
   pcdc->g_cmd = (uint8_t *)g_cdc_cmd_buffer;
+#ifdef USBD_CDC_STREAM_MODE
+  pcdc->tx_ring = (uint8_t *)g_cdc_tx_ring;
+  pcdc->tx_head = 0;
+  pcdc->tx_tail = 0;
+  pcdc->tx_inflight = 0;
+  pcdc->tx_busy = 0;
+  pcdc->rx_block = (uint8_t *)g_cdc_rx_block;
+  for(i_index = 0; i_index < USBD_CDC_RX_BLOCK_NUM; i_index ++)
+  {
+    pcdc->rx_len[i_index] = 0;
+    pcdc->rx_state[i_index] = USBD_CDC_RX_BLOCK_FREE;
+  }
+  pcdc->rx_wr = 0;
+  pcdc->rx_rd = 0;
+  pcdc->rx_offset = 0;
+  pcdc->rx_armed = 0;
+#endif
   return USB_OK;
 }
 
@@ -377,6 +431,19 @@ uint16_t usb_vcp_get_rxdata(void *udev, uint8_t *recv_data)
   uint16_t tmp_len = 0;
   usbd_core_type *pudev = (usbd_core_type *)udev;
   cdc_struct_type *pcdc = (cdc_struct_type *)pudev->class_handler->pdata;
+#ifdef USBD_CDC_STREAM_MODE
+  uint8_t *pbuf;
+
+  /* copy at most one packet from the rx ring */
+  tmp_len = (uint16_t)MIN(usb_vcp_rx_peek(udev, &pbuf), pcdc->maxpacket);
+  for(i_index = 0; i_index < tmp_len; i_index ++)
+  {
+    recv_data[i_index] = pbuf[i_index];
+  }
+  usb_vcp_rx_release(udev, tmp_len);
+
+  return tmp_len;
+#else
 
   if(pcdc->g_rx_completed == 0)
   {
@@ -392,6 +459,7 @@ uint16_t usb_vcp_get_rxdata(void *udev, uint8_t *recv_data)
   usbd_ept_recv(pudev, USBD_CDC_BULK_OUT_EPT, pcdc->g_rx_buff, pcdc->maxpacket);
 
   return tmp_len;
+#endif
 }
 
 /**
@@ -406,6 +474,27 @@ error_status usb_vcp_send_data(void *udev, uint8_t *send_data, uint16_t len)
   error_status status = SUCCESS;
   usbd_core_type *pudev = (usbd_core_type *)udev;
   cdc_struct_type *pcdc = (cdc_struct_type *)pudev->class_handler->pdata;
+#ifdef USBD_CDC_STREAM_MODE
+  uint8_t *pbuf;
+  uint32_t span, i_index;
+
+  /* copy to the tx ring, the ring sends zero length packet itself */
+  if(((pcdc->tx_tail + USBD_CDC_TX_RING_SIZE - pcdc->tx_head - 1) % USBD_CDC_TX_RING_SIZE) < len)
+  {
+    return ERROR;
+  }
+  while(len > 0)
+  {
+    span = MIN(usb_vcp_tx_reserve(udev, &pbuf), len);
+    for(i_index = 0; i_index < span; i_index ++)
+    {
+      pbuf[i_index] = send_data[i_index];
+    }
+    send_data += span;
+    len -= span;
+    usb_vcp_tx_commit(udev, span);
+  }
+#else
   if(pcdc->g_tx_completed)
   {
     pcdc->g_tx_completed = 0;
@@ -415,9 +504,199 @@ error_status usb_vcp_send_data(void *udev, uint8_t *send_data, uint16_t len)
   {
     status = ERROR;
   }
+#endif
   return status;
 }
 
+#ifdef USBD_CDC_STREAM_MODE
+/**
+  * @brief  usb device cdc stream get contiguous free space of tx ring
+  * @param  udev: to the structure of usbd_core_type
+  * @param  pbuf: return the write pointer of tx ring
+  * @retval number of bytes can be written at pbuf
+  */
+uint32_t usb_vcp_tx_reserve(void *udev, uint8_t **pbuf)
+{
+  usbd_core_type *pudev = (usbd_core_type *)udev;
+  cdc_struct_type *pcdc = (cdc_struct_type *)pudev->class_handler->pdata;
+  uint32_t head = pcdc->tx_head;
+  uint32_t tail = pcdc->tx_tail;
+  uint32_t len;
+
+  if(head >= tail)
+  {
+    len = USBD_CDC_TX_RING_SIZE - head;
+    if(tail == 0)
+    {
+      len -= 1;
+    }
+  }
+  else
+  {
+    len = tail - head - 1;
+  }
+  *pbuf = pcdc->tx_ring + head;
+  return len;
+}
+
+/**
+  * @brief  usb device cdc stream commit written data of tx ring and
+  *         start the in transfer if endpoint is idle
+  * @param  udev: to the structure of usbd_core_type
+  * @param  len: number of bytes written at the reserved pointer
+  * @retval none
+  */
+void usb_vcp_tx_commit(void *udev, uint32_t len)
+{
+  usbd_core_type *pudev = (usbd_core_type *)udev;
+  cdc_struct_type *pcdc = (cdc_struct_type *)pudev->class_handler->pdata;
+  uint32_t head = pcdc->tx_head + len;
+
+  if(head >= USBD_CDC_TX_RING_SIZE)
+  {
+    head -= USBD_CDC_TX_RING_SIZE;
+  }
+  pcdc->tx_head = head;
+  cdc_stream_tx_start(pudev, pcdc);
+}
+
+/**
+  * @brief  usb device cdc stream get received data of rx ring
+  * @param  udev: to the structure of usbd_core_type
+  * @param  pbuf: return the read pointer of rx ring
+  * @retval number of bytes can be read at pbuf
+  */
+uint32_t usb_vcp_rx_peek(void *udev, uint8_t **pbuf)
+{
+  usbd_core_type *pudev = (usbd_core_type *)udev;
+  cdc_struct_type *pcdc = (cdc_struct_type *)pudev->class_handler->pdata;
+  uint32_t blk;
+
+  while(pcdc->rx_state[pcdc->rx_rd] == USBD_CDC_RX_BLOCK_FILLED)
+  {
+    blk = pcdc->rx_rd;
+    if(pcdc->rx_len[blk] > pcdc->rx_offset)
+    {
+      *pbuf = pcdc->rx_block + blk * USBD_CDC_RX_BLOCK_SIZE + pcdc->rx_offset;
+      return pcdc->rx_len[blk] - pcdc->rx_offset;
+    }
+    /* zero length packet, drop the empty block */
+    usb_vcp_rx_release(udev, 0);
+  }
+  return 0;
+}
+
+/**
+  * @brief  usb device cdc stream release read data of rx ring
+  * @param  udev: to the structure of usbd_core_type
+  * @param  len: number of bytes consumed at the peek pointer
+  * @retval none
+  */
+void usb_vcp_rx_release(void *udev, uint32_t len)
+{
+  usbd_core_type *pudev = (usbd_core_type *)udev;
+  cdc_struct_type *pcdc = (cdc_struct_type *)pudev->class_handler->pdata;
+  uint32_t blk = pcdc->rx_rd;
+
+  if(pcdc->rx_state[blk] != USBD_CDC_RX_BLOCK_FILLED)
+  {
+    return;
+  }
+  pcdc->rx_offset += len;
+  if(pcdc->rx_offset >= pcdc->rx_len[blk])
+  {
+    pcdc->rx_offset = 0;
+    pcdc->rx_rd = (blk + 1) % USBD_CDC_RX_BLOCK_NUM;
+    pcdc->rx_state[blk] = USBD_CDC_RX_BLOCK_FREE;
+
+    /* out endpoint stopped because the ring was full */
+    if(pcdc->rx_armed == 0)
+    {
+      cdc_stream_rx_start(pudev, pcdc);
+    }
+  }
+}
+
+/**
+  * @brief  usb device cdc stream start in transfer of the tx ring,
+  *         the contiguous data from tail is sent as one transfer
+  * @param  pudev: to the structure of usbd_core_type
+  * @param  pcdc: to the structure of cdc_struct
+  * @retval none
+  */
+static void cdc_stream_tx_start(usbd_core_type *pudev, cdc_struct_type *pcdc)
+{
+  uint32_t head = pcdc->tx_head;
+  uint32_t tail = pcdc->tx_tail;
+  uint32_t len;
+
+  if(pcdc->tx_busy || head == tail)
+  {
+    return;
+  }
+  if(head > tail)
+  {
+    len = head - tail;
+  }
+  else
+  {
+    len = USBD_CDC_TX_RING_SIZE - tail;
+  }
+  pcdc->tx_busy = 1;
+  pcdc->tx_inflight = len;
+  usbd_ept_send(pudev, USBD_CDC_BULK_IN_EPT, pcdc->tx_ring + tail, (uint16_t)len);
+}
+
+/**
+  * @brief  usb device cdc stream in transfer complete
+  * @param  pudev: to the structure of usbd_core_type
+  * @param  pcdc: to the structure of cdc_struct
+  * @retval none
+  */
+static void cdc_stream_tx_done(usbd_core_type *pudev, cdc_struct_type *pcdc)
+{
+  uint32_t sent = pcdc->tx_inflight;
+  uint32_t tail = pcdc->tx_tail + sent;
+
+  if(tail >= USBD_CDC_TX_RING_SIZE)
+  {
+    tail -= USBD_CDC_TX_RING_SIZE;
+  }
+  pcdc->tx_tail = tail;
+  pcdc->tx_inflight = 0;
+
+  /* ring is empty after a max packet multiple transfer, end it with zero length packet */
+  if(pcdc->tx_head == tail && sent != 0 && (sent % pcdc->maxpacket) == 0)
+  {
+    usbd_ept_send(pudev, USBD_CDC_BULK_IN_EPT, pcdc->tx_ring + tail, 0);
+    return;
+  }
+  pcdc->tx_busy = 0;
+  cdc_stream_tx_start(pudev, pcdc);
+}
+
+/**
+  * @brief  usb device cdc stream start out transfer to the next rx block
+  * @param  pudev: to the structure of usbd_core_type
+  * @param  pcdc: to the structure of cdc_struct
+  * @retval none
+  */
+static void cdc_stream_rx_start(usbd_core_type *pudev, cdc_struct_type *pcdc)
+{
+  uint32_t blk = pcdc->rx_wr;
+
+  if(pcdc->rx_state[blk] == USBD_CDC_RX_BLOCK_FREE)
+  {
+    pcdc->rx_armed = 1;
+    usbd_ept_recv(pudev, USBD_CDC_BULK_OUT_EPT, pcdc->rx_block + blk * USBD_CDC_RX_BLOCK_SIZE, USBD_CDC_RX_BLOCK_SIZE);
+  }
+  else
+  {
+    pcdc->rx_armed = 0;
+  }
+}
+#endif
+
 /**
   * @brief  usb device function
   * @param  udev: to the structure of usbd_core_type
@@ -66,6 +66,27 @@ extern "C" {
 #define USBD_HS_CDC_OUT_MAXPACKET_SIZE    USBD_HS_CDC_MAXPACKET_SIZE
 #define USBD_HS_CDC_CMD_MAXPACKET_SIZE    0x08
 
+#ifdef USBD_CDC_STREAM_MODE
+/**
+  * @brief usb cdc stream mode buffer define, tx ring size must be less
+  *        than 64KB and rx block size must be a multiple of 512
+  */
+#ifndef USBD_CDC_TX_RING_SIZE
+#define USBD_CDC_TX_RING_SIZE             8192
+#endif
+
+#ifndef USBD_CDC_RX_BLOCK_SIZE
+#define USBD_CDC_RX_BLOCK_SIZE            2048
+#endif
+
+#ifndef USBD_CDC_RX_BLOCK_NUM
+#define USBD_CDC_RX_BLOCK_NUM             4
+#endif
+
+#define USBD_CDC_RX_BLOCK_FREE            0
+#define USBD_CDC_RX_BLOCK_FILLED          1
+#endif
+
 /**
   * @}
   */
@@ -87,6 +108,18 @@ typedef struct
   __IO uint8_t g_tx_completed, g_rx_completed;
   linecoding_type linecoding;
   uint32_t maxpacket;
+#ifdef USBD_CDC_STREAM_MODE
+  uint8_t *tx_ring;
+  __IO uint32_t tx_head, tx_tail;
+  __IO uint32_t tx_inflight;
+  __IO uint8_t tx_busy;
+  uint8_t *rx_block;
+  __IO uint32_t rx_len[USBD_CDC_RX_BLOCK_NUM];
+  __IO uint8_t rx_state[USBD_CDC_RX_BLOCK_NUM];
+  __IO uint32_t rx_wr, rx_rd;
+  uint32_t rx_offset;
+  __IO uint8_t rx_armed;
+#endif
 }cdc_struct_type;
 
 
@@ -100,6 +133,12 @@ typedef struct
 extern usbd_class_handler cdc_class_handler;
 uint16_t usb_vcp_get_rxdata(void *udev, uint8_t *recv_data);
 error_status usb_vcp_send_data(void *udev, uint8_t *send_data, uint16_t len);
+#ifdef USBD_CDC_STREAM_MODE
+uint32_t usb_vcp_tx_reserve(void *udev, uint8_t **pbuf);
+void usb_vcp_tx_commit(void *udev, uint32_t len);
+uint32_t usb_vcp_rx_peek(void *udev, uint8_t **pbuf);
+void usb_vcp_rx_release(void *udev, uint32_t len);
+#endif
 
 /**
   * @}
@@ -37,6 +37,20 @@
   * @{
   */
 
+static usb_sts_type bot_scsi_rw_decode(void *udev, uint8_t lun);
+#ifndef MSC_ASYNC_STORAGE
+static usb_sts_type bot_scsi_disk_read(void *udev, uint8_t lun, uint64_t addr, uint8_t *buf, uint32_t len);
+static usb_sts_type bot_scsi_disk_write(void *udev, uint8_t lun, uint64_t addr, uint8_t *buf, uint32_t len);
+#endif
+static void bot_scsi_cache_invalidate(void *udev, uint8_t lun, uint64_t addr, uint32_t len);
+#ifdef MSC_BOT_PINGPONG
+static void bot_scsi_pp_init(void *udev, uint8_t lun);
+static void bot_scsi_pp_disk_start(void *udev);
+static void bot_scsi_pp_read_pump(void *udev);
+static void bot_scsi_pp_write_pump(void *udev);
+static usb_sts_type bot_scsi_pp_read(void *udev);
+static usb_sts_type bot_scsi_pp_write(void *udev);
+#endif
 
 #if defined ( __ICCARM__ ) /* iar compiler */
   #pragma data_alignment=4
@@ -45,9 +59,46 @@ ALIGNED_HEAD uint8_t page00_inquiry_data[] ALIGNED_TAIL = {
   0x00,
   0x00,
   0x00,
+  0x03,
   0x00,
-  0x00,
+  0xB0,
+  0xB2,
+};
+
+#if defined ( __ICCARM__ ) /* iar compiler */
+  #pragma data_alignment=4
+#endif
+ALIGNED_HEAD uint8_t pageb0_inquiry_data[] ALIGNED_TAIL = {
+  0x00, 0xB0, 0x00, 0x3C,
+  0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00,
+  0xFF, 0xFF, 0xFF, 0xFF,  /* maximum unmap lba count */
+  0x00, 0x00, 0x00, (MSC_MAX_DATA_BUF_LEN - MSC_UNMAP_HEADER_LEN) / MSC_UNMAP_DESC_LEN, /* maximum unmap descriptor count */
+  0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00,
+};
 
+#if defined ( __ICCARM__ ) /* iar compiler */
+  #pragma data_alignment=4
+#endif
+ALIGNED_HEAD uint8_t pageb2_inquiry_data[] ALIGNED_TAIL = {
+  0x00,
+  0xB2,
+  0x00,
+  0x04,
+  0x00,
+  0x80,  /* lbpu, unmap command supported */
+  0x00,
+  0x00,
 };
 #if defined ( __ICCARM__ ) /* iar compiler */
   #pragma data_alignment=4
@@ -94,6 +145,27 @@ ALIGNED_HEAD uint8_t mode_sense10_data[8] ALIGNED_TAIL =
   0x00,
   0x00
 };
+
+#ifdef MSC_WRITE_CACHE
+/* caching mode page, write cache enabled */
+#define MODE_PAGE_CACHING                0x08
+#define MODE_PAGE_ALL                    0x3F
+#define MODE_PAGE_CACHING_LEN            20
+#if defined ( __ICCARM__ ) /* iar compiler */
+  #pragma data_alignment=4
+#endif
+ALIGNED_HEAD uint8_t mode_page_caching[MODE_PAGE_CACHING_LEN] ALIGNED_TAIL =
+{
+  MODE_PAGE_CACHING,
+  MODE_PAGE_CACHING_LEN - 2,
+  0x04,
+  0x00,
+  0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00
+};
+#endif
 /**
   * @brief  initialize bulk-only transport and scsi
   * @param  udev: to the structure of usbd_core_type
@@ -130,6 +202,9 @@ void bot_scsi_reset(void *udev)
   pmsc->msc_state = MSC_STATE_MACHINE_IDLE;
   pmsc->bot_status = MSC_BOT_STATE_RECOVERY;
   pmsc->max_lun = MSC_SUPPORT_MAX_LUN - 1;
+
+  /* the host gives up the command, acknowledged writes go to storage */
+  bot_scsi_cache_flush(udev);
   usbd_flush_tx_fifo(pudev, USBD_MSC_BULK_IN_EPT&0x7F);
 
   /* set out endpoint to receive status */
@@ -202,6 +277,9 @@ void bot_cbw_decode(void *udev)
 
   pmsc->csw_struct.dCSWTag = pmsc->cbw_struct.dCBWTage;
   pmsc->csw_struct.dCSWDataResidue = pmsc->cbw_struct.dCBWDataTransferLength;
+#ifdef MSC_WRITE_CACHE
+  pmsc->cache_idle = 0;
+#endif
 
   /* check param */
   if((pmsc->cbw_struct.dCBWSignature != CBW_DCBWSIGNATURE) ||
@@ -306,7 +384,7 @@ usb_sts_type bot_scsi_check_address(void *udev, uint8_t lun, uint32_t blk_offset
 {
   usbd_core_type *pudev = (usbd_core_type *)udev;
   msc_type *pmsc = (msc_type *)pudev->class_handler->pdata;
-  if((blk_offset + blk_count) > pmsc->blk_nbr[lun])
+  if(blk_offset > pmsc->blk_nbr[lun] || blk_count > pmsc->blk_nbr[lun] - blk_offset)
   {
     bot_scsi_sense_code(udev, SENSE_KEY_ILLEGAL_REQUEST, ADDRESS_OUT_OF_RANGE);
     return USB_FAIL;
@@ -377,8 +455,21 @@ usb_sts_type bot_scsi_inquiry(void *udev, uint8_t lun)
 
   if(pmsc->cbw_struct.CBWCB[1] & 0x01)
   {
-    pdata = page00_inquiry_data;
-    trans_len = 5;
+    switch(pmsc->cbw_struct.CBWCB[2])
+    {
+      case 0xB0:
+        pdata = pageb0_inquiry_data;
+        trans_len = sizeof(pageb0_inquiry_data);
+        break;
+      case 0xB2:
+        pdata = pageb2_inquiry_data;
+        trans_len = sizeof(pageb2_inquiry_data);
+        break;
+      default:
+        pdata = page00_inquiry_data;
+        trans_len = sizeof(page00_inquiry_data);
+        break;
+    }
   }
   else
   {
@@ -413,6 +504,13 @@ usb_sts_type bot_scsi_start_stop(void *udev, uint8_t lun)
   usbd_core_type *pudev = (usbd_core_type *)udev;
   msc_type *pmsc = (msc_type *)pudev->class_handler->pdata;
   pmsc->data_len = 0;
+
+  /* medium is going to be ejected, write back cached blocks */
+  if(bot_scsi_cache_flush(udev) != USB_OK)
+  {
+    bot_scsi_sense_code(udev, SENSE_KEY_HARDWARE_ERROR, MEDIUM_NOT_PRESENT);
+    return USB_FAIL;
+  }
   return USB_OK;
 }
 
@@ -447,6 +545,19 @@ usb_sts_type bot_scsi_mode_sense6(void *udev, uint8_t lun)
     data_len --;
     pmsc->data[data_len] = mode_sense6_data[data_len];
   };
+#ifdef MSC_WRITE_CACHE
+  if((pmsc->cbw_struct.CBWCB[2] & 0x3F) == MODE_PAGE_CACHING ||
+     (pmsc->cbw_struct.CBWCB[2] & 0x3F) == MODE_PAGE_ALL)
+  {
+    /* 4 bytes header then caching page */
+    for(data_len = 0; data_len < MODE_PAGE_CACHING_LEN; data_len ++)
+    {
+      pmsc->data[4 + data_len] = mode_page_caching[data_len];
+    }
+    pmsc->data_len = 4 + MODE_PAGE_CACHING_LEN;
+    pmsc->data[0] = pmsc->data_len - 1;
+  }
+#endif
   return USB_OK;
 }
 
@@ -467,6 +578,20 @@ usb_sts_type bot_scsi_mode_sense10(void *udev, uint8_t lun)
     data_len --;
     pmsc->data[data_len] = mode_sense10_data[data_len];
   };
+#ifdef MSC_WRITE_CACHE
+  if((pmsc->cbw_struct.CBWCB[2] & 0x3F) == MODE_PAGE_CACHING ||
+     (pmsc->cbw_struct.CBWCB[2] & 0x3F) == MODE_PAGE_ALL)
+  {
+    /* 8 bytes header then caching page */
+    for(data_len = 0; data_len < MODE_PAGE_CACHING_LEN; data_len ++)
+    {
+      pmsc->data[8 + data_len] = mode_page_caching[data_len];
+    }
+    pmsc->data_len = 8 + MODE_PAGE_CACHING_LEN;
+    pmsc->data[0] = 0;
+    pmsc->data[1] = pmsc->data_len - 2;
+  }
+#endif
   return USB_OK;
 }
 
@@ -601,8 +726,9 @@ usb_sts_type bot_scsi_read10(void *udev, uint8_t lun)
 {
   usbd_core_type *pudev = (usbd_core_type *)udev;
   msc_type *pmsc = (msc_type *)pudev->class_handler->pdata;
-  uint8_t *cmd = pmsc->cbw_struct.CBWCB;
+#ifndef MSC_BOT_PINGPONG
   uint32_t len;
+#endif
 
   if(pmsc->msc_state == MSC_STATE_MACHINE_IDLE)
   {
@@ -612,10 +738,7 @@ usb_sts_type bot_scsi_read10(void *udev, uint8_t lun)
       return USB_FAIL;
     }
 
-    pmsc->blk_addr = cmd[2] << 24 | cmd[3] << 16 | cmd[4] << 8 | cmd[5];
-    pmsc->blk_len = cmd[7] << 8 | cmd[8];
-
-    if(bot_scsi_check_address(udev, lun, pmsc->blk_addr, pmsc->blk_len) != USB_OK)
+    if(bot_scsi_rw_decode(udev, lun) != USB_OK)
     {
       return USB_FAIL;
     }
@@ -628,12 +751,24 @@ usb_sts_type bot_scsi_read10(void *udev, uint8_t lun)
       bot_scsi_sense_code(udev, SENSE_KEY_ILLEGAL_REQUEST, INVALID_COMMAND);
       return USB_FAIL;
     }
+    if(pmsc->blk_len == 0)
+    {
+      /* no data stage, the status is sent right away */
+      pmsc->data_len = 0;
+      return USB_OK;
+    }
     pmsc->msc_state  = MSC_STATE_MACHINE_DATA_IN;
+#ifdef MSC_BOT_PINGPONG
+    bot_scsi_pp_init(udev, lun);
+#endif
   }
+#ifdef MSC_BOT_PINGPONG
+  return bot_scsi_pp_read(udev);
+#else
   pmsc->data_len = MSC_MAX_DATA_BUF_LEN;
 
   len = MIN(pmsc->blk_len, MSC_MAX_DATA_BUF_LEN);
-  if( msc_disk_read(lun, pmsc->blk_addr, pmsc->data, len) != USB_OK)
+  if(bot_scsi_disk_read(udev, lun, pmsc->blk_addr, pmsc->data, len) != USB_OK)
   {
     bot_scsi_sense_code(udev, SENSE_KEY_HARDWARE_ERROR, MEDIUM_NOT_PRESENT);
     return USB_FAIL;
@@ -649,6 +784,7 @@ usb_sts_type bot_scsi_read10(void *udev, uint8_t lun)
   }
 
   return USB_OK;
+#endif
 }
 
 
@@ -662,8 +798,9 @@ usb_sts_type bot_scsi_write10(void *udev, uint8_t lun)
 {
   usbd_core_type *pudev = (usbd_core_type *)udev;
   msc_type *pmsc = (msc_type *)pudev->class_handler->pdata;
-  uint8_t *cmd = pmsc->cbw_struct.CBWCB;
+#ifndef MSC_BOT_PINGPONG
   uint32_t len;
+#endif
 
   if(pmsc->msc_state == MSC_STATE_MACHINE_IDLE)
   {
@@ -673,10 +810,7 @@ usb_sts_type bot_scsi_write10(void *udev, uint8_t lun)
       return USB_FAIL;
     }
 
-    pmsc->blk_addr = cmd[2] << 24 | cmd[3] << 16 | cmd[4] << 8 | cmd[5];
-    pmsc->blk_len = cmd[7] << 8 | cmd[8];
-
-    if(bot_scsi_check_address(udev, lun, pmsc->blk_addr, pmsc->blk_len) != USB_OK)
+    if(bot_scsi_rw_decode(udev, lun) != USB_OK)
     {
       return USB_FAIL;
     }
@@ -689,16 +823,30 @@ usb_sts_type bot_scsi_write10(void *udev, uint8_t lun)
       bot_scsi_sense_code(udev, SENSE_KEY_ILLEGAL_REQUEST, INVALID_COMMAND);
       return USB_FAIL;
     }
+    if(pmsc->blk_len == 0)
+    {
+      /* no data stage, the status is sent right away */
+      pmsc->data_len = 0;
+      return USB_OK;
+    }
 
     pmsc->msc_state  = MSC_STATE_MACHINE_DATA_OUT;
+#ifdef MSC_BOT_PINGPONG
+    bot_scsi_pp_init(udev, lun);
+    return bot_scsi_pp_write(udev);
+#else
     len = MIN(pmsc->blk_len, MSC_MAX_DATA_BUF_LEN);
     usbd_ept_recv(pudev, USBD_MSC_BULK_OUT_EPT, (uint8_t *)pmsc->data, len);
+#endif
 
   }
   else
   {
+#ifdef MSC_BOT_PINGPONG
+    return bot_scsi_pp_write(udev);
+#else
     len = MIN(pmsc->blk_len, MSC_MAX_DATA_BUF_LEN);
-    if(msc_disk_write(lun, pmsc->blk_addr, pmsc->data, len) != USB_OK)
+    if(bot_scsi_disk_write(udev, lun, pmsc->blk_addr, pmsc->data, len) != USB_OK)
     {
       bot_scsi_sense_code(udev, SENSE_KEY_HARDWARE_ERROR, MEDIUM_NOT_PRESENT);
       return USB_FAIL;
@@ -718,10 +866,657 @@ usb_sts_type bot_scsi_write10(void *udev, uint8_t lun)
       len = MIN(pmsc->blk_len, MSC_MAX_DATA_BUF_LEN);
       usbd_ept_recv(pudev, USBD_MSC_BULK_OUT_EPT, (uint8_t *)pmsc->data, len);
     }
+#endif
   }
   return USB_OK;
 }
 
+#ifdef MSC_BOT_PINGPONG
+/**
+  * @brief  init ping-pong buffer state of read10/write10, blk_addr
+  *         and blk_len must already be converted to bytes
+  * @param  udev: to the structure of usbd_core_type
+  * @param  lun: logical units number
+  * @retval none
+  */
+static void bot_scsi_pp_init(void *udev, uint8_t lun)
+{
+  usbd_core_type *pudev = (usbd_core_type *)udev;
+  msc_type *pmsc = (msc_type *)pudev->class_handler->pdata;
+
+  pmsc->pp_buf[0] = pmsc->data;
+  pmsc->pp_buf[1] = pmsc->data_pp;
+  pmsc->pp_len[0] = 0;
+  pmsc->pp_len[1] = 0;
+  pmsc->pp_bus_idx = 0;
+  pmsc->pp_disk_idx = 0;
+  pmsc->pp_bus_busy = 0;
+  pmsc->pp_disk_busy = 0;
+  pmsc->pp_in_cmd = 0;
+  pmsc->pp_error = 0;
+  pmsc->pp_lun = lun;
+  pmsc->pp_disk_addr = pmsc->blk_addr;
+  pmsc->pp_disk_len = pmsc->blk_len;
+  pmsc->pp_disk_cur = 0;
+}
+
+/**
+  * @brief  start storage access of the current disk buffer, the access
+  *         is finished by bot_scsi_storage_done
+  * @param  udev: to the structure of usbd_core_type
+  * @retval none
+  */
+static void bot_scsi_pp_disk_start(void *udev)
+{
+  usbd_core_type *pudev = (usbd_core_type *)udev;
+  msc_type *pmsc = (msc_type *)pudev->class_handler->pdata;
+  uint8_t *buf = pmsc->pp_buf[pmsc->pp_disk_idx];
+  usb_sts_type status;
+
+  if(pmsc->cbw_struct.bmCBWFlags & 0x80)
+  {
+    pmsc->pp_disk_cur = MIN(pmsc->pp_disk_len, MSC_MAX_DATA_BUF_LEN);
+  }
+  else
+  {
+    pmsc->pp_disk_cur = pmsc->pp_len[pmsc->pp_disk_idx];
+  }
+  pmsc->pp_disk_busy = 1;
+
+#ifdef MSC_ASYNC_STORAGE
+  if(pmsc->cbw_struct.bmCBWFlags & 0x80)
+  {
+    status = msc_disk_read_start(pmsc->pp_lun, pmsc->pp_disk_addr, buf, pmsc->pp_disk_cur);
+  }
+  else
+  {
+    status = msc_disk_write_start(pmsc->pp_lun, pmsc->pp_disk_addr, buf, pmsc->pp_disk_cur);
+  }
+  if(status == USB_OK)
+  {
+    /* storage calls bot_scsi_storage_done when finished */
+    return;
+  }
+#else
+  if(pmsc->cbw_struct.bmCBWFlags & 0x80)
+  {
+    status = bot_scsi_disk_read(udev, pmsc->pp_lun, pmsc->pp_disk_addr, buf, pmsc->pp_disk_cur);
+  }
+  else
+  {
+    status = bot_scsi_disk_write(udev, pmsc->pp_lun, pmsc->pp_disk_addr, buf, pmsc->pp_disk_cur);
+  }
+#endif
+  bot_scsi_storage_done(udev, status);
+}
+
+/**
+  * @brief  read10 ping-pong pump, send the filled buffer and fill the
+  *         free buffer from storage while the other one is on the bus
+  * @param  udev: to the structure of usbd_core_type
+  * @retval none
+  */
+static void bot_scsi_pp_read_pump(void *udev)
+{
+  usbd_core_type *pudev = (usbd_core_type *)udev;
+  msc_type *pmsc = (msc_type *)pudev->class_handler->pdata;
+  uint32_t len = pmsc->pp_len[pmsc->pp_bus_idx];
+
+  if(pmsc->pp_bus_busy == 0 && len != 0)
+  {
+    pmsc->pp_bus_busy = 1;
+    pmsc->blk_len -= len;
+    pmsc->csw_struct.dCSWDataResidue -= len;
+    if(pmsc->blk_len == 0)
+    {
+      pmsc->msc_state = MSC_STATE_MACHINE_LAST_DATA;
+    }
+    usbd_ept_send(pudev, USBD_MSC_BULK_IN_EPT, pmsc->pp_buf[pmsc->pp_bus_idx], len);
+  }
+
+  if(pmsc->pp_disk_busy == 0 && pmsc->pp_disk_len != 0 &&
+     pmsc->pp_len[pmsc->pp_disk_idx] == 0)
+  {
+    bot_scsi_pp_disk_start(udev);
+  }
+}
+
+/**
+  * @brief  write10 ping-pong pump, receive to the free buffer and write
+  *         the received buffer to storage while the other one is on the bus
+  * @param  udev: to the structure of usbd_core_type
+  * @retval none
+  */
+static void bot_scsi_pp_write_pump(void *udev)
+{
+  usbd_core_type *pudev = (usbd_core_type *)udev;
+  msc_type *pmsc = (msc_type *)pudev->class_handler->pdata;
+
+  if(pmsc->pp_bus_busy == 0 && pmsc->blk_len != 0 &&
+     pmsc->pp_len[pmsc->pp_bus_idx] == 0)
+  {
+    pmsc->pp_bus_busy = 1;
+    usbd_ept_recv(pudev, USBD_MSC_BULK_OUT_EPT, pmsc->pp_buf[pmsc->pp_bus_idx],
+                  MIN(pmsc->blk_len, MSC_MAX_DATA_BUF_LEN));
+  }
+
+  if(pmsc->pp_disk_busy == 0 && pmsc->pp_len[pmsc->pp_disk_idx] != 0)
+  {
+    bot_scsi_pp_disk_start(udev);
+  }
+}
+
+/**
+  * @brief  read10 ping-pong step, called on command start and on each
+  *         in transfer complete
+  * @param  udev: to the structure of usbd_core_type
+  * @retval status of usb_sts_type
+  */
+static usb_sts_type bot_scsi_pp_read(void *udev)
+{
+  usbd_core_type *pudev = (usbd_core_type *)udev;
+  msc_type *pmsc = (msc_type *)pudev->class_handler->pdata;
+
+  pmsc->pp_in_cmd = 1;
+  if(pmsc->pp_bus_busy)
+  {
+    /* buffer sent, release it */
+    pmsc->pp_len[pmsc->pp_bus_idx] = 0;
+    pmsc->pp_bus_idx ^= 1;
+    pmsc->pp_bus_busy = 0;
+  }
+  if(pmsc->pp_error == 0)
+  {
+    bot_scsi_pp_read_pump(udev);
+  }
+  pmsc->pp_in_cmd = 0;
+
+  return (pmsc->pp_error == 0) ? USB_OK : USB_FAIL;
+}
+
+/**
+  * @brief  write10 ping-pong step, called on command start and on each
+  *         out transfer complete
+  * @param  udev: to the structure of usbd_core_type
+  * @retval status of usb_sts_type
+  */
+static usb_sts_type bot_scsi_pp_write(void *udev)
+{
+  usbd_core_type *pudev = (usbd_core_type *)udev;
+  msc_type *pmsc = (msc_type *)pudev->class_handler->pdata;
+  uint32_t len;
+
+  pmsc->pp_in_cmd = 1;
+  if(pmsc->pp_bus_busy)
+  {
+    /* buffer received, queue it for storage write */
+    len = MIN(pmsc->blk_len, MSC_MAX_DATA_BUF_LEN);
+    pmsc->pp_len[pmsc->pp_bus_idx] = len;
+    pmsc->blk_len -= len;
+    pmsc->pp_bus_idx ^= 1;
+    pmsc->pp_bus_busy = 0;
+  }
+  if(pmsc->pp_error == 0)
+  {
+    bot_scsi_pp_write_pump(udev);
+  }
+  pmsc->pp_in_cmd = 0;
+
+  return (pmsc->pp_error == 0) ? USB_OK : USB_FAIL;
+}
+
+/**
+  * @brief  storage access finished, with MSC_ASYNC_STORAGE it is called by
+  *         the storage driver from an interrupt of the same priority as otg
+  * @param  udev: to the structure of usbd_core_type
+  * @param  status: storage access status
+  * @retval none
+  */
+void bot_scsi_storage_done(void *udev, usb_sts_type status)
+{
+  usbd_core_type *pudev = (usbd_core_type *)udev;
+  msc_type *pmsc = (msc_type *)pudev->class_handler->pdata;
+  uint8_t idx = pmsc->pp_disk_idx;
+  uint32_t len = pmsc->pp_disk_cur;
+
+  pmsc->pp_disk_busy = 0;
+  if(status != USB_OK)
+  {
+    bot_scsi_sense_code(udev, SENSE_KEY_HARDWARE_ERROR, MEDIUM_NOT_PRESENT);
+    pmsc->pp_error = 1;
+    pmsc->pp_disk_len = 0;
+
+    /* no transfer will complete the command, send failed status here */
+    if(pmsc->pp_in_cmd == 0 && pmsc->pp_bus_busy == 0)
+    {
+      bot_scsi_send_csw(udev, CSW_BCSWSTATUS_FAILED);
+    }
+    return;
+  }
+
+  pmsc->pp_disk_addr += len;
+  pmsc->pp_disk_len -= len;
+  pmsc->pp_disk_idx ^= 1;
+
+  if(pmsc->cbw_struct.bmCBWFlags & 0x80)
+  {
+    pmsc->pp_len[idx] = len;
+    bot_scsi_pp_read_pump(udev);
+  }
+  else
+  {
+    pmsc->pp_len[idx] = 0;
+    pmsc->csw_struct.dCSWDataResidue -= len;
+    if(pmsc->pp_disk_len == 0)
+    {
+      bot_scsi_send_csw(udev, CSW_BCSWSTATUS_PASS);
+    }
+    else
+    {
+      bot_scsi_pp_write_pump(udev);
+    }
+  }
+}
+#endif
+
+/**
+  * @brief  bulk-only transport scsi command read capacity16
+  * @param  udev: to the structure of usbd_core_type
+  * @param  lun: logical units number
+  * @retval status of usb_sts_type
+  */
+usb_sts_type bot_scsi_capacity16(void *udev, uint8_t lun)
+{
+  usbd_core_type *pudev = (usbd_core_type *)udev;
+  msc_type *pmsc = (msc_type *)pudev->class_handler->pdata;
+  uint8_t *cmd = pmsc->cbw_struct.CBWCB;
+  uint8_t *pdata = pmsc->data;
+  uint32_t alloc_len;
+  uint32_t i_index;
+
+  if((cmd[1] & 0x1F) != MSC_SA_READ_CAPACITY16)
+  {
+    bot_scsi_sense_code(udev, SENSE_KEY_ILLEGAL_REQUEST, INVALID_COMMAND);
+    return USB_FAIL;
+  }
+
+  msc_disk_capacity(lun, &pmsc->blk_nbr[lun], &pmsc->blk_size[lun]);
+
+  for(i_index = 0; i_index < MSC_READ_CAPACITY16_DATA_LEN; i_index ++)
+  {
+    pdata[i_index] = 0;
+  }
+
+  /* last logical block address, upper 32 bits are zero */
+  pdata[4] = (uint8_t)((pmsc->blk_nbr[lun] - 1) >> 24);
+  pdata[5] = (uint8_t)((pmsc->blk_nbr[lun] - 1) >> 16);
+  pdata[6] = (uint8_t)((pmsc->blk_nbr[lun] - 1) >> 8);
+  pdata[7] = (uint8_t)((pmsc->blk_nbr[lun] - 1));
+
+  pdata[8] = (uint8_t)((pmsc->blk_size[lun]) >> 24);
+  pdata[9] = (uint8_t)((pmsc->blk_size[lun]) >> 16);
+  pdata[10] = (uint8_t)((pmsc->blk_size[lun]) >> 8);
+  pdata[11] = (uint8_t)((pmsc->blk_size[lun]));
+
+  /* lbpme, logical block provisioning (unmap) enabled */
+  pdata[14] = 0x80;
+
+  alloc_len = cmd[10] << 24 | cmd[11] << 16 | cmd[12] << 8 | cmd[13];
+  pmsc->data_len = MIN(alloc_len, MSC_READ_CAPACITY16_DATA_LEN);
+  return USB_OK;
+}
+
+/**
+  * @brief  bulk-only transport scsi command synchronize cache
+  * @param  udev: to the structure of usbd_core_type
+  * @param  lun: logical units number
+  * @retval status of usb_sts_type
+  */
+usb_sts_type bot_scsi_sync_cache(void *udev, uint8_t lun)
+{
+  usbd_core_type *pudev = (usbd_core_type *)udev;
+  msc_type *pmsc = (msc_type *)pudev->class_handler->pdata;
+
+  pmsc->data_len = 0;
+  if(bot_scsi_cache_flush(udev) != USB_OK)
+  {
+    bot_scsi_sense_code(udev, SENSE_KEY_HARDWARE_ERROR, MEDIUM_NOT_PRESENT);
+    return USB_FAIL;
+  }
+  return USB_OK;
+}
+
+/**
+  * @brief  bulk-only transport scsi command unmap, the parameter list
+  *         is received first then each block descriptor is unmapped
+  * @param  udev: to the structure of usbd_core_type
+  * @param  lun: logical units number
+  * @retval status of usb_sts_type
+  */
+usb_sts_type bot_scsi_unmap(void *udev, uint8_t lun)
+{
+  usbd_core_type *pudev = (usbd_core_type *)udev;
+  msc_type *pmsc = (msc_type *)pudev->class_handler->pdata;
+  uint8_t *cmd = pmsc->cbw_struct.CBWCB;
+  uint8_t *pdata = pmsc->data;
+  uint32_t list_len, offset;
+  uint32_t blk_addr, blk_count;
+
+  if(pmsc->msc_state == MSC_STATE_MACHINE_IDLE)
+  {
+    list_len = cmd[7] << 8 | cmd[8];
+    pmsc->data_len = 0;
+    if(list_len == 0)
+    {
+      return USB_OK;
+    }
+    if(((pmsc->cbw_struct.bmCBWFlags & 0x80) == 0x80) ||
+       (list_len > MSC_MAX_DATA_BUF_LEN) ||
+       (pmsc->cbw_struct.dCBWDataTransferLength != list_len))
+    {
+      bot_scsi_sense_code(udev, SENSE_KEY_ILLEGAL_REQUEST, INVALID_FIELED_IN_COMMAND);
+      return USB_FAIL;
+    }
+    pmsc->blk_len = list_len;
+    pmsc->msc_state = MSC_STATE_MACHINE_DATA_OUT;
+    usbd_ept_recv(pudev, USBD_MSC_BULK_OUT_EPT, pmsc->data, list_len);
+    return USB_OK;
+  }
+
+  /* parameter list received */
+  pmsc->csw_struct.dCSWDataResidue -= pmsc->blk_len;
+  list_len = MIN((uint32_t)(pdata[2] << 8 | pdata[3]) + MSC_UNMAP_HEADER_LEN, pmsc->blk_len);
+  for(offset = MSC_UNMAP_HEADER_LEN; offset + MSC_UNMAP_DESC_LEN <= list_len; offset += MSC_UNMAP_DESC_LEN)
+  {
+    if(pdata[offset] | pdata[offset + 1] | pdata[offset + 2] | pdata[offset + 3])
+    {
+      bot_scsi_sense_code(udev, SENSE_KEY_ILLEGAL_REQUEST, ADDRESS_OUT_OF_RANGE);
+      return USB_FAIL;
+    }
+    blk_addr = pdata[offset + 4] << 24 | pdata[offset + 5] << 16 | pdata[offset + 6] << 8 | pdata[offset + 7];
+    blk_count = pdata[offset + 8] << 24 | pdata[offset + 9] << 16 | pdata[offset + 10] << 8 | pdata[offset + 11];
+    if(blk_count == 0)
+    {
+      continue;
+    }
+    if(bot_scsi_check_address(udev, lun, blk_addr, blk_count) != USB_OK)
+    {
+      return USB_FAIL;
+    }
+    bot_scsi_cache_invalidate(udev, lun, (uint64_t)blk_addr * pmsc->blk_size[lun], blk_count * pmsc->blk_size[lun]);
+    if(msc_disk_unmap(lun, (uint64_t)blk_addr * pmsc->blk_size[lun], blk_count * pmsc->blk_size[lun]) != USB_OK)
+    {
+      bot_scsi_sense_code(udev, SENSE_KEY_HARDWARE_ERROR, MEDIUM_NOT_PRESENT);
+      return USB_FAIL;
+    }
+  }
+  bot_scsi_send_csw(udev, CSW_BCSWSTATUS_PASS);
+  return USB_OK;
+}
+
+/**
+  * @brief  disk unmap, default is no operation, storage can override it
+  *         to release the blocks (e.g. mark flash sectors erasable)
+  * @param  lun: logical units number
+  * @param  addr: logical address
+  * @param  len: unmap length
+  * @retval status of usb_sts_type
+  */
+__WEAK usb_sts_type msc_disk_unmap(uint8_t lun, uint64_t addr, uint32_t len)
+{
+  return USB_OK;
+}
+
+/**
+  * @brief  decode address and length of read/write 10, 12 and 16 command
+  * @param  udev: to the structure of usbd_core_type
+  * @param  lun: logical units number
+  * @retval status of usb_sts_type
+  */
+static usb_sts_type bot_scsi_rw_decode(void *udev, uint8_t lun)
+{
+  usbd_core_type *pudev = (usbd_core_type *)udev;
+  msc_type *pmsc = (msc_type *)pudev->class_handler->pdata;
+  uint8_t *cmd = pmsc->cbw_struct.CBWCB;
+
+  switch(cmd[0])
+  {
+    case MSC_CMD_READ_16:
+    case MSC_CMD_WRITE_16:
+      if(cmd[2] | cmd[3] | cmd[4] | cmd[5])
+      {
+        bot_scsi_sense_code(udev, SENSE_KEY_ILLEGAL_REQUEST, ADDRESS_OUT_OF_RANGE);
+        return USB_FAIL;
+      }
+      pmsc->blk_addr = cmd[6] << 24 | cmd[7] << 16 | cmd[8] << 8 | cmd[9];
+      pmsc->blk_len = cmd[10] << 24 | cmd[11] << 16 | cmd[12] << 8 | cmd[13];
+      break;
+
+    case MSC_CMD_READ_12:
+    case MSC_CMD_WRITE_12:
+      pmsc->blk_addr = cmd[2] << 24 | cmd[3] << 16 | cmd[4] << 8 | cmd[5];
+      pmsc->blk_len = cmd[6] << 24 | cmd[7] << 16 | cmd[8] << 8 | cmd[9];
+      break;
+
+    default:
+      pmsc->blk_addr = cmd[2] << 24 | cmd[3] << 16 | cmd[4] << 8 | cmd[5];
+      pmsc->blk_len = cmd[7] << 8 | cmd[8];
+      break;
+  }
+
+  if(pmsc->blk_len > pmsc->blk_nbr[lun])
+  {
+    bot_scsi_sense_code(udev, SENSE_KEY_ILLEGAL_REQUEST, ADDRESS_OUT_OF_RANGE);
+    return USB_FAIL;
+  }
+
+  /* the byte length of the transfer must fit dCBWDataTransferLength */
+  if(pmsc->blk_len > 0xFFFFFFFF / pmsc->blk_size[lun])
+  {
+    bot_scsi_sense_code(udev, SENSE_KEY_ILLEGAL_REQUEST, INVALID_FIELED_IN_COMMAND);
+    return USB_FAIL;
+  }
+  return bot_scsi_check_address(udev, lun, pmsc->blk_addr, pmsc->blk_len);
+}
+
+#ifndef MSC_ASYNC_STORAGE
+/**
+  * @brief  disk read through the write-back cache, blocks still dirty
+  *         in the cache are copied over the storage data
+  * @param  udev: to the structure of usbd_core_type
+  * @param  lun: logical units number
+  * @param  addr: logical address
+  * @param  buf: pointer to read buffer
+  * @param  len: read length
+  * @retval status of usb_sts_type
+  */
+static usb_sts_type bot_scsi_disk_read(void *udev, uint8_t lun, uint64_t addr, uint8_t *buf, uint32_t len)
+{
+#ifdef MSC_WRITE_CACHE
+  usbd_core_type *pudev = (usbd_core_type *)udev;
+  msc_type *pmsc = (msc_type *)pudev->class_handler->pdata;
+  msc_cache_type *pcache;
+  uint32_t blk_size = pmsc->blk_size[lun];
+  uint32_t i_index, j_index;
+#endif
+
+  if(msc_disk_read(lun, addr, buf, len) != USB_OK)
+  {
+    return USB_FAIL;
+  }
+
+#ifdef MSC_WRITE_CACHE
+  for(i_index = 0; i_index < MSC_CACHE_BLOCK_NUM; i_index ++)
+  {
+    pcache = &pmsc->cache[i_index];
+    if(pcache->valid && pcache->lun == lun &&
+       pcache->addr >= addr && pcache->addr < addr + len)
+    {
+      for(j_index = 0; j_index < blk_size; j_index ++)
+      {
+        buf[pcache->addr - addr + j_index] = pcache->data[j_index];
+      }
+    }
+  }
+#endif
+  return USB_OK;
+}
+
+/**
+  * @brief  disk write through the write-back cache, short writes are kept
+  *         in the cache so repeated updates of a block are written once,
+  *         long writes go to storage directly
+  * @param  udev: to the structure of usbd_core_type
+  * @param  lun: logical units number
+  * @param  addr: logical address
+  * @param  buf: pointer to write buffer
+  * @param  len: write length
+  * @retval status of usb_sts_type
+  */
+static usb_sts_type bot_scsi_disk_write(void *udev, uint8_t lun, uint64_t addr, uint8_t *buf, uint32_t len)
+{
+#ifdef MSC_WRITE_CACHE
+  usbd_core_type *pudev = (usbd_core_type *)udev;
+  msc_type *pmsc = (msc_type *)pudev->class_handler->pdata;
+  msc_cache_type *pcache, *pvictim;
+  uint32_t blk_size = pmsc->blk_size[lun];
+  uint32_t offset, i_index, j_index;
+
+  if(blk_size > MSC_CACHE_BLOCK_SIZE || len > blk_size * MSC_CACHE_BLOCK_NUM)
+  {
+    bot_scsi_cache_invalidate(udev, lun, addr, len);
+    return msc_disk_write(lun, addr, buf, len);
+  }
+
+  for(offset = 0; offset < len; offset += blk_size)
+  {
+    pcache = 0;
+    pvictim = &pmsc->cache[0];
+    for(i_index = 0; i_index < MSC_CACHE_BLOCK_NUM; i_index ++)
+    {
+      if(pmsc->cache[i_index].valid && pmsc->cache[i_index].lun == lun &&
+         pmsc->cache[i_index].addr == addr + offset)
+      {
+        pcache = &pmsc->cache[i_index];
+        break;
+      }
+      /* free block first, otherwise the least recently used */
+      if(pvictim->valid &&
+         (pmsc->cache[i_index].valid == 0 || pmsc->cache[i_index].age < pvictim->age))
+      {
+        pvictim = &pmsc->cache[i_index];
+      }
+    }
+
+    if(pcache == 0)
+    {
+      pcache = pvictim;
+      if(pcache->valid && pcache->dirty)
+      {
+        if(msc_disk_write(pcache->lun, pcache->addr, pcache->data, blk_size) != USB_OK)
+        {
+          return USB_FAIL;
+        }
+      }
+      pcache->lun = lun;
+      pcache->addr = addr + offset;
+      pcache->valid = 1;
+    }
+
+    for(j_index = 0; j_index < blk_size; j_index ++)
+    {
+      pcache->data[j_index] = buf[offset + j_index];
+    }
+    pcache->dirty = 1;
+    pcache->age = ++ pmsc->cache_age;
+  }
+  return USB_OK;
+#else
+  return msc_disk_write(lun, addr, buf, len);
+#endif
+}
+#endif
+
+/**
+  * @brief  drop cached blocks in the address range
+  * @param  udev: to the structure of usbd_core_type
+  * @param  lun: logical units number
+  * @param  addr: logical address
+  * @param  len: length
+  * @retval none
+  */
+static void bot_scsi_cache_invalidate(void *udev, uint8_t lun, uint64_t addr, uint32_t len)
+{
+#ifdef MSC_WRITE_CACHE
+  usbd_core_type *pudev = (usbd_core_type *)udev;
+  msc_type *pmsc = (msc_type *)pudev->class_handler->pdata;
+  uint32_t i_index;
+
+  for(i_index = 0; i_index < MSC_CACHE_BLOCK_NUM; i_index ++)
+  {
+    if(pmsc->cache[i_index].lun == lun &&
+       pmsc->cache[i_index].addr >= addr && pmsc->cache[i_index].addr < addr + len)
+    {
+      pmsc->cache[i_index].valid = 0;
+      pmsc->cache[i_index].dirty = 0;
+    }
+  }
+#endif
+}
+
+/**
+  * @brief  write back all dirty blocks of the write-back cache
+  * @param  udev: to the structure of usbd_core_type
+  * @retval status of usb_sts_type
+  */
+usb_sts_type bot_scsi_cache_flush(void *udev)
+{
+#ifdef MSC_WRITE_CACHE
+  usbd_core_type *pudev = (usbd_core_type *)udev;
+  msc_type *pmsc = (msc_type *)pudev->class_handler->pdata;
+  msc_cache_type *pcache;
+  uint32_t i_index;
+
+  for(i_index = 0; i_index < MSC_CACHE_BLOCK_NUM; i_index ++)
+  {
+    pcache = &pmsc->cache[i_index];
+    if(pcache->valid && pcache->dirty)
+    {
+      if(msc_disk_write(pcache->lun, pcache->addr, pcache->data, pmsc->blk_size[pcache->lun]) != USB_OK)
+      {
+        return USB_FAIL;
+      }
+      pcache->dirty = 0;
+    }
+  }
+#endif
+  return USB_OK;
+}
+
+/**
+  * @brief  start of frame, write back the cache when no command came for
+  *         MSC_CACHE_IDLE_SOF frames
+  * @param  udev: to the structure of usbd_core_type
+  * @retval none
+  */
+void bot_scsi_sof_handler(void *udev)
+{
+#ifdef MSC_WRITE_CACHE
+  usbd_core_type *pudev = (usbd_core_type *)udev;
+  msc_type *pmsc = (msc_type *)pudev->class_handler->pdata;
+
+  if(pmsc->msc_state != MSC_STATE_MACHINE_IDLE)
+  {
+    pmsc->cache_idle = 0;
+  }
+  else if(++ pmsc->cache_idle >= MSC_CACHE_IDLE_SOF)
+  {
+    pmsc->cache_idle = 0;
+    bot_scsi_cache_flush(udev);
+  }
+#endif
+}
+
 /**
   * @brief  clear feature
   * @param  udev: to the structure of usbd_core_type
@@ -776,6 +1571,8 @@ usb_sts_type bot_scsi_cmd_process(void *udev)
       break;
 
     case MSC_CMD_READ_10:
+    case MSC_CMD_READ_12:
+    case MSC_CMD_READ_16:
       status = bot_scsi_read10(udev, pmsc->cbw_struct.bCBWLUN);
       break;
 
@@ -796,9 +1593,24 @@ usb_sts_type bot_scsi_cmd_process(void *udev)
       break;
 
     case MSC_CMD_WRITE_10:
+    case MSC_CMD_WRITE_12:
+    case MSC_CMD_WRITE_16:
       status = bot_scsi_write10(udev, pmsc->cbw_struct.bCBWLUN);
       break;
 
+    case MSC_CMD_SERVICE_ACTION_IN16:
+      status = bot_scsi_capacity16(udev, pmsc->cbw_struct.bCBWLUN);
+      break;
+
+    case MSC_CMD_SYNCHRONIZE_CACHE10:
+    case MSC_CMD_SYNCHRONIZE_CACHE16:
+      status = bot_scsi_sync_cache(udev, pmsc->cbw_struct.bCBWLUN);
+      break;
+
+    case MSC_CMD_UNMAP:
+      status = bot_scsi_unmap(udev, pmsc->cbw_struct.bCBWLUN);
+      break;
+
     case MSC_CMD_READ_FORMAT_CAPACITY:
       status = bot_scsi_format_capacity(udev, pmsc->cbw_struct.bCBWLUN);
       break;
@@ -47,6 +47,41 @@ extern "C" {
 #define MSC_SUPPORT_MAX_LUN              1
 #define MSC_MAX_DATA_BUF_LEN             4096
 
+/**
+  * @brief msc asynchronous storage access needs the ping-pong data buffer.
+  *        with synchronous storage access the ping-pong buffer only gains
+  *        when the bulk transfer runs without the cpu (OTG_USE_DMA), without
+  *        dma the storage access blocks the fifo interrupts and nothing overlaps
+  */
+#if defined(MSC_ASYNC_STORAGE) && !defined(MSC_BOT_PINGPONG)
+#define MSC_BOT_PINGPONG
+#endif
+
+/**
+  * @brief msc write-back block cache define, the cache works with
+  *        synchronous storage access only
+  */
+#if defined(MSC_WRITE_CACHE) && defined(MSC_ASYNC_STORAGE)
+#error "MSC_WRITE_CACHE can not be used with MSC_ASYNC_STORAGE"
+#endif
+
+#ifdef MSC_WRITE_CACHE
+#ifndef MSC_CACHE_BLOCK_NUM
+#define MSC_CACHE_BLOCK_NUM              4
+#endif
+
+/* largest sector size of the luns, luns with larger blocks bypass the cache */
+#ifndef MSC_CACHE_BLOCK_SIZE
+#define MSC_CACHE_BLOCK_SIZE             512
+#endif
+
+/* sof periods without a command before dirty blocks are written back,
+   1 ms each at full speed and 125 us at high speed */
+#ifndef MSC_CACHE_IDLE_SOF
+#define MSC_CACHE_IDLE_SOF               1000
+#endif
+#endif
+
 #define MSC_CMD_FORMAT_UNIT              0x04
 #define MSC_CMD_INQUIRY                  0x12
 #define MSC_CMD_START_STOP               0x1B
@@ -63,6 +98,17 @@ extern "C" {
 #define MSC_CMD_WRITE_10                 0x2A
 #define MSC_CMD_WRITE_12                 0xAA
 #define MSC_CMD_WRITE_VERIFY             0x2E
+#define MSC_CMD_SYNCHRONIZE_CACHE10      0x35
+#define MSC_CMD_UNMAP                    0x42
+#define MSC_CMD_READ_16                  0x88
+#define MSC_CMD_WRITE_16                 0x8A
+#define MSC_CMD_SYNCHRONIZE_CACHE16      0x91
+#define MSC_CMD_SERVICE_ACTION_IN16      0x9E
+
+#define MSC_SA_READ_CAPACITY16           0x10
+#define MSC_READ_CAPACITY16_DATA_LEN     32
+#define MSC_UNMAP_DESC_LEN               16
+#define MSC_UNMAP_HEADER_LEN             8
 
 #define MSC_REQ_GET_MAX_LUN              0xFE  /*!< get max lun */
 #define MSC_REQ_BO_RESET                 0xFF  /*!< bulk only mass storage reset */
@@ -187,6 +233,20 @@ typedef struct
   uint32_t reserved3;
 }sense_type;
 
+#ifdef MSC_WRITE_CACHE
+/**
+  * @brief write-back cache block
+  */
+typedef struct
+{
+  uint64_t addr;
+  uint32_t age;
+  uint8_t  lun;
+  uint8_t  valid;
+  uint8_t  dirty;
+  uint8_t  data[MSC_CACHE_BLOCK_SIZE];
+}msc_cache_type;
+#endif
 
 typedef struct
 {
@@ -202,6 +262,27 @@ typedef struct
 
   uint32_t data_len;
   uint8_t data[MSC_MAX_DATA_BUF_LEN];
+#ifdef MSC_BOT_PINGPONG
+  uint8_t data_pp[MSC_MAX_DATA_BUF_LEN];
+
+  uint8_t *pp_buf[2];
+  uint32_t pp_len[2];
+  uint8_t pp_bus_idx;
+  uint8_t pp_disk_idx;
+  uint8_t pp_bus_busy;
+  uint8_t pp_disk_busy;
+  uint8_t pp_in_cmd;
+  uint8_t pp_error;
+  uint8_t pp_lun;
+  uint64_t pp_disk_addr;
+  uint32_t pp_disk_len;
+  uint32_t pp_disk_cur;
+#endif
+#ifdef MSC_WRITE_CACHE
+  msc_cache_type cache[MSC_CACHE_BLOCK_NUM];
+  uint32_t cache_age;
+  uint32_t cache_idle;
+#endif
 
   uint32_t alt_setting;
 
@@ -234,7 +315,20 @@ usb_sts_type bot_scsi_format_capacity(void *udev, uint8_t lun);
 usb_sts_type bot_scsi_request_sense(void *udev, uint8_t lun);
 usb_sts_type bot_scsi_verify(void *udev, uint8_t lun);
 usb_sts_type bot_scsi_write10(void *udev, uint8_t lun);
+usb_sts_type bot_scsi_capacity16(void *udev, uint8_t lun);
+usb_sts_type bot_scsi_sync_cache(void *udev, uint8_t lun);
+usb_sts_type bot_scsi_unmap(void *udev, uint8_t lun);
+usb_sts_type bot_scsi_cache_flush(void *udev);
+void bot_scsi_sof_handler(void *udev);
+usb_sts_type msc_disk_unmap(uint8_t lun, uint64_t addr, uint32_t len);
 void bot_scsi_clear_feature(void *udev, uint8_t ept_num);
+#ifdef MSC_BOT_PINGPONG
+void bot_scsi_storage_done(void *udev, usb_sts_type status);
+#endif
+#ifdef MSC_ASYNC_STORAGE
+usb_sts_type msc_disk_read_start(uint8_t lun, uint64_t addr, uint8_t *read_buf, uint32_t len);
+usb_sts_type msc_disk_write_start(uint8_t lun, uint64_t addr, uint8_t *buf, uint32_t len);
+#endif
 
 /**
   * @}
@@ -109,6 +109,9 @@ static usb_sts_type class_clear_handler(void *udev)
   usb_sts_type status = USB_OK;
   usbd_core_type *pudev = (usbd_core_type *)udev;
 
+  /* write back the cached blocks before the class goes away */
+  bot_scsi_cache_flush(udev);
+
   /* close in endpoint */
   usbd_ept_close(pudev, USBD_MSC_BULK_IN_EPT);
 
@@ -257,7 +260,7 @@ static usb_sts_type class_sof_handler(void *udev)
 {
   usb_sts_type status = USB_OK;
 
-  /* ...user code... */
+  bot_scsi_sof_handler(udev);
 
   return status;
 }
@@ -275,7 +278,8 @@ static usb_sts_type class_event_handler(void *udev, usbd_event_type event)
   {
     case USBD_RESET_EVENT:
 
-      /* ...user code... */
+      /* acknowledged writes must not stay in the cache over a bus reset */
+      bot_scsi_cache_flush(udev);
 
       break;
     case USBD_SUSPEND_EVENT:
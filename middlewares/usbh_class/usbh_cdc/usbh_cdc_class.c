@@ -105,7 +105,7 @@ static usb_sts_type uhost_init_handler(void *uhost)
       pcdc->common_interface.notif_endpoint_size  = puhost->dev.cfg_desc.interface[if_x].endpoint[0].wMaxPacketSize;
     }
     /* allocate the length for host channel number in */
-    pcdc->common_interface.notif_channel = usbh_alloc_channel(puhost, pcdc->common_interface.notif_endpoint);
+    pcdc->common_interface.notif_channel = usbh_alloc_periodic_channel(puhost, pcdc->common_interface.notif_endpoint);
     
     /* enable channel */
     usbh_hc_open(puhost, 
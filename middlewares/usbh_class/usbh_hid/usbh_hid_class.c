@@ -97,7 +97,7 @@ static usb_sts_type uhost_init_handler(void *uhost)
       phid->in_maxpacket = puhost->dev.cfg_desc.interface[hidx].endpoint[eptidx].wMaxPacketSize;
       phid->in_poll = puhost->dev.cfg_desc.interface[hidx].endpoint[eptidx].bInterval;
 
-      phid->chin = usbh_alloc_channel(puhost, phid->eptin);
+      phid->chin = usbh_alloc_periodic_channel(puhost, phid->eptin);
       /* enable channel */
       usbh_hc_open(puhost, phid->chin,phid->eptin,
                     puhost->dev.address, EPT_INT_TYPE,
@@ -112,7 +112,7 @@ static usb_sts_type uhost_init_handler(void *uhost)
       phid->out_maxpacket = puhost->dev.cfg_desc.interface[hidx].endpoint[eptidx].wMaxPacketSize;
       phid->out_poll = puhost->dev.cfg_desc.interface[hidx].endpoint[eptidx].bInterval;
 
-      phid->chout = usbh_alloc_channel(puhost, phid->eptout);
+      phid->chout = usbh_alloc_periodic_channel(puhost, phid->eptout);
       /* enable channel */
       usbh_hc_open(puhost, phid->chout, phid->eptout,
                     puhost->dev.address, EPT_INT_TYPE,
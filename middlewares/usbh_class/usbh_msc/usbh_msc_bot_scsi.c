@@ -49,6 +49,8 @@ static usb_sts_type usbh_cmd_write(msc_bot_trans_type *bot_trans, uint8_t *cmd,
                             uint32_t data_len, uint32_t address, uint8_t *buffer);
 static usb_sts_type usbh_cmd_read(msc_bot_trans_type *bot_trans, uint8_t *cmd, uint8_t lun,
                             uint32_t data_len, uint32_t address, uint8_t *buffer);
+static uint32_t usbh_bot_data_len(msc_bot_trans_type *bot_trans, uint16_t maxpacket, uint32_t burst);
+static void usbh_bot_data_next(msc_bot_trans_type *bot_trans);
 
 /**
   * @brief  usb host bulk-only cbw
@@ -164,6 +166,14 @@ static usb_sts_type usbh_cmd_write(msc_bot_trans_type *bot_trans, uint8_t *cmd,
   cmd[8] = data_len;
 
   bot_trans->data = buffer;
+  bot_trans->seg_idx = bot_trans->seg_num;
+  if(bot_trans->seg_num > 1)
+  {
+    /* merged request, data phase walks the segment list */
+    bot_trans->seg_idx = 0;
+    bot_trans->data = bot_trans->seg[0].data;
+    bot_trans->seg_len = bot_trans->seg[0].len;
+  }
   return USB_OK;
 }
 
@@ -191,9 +201,76 @@ static usb_sts_type usbh_cmd_read(msc_bot_trans_type *bot_trans, uint8_t *cmd, u
   cmd[8] = data_len;
 
   bot_trans->data = buffer;
+  bot_trans->seg_idx = bot_trans->seg_num;
+  if(bot_trans->seg_num > 1)
+  {
+    /* merged request, data phase walks the segment list */
+    bot_trans->seg_idx = 0;
+    bot_trans->data = bot_trans->seg[0].data;
+    bot_trans->seg_len = bot_trans->seg[0].len;
+  }
   return USB_OK;
 }
 
+/**
+  * @brief  usb host bulk-only length of the next data phase request
+  * @param  bot_trans: to the structure of msc_bot_trans_type
+  * @param  maxpacket: endpoint max packet size
+  * @param  burst: max packets of one request
+  * @retval request length
+  */
+static uint32_t usbh_bot_data_len(msc_bot_trans_type *bot_trans, uint16_t maxpacket, uint32_t burst)
+{
+  uint32_t len = bot_trans->cbw.dCBWDataTransferLength;
+
+  if(bot_trans->seg_idx < bot_trans->seg_num && len > bot_trans->seg_len)
+  {
+    len = bot_trans->seg_len;
+  }
+
+  if(len > maxpacket * burst)
+  {
+    len = maxpacket * burst;
+  }
+  else if(len > maxpacket)
+  {
+    len -= len % maxpacket;
+  }
+  else
+  {
+    len = maxpacket;
+  }
+  return len;
+}
+
+/**
+  * @brief  usb host bulk-only advance data pointer after a data phase request
+  * @param  bot_trans: to the structure of msc_bot_trans_type
+  * @retval none
+  */
+static void usbh_bot_data_next(msc_bot_trans_type *bot_trans)
+{
+  if(bot_trans->cbw.dCBWDataTransferLength > bot_trans->data_len)
+  {
+    bot_trans->data += bot_trans->data_len;
+    bot_trans->cbw.dCBWDataTransferLength -= bot_trans->data_len;
+    if(bot_trans->seg_idx < bot_trans->seg_num)
+    {
+      bot_trans->seg_len -= bot_trans->data_len;
+      if(bot_trans->seg_len == 0 && bot_trans->seg_idx + 1 < bot_trans->seg_num)
+      {
+        bot_trans->seg_idx ++;
+        bot_trans->data = bot_trans->seg[bot_trans->seg_idx].data;
+        bot_trans->seg_len = bot_trans->seg[bot_trans->seg_idx].len;
+      }
+    }
+  }
+  else
+  {
+    bot_trans->cbw.dCBWDataTransferLength = 0;
+  }
+}
+
 /**
   * @brief  usb host csw check
   * @param  cbw: to the structure of msc_bot_cbw_type
@@ -267,8 +344,9 @@ usb_sts_type usb_bot_request(void *uhost, msc_bot_trans_type *bot_trans)
       break;
 
     case BOT_STATE_DATA_IN:
+      bot_trans->data_len = usbh_bot_data_len(bot_trans, msc_struct->in_maxpacket, USBH_MSC_BURST_PKT_NUM);
       usbh_bulk_recv(puhost, msc_struct->chin, bot_trans->data,
-                     msc_struct->in_maxpacket);
+                     bot_trans->data_len);
       bot_trans->bot_state = BOT_STATE_DATA_IN_WAIT;
       break;
 
@@ -276,19 +354,12 @@ usb_sts_type usb_bot_request(void *uhost, msc_bot_trans_type *bot_trans)
       urb_status = usbh_get_urb_status(puhost, msc_struct->chin);
       if(urb_status == URB_DONE)
       {
-        if(bot_trans->cbw.dCBWDataTransferLength > msc_struct->in_maxpacket)
-        {
-          bot_trans->data += msc_struct->in_maxpacket;
-          bot_trans->cbw.dCBWDataTransferLength -= msc_struct->in_maxpacket;
-        }
-        else
-        {
-          bot_trans->cbw.dCBWDataTransferLength = 0;
-        }
+        usbh_bot_data_next(bot_trans);
         if(bot_trans->cbw.dCBWDataTransferLength > 0)
         {
+          bot_trans->data_len = usbh_bot_data_len(bot_trans, msc_struct->in_maxpacket, USBH_MSC_BURST_PKT_NUM);
           usbh_bulk_recv(puhost, msc_struct->chin, bot_trans->data,
-                     msc_struct->in_maxpacket);
+                     bot_trans->data_len);
         }
         else
         {
@@ -303,7 +374,10 @@ usb_sts_type usb_bot_request(void *uhost, msc_bot_trans_type *bot_trans)
       break;
 
     case BOT_STATE_DATA_OUT:
-      usbh_bulk_send(puhost, msc_struct->chout, bot_trans->data, msc_struct->out_maxpacket);
+      /* without dma the whole request is written to the tx fifo at once */
+      bot_trans->data_len = usbh_bot_data_len(bot_trans, msc_struct->out_maxpacket,
+                                              puhost->dma_en ? USBH_MSC_BURST_PKT_NUM : 1);
+      usbh_bulk_send(puhost, msc_struct->chout, bot_trans->data, bot_trans->data_len);
       bot_trans->bot_state = BOT_STATE_DATA_OUT_WAIT;
       break;
 
@@ -311,18 +385,12 @@ usb_sts_type usb_bot_request(void *uhost, msc_bot_trans_type *bot_trans)
       urb_status = usbh_get_urb_status(puhost, msc_struct->chout);
       if(urb_status == URB_DONE)
       {
-        if(bot_trans->cbw.dCBWDataTransferLength > msc_struct->out_maxpacket)
-        {
-          bot_trans->data += msc_struct->out_maxpacket;
-          bot_trans->cbw.dCBWDataTransferLength -= msc_struct->out_maxpacket;
-        }
-        else
-        {
-          bot_trans->cbw.dCBWDataTransferLength = 0;
-        }
+        usbh_bot_data_next(bot_trans);
         if(bot_trans->cbw.dCBWDataTransferLength > 0)
         {
-          usbh_bulk_send(puhost, msc_struct->chout, bot_trans->data, msc_struct->out_maxpacket);
+          bot_trans->data_len = usbh_bot_data_len(bot_trans, msc_struct->out_maxpacket,
+                                                  puhost->dma_en ? USBH_MSC_BURST_PKT_NUM : 1);
+          usbh_bulk_send(puhost, msc_struct->chout, bot_trans->data, bot_trans->data_len);
         }
         else
         {
@@ -351,6 +419,8 @@ usb_sts_type usb_bot_request(void *uhost, msc_bot_trans_type *bot_trans)
       {
         bot_trans->bot_state = BOT_STATE_SEND_CBW;
         bot_trans->cmd_state = CMD_STATE_SEND;
+        /* command end, segment list is no longer used */
+        bot_trans->seg_idx = bot_trans->seg_num;
         status = usbh_check_csw(uhost, &bot_trans->cbw, &bot_trans->csw);
       }
       else if(urb_status == URB_STALL)
@@ -560,11 +630,12 @@ usb_sts_type usbh_msc_bot_scsi_write(void *uhost, msc_bot_trans_type *bot_trans,
                                      uint32_t address, uint8_t *write_data,
                                      uint32_t write_len, uint8_t lun)
 {
+  usbh_msc_type *msc_struct = (usbh_msc_type *)bot_trans->msc_struct;
   usb_sts_type status = USB_WAIT;
   switch(bot_trans->cmd_state)
   {
     case CMD_STATE_SEND:
-      usbh_bot_cbw(&bot_trans->cbw, write_len * 512,
+      usbh_bot_cbw(&bot_trans->cbw, write_len * msc_struct->l_unit_n[lun].capacity.blk_size,
                    MSC_WRITE_CMD_LEN, MSC_CBW_FLAG_OUT);
       bot_trans->cbw.bCBWLUN = lun;
       usbh_cmd_write(bot_trans, bot_trans->cbw.CBWCB, lun, write_len, address, write_data);
@@ -603,11 +674,12 @@ usb_sts_type usbh_msc_bot_scsi_read(void *uhost, msc_bot_trans_type *bot_trans,
                                      uint32_t address, uint8_t *read_data,
                                      uint32_t read_len, uint8_t lun)
 {
+  usbh_msc_type *msc_struct = (usbh_msc_type *)bot_trans->msc_struct;
   usb_sts_type status = USB_WAIT;
   switch(bot_trans->cmd_state)
   {
     case CMD_STATE_SEND:
-      usbh_bot_cbw(&bot_trans->cbw, read_len * 512,
+      usbh_bot_cbw(&bot_trans->cbw, read_len * msc_struct->l_unit_n[lun].capacity.blk_size,
                    MSC_READ_CMD_LEN, MSC_CBW_FLAG_IN);
       bot_trans->cbw.bCBWLUN = lun;
       usbh_cmd_read(bot_trans, bot_trans->cbw.CBWCB, lun, read_len, address, read_data);
@@ -648,6 +720,8 @@ usb_sts_type msc_bot_scsi_init(usbh_msc_type *msc_struct)
   msc_struct->bot_trans.msc_struct = &usbh_msc;
   msc_struct->bot_trans.cmd_state = CMD_STATE_SEND;
   msc_struct->bot_trans.bot_state = BOT_STATE_SEND_CBW;
+  msc_struct->bot_trans.seg_num = 0;
+  msc_struct->bot_trans.seg_idx = 0;
   return USB_OK;
 }
 
@@ -71,6 +71,18 @@ extern "C" {
 #define MSC_OPCODE_WRITE10               0x2A
 #define MSC_OPCODE_READ10                0x28
 
+/**
+  * @brief  max packets of one bulk data phase request, the default keeps
+  *         one packet per request, the queued mode uses multi-packet requests
+  */
+#ifndef USBH_MSC_BURST_PKT_NUM
+#ifdef USBH_MSC_QUEUE
+#define USBH_MSC_BURST_PKT_NUM           64
+#else
+#define USBH_MSC_BURST_PKT_NUM           1
+#endif
+#endif
+
 typedef enum
 {
   BOT_STATE_IDLE,
@@ -169,6 +181,15 @@ typedef struct
   uint8_t  bCSWStatus;
 }msc_bot_csw_type;
 
+/**
+  * @brief  usb msc bulk-only data segment type
+  */
+typedef struct
+{
+  uint8_t *data;
+  uint32_t len;
+}msc_bot_seg_type;
+
 /**
   * @brief  usb msc bulk-only transfer control type
   */
@@ -180,6 +201,11 @@ typedef struct
   msc_cmd_state_type cmd_state;
   msc_bot_state_type bot_state;
   uint8_t *data;
+  uint32_t data_len;
+  msc_bot_seg_type *seg;
+  uint8_t seg_num;
+  uint8_t seg_idx;
+  uint32_t seg_len;
   void *msc_struct;
 }msc_bot_trans_type;
 
@@ -46,6 +46,10 @@ static usb_sts_type uhost_process_handler(void *uhost);
 
 static usb_sts_type usbh_msc_get_max_lun(void *uhost, uint8_t *lun);
 static usb_sts_type usbh_msc_clear_feature(void *uhost, uint8_t ept_num);
+#ifdef USBH_MSC_QUEUE
+static void usbh_msc_queue_reset(usbh_msc_type *pmsc);
+static void usbh_msc_queue_complete(usbh_msc_type *pmsc, usb_sts_type status);
+#endif
 
 
 usbh_msc_type usbh_msc;
@@ -142,6 +146,9 @@ static usb_sts_type uhost_reset_handler(void *uhost)
     pmsc->l_unit_n[i_index].state = USBH_MSC_INIT;
     pmsc->l_unit_n[i_index].ready = MSC_NOT_READY;
   }
+#ifdef USBH_MSC_QUEUE
+  usbh_msc_queue_reset(pmsc);
+#endif
 
   if(pmsc->chin != 0 )
   {
@@ -294,6 +301,9 @@ static usb_sts_type uhost_process_handler(void *uhost)
       }
       break;
     case USBH_MSC_IDLE:
+#ifdef USBH_MSC_QUEUE
+    usbh_msc_queue_process(uhost);
+#endif
     if(puhost->user_handler->user_application != NULL)
     {
       puhost->user_handler->user_application();
@@ -447,6 +457,14 @@ usb_sts_type usbh_msc_rw_handle(void *uhost, uint32_t address, uint32_t len, uin
   */
 usb_sts_type usbh_msc_read(void *uhost, uint32_t address, uint32_t len, uint8_t *buffer, uint8_t lun)
 {
+#ifdef USBH_MSC_QUEUE
+  uint8_t handle;
+  if(usbh_msc_submit(uhost, USBH_MSC_DIR_READ, address, len, buffer, lun, &handle) != USB_OK)
+  {
+    return USB_FAIL;
+  }
+  return usbh_msc_wait(uhost, handle);
+#else
   usbh_core_type *puhost = (usbh_core_type *)uhost;
   usbh_msc_type *pmsc = (usbh_msc_type *)puhost->class_handler->pdata;
   uint32_t timeout = 0;
@@ -470,6 +488,7 @@ usb_sts_type usbh_msc_read(void *uhost, uint32_t address, uint32_t len, uint8_t
     }
   }
   return USB_OK;
+#endif
 }
 
 /**
@@ -483,6 +502,14 @@ usb_sts_type usbh_msc_read(void *uhost, uint32_t address, uint32_t len, uint8_t
   */
 usb_sts_type usbh_msc_write(void *uhost, uint32_t address, uint32_t len, uint8_t *buffer, uint8_t lun)
 {
+#ifdef USBH_MSC_QUEUE
+  uint8_t handle;
+  if(usbh_msc_submit(uhost, USBH_MSC_DIR_WRITE, address, len, buffer, lun, &handle) != USB_OK)
+  {
+    return USB_FAIL;
+  }
+  return usbh_msc_wait(uhost, handle);
+#else
   usbh_core_type *puhost = (usbh_core_type *)uhost;
   usbh_msc_type *pmsc = (usbh_msc_type *)puhost->class_handler->pdata;
   uint32_t timeout = 0;
@@ -506,7 +533,215 @@ usb_sts_type usbh_msc_write(void *uhost, uint32_t address, uint32_t len, uint8_t
     }
   }
   return USB_OK;
+#endif
+}
+
+#ifdef USBH_MSC_QUEUE
+/**
+  * @brief  usb host msc submit a queued read or write request, the request
+  *         is carried out by usbh_msc_queue_process and the buffer must stay
+  *         valid until the request completes
+  * @param  uhost: to the structure of usbh_core_type
+  * @param  dir: USBH_MSC_DIR_READ or USBH_MSC_DIR_WRITE
+  * @param  address: logical block address
+  * @param  len: transfer sector number
+  * @param  buffer: transfer data buffer
+  * @param  lun: logical unit number
+  * @param  handle: returned request handle
+  * @retval status: usb_sts_type status, USB_FAIL when queue is full
+  */
+usb_sts_type usbh_msc_submit(void *uhost, uint8_t dir, uint32_t address, uint32_t len,
+                             uint8_t *buffer, uint8_t lun, uint8_t *handle)
+{
+  usbh_core_type *puhost = (usbh_core_type *)uhost;
+  usbh_msc_type *pmsc = (usbh_msc_type *)puhost->class_handler->pdata;
+  usbh_msc_req_type *preq = &pmsc->req[pmsc->q_head];
+
+  if(puhost->conn_sts == 0 || puhost->global_state != USBH_CLASS
+    || lun >= pmsc->max_lun || pmsc->l_unit_n[lun].ready != MSC_OK
+    || len == 0 || len > 0xFFFF || preq->state != USBH_MSC_REQ_FREE)
+  {
+    return USB_FAIL;
+  }
+
+  preq->address = address;
+  preq->len = len;
+  preq->buffer = buffer;
+  preq->lun = lun;
+  preq->dir = dir;
+  preq->state = USBH_MSC_REQ_PENDING;
+
+  *handle = pmsc->q_head;
+  pmsc->q_head = (pmsc->q_head + 1) % USBH_MSC_QUEUE_DEPTH;
+  return USB_OK;
+}
+
+/**
+  * @brief  usb host msc queued request status, a finished request handle
+  *         is released by this call
+  * @param  uhost: to the structure of usbh_core_type
+  * @param  handle: request handle
+  * @retval status: USB_WAIT in progress, USB_OK done, USB_FAIL error
+  */
+usb_sts_type usbh_msc_req_status(void *uhost, uint8_t handle)
+{
+  usbh_core_type *puhost = (usbh_core_type *)uhost;
+  usbh_msc_type *pmsc = (usbh_msc_type *)puhost->class_handler->pdata;
+  usbh_msc_req_type *preq = &pmsc->req[handle];
+
+  switch(preq->state)
+  {
+    case USBH_MSC_REQ_PENDING:
+    case USBH_MSC_REQ_ACTIVE:
+      return USB_WAIT;
+    case USBH_MSC_REQ_DONE:
+      preq->state = USBH_MSC_REQ_FREE;
+      return USB_OK;
+    case USBH_MSC_REQ_ERROR:
+      preq->state = USBH_MSC_REQ_FREE;
+      return USB_FAIL;
+    default:
+      return USB_FAIL;
+  }
+}
+
+/**
+  * @brief  usb host msc wait queued request done, the queue is processed
+  *         while waiting
+  * @param  uhost: to the structure of usbh_core_type
+  * @param  handle: request handle
+  * @retval status: usb_sts_type status
+  */
+usb_sts_type usbh_msc_wait(void *uhost, uint8_t handle)
+{
+  usb_sts_type status;
+  while((status = usbh_msc_req_status(uhost, handle)) == USB_WAIT)
+  {
+    usbh_msc_queue_process(uhost);
+  }
+  return status;
+}
+
+/**
+  * @brief  usb host msc request queue process, contiguous pending requests
+  *         of the same lun and direction are merged into one bot transfer
+  * @param  uhost: to the structure of usbh_core_type
+  * @retval none
+  */
+void usbh_msc_queue_process(void *uhost)
+{
+  usbh_core_type *puhost = (usbh_core_type *)uhost;
+  usbh_msc_type *pmsc = (usbh_msc_type *)puhost->class_handler->pdata;
+  usbh_msc_req_type *pfirst = &pmsc->req[pmsc->q_next];
+  usbh_msc_req_type *preq;
+  usb_sts_type status;
+  uint8_t idx;
+
+  if(puhost->conn_sts == 0)
+  {
+    usbh_msc_queue_complete(pmsc, USB_FAIL);
+    return;
+  }
+
+  if(pmsc->q_active_num == 0)
+  {
+    if(pfirst->state != USBH_MSC_REQ_PENDING ||
+       pmsc->l_unit_n[pfirst->lun].state != USBH_MSC_IDLE)
+    {
+      return;
+    }
+
+    /* merge following requests while they continue the first one */
+    idx = pmsc->q_next;
+    pmsc->q_active_len = 0;
+    while(pmsc->q_active_num < USBH_MSC_QUEUE_DEPTH)
+    {
+      preq = &pmsc->req[idx];
+      if(preq->state != USBH_MSC_REQ_PENDING || preq->lun != pfirst->lun ||
+         preq->dir != pfirst->dir || preq->address != pfirst->address + pmsc->q_active_len ||
+         (pmsc->q_active_num > 0 && pmsc->q_active_len + preq->len > USBH_MSC_MERGE_MAX_SECTOR))
+      {
+        break;
+      }
+      preq->state = USBH_MSC_REQ_ACTIVE;
+      pmsc->seg[pmsc->q_active_num].data = preq->buffer;
+      pmsc->seg[pmsc->q_active_num].len = preq->len * pmsc->l_unit_n[preq->lun].capacity.blk_size;
+      pmsc->q_active_len += preq->len;
+      pmsc->q_active_num ++;
+      idx = (idx + 1) % USBH_MSC_QUEUE_DEPTH;
+    }
+
+    pmsc->bot_trans.msc_struct = &usbh_msc;
+    pmsc->bot_trans.seg = pmsc->seg;
+    pmsc->bot_trans.seg_num = pmsc->q_active_num;
+    pmsc->l_unit_n[pfirst->lun].state = (pfirst->dir == USBH_MSC_DIR_READ) ? USBH_MSC_READ10 : USBH_MSC_WRITE;
+    pmsc->use_lun = pfirst->lun;
+    pmsc->q_timer = puhost->timer;
+  }
+
+  status = usbh_msc_rw_handle(uhost, pfirst->address, pmsc->q_active_len, pfirst->buffer, pfirst->lun);
+  if(status == USB_WAIT)
+  {
+    if((puhost->timer - pmsc->q_timer) <= (pmsc->q_active_len * 10000))
+    {
+      return;
+    }
+    pmsc->l_unit_n[pfirst->lun].state = USBH_MSC_IDLE;
+    pmsc->bot_trans.cmd_state = CMD_STATE_SEND;
+    status = USB_FAIL;
+  }
+  usbh_msc_queue_complete(pmsc, status);
+}
+
+/**
+  * @brief  usb host msc finish the active requests, on error all pending
+  *         requests are failed as well
+  * @param  pmsc: to the structure of usbh_msc_type
+  * @param  status: result of the active requests
+  * @retval none
+  */
+static void usbh_msc_queue_complete(usbh_msc_type *pmsc, usb_sts_type status)
+{
+  usbh_msc_req_type *preq;
+
+  while(pmsc->q_active_num > 0)
+  {
+    pmsc->req[pmsc->q_next].state = (status == USB_OK) ? USBH_MSC_REQ_DONE : USBH_MSC_REQ_ERROR;
+    pmsc->q_next = (pmsc->q_next + 1) % USBH_MSC_QUEUE_DEPTH;
+    pmsc->q_active_num --;
+  }
+  pmsc->bot_trans.seg_num = 0;
+
+  if(status != USB_OK)
+  {
+    preq = &pmsc->req[pmsc->q_next];
+    while(preq->state == USBH_MSC_REQ_PENDING)
+    {
+      preq->state = USBH_MSC_REQ_ERROR;
+      pmsc->q_next = (pmsc->q_next + 1) % USBH_MSC_QUEUE_DEPTH;
+      preq = &pmsc->req[pmsc->q_next];
+    }
+  }
+}
+
+/**
+  * @brief  usb host msc drop all queued requests
+  * @param  pmsc: to the structure of usbh_msc_type
+  * @retval none
+  */
+static void usbh_msc_queue_reset(usbh_msc_type *pmsc)
+{
+  uint8_t i_index;
+  for(i_index = 0; i_index < USBH_MSC_QUEUE_DEPTH; i_index ++)
+  {
+    pmsc->req[i_index].state = USBH_MSC_REQ_FREE;
+  }
+  pmsc->q_head = 0;
+  pmsc->q_next = 0;
+  pmsc->q_active_num = 0;
+  pmsc->bot_trans.seg_num = 0;
 }
+#endif
 
 /**
   * @}
@@ -74,6 +74,46 @@ extern "C" {
 
 #define USBH_SUPPORT_MAX_LUN             0x2
 
+#ifdef USBH_MSC_QUEUE
+/**
+  * @brief  usb msc request queue config
+  */
+#ifndef USBH_MSC_QUEUE_DEPTH
+#define USBH_MSC_QUEUE_DEPTH             8
+#endif
+#ifndef USBH_MSC_MERGE_MAX_SECTOR
+#define USBH_MSC_MERGE_MAX_SECTOR        128
+#endif
+
+#define USBH_MSC_DIR_READ                0
+#define USBH_MSC_DIR_WRITE               1
+
+/**
+  * @brief  usb msc queued request state
+  */
+typedef enum
+{
+  USBH_MSC_REQ_FREE,
+  USBH_MSC_REQ_PENDING,
+  USBH_MSC_REQ_ACTIVE,
+  USBH_MSC_REQ_DONE,
+  USBH_MSC_REQ_ERROR
+}usbh_msc_req_state_type;
+
+/**
+  * @brief  usb msc queued request
+  */
+typedef struct
+{
+  uint32_t                               address;
+  uint32_t                               len;
+  uint8_t                                *buffer;
+  uint8_t                                lun;
+  uint8_t                                dir;
+  usbh_msc_req_state_type                state;
+}usbh_msc_req_type;
+#endif
+
 /**
   * @brief  usb msc request state
   */
@@ -113,6 +153,15 @@ typedef struct
   usbh_msc_unit_type                     l_unit_n[USBH_SUPPORT_MAX_LUN];
   uint16_t                               poll_timer;
   uint8_t buffer[64];
+#ifdef USBH_MSC_QUEUE
+  usbh_msc_req_type                      req[USBH_MSC_QUEUE_DEPTH];
+  msc_bot_seg_type                       seg[USBH_MSC_QUEUE_DEPTH];
+  uint8_t                                q_head;
+  uint8_t                                q_next;
+  uint8_t                                q_active_num;
+  uint32_t                               q_active_len;
+  uint32_t                               q_timer;
+#endif
 }usbh_msc_type;
 
 extern usbh_class_handler_type uhost_msc_class_handler;
@@ -122,6 +171,13 @@ usb_sts_type usbh_msc_write(void *uhost, uint32_t address, uint32_t len, uint8_t
 usb_sts_type usbh_msc_read(void *uhost, uint32_t address, uint32_t len, uint8_t *buffer, uint8_t lun);
 usb_sts_type usbh_msc_rw_handle(void *uhost, uint32_t address, uint32_t len, uint8_t *buffer, uint8_t lun);
 usb_sts_type msc_bot_scsi_init(usbh_msc_type *msc_struct);
+#ifdef USBH_MSC_QUEUE
+usb_sts_type usbh_msc_submit(void *uhost, uint8_t dir, uint32_t address, uint32_t len,
+                             uint8_t *buffer, uint8_t lun, uint8_t *handle);
+usb_sts_type usbh_msc_req_status(void *uhost, uint8_t handle);
+usb_sts_type usbh_msc_wait(void *uhost, uint8_t handle);
+void usbh_msc_queue_process(void *uhost);
+#endif
 
 /**
   * @}
@@ -0,0 +1,71 @@
+/**
+  **************************************************************************
+  * @file     crc_soft.h
+  * @brief    header file of the software crc reference
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#ifndef __CRC_SOFT_H
+#define __CRC_SOFT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the reference only depends on the standard c library, so the same file
+   builds on a pc and checks the hardware results there */
+#include <stdint.h>
+
+/** @addtogroup AT32F402_periph_examples
+  * @{
+  */
+
+/** @addtogroup 402_CRC_calculation
+  * @{
+  */
+
+/**
+  * @brief crc algorithm of the software reference
+  */
+typedef struct
+{
+  uint32_t                               width;        /*!< crc width in bits, 7 to 32 */
+  uint32_t                               poly;         /*!< polynomial value, normal representation */
+  uint32_t                               init;         /*!< initial value */
+  uint32_t                               xor_out;      /*!< value xor-ed to the final result */
+  uint8_t                                reflect_in;   /*!< input bytes are bit reversed */
+  uint8_t                                reflect_out;  /*!< result is bit reversed */
+} crc_soft_model_type;
+
+uint32_t crc_soft_calculate(const crc_soft_model_type *model, const uint8_t *pdata, uint32_t length);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
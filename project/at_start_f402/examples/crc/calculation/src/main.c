@@ -24,6 +24,7 @@
 
 #include "at32f402_405_board.h"
 #include "at32f402_405_clock.h"
+#include "crc_soft.h"
 
 /** @addtogroup AT32F402_periph_examples
   * @{
@@ -59,7 +60,82 @@ static const uint32_t data_buffer[BUFFER_SIZE] =
   0x4ad47ab7, 0x6a961a71, 0x0a503a33, 0x2a12dbfd, 0xfbbfeb9e, 0x9b798b58
 };
 
+static const uint8_t check_string[9] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
 __IO uint32_t crc_value = 0;
+__IO uint32_t soft_cycles = 0;
+__IO uint32_t stream_cycles = 0;
+__IO uint32_t dma_cycles = 0;
+
+/**
+  * @brief  software reference parameters of a preset
+  * @param  preset: crc algorithm
+  * @param  model: reference parameters
+  * @retval none
+  */
+static void crc_soft_model_get(const crc_preset_type *preset, crc_soft_model_type *model)
+{
+  model->width = (preset->poly_size == CRC_POLY_SIZE_32B) ? 32 :
+                 (preset->poly_size == CRC_POLY_SIZE_16B) ? 16 :
+                 (preset->poly_size == CRC_POLY_SIZE_8B) ? 8 : 7;
+  model->poly = preset->poly;
+  model->init = preset->init;
+  model->xor_out = preset->xor_out;
+  model->reflect_in = (preset->reflect_in == TRUE);
+  model->reflect_out = (preset->reflect_out == TRUE);
+}
+
+/**
+  * @brief  check the crc stream api against the software reference,
+  *         with unaligned start and uneven update sizes, by cpu and by dma.
+  * @param  preset: crc algorithm
+  * @param  check: crc of "123456789"
+  * @retval SUCCESS or ERROR
+  */
+static error_status crc_preset_check(const crc_preset_type *preset, uint32_t check)
+{
+  const uint8_t *pdata = (const uint8_t *)data_buffer + 1;
+  uint32_t length = sizeof(data_buffer) - 3;
+  crc_soft_model_type model;
+  crc_stream_type stream;
+  uint32_t soft, start;
+
+  if(crc_stream_calculate(preset, check_string, sizeof(check_string)) != check)
+  {
+    return ERROR;
+  }
+
+  crc_soft_model_get(preset, &model);
+  start = DWT->CYCCNT;
+  soft = crc_soft_calculate(&model, pdata, length);
+  soft_cycles = DWT->CYCCNT - start;
+
+  start = DWT->CYCCNT;
+  crc_stream_init(&stream, preset);
+  crc_stream_update(&stream, pdata, 5);
+  crc_stream_update(&stream, pdata + 5, 250);
+  crc_stream_update(&stream, pdata + 255, length - 255);
+  crc_value = crc_stream_final(&stream);
+  stream_cycles = DWT->CYCCNT - start;
+  if(crc_value != soft)
+  {
+    return ERROR;
+  }
+
+  start = DWT->CYCCNT;
+  crc_stream_init(&stream, preset);
+  crc_stream_dma_start(&stream, DMA1_CHANNEL1, pdata, length);
+  while(crc_stream_dma_busy(&stream) == SET)
+  {
+  }
+  crc_value = crc_stream_final(&stream);
+  dma_cycles = DWT->CYCCNT - start;
+  if(crc_value != soft)
+  {
+    return ERROR;
+  }
+  return SUCCESS;
+}
 
 /**
   * @brief  main function.
@@ -72,15 +148,23 @@ int main(void)
 
   at32_board_init();
 
-  /* enable crc clock */
+  /* enable crc and dma clock */
   crm_periph_clock_enable(CRM_CRC_PERIPH_CLOCK, TRUE);
+  crm_periph_clock_enable(CRM_DMA1_PERIPH_CLOCK, TRUE);
+
+  /* cycle counter for the throughput figures */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 
   crc_data_reset();
 
   /* compute the crc of "data_buffer" */
   crc_value = crc_block_calculate((uint32_t *)data_buffer, BUFFER_SIZE);
 
-  if(crc_value == 0xE5DFCF6D)
+  if(crc_value == 0xE5DFCF6D &&
+     crc_preset_check(&crc_preset_crc16_ccitt, 0x29B1) == SUCCESS &&
+     crc_preset_check(&crc_preset_crc8, 0xF4) == SUCCESS &&
+     crc_preset_check(&crc_preset_crc32, 0xCBF43926) == SUCCESS)
   {
     /* turn on led3 */
     at32_led_on(LED3);
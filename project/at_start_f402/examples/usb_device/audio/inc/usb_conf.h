@@ -151,6 +151,12 @@ extern "C" {
   */
 /* #define USB_LOW_POWER_WAKUP */
 
+/**
+  * @brief usb device performance statistics enable,
+  *        interrupt count and cpu cycles are recorded in usbd_core_type perf
+  */
+/* #define USBD_PERF_STATISTICS */
+
 void usb_delay_ms(uint32_t ms);
 void usb_delay_us(uint32_t us);
 
@@ -152,6 +152,32 @@ extern "C" {
   */
 /* #define USB_LOW_POWER_WAKUP */
 
+/**
+  * @brief usb device performance statistics enable,
+  *        interrupt count and cpu cycles are recorded in usbd_core_type perf
+  */
+/* #define USBD_PERF_STATISTICS */
+
+/**
+  * @brief msc read10/write10 ping-pong data buffer enable,
+  *        storage access of one buffer overlaps usb transfer of the other,
+  *        use it with MSC_ASYNC_STORAGE, synchronous storage access blocks
+  *        the fifo interrupts and gains nothing
+  */
+/* #define MSC_BOT_PINGPONG */
+
+/**
+  * @brief msc asynchronous storage access enable, msc_disk_read_start and
+  *        msc_disk_write_start must be provided and call bot_scsi_storage_done
+  */
+/* #define MSC_ASYNC_STORAGE */
+
+/**
+  * @brief msc write-back block cache enable, cached blocks are written to
+  *        storage on synchronize cache, start stop unit or eviction
+  */
+/* #define MSC_WRITE_CACHE */
+
 void usb_delay_ms(uint32_t ms);
 void usb_delay_us(uint32_t us);
 
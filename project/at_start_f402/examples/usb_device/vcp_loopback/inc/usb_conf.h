@@ -151,6 +151,18 @@ extern "C" {
   */
 /* #define USB_LOW_POWER_WAKUP */
 
+/**
+  * @brief usb device performance statistics enable,
+  *        interrupt count and cpu cycles are recorded in usbd_core_type perf
+  */
+/* #define USBD_PERF_STATISTICS */
+
+/**
+  * @brief usb cdc stream mode enable, tx ring and rx block ring are used
+  *        and the loopback throughput is printed by usart1
+  */
+/* #define USBD_CDC_STREAM_MODE */
+
 void usb_delay_ms(uint32_t ms);
 void usb_delay_us(uint32_t us);
 /**
@@ -153,6 +153,18 @@ extern "C" {
   */
 /* #define USB_LOW_POWER_WAKUP */
 
+/**
+  * @brief usb host control transfer stages are advanced in the channel
+  *        interrupt, requests can have a complete callback
+  */
+/* #define USBH_CTRL_EVENT */
+
+/**
+  * @brief usb host channel scheduler, keeps channels for periodic endpoints
+  *        and limits bulk nak retries per frame
+  */
+/* #define USBH_CHANNEL_SCHEDULER */
+
 #define USBH_DEBUG_ENABLE
 
 #ifdef USBH_DEBUG_ENABLE
@@ -0,0 +1,158 @@
+/**
+  **************************************************************************
+  * @file     main.c
+  * @brief    main program
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "at32f402_405_board.h"
+#include "at32f402_405_clock.h"
+#include "adc_capture.h"
+
+/** @addtogroup AT32F405_periph_examples
+  * @{
+  */
+
+/** @addtogroup 405_ADC_fault_capture ADC_fault_capture
+  * @{
+  */
+
+#define CHANNEL_NUM                      2
+#define BLOCK_SIZE                       128
+#define SAMPLE_RATE                      10000
+#define PRE_SAMPLES                      32
+#define POST_SAMPLES                     64
+
+uint16_t adc_ring[2 * BLOCK_SIZE * CHANNEL_NUM];
+uint16_t snapshot[(PRE_SAMPLES + POST_SAMPLES) * CHANNEL_NUM];
+adc_stream_type stream;
+adc_capture_type capture;
+
+/**
+  * @brief  gpio configuration.
+  * @param  none
+  * @retval none
+  */
+static void gpio_config(void)
+{
+  gpio_init_type gpio_initstructure;
+  crm_periph_clock_enable(CRM_GPIOA_PERIPH_CLOCK, TRUE);
+
+  gpio_default_para_init(&gpio_initstructure);
+
+  /* config adc pin as analog input mode */
+  gpio_initstructure.gpio_mode = GPIO_MODE_ANALOG;
+  gpio_initstructure.gpio_pins = GPIO_PINS_4 | GPIO_PINS_5;
+  gpio_init(GPIOA, &gpio_initstructure);
+}
+
+/**
+  * @brief  main function.
+  * @param  none
+  * @retval none
+  */
+int main(void)
+{
+  uint32_t index, last_timestamp = 0;
+  uint16_t min, max;
+
+  system_clock_config();
+  at32_board_init();
+  uart_print_init(115200);
+
+  nvic_priority_group_config(NVIC_PRIORITY_GROUP_4);
+
+  /* dma clocks and channel table */
+  dma_app_init();
+
+  gpio_config();
+  adc_clock_div_set(ADC_DIV_16);
+
+  /* pa4 and pa5 at 10 khz, the ring on dma1 channel1 is the pre-trigger buffer */
+  stream.channel[0] = ADC_CHANNEL_4;
+  stream.channel[1] = ADC_CHANNEL_5;
+  stream.channel_num = CHANNEL_NUM;
+  stream.sampletime = ADC_SAMPLETIME_28_5;
+  stream.tmr_x = TMR1;
+  stream.sample_rate = SAMPLE_RATE;
+  stream.oversample_enable = FALSE;
+  stream.block_size = BLOCK_SIZE;
+  stream.ring = adc_ring;
+  stream.priority = 1;
+
+  /* pa4 out of 1000..3000 trips, the snapshot is copied by dma1 channel2 */
+  capture.channel = ADC_CHANNEL_4;
+  capture.high_threshold = 3000;
+  capture.low_threshold = 1000;
+  capture.pre_samples = PRE_SAMPLES;
+  capture.post_samples = POST_SAMPLES;
+  capture.snapshot = snapshot;
+  capture.ts_tmr = 0;
+
+  if(adc_stream_init(&stream) != SUCCESS || adc_capture_init(&capture, &stream) != SUCCESS)
+  {
+    at32_led_on(LED2);
+    while(1)
+    {
+    }
+  }
+  adc_stream_start(&stream);
+  adc_capture_arm(&capture);
+  at32_led_on(LED3);
+
+  while(1)
+  {
+    if(capture.state == ADC_CAPTURE_STATE_ERROR)
+    {
+      printf("snapshot copy failed, %d errors\r\n", (int)capture.error_count);
+      adc_capture_arm(&capture);
+    }
+
+    if(adc_capture_ready(&capture) == SET)
+    {
+      at32_led_toggle(LED4);
+
+      /* channel 0 of the sequences after the trip */
+      min = 0xFFFF;
+      max = 0;
+      for(index = PRE_SAMPLES; index < PRE_SAMPLES + POST_SAMPLES; index++)
+      {
+        min = (snapshot[index * CHANNEL_NUM] < min) ? snapshot[index * CHANNEL_NUM] : min;
+        max = (snapshot[index * CHANNEL_NUM] > max) ? snapshot[index * CHANNEL_NUM] : max;
+      }
+      printf("capture %d: sequence %d, %d cycles after the last, trip value %d, after it min %d max %d\r\n",
+             (int)capture.capture_count, (int)(capture.trigger_count / CHANNEL_NUM),
+             (int)(capture.timestamp - last_timestamp), snapshot[PRE_SAMPLES * CHANNEL_NUM], min, max);
+      last_timestamp = capture.timestamp;
+
+      /* the monitor keeps tripping while the input is out of range */
+      delay_ms(500);
+      adc_capture_arm(&capture);
+    }
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
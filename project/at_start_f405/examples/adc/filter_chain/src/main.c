@@ -0,0 +1,191 @@
+/**
+  **************************************************************************
+  * @file     main.c
+  * @brief    main program
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "at32f402_405_board.h"
+#include "at32f402_405_clock.h"
+#include "adc_filter.h"
+
+/** @addtogroup AT32F405_periph_examples
+  * @{
+  */
+
+/** @addtogroup 405_ADC_filter_chain ADC_filter_chain
+  * @{
+  */
+
+#define SAMPLE_RATE                      16000
+#define BLOCK_SIZE                       160
+#define FIR_TAPS                         32
+#define FIR_FACTOR                       8
+
+/* low pass 800 hz at 16 khz, hamming window, before the decimation by 8 */
+const float32_t fir_coeffs[FIR_TAPS] =
+{
+  -0.001646695f, -0.001967448f, -0.002500367f, -0.002968428f,
+  -0.002844692f, -0.001427780f,  0.002022559f,  0.008114798f,
+   0.017155263f,  0.029016349f,  0.043076084f,  0.058248706f,
+   0.073107780f,  0.086084071f,  0.095704111f,  0.100825690f,
+   0.100825690f,  0.095704111f,  0.086084071f,  0.073107780f,
+   0.058248706f,  0.043076084f,  0.029016349f,  0.017155263f,
+   0.008114798f,  0.002022559f, -0.001427780f, -0.002844692f,
+  -0.002968428f, -0.002500367f, -0.001967448f, -0.001646695f
+};
+
+/* butterworth low pass 100 hz at 2 khz: b0, b1, b2, a1, a2 */
+const float32_t iir_coeffs[5] =
+{
+  0.020083366f, 0.040166731f, 0.020083366f, 1.561018076f, -0.641351538f
+};
+
+uint16_t adc_ring[2 * BLOCK_SIZE];
+float32_t work_buffer[2][BLOCK_SIZE];
+float32_t fir_state[FIR_TAPS + BLOCK_SIZE - 1];
+float32_t iir_state[2];
+arm_fir_decimate_instance_f32 fir;
+arm_biquad_cascade_df2T_instance_f32 iir;
+adc_stream_type stream;
+adc_filter_type filter;
+
+/* output of the last block, written in the dma interrupt */
+__IO float32_t output_last, output_min, output_max;
+
+/**
+  * @brief  gpio configuration.
+  * @param  none
+  * @retval none
+  */
+static void gpio_config(void)
+{
+  gpio_init_type gpio_initstructure;
+  crm_periph_clock_enable(CRM_GPIOA_PERIPH_CLOCK, TRUE);
+
+  gpio_default_para_init(&gpio_initstructure);
+
+  /* config adc pin as analog input mode */
+  gpio_initstructure.gpio_mode = GPIO_MODE_ANALOG;
+  gpio_initstructure.gpio_pins = GPIO_PINS_4;
+  gpio_init(GPIOA, &gpio_initstructure);
+}
+
+/**
+  * @brief  filter output callback, 20 samples per block at 2 khz.
+  * @param  filter: the chain.
+  * @param  output: samples, -1 to 1.
+  * @param  length: number of samples.
+  * @retval none
+  */
+void filter_output(adc_filter_type *filter, void *output, uint32_t length)
+{
+  float32_t *sample = (float32_t *)output;
+  float32_t min = sample[0], max = sample[0];
+  uint32_t index;
+
+  for(index = 1; index < length; index++)
+  {
+    min = (sample[index] < min) ? sample[index] : min;
+    max = (sample[index] > max) ? sample[index] : max;
+  }
+  output_min = min;
+  output_max = max;
+  output_last = sample[length - 1];
+}
+
+/**
+  * @brief  main function.
+  * @param  none
+  * @retval none
+  */
+int main(void)
+{
+  uint32_t blocks = 0;
+
+  system_clock_config();
+  at32_board_init();
+  uart_print_init(115200);
+
+  nvic_priority_group_config(NVIC_PRIORITY_GROUP_4);
+
+  /* dma clocks and channel table */
+  dma_app_init();
+
+  gpio_config();
+  adc_clock_div_set(ADC_DIV_16);
+
+  /* pa4 at 16 khz, triggered by tmr1, the ring is on dma1 channel1 */
+  stream.channel[0] = ADC_CHANNEL_4;
+  stream.channel_num = 1;
+  stream.sampletime = ADC_SAMPLETIME_28_5;
+  stream.tmr_x = TMR1;
+  stream.sample_rate = SAMPLE_RATE;
+  stream.oversample_enable = FALSE;
+  stream.block_size = BLOCK_SIZE;
+  stream.ring = adc_ring;
+  stream.priority = 1;
+
+  /* decimation by 8 to 2 khz, then a 100 hz low pass */
+  arm_fir_decimate_init_f32(&fir, FIR_TAPS, FIR_FACTOR, fir_coeffs, fir_state, BLOCK_SIZE);
+  arm_biquad_cascade_df2T_init_f32(&iir, 1, iir_coeffs, iir_state);
+
+  filter.channel = 0;
+  filter.format = ADC_FILTER_FORMAT_F32;
+  filter.stage[0].kind = ADC_FILTER_FIR_DECIMATE;
+  filter.stage[0].instance = &fir;
+  filter.stage[1].kind = ADC_FILTER_BIQUAD;
+  filter.stage[1].instance = &iir;
+  filter.stage_num = 2;
+  filter.offset = 0;
+  filter.buffer[0] = work_buffer[0];
+  filter.buffer[1] = work_buffer[1];
+  filter.callback = filter_output;
+
+  if(adc_stream_init(&stream) != SUCCESS || adc_filter_init(&filter, &stream) != SUCCESS)
+  {
+    at32_led_on(LED2);
+    while(1)
+    {
+    }
+  }
+  adc_stream_start(&stream);
+  at32_led_on(LED3);
+
+  while(1)
+  {
+    /* one line per second */
+    if(filter.block_count - blocks >= filter.rate / filter.length)
+    {
+      blocks = filter.block_count;
+      at32_led_toggle(LED4);
+      printf("output %d hz: last %d, min %d, max %d (1/1000 of full scale)\r\n", (int)filter.rate,
+             (int)(output_last * 1000), (int)(output_min * 1000), (int)(output_max * 1000));
+    }
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
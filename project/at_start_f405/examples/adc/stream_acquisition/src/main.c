@@ -0,0 +1,165 @@
+/**
+  **************************************************************************
+  * @file     main.c
+  * @brief    main program
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "at32f402_405_board.h"
+#include "at32f402_405_clock.h"
+#include "adc_stream.h"
+
+/** @addtogroup AT32F405_periph_examples
+  * @{
+  */
+
+/** @addtogroup 405_ADC_stream_acquisition ADC_stream_acquisition
+  * @{
+  */
+
+#define CHANNEL_NUM                      2
+#define BLOCK_SIZE                       100
+#define SAMPLE_RATE                      10000
+
+uint16_t adc_ring[2 * BLOCK_SIZE * CHANNEL_NUM];
+uint16_t adc_block[2 * BLOCK_SIZE * CHANNEL_NUM];
+adc_stream_type stream;
+
+/* statistics of the last block, written in the dma interrupt */
+__IO uint16_t channel_min[CHANNEL_NUM], channel_max[CHANNEL_NUM], channel_mean[CHANNEL_NUM];
+
+/**
+  * @brief  gpio configuration.
+  * @param  none
+  * @retval none
+  */
+static void gpio_config(void)
+{
+  gpio_init_type gpio_initstructure;
+  crm_periph_clock_enable(CRM_GPIOA_PERIPH_CLOCK, TRUE);
+
+  gpio_default_para_init(&gpio_initstructure);
+
+  /* config adc pin as analog input mode */
+  gpio_initstructure.gpio_mode = GPIO_MODE_ANALOG;
+  gpio_initstructure.gpio_pins = GPIO_PINS_4 | GPIO_PINS_5;
+  gpio_init(GPIOA, &gpio_initstructure);
+}
+
+/**
+  * @brief  block callback, one block per channel.
+  * @param  st: the stream.
+  * @param  block: channel blocks.
+  * @retval none
+  */
+void stream_block(adc_stream_type *st, uint16_t *block)
+{
+  uint16_t *sample, min, max;
+  uint32_t sum, index;
+  uint8_t channel;
+
+  for(channel = 0; channel < st->channel_num; channel++)
+  {
+    sample = adc_stream_channel_get(st, block, channel);
+    min = 0xFFFF;
+    max = 0;
+    sum = 0;
+    for(index = 0; index < st->block_size; index++)
+    {
+      min = (sample[index] < min) ? sample[index] : min;
+      max = (sample[index] > max) ? sample[index] : max;
+      sum += sample[index];
+    }
+    channel_min[channel] = min;
+    channel_max[channel] = max;
+    channel_mean[channel] = (uint16_t)(sum / st->block_size);
+  }
+}
+
+/**
+  * @brief  main function.
+  * @param  none
+  * @retval none
+  */
+int main(void)
+{
+  uint32_t blocks = 0;
+  uint8_t channel;
+
+  system_clock_config();
+  at32_board_init();
+  uart_print_init(115200);
+
+  nvic_priority_group_config(NVIC_PRIORITY_GROUP_4);
+
+  /* dma clocks and channel table */
+  dma_app_init();
+
+  gpio_config();
+  adc_clock_div_set(ADC_DIV_16);
+
+  /* pa4 and pa5 at 10 khz, triggered by tmr1, the ring is on dma1 channel1 */
+  stream.channel[0] = ADC_CHANNEL_4;
+  stream.channel[1] = ADC_CHANNEL_5;
+  stream.channel_num = CHANNEL_NUM;
+  stream.sampletime = ADC_SAMPLETIME_28_5;
+  stream.tmr_x = TMR1;
+  stream.sample_rate = SAMPLE_RATE;
+  stream.oversample_enable = FALSE;
+  stream.block_size = BLOCK_SIZE;
+  stream.ring = adc_ring;
+  stream.block = adc_block;
+  stream.callback = stream_block;
+  stream.priority = 1;
+
+  if(adc_stream_init(&stream) != SUCCESS)
+  {
+    at32_led_on(LED2);
+    while(1)
+    {
+    }
+  }
+  adc_stream_start(&stream);
+  at32_led_on(LED3);
+
+  while(1)
+  {
+    /* one line per second */
+    if(stream.block_count - blocks >= stream.rate / BLOCK_SIZE)
+    {
+      blocks = stream.block_count;
+      at32_led_toggle(LED4);
+      for(channel = 0; channel < CHANNEL_NUM; channel++)
+      {
+        printf("channel %d: mean %d, min %d, max %d\r\n", channel,
+               channel_mean[channel], channel_min[channel], channel_max[channel]);
+      }
+      printf("blocks %d, dma errors %d\r\n", (int)stream.block_count, (int)stream.error_count);
+    }
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,123 @@
+/**
+  **************************************************************************
+  * @file     crc_soft.c
+  * @brief    bitwise software crc reference, portable c
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "crc_soft.h"
+
+/** @addtogroup AT32F405_periph_examples
+  * @{
+  */
+
+/** @addtogroup 405_CRC_calculation
+  * @{
+  */
+
+/**
+  * @brief  reference crc calculation, bit by bit in software.
+  * @param  model: crc algorithm
+  * @param  pdata: data address
+  * @param  length: data length in byte
+  * @retval crc value
+  */
+uint32_t crc_soft_calculate(const crc_soft_model_type *model, const uint8_t *pdata, uint32_t length)
+{
+  uint32_t top = 1UL << (model->width - 1);
+  uint32_t mask = (top << 1) - 1;
+  uint32_t crc = model->init & mask;
+  uint32_t value, i_index, bit, din, fb;
+
+  for(i_index = 0; i_index < length; i_index ++)
+  {
+    value = pdata[i_index];
+    for(bit = 0; bit < 8; bit ++)
+    {
+      /* take the data bits lsb first for reflected input */
+      din = model->reflect_in ? (value >> bit) & 1 : (value >> (7 - bit)) & 1;
+      fb = ((crc & top) ? 1 : 0) ^ din;
+      crc = (crc << 1) & mask;
+      if(fb)
+      {
+        crc ^= model->poly & mask;
+      }
+    }
+  }
+
+  if(model->reflect_out)
+  {
+    value = 0;
+    for(bit = 0; bit < model->width; bit ++)
+    {
+      value |= ((crc >> bit) & 1) << (model->width - 1 - bit);
+    }
+    crc = value;
+  }
+  return (crc ^ model->xor_out) & mask;
+}
+
+#ifdef CRC_SOFT_HOST_TEST
+#include <stdio.h>
+
+/**
+  * @brief  pc check of the reference against the published check values,
+  *         the crc of "123456789":
+  *         cc -DCRC_SOFT_HOST_TEST -I../inc crc_soft.c && ./a.out
+  * @param  none
+  * @retval 0 when all check values match
+  */
+int main(void)
+{
+  static const struct
+  {
+    const char *name;
+    crc_soft_model_type model;
+    uint32_t check;
+  } test[] =
+  {
+    {"crc-32",         {32, 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, 1, 1}, 0xCBF43926},
+    {"crc-16/ccitt",   {16, 0x1021,     0xFFFF,     0x0000,     0, 0}, 0x29B1},
+    {"crc-8",          {8,  0x07,       0x00,       0x00,       0, 0}, 0xF4},
+  };
+  uint32_t i_index, crc;
+  int result = 0;
+
+  for(i_index = 0; i_index < sizeof(test) / sizeof(test[0]); i_index ++)
+  {
+    crc = crc_soft_calculate(&test[i_index].model, (const uint8_t *)"123456789", 9);
+    printf("%-14s 0x%08lX %s\n", test[i_index].name, (unsigned long)crc,
+           crc == test[i_index].check ? "ok" : "fail");
+    if(crc != test[i_index].check)
+    {
+      result = 1;
+    }
+  }
+  return result;
+}
+#endif
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
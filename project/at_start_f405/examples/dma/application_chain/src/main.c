@@ -0,0 +1,181 @@
+/**
+  **************************************************************************
+  * @file     main.c
+  * @brief    main program
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "at32f402_405_board.h"
+#include "at32f402_405_clock.h"
+#include "dma_application.h"
+
+/** @addtogroup AT32F405_periph_examples
+  * @{
+  */
+
+/** @addtogroup 405_DMA_application_chain DMA_application_chain
+  * @{
+  */
+
+#define BUFFER_SIZE                      32
+
+const uint32_t src_const_buffer[BUFFER_SIZE]= {0x01020304, 0x05060708, 0x090A0B0C, 0x0D0E0F10,
+                                               0x11121314, 0x15161718, 0x191A1B1C, 0x1D1E1F20,
+                                               0x21222324, 0x25262728, 0x292A2B2C, 0x2D2E2F30,
+                                               0x31323334, 0x35363738, 0x393A3B3C, 0x3D3E3F40,
+                                               0x41424344, 0x45464748, 0x494A4B4C, 0x4D4E4F50,
+                                               0x51525354, 0x55565758, 0x595A5B5C, 0x5D5E5F60,
+                                               0x61626364, 0x65666768, 0x696A6B6C, 0x6D6E6F70,
+                                               0x71727374, 0x75767778, 0x797A7B7C, 0x7D7E7F80};
+uint32_t dst_buffer[BUFFER_SIZE];
+
+/* the flash buffer is copied in three pieces of a descriptor chain */
+const uint16_t desc_count[3] = {8, 16, 8};
+dma_app_desc_type desc_list[3];
+
+dma_app_handle_type *hdma;
+__IO uint32_t desc_event = 0;
+__IO uint32_t full_event = 0;
+__IO uint32_t error_event = 0;
+__IO uint32_t utilization = 0;
+
+/**
+  * @brief  dma event callback, called in the channel interrupt.
+  * @param  hdma: channel handle
+  * @param  event: DMA_APP_EVENT_xxx
+  * @retval none
+  */
+static void dma_chain_event(dma_app_handle_type *hdma, uint32_t event)
+{
+  if(event & DMA_APP_EVENT_DESC)
+  {
+    desc_event ++;
+  }
+  if(event & DMA_APP_EVENT_FULL)
+  {
+    full_event ++;
+  }
+  if(event & DMA_APP_EVENT_ERROR)
+  {
+    error_event ++;
+  }
+}
+
+/**
+  * @brief  compares two buffers.
+  * @param  pbuffer, pbuffer1: buffers to be compared.
+  * @param  buffer_length: buffer's length
+  * @retval SUCCESS: pbuffer identical to pbuffer1
+  *         ERROR: pbuffer differs from pbuffer1
+  */
+error_status buffer_compare(const uint32_t* pbuffer, uint32_t* pbuffer1, uint16_t buffer_length)
+{
+  while(buffer_length--)
+  {
+    if(*pbuffer != *pbuffer1)
+    {
+      return ERROR;
+    }
+
+    pbuffer++;
+    pbuffer1++;
+  }
+
+  return SUCCESS;
+}
+
+/**
+  * @brief  main function.
+  * @param  none
+  * @retval none
+  */
+int main(void)
+{
+  dma_init_type dma_init_struct;
+  uint32_t i_index, offset = 0;
+
+  /* initial system clock */
+  system_clock_config();
+
+  /* at board initial */
+  at32_board_init();
+
+  nvic_priority_group_config(NVIC_PRIORITY_GROUP_4);
+
+  /* dma clocks, channel table and cycle counter */
+  dma_app_init();
+
+  /* memory to memory by word, addresses and counts come from the descriptors */
+  dma_default_para_init(&dma_init_struct);
+  dma_init_struct.direction = DMA_DIR_MEMORY_TO_MEMORY;
+  dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_WORD;
+  dma_init_struct.memory_inc_enable = TRUE;
+  dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_WORD;
+  dma_init_struct.peripheral_inc_enable = TRUE;
+  dma_init_struct.priority = DMA_PRIORITY_MEDIUM;
+
+  for(i_index = 0; i_index < 3; i_index ++)
+  {
+    desc_list[i_index].peripheral_addr = (uint32_t)&src_const_buffer[offset];
+    desc_list[i_index].memory_addr = (uint32_t)&dst_buffer[offset];
+    desc_list[i_index].count = desc_count[i_index];
+    desc_list[i_index].next = (i_index < 2) ? &desc_list[i_index + 1] : 0;
+    offset += desc_count[i_index];
+  }
+
+  /* the first free channel is dma1 channel1, see DMA1_Channel1_IRQHandler */
+  hdma = dma_app_channel_alloc(DMAMUX_DMAREQ_ID_REQ_G1, &dma_init_struct, dma_chain_event, 1);
+  if(hdma == 0 || dma_app_start_chain(hdma, desc_list) != SUCCESS)
+  {
+    at32_led_on(LED2);
+    while(1)
+    {
+    }
+  }
+
+  /* wait the end of the chain */
+  while(dma_app_busy(hdma) == SET)
+  {
+  }
+  utilization = dma_app_utilization_get(hdma);
+
+  /* two descriptor events, one full event after the last descriptor */
+  if(buffer_compare(src_const_buffer, dst_buffer, BUFFER_SIZE) == SUCCESS &&
+     desc_event == 2 && full_event == 1 && error_event == 0 &&
+     hdma->stat.bytes == sizeof(dst_buffer))
+  {
+    /* turn led2/led3/led4 on */
+    at32_led_on(LED2);
+    at32_led_on(LED3);
+    at32_led_on(LED4);
+  }
+
+  while(1)
+  {
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
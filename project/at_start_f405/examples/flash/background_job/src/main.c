@@ -0,0 +1,134 @@
+/**
+  **************************************************************************
+  * @file     main.c
+  * @brief    main program
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "at32f402_405_board.h"
+#include "at32f402_405_clock.h"
+#include "flash_job.h"
+
+/** @addtogroup AT32F405_periph_examples
+  * @{
+  */
+
+/** @addtogroup 405_FLASH_background_job FLASH_background_job
+  * @{
+  */
+
+#define TEST_FLASH_ADDRESS               ((uint32_t)0x08030000)
+#define TEST_WORDS                       256
+
+uint32_t buffer_tx[TEST_WORDS];
+flash_job_type job_erase, job_program;
+__IO uint32_t jobs_done = 0;
+
+/**
+  * @brief  job completion, runs in the flash interrupt.
+  * @param  job: the finished job.
+  * @retval none
+  */
+void job_done(flash_job_type *job)
+{
+  jobs_done++;
+}
+
+/**
+  * @brief  main function.
+  * @param  none
+  * @retval none
+  */
+int main(void)
+{
+  uint32_t index, loops = 0;
+  error_status status = SUCCESS;
+
+  system_clock_config();
+  at32_board_init();
+  uart_print_init(115200);
+
+  for(index = 0; index < TEST_WORDS; index++)
+  {
+    buffer_tx[index] = 0x12345678 + index;
+  }
+
+  flash_unlock();
+  flash_job_init();
+  nvic_irq_enable(FLASH_IRQn, 0, 0);
+
+  /* both jobs are queued at once, the program starts when the erase ends */
+  job_erase.op = FLASH_JOB_SECTOR_ERASE;
+  job_erase.address = TEST_FLASH_ADDRESS;
+  job_erase.callback = job_done;
+  job_program.op = FLASH_JOB_WORD_PROGRAM;
+  job_program.address = TEST_FLASH_ADDRESS;
+  job_program.pdata = buffer_tx;
+  job_program.count = TEST_WORDS;
+  job_program.callback = job_done;
+  flash_job_submit(&job_erase);
+  flash_job_submit(&job_program);
+
+  /* the loop runs from flash, so it stalls while the flash is busy and
+     goes on between the words */
+  while(flash_job_busy() == SET)
+  {
+    loops++;
+  }
+  flash_lock();
+
+  if(job_erase.status != FLASH_OPERATE_DONE || job_program.status != FLASH_OPERATE_DONE || jobs_done != 2)
+  {
+    status = ERROR;
+  }
+  for(index = 0; index < TEST_WORDS; index++)
+  {
+    if(*(__IO uint32_t *)(TEST_FLASH_ADDRESS + index * 4) != buffer_tx[index])
+    {
+      status = ERROR;
+    }
+  }
+
+  printf("%d jobs done, %d words programmed, %d main loop passes\r\n",
+         (int)jobs_done, (int)job_program.done, (int)loops);
+
+  if(status == SUCCESS)
+  {
+    printf("flash background job success!\r\n");
+    at32_led_on(LED3);
+  }
+  else
+  {
+    printf("flash background job ERROR!\r\n");
+    at32_led_on(LED2);
+  }
+
+  while(1)
+  {
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,151 @@
+/**
+  **************************************************************************
+  * @file     main.c
+  * @brief    main program
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include <string.h>
+#include "at32f402_405_board.h"
+#include "at32f402_405_clock.h"
+#include "flash_kv.h"
+
+/** @addtogroup AT32F405_periph_examples
+  * @{
+  */
+
+/** @addtogroup 405_FLASH_kv_store FLASH_kv_store
+  * @{
+  */
+
+/* the last 32 kbyte of the at32f405rct7, 2 kbyte sectors */
+#define KV_SECTOR_SIZE                   2048
+#define KV_AREA_SIZE                     (8 * KV_SECTOR_SIZE)
+#define KV_AREA0                         ((uint32_t)0x08038000)
+#define KV_AREA1                         (KV_AREA0 + KV_AREA_SIZE)
+
+#define KEY_BOOT_COUNT                   1
+#define KEY_CONFIG                       2
+#define KEY_LOG                          3
+#define LOG_WRITES                       500
+
+typedef struct
+{
+  uint32_t                               baudrate;
+  uint16_t                               threshold;
+  uint8_t                                name[10];
+} config_type;
+
+const config_type config_default = {115200, 1000, "at-start"};
+flash_kv_type kv;
+
+/**
+  * @brief  main function.
+  * @param  none
+  * @retval none
+  */
+int main(void)
+{
+  uint32_t boot_count = 0, value, index, gc_steps = 0;
+  config_type config;
+  uint16_t length;
+  error_status status = SUCCESS;
+
+  system_clock_config();
+  at32_board_init();
+  uart_print_init(115200);
+
+  /* every record carries a crc32 of the crc unit */
+  crm_periph_clock_enable(CRM_CRC_PERIPH_CLOCK, TRUE);
+
+  /* an empty flash is formatted, a collection cut by a reset goes on */
+  if(flash_kv_init(&kv, KV_AREA0, KV_AREA1, KV_AREA_SIZE, KV_SECTOR_SIZE) != FLASH_KV_OK)
+  {
+    status = ERROR;
+  }
+
+  /* counts the resets of the board */
+  flash_kv_read(&kv, KEY_BOOT_COUNT, &boot_count, sizeof(boot_count), 0);
+  boot_count++;
+  if(flash_kv_write(&kv, KEY_BOOT_COUNT, &boot_count, sizeof(boot_count)) != FLASH_KV_OK)
+  {
+    status = ERROR;
+  }
+
+  /* the default configuration is stored once, later boots read it back */
+  if(flash_kv_read(&kv, KEY_CONFIG, &config, sizeof(config), &length) != FLASH_KV_OK || length != sizeof(config))
+  {
+    config = config_default;
+    if(flash_kv_write(&kv, KEY_CONFIG, &config, sizeof(config)) != FLASH_KV_OK)
+    {
+      status = ERROR;
+    }
+  }
+
+  /* a value updated often, the store collects its old records on the way */
+  for(index = 0; index < LOG_WRITES && status == SUCCESS; index++)
+  {
+    value = boot_count * LOG_WRITES + index;
+    if(flash_kv_write(&kv, KEY_LOG, &value, sizeof(value)) != FLASH_KV_OK ||
+       flash_kv_read(&kv, KEY_LOG, &value, sizeof(value), 0) != FLASH_KV_OK ||
+       value != boot_count * LOG_WRITES + index)
+    {
+      status = ERROR;
+    }
+  }
+
+  /* the idle loop finishes a started collection before the next write needs it */
+  while(flash_kv_gc_step(&kv) == SET)
+  {
+    gc_steps++;
+  }
+
+  if(flash_kv_read(&kv, KEY_CONFIG, &config, sizeof(config), 0) != FLASH_KV_OK ||
+     memcmp(&config, &config_default, sizeof(config)) != 0)
+  {
+    status = ERROR;
+  }
+
+  printf("boot %d, %d writes, %d sectors erased, %d idle gc steps, %d bytes free\r\n",
+         (int)boot_count, (int)kv.write_count, (int)kv.erase_count, (int)gc_steps, (int)flash_kv_free_get(&kv));
+
+  if(status == SUCCESS)
+  {
+    printf("flash kv store success!\r\n");
+    at32_led_on(LED3);
+  }
+  else
+  {
+    printf("flash kv store ERROR!\r\n");
+    at32_led_on(LED2);
+  }
+
+  while(1)
+  {
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,202 @@
+/**
+  **************************************************************************
+  * @file     at32f402_405_int.c
+  * @brief    main interrupt service routines.
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* includes ------------------------------------------------------------------*/
+#include "at32f402_405_int.h"
+#include "i2c_memory.h"
+
+/** @addtogroup AT32F405_periph_examples
+  * @{
+  */
+
+/** @addtogroup 405_I2C_memory_library
+  * @{
+  */
+
+extern i2c_handle_type hi2cx;
+extern i2c_mem_type hmem;
+
+#define I2Cx_DMA_TX_IRQHandler           DMA1_Channel1_IRQHandler
+#define I2Cx_DMA_RX_IRQHandler           DMA1_Channel2_IRQHandler
+#define I2Cx_EVT_IRQHandler              I2C1_EVT_IRQHandler
+#define I2Cx_ERR_IRQHandler              I2C1_ERR_IRQHandler
+
+/**
+  * @brief  this function handles nmi exception.
+  * @param  none
+  * @retval none
+  */
+void NMI_Handler(void)
+{
+}
+
+/**
+  * @brief  this function handles hard fault exception.
+  * @param  none
+  * @retval none
+  */
+void HardFault_Handler(void)
+{
+  /* go to infinite loop when hard fault exception occurs */
+  while(1)
+  {
+  }
+}
+
+/**
+  * @brief  this function handles memory manage exception.
+  * @param  none
+  * @retval none
+  */
+void MemManage_Handler(void)
+{
+  /* go to infinite loop when memory manage exception occurs */
+  while(1)
+  {
+  }
+}
+
+/**
+  * @brief  this function handles bus fault exception.
+  * @param  none
+  * @retval none
+  */
+void BusFault_Handler(void)
+{
+  /* go to infinite loop when bus fault exception occurs */
+  while(1)
+  {
+  }
+}
+
+/**
+  * @brief  this function handles usage fault exception.
+  * @param  none
+  * @retval none
+  */
+void UsageFault_Handler(void)
+{
+  /* go to infinite loop when usage fault exception occurs */
+  while(1)
+  {
+  }
+}
+
+/**
+  * @brief  this function handles svcall exception.
+  * @param  none
+  * @retval none
+  */
+void SVC_Handler(void)
+{
+}
+
+/**
+  * @brief  this function handles debug monitor exception.
+  * @param  none
+  * @retval none
+  */
+void DebugMon_Handler(void)
+{
+}
+
+/**
+  * @brief  this function handles pendsv_handler exception.
+  * @param  none
+  * @retval none
+  */
+void PendSV_Handler(void)
+{
+}
+
+/**
+  * @brief  this function handles systick handler.
+  * @param  none
+  * @retval none
+  */
+void SysTick_Handler(void)
+{
+}
+
+/**
+  * @brief  this function handles dma interrupt request.
+  * @param  none
+  * @retval none
+  */
+void I2Cx_DMA_RX_IRQHandler(void)
+{
+  i2c_dma_rx_irq_handler(&hi2cx);
+}
+
+/**
+  * @brief  this function handles dma interrupt request.
+  * @param  none
+  * @retval none
+  */
+void I2Cx_DMA_TX_IRQHandler(void)
+{
+  i2c_dma_tx_irq_handler(&hi2cx);
+}
+
+/**
+  * @brief  this function handles i2c event interrupt request.
+  * @param  none
+  * @retval none
+  */
+void I2Cx_EVT_IRQHandler(void)
+{
+  i2c_evt_irq_handler(&hi2cx);
+}
+
+/**
+  * @brief  this function handles i2c error interrupt request.
+  * @param  none
+  * @retval none
+  */
+void I2Cx_ERR_IRQHandler(void)
+{
+  i2c_err_irq_handler(&hi2cx);
+}
+
+/**
+  * @brief  this function handles timer1 overflow handler.
+  * @param  none
+  * @retval none
+  */
+void TMR1_OVF_TMR10_IRQHandler(void)
+{
+  if(tmr_interrupt_flag_get(TMR1, TMR_OVF_FLAG) == SET)
+  {
+    tmr_flag_clear(TMR1, TMR_OVF_FLAG);
+    i2c_mem_tick(&hmem);
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
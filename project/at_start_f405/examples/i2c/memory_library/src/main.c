@@ -0,0 +1,302 @@
+/**
+  **************************************************************************
+  * @file     main.c
+  * @brief    main program
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "at32f402_405_board.h"
+#include "at32f402_405_clock.h"
+#include "i2c_memory.h"
+
+/** @addtogroup AT32F405_periph_examples
+  * @{
+  */
+
+/** @addtogroup 405_I2C_memory_library I2C_memory_library
+  * @{
+  */
+
+#define I2C_TIMEOUT                      0xFFFFFFF
+
+//#define I2Cx_CLKCTRL                   0x4170FEFE   //10K
+//#define I2Cx_CLKCTRL                   0x90F06666   //50K
+#define I2Cx_CLKCTRL                     0x90F03030   //100K
+//#define I2Cx_CLKCTRL                   0x20F07DDE   //200K
+
+#define I2Cx_ADDRESS                     0xA0
+
+#define I2Cx_PORT                        I2C1
+#define I2Cx_CLK                         CRM_I2C1_PERIPH_CLOCK
+#define I2Cx_DMA                         DMA1
+#define I2Cx_DMA_CLK                     CRM_DMA1_PERIPH_CLOCK
+
+#define I2Cx_SCL_GPIO_CLK                CRM_GPIOB_PERIPH_CLOCK
+#define I2Cx_SCL_GPIO_PIN                GPIO_PINS_6
+#define I2Cx_SCL_GPIO_PinsSource         GPIO_PINS_SOURCE6
+#define I2Cx_SCL_GPIO_PORT               GPIOB
+#define I2Cx_SCL_GPIO_MUX                GPIO_MUX_4
+
+#define I2Cx_SDA_GPIO_CLK                CRM_GPIOB_PERIPH_CLOCK
+#define I2Cx_SDA_GPIO_PIN                GPIO_PINS_7
+#define I2Cx_SDA_GPIO_PinsSource         GPIO_PINS_SOURCE7
+#define I2Cx_SDA_GPIO_PORT               GPIOB
+#define I2Cx_SDA_GPIO_MUX                GPIO_MUX_4
+
+#define I2Cx_DMA_TX_Channel              DMA1_CHANNEL1
+#define I2Cx_DMA_TX_DMAMUX_Channel       DMA1MUX_CHANNEL1
+#define I2Cx_DMA_TX_DMAREQ               DMAMUX_DMAREQ_ID_I2C1_TX
+#define I2Cx_DMA_TX_IRQn                 DMA1_Channel1_IRQn
+
+#define I2Cx_DMA_RX_Channel              DMA1_CHANNEL2
+#define I2Cx_DMA_RX_DMAMUX_Channel       DMA1MUX_CHANNEL2
+#define I2Cx_DMA_RX_DMAREQ               DMAMUX_DMAREQ_ID_I2C1_RX
+#define I2Cx_DMA_RX_IRQn                 DMA1_Channel2_IRQn
+
+#define I2Cx_EVT_IRQn                    I2C1_EVT_IRQn
+#define I2Cx_ERR_IRQn                    I2C1_ERR_IRQn
+
+#define BUF_SIZE                         40
+#define MEM_ADDRESS                      0x03
+
+uint8_t tx_buf[BUF_SIZE];
+uint8_t rx_buf[BUF_SIZE];
+
+crm_clocks_freq_type crm_clocks_freq_struct = {0};
+i2c_handle_type hi2cx;
+i2c_mem_type hmem;
+
+/**
+  * @brief  error handler program
+  * @param  i2c_status
+  * @retval none
+  */
+void error_handler(uint32_t error_code)
+{
+  while(1)
+  {
+    at32_led_toggle(LED2);
+    delay_ms(500);
+  }
+}
+
+/**
+  * @brief  compare whether the valus of buffer 1 and buffer 2 are equal.
+  * @param  buffer1: buffer 1 address.
+            buffer2: buffer 2 address.
+  * @retval 0: equal.
+  *         1: unequal.
+  */
+uint32_t buffer_compare(uint8_t* buffer1, uint8_t* buffer2, uint32_t len)
+{
+  uint32_t i;
+
+  for(i = 0; i < len; i++)
+  {
+    if(buffer1[i] != buffer2[i])
+    {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  1 ms tick for the ack poll back off
+  * @param  none
+  * @retval none
+  */
+void tick_config(void)
+{
+  crm_clocks_freq_get(&crm_clocks_freq_struct);
+
+  crm_periph_clock_enable(CRM_TMR1_PERIPH_CLOCK, TRUE);
+
+  /* 10 khz counter, overflow every 10 counts */
+  tmr_base_init(TMR1, 9, (crm_clocks_freq_struct.apb2_freq / 10000) - 1);
+  tmr_cnt_dir_set(TMR1, TMR_COUNT_UP);
+  tmr_interrupt_enable(TMR1, TMR_OVF_INT, TRUE);
+
+  /* below the i2c interrupts */
+  nvic_irq_enable(TMR1_OVF_TMR10_IRQn, 1, 0);
+
+  tmr_counter_enable(TMR1, TRUE);
+}
+
+/**
+  * @brief  main function.
+  * @param  none
+  * @retval none
+  */
+int main(void)
+{
+  i2c_status_type i2c_status;
+  uint32_t i;
+
+  /* initial system clock */
+  system_clock_config();
+
+  /* config nvic priority group */
+  nvic_priority_group_config(NVIC_PRIORITY_GROUP_4);
+
+  /* at board initial */
+  at32_board_init();
+
+  hi2cx.i2cx = I2Cx_PORT;
+
+  /* i2c config */
+  i2c_config(&hi2cx);
+  i2c_queue_init(&hi2cx);
+
+  /* 24c02 on the bus, ack polls every 1 ms */
+  i2c_mem_init(&hmem, &hi2cx, &i2c_mem_24c02);
+  hmem.poll_interval = 1;
+  tick_config();
+
+  for(i = 0; i < BUF_SIZE; i++)
+  {
+    tx_buf[i] = (uint8_t)(i + 1);
+  }
+
+  while(1)
+  {
+    /* wait for key USER_BUTTON press before starting the communication */
+    while(at32_button_press() != USER_BUTTON)
+    {
+    }
+
+    /* unaligned write over six pages, split and polled by the library */
+    if((i2c_status = i2c_mem_write_start(&hmem, MEM_ADDRESS, tx_buf, BUF_SIZE, 0)) != I2C_OK)
+    {
+      error_handler(i2c_status);
+    }
+    if((i2c_status = i2c_mem_wait(&hmem, I2C_TIMEOUT)) != I2C_OK)
+    {
+      error_handler(i2c_status);
+    }
+
+    /* the last write cycle is over, read at once */
+    if((i2c_status = i2c_mem_read_start(&hmem, MEM_ADDRESS, rx_buf, BUF_SIZE, 0)) != I2C_OK)
+    {
+      error_handler(i2c_status);
+    }
+    if((i2c_status = i2c_mem_wait(&hmem, I2C_TIMEOUT)) != I2C_OK)
+    {
+      error_handler(i2c_status);
+    }
+
+    if(buffer_compare(tx_buf, rx_buf, BUF_SIZE) == 0)
+    {
+      at32_led_on(LED3);
+    }
+    else
+    {
+      error_handler(i2c_status);
+    }
+  }
+}
+
+/**
+  * @brief  initializes peripherals used by the i2c.
+  * @param  none
+  * @retval none
+  */
+void i2c_lowlevel_init(i2c_handle_type* hi2c)
+{
+  gpio_init_type gpio_init_structure;
+
+  if(hi2c->i2cx == I2Cx_PORT)
+  {
+    /* i2c periph clock enable */
+    crm_periph_clock_enable(I2Cx_CLK, TRUE);
+    crm_periph_clock_enable(I2Cx_SCL_GPIO_CLK, TRUE);
+    crm_periph_clock_enable(I2Cx_SDA_GPIO_CLK, TRUE);
+
+    /* gpio configuration */
+    gpio_pin_mux_config(I2Cx_SCL_GPIO_PORT, I2Cx_SCL_GPIO_PinsSource, I2Cx_SCL_GPIO_MUX);
+
+    gpio_pin_mux_config(I2Cx_SDA_GPIO_PORT, I2Cx_SDA_GPIO_PinsSource, I2Cx_SDA_GPIO_MUX);
+
+    /* configure i2c pins: scl */
+    gpio_init_structure.gpio_drive_strength = GPIO_DRIVE_STRENGTH_STRONGER;
+    gpio_init_structure.gpio_mode           = GPIO_MODE_MUX;
+    gpio_init_structure.gpio_out_type       = GPIO_OUTPUT_OPEN_DRAIN;
+    gpio_init_structure.gpio_pull           = GPIO_PULL_NONE;
+
+    gpio_init_structure.gpio_pins           = I2Cx_SCL_GPIO_PIN;
+    gpio_init(I2Cx_SCL_GPIO_PORT, &gpio_init_structure);
+
+    /* configure i2c pins: sda */
+    gpio_init_structure.gpio_pins           = I2Cx_SDA_GPIO_PIN;
+    gpio_init(I2Cx_SDA_GPIO_PORT, &gpio_init_structure);
+
+    /* configure and enable i2c interrupt */
+    nvic_irq_enable(I2Cx_EVT_IRQn, 0, 0);
+    nvic_irq_enable(I2Cx_ERR_IRQn, 0, 0);
+
+    /* configure and enable i2c dma channel interrupt */
+    nvic_irq_enable(I2Cx_DMA_TX_IRQn, 0, 0);
+    nvic_irq_enable(I2Cx_DMA_RX_IRQn, 0, 0);
+
+    /* i2c dma tx and rx channels configuration */
+    /* enable the dma clock */
+    crm_periph_clock_enable(I2Cx_DMA_CLK, TRUE);
+
+    /* i2c dma channel configuration */
+    hi2c->dma_tx_channel = I2Cx_DMA_TX_Channel;
+    hi2c->dma_rx_channel = I2Cx_DMA_RX_Channel;
+
+    dma_reset(hi2c->dma_tx_channel);
+    dma_reset(hi2c->dma_rx_channel);
+
+    hi2c->dma_init_struct.peripheral_base_addr    = (uint32_t)&hi2c->i2cx->txdt;
+    hi2c->dma_init_struct.memory_base_addr        = 0;
+    hi2c->dma_init_struct.direction               = DMA_DIR_MEMORY_TO_PERIPHERAL;
+    hi2c->dma_init_struct.buffer_size             = 0xFFFF;
+    hi2c->dma_init_struct.peripheral_inc_enable   = FALSE;
+    hi2c->dma_init_struct.memory_inc_enable       = TRUE;
+    hi2c->dma_init_struct.peripheral_data_width   = DMA_PERIPHERAL_DATA_WIDTH_BYTE;
+    hi2c->dma_init_struct.memory_data_width       = DMA_MEMORY_DATA_WIDTH_BYTE;
+    hi2c->dma_init_struct.loop_mode_enable        = FALSE;
+    hi2c->dma_init_struct.priority                = DMA_PRIORITY_LOW;
+
+    dma_init(hi2c->dma_tx_channel, &hi2c->dma_init_struct);
+    dma_init(hi2c->dma_rx_channel, &hi2c->dma_init_struct);
+
+    dmamux_init(I2Cx_DMA_TX_DMAMUX_Channel, I2Cx_DMA_TX_DMAREQ);
+    dmamux_init(I2Cx_DMA_RX_DMAMUX_Channel, I2Cx_DMA_RX_DMAREQ);
+
+    dmamux_enable(I2Cx_DMA, TRUE);
+
+    /* config i2c */
+    i2c_init(hi2c->i2cx, 0x0F, I2Cx_CLKCTRL);
+
+    i2c_own_address1_set(hi2c->i2cx, I2C_ADDRESS_MODE_7BIT, I2Cx_ADDRESS);
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
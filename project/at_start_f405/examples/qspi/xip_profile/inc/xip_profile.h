@@ -0,0 +1,83 @@
+/**
+  **************************************************************************
+  * @file     xip_profile.h
+  * @brief    xip code region profiler header
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __XIP_PROFILE_H
+#define __XIP_PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "at32f402_405.h"
+
+/** @addtogroup AT32F405_periph_examples
+  * @{
+  */
+
+/** @addtogroup 405_QSPI_xip_profile
+  * @{
+  */
+
+/**
+  * @brief xip access latency in core cycles
+  */
+typedef struct
+{
+  uint32_t                               hit_cycles;                    /*!< cycles of a word read from cache */
+  uint32_t                               miss_cycles;                   /*!< cycles of a word read from flash */
+} xip_latency_type;
+
+/**
+  * @brief xip code region profile
+  */
+typedef struct
+{
+  void                                   (*func)(void);                 /*!< region entry, code placed in xip */
+  uint32_t                               calls;                         /*!< profiled calls */
+  uint64_t                               total_cycles;                  /*!< cycles of all calls */
+  uint32_t                               cold_cycles;                   /*!< cycles of the first call */
+  uint32_t                               best_cycles;                   /*!< cycles of the fastest call */
+} xip_region_type;
+
+void xip_latency_measure(uint32_t xip_addr, xip_latency_type *latency);
+void xip_region_reset(xip_region_type *region, void (*func)(void));
+void xip_region_run(xip_region_type *region);
+uint64_t xip_region_stall_get(xip_region_type *region);
+uint32_t xip_region_miss_estimate(xip_region_type *region, xip_latency_type *latency);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,79 @@
+/**
+  **************************************************************************
+  * @file     run_in_qspi.c
+  * @brief    run in qspi program
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "at32f402_405_board.h"
+#include "run_in_qspi.h"
+
+/** @addtogroup AT32F405_periph_examples
+  * @{
+  */
+
+/** @addtogroup 405_QSPI_xip_profile
+  * @{
+  */
+
+uint32_t qspi_region_result = 0;
+
+/**
+  * @brief  profiled code region, its code is fetched through xip.
+  * @param  none
+  * @retval none
+  */
+void qspi_region(void)
+{
+  uint32_t i_index, value = qspi_region_result;
+
+  for(i_index = 0; i_index < 256; i_index ++)
+  {
+    value = (value << 5) ^ (value >> 27) ^ (i_index * 0x9E3779B9);
+  }
+  qspi_region_result = value;
+}
+
+/**
+  * @brief  check the led toggle in qspi
+  * @param  none
+  * @retval none
+  */
+void qspi_run(void)
+{
+  while(1)
+  {
+    /* toggle led */
+    at32_led_toggle(LED2);
+    delay_ms(100);
+    at32_led_toggle(LED3);
+    delay_ms(100);
+    at32_led_toggle(LED4);
+    delay_ms(100);
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
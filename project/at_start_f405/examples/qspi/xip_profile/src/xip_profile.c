@@ -0,0 +1,156 @@
+/**
+  **************************************************************************
+  * @file     xip_profile.c
+  * @brief    xip code region profiler
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "xip_profile.h"
+
+/** @addtogroup AT32F405_periph_examples
+  * @{
+  */
+
+/** @addtogroup 405_QSPI_xip_profile
+  * @{
+  */
+
+/**
+  * @brief  start the core cycle counter used by the profiler.
+  * @param  none
+  * @retval none
+  */
+static void xip_cycle_counter_start(void)
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+  * @brief  measure the xip read latency of a cached and of a missed word.
+  *         the xip port must be enabled. misses are forced by reading with
+  *         a 4 kbyte stride, hits by reading the same word again.
+  * @param  xip_addr: xip memory address, 64 kbyte readable from it
+  * @param  latency: pointer to a xip_latency_type structure
+  * @retval none
+  */
+void xip_latency_measure(uint32_t xip_addr, xip_latency_type *latency)
+{
+  uint32_t start, i_index, sum = 0;
+
+  xip_cycle_counter_start();
+
+  start = DWT->CYCCNT;
+  for(i_index = 0; i_index < 16; i_index ++)
+  {
+    sum += *(__IO uint32_t *)(xip_addr + i_index * 0x1000);
+  }
+  latency->miss_cycles = (DWT->CYCCNT - start) / 16;
+
+  start = DWT->CYCCNT;
+  for(i_index = 0; i_index < 16; i_index ++)
+  {
+    sum += *(__IO uint32_t *)(xip_addr + 0xF000);
+  }
+  latency->hit_cycles = (DWT->CYCCNT - start) / 16;
+  (void)sum;
+}
+
+/**
+  * @brief  clear the profile of a code region.
+  * @param  region: pointer to a xip_region_type structure
+  * @param  func: region entry
+  * @retval none
+  */
+void xip_region_reset(xip_region_type *region, void (*func)(void))
+{
+  region->func = func;
+  region->calls = 0;
+  region->total_cycles = 0;
+  region->cold_cycles = 0;
+  region->best_cycles = 0xFFFFFFFF;
+  xip_cycle_counter_start();
+}
+
+/**
+  * @brief  call the region entry once and account its cycles.
+  * @param  region: pointer to a xip_region_type structure
+  * @retval none
+  */
+void xip_region_run(xip_region_type *region)
+{
+  uint32_t start, cycles;
+
+  start = DWT->CYCCNT;
+  region->func();
+  cycles = DWT->CYCCNT - start;
+
+  if(region->calls == 0)
+  {
+    region->cold_cycles = cycles;
+  }
+  if(cycles < region->best_cycles)
+  {
+    region->best_cycles = cycles;
+  }
+  region->calls ++;
+  region->total_cycles += cycles;
+}
+
+/**
+  * @brief  xip stall cycles of a region: the cycles above the fastest call
+  *         (all code cached) summed over the calls. the xip cache has no
+  *         hit or miss counter, so stalls are derived from timing.
+  * @param  region: pointer to a xip_region_type structure
+  * @retval stall cycles
+  */
+uint64_t xip_region_stall_get(xip_region_type *region)
+{
+  if(region->calls == 0)
+  {
+    return 0;
+  }
+  return (region->total_cycles - (uint64_t)region->calls * region->best_cycles);
+}
+
+/**
+  * @brief  estimated xip cache misses of a region, the stall cycles over
+  *         the measured miss penalty. a region with many misses per call
+  *         is a candidate for relocation to sram.
+  * @param  region: pointer to a xip_region_type structure
+  * @param  latency: result of xip_latency_measure
+  * @retval estimated misses
+  */
+uint32_t xip_region_miss_estimate(xip_region_type *region, xip_latency_type *latency)
+{
+  if(latency->miss_cycles <= latency->hit_cycles)
+  {
+    return 0;
+  }
+  return (uint32_t)(xip_region_stall_get(region) / (latency->miss_cycles - latency->hit_cycles));
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,209 @@
+/**
+  **************************************************************************
+  * @file     main.c
+  * @brief    main program
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "at32f402_405_board.h"
+#include "at32f402_405_clock.h"
+#include "spi_nor.h"
+
+/** @addtogroup AT32F405_periph_examples
+  * @{
+  */
+
+/** @addtogroup 405_SPI_nor_flash_library SPI_nor_flash_library
+  * @{
+  */
+
+#define FLASH_TEST_ADDR                  0x1000
+#define BUF_SIZE                         600
+
+uint8_t buffer_tx[BUF_SIZE];
+uint8_t buffer_rx[BUF_SIZE];
+spi_nor_type nor;
+
+/**
+  * @brief  buffer compare function.
+  * @param  pbuffer1, pbuffer2: buffers to be compared.
+  * @param  buffer_length: buffer's length
+  * @retval the result of compare
+  */
+error_status buffer_compare(uint8_t* pbuffer1, uint8_t* pbuffer2, uint16_t buffer_length)
+{
+  while(buffer_length--)
+  {
+    if(*pbuffer1 != *pbuffer2)
+    {
+      return ERROR;
+    }
+
+    pbuffer1++;
+    pbuffer2++;
+  }
+  return SUCCESS;
+}
+
+/**
+  * @brief  spi, pins and cs of the flash, the library sets up the dma.
+  * @param  none
+  * @retval none
+  */
+void spi_nor_config(void)
+{
+  gpio_init_type gpio_initstructure;
+  spi_init_type spi_init_struct;
+
+  crm_periph_clock_enable(CRM_GPIOB_PERIPH_CLOCK, TRUE);
+  crm_periph_clock_enable(CRM_GPIOC_PERIPH_CLOCK, TRUE);
+  crm_periph_clock_enable(CRM_DMA1_PERIPH_CLOCK, TRUE);
+  /* software cs, pb12 as a general io to control flash cs */
+  gpio_initstructure.gpio_out_type       = GPIO_OUTPUT_PUSH_PULL;
+  gpio_initstructure.gpio_pull           = GPIO_PULL_UP;
+  gpio_initstructure.gpio_mode           = GPIO_MODE_OUTPUT;
+  gpio_initstructure.gpio_drive_strength = GPIO_DRIVE_STRENGTH_STRONGER;
+  gpio_initstructure.gpio_pins           = GPIO_PINS_12;
+  gpio_init(GPIOB, &gpio_initstructure);
+
+  /* sck */
+  gpio_initstructure.gpio_pull           = GPIO_PULL_UP;
+  gpio_initstructure.gpio_mode           = GPIO_MODE_MUX;
+  gpio_initstructure.gpio_pins           = GPIO_PINS_13;
+  gpio_init(GPIOB, &gpio_initstructure);
+  gpio_pin_mux_config(GPIOB, GPIO_PINS_SOURCE13, GPIO_MUX_5);
+
+  /* miso */
+  gpio_initstructure.gpio_pull           = GPIO_PULL_UP;
+  gpio_initstructure.gpio_pins           = GPIO_PINS_2;
+  gpio_init(GPIOC, &gpio_initstructure);
+  gpio_pin_mux_config(GPIOC, GPIO_PINS_SOURCE2, GPIO_MUX_5);
+
+  /* mosi */
+  gpio_initstructure.gpio_pull           = GPIO_PULL_UP;
+  gpio_initstructure.gpio_pins           = GPIO_PINS_3;
+  gpio_init(GPIOC, &gpio_initstructure);
+  gpio_pin_mux_config(GPIOC, GPIO_PINS_SOURCE3, GPIO_MUX_5);
+
+  gpio_bits_set(GPIOB, GPIO_PINS_12);
+  crm_periph_clock_enable(CRM_SPI2_PERIPH_CLOCK, TRUE);
+  spi_default_para_init(&spi_init_struct);
+  spi_init_struct.transmission_mode = SPI_TRANSMIT_FULL_DUPLEX;
+  spi_init_struct.master_slave_mode = SPI_MODE_MASTER;
+  spi_init_struct.mclk_freq_division = SPI_MCLK_DIV_8;
+  spi_init_struct.first_bit_transmission = SPI_FIRST_BIT_MSB;
+  spi_init_struct.frame_bit_num = SPI_FRAME_8BIT;
+  spi_init_struct.clock_polarity = SPI_CLOCK_POLARITY_HIGH;
+  spi_init_struct.clock_phase = SPI_CLOCK_PHASE_2EDGE;
+  spi_init_struct.cs_mode_selection = SPI_CS_SOFTWARE_MODE;
+  spi_init(SPI2, &spi_init_struct);
+  spi_enable(SPI2, TRUE);
+
+  nor.spi_x = SPI2;
+  nor.cs_gpio = GPIOB;
+  nor.cs_pin = GPIO_PINS_12;
+  nor.dma_x = DMA1;
+  nor.dma_tx_channel = DMA1_CHANNEL3;
+  nor.dmamux_tx_channel = DMA1MUX_CHANNEL3;
+  nor.dmamux_tx_req = DMAMUX_DMAREQ_ID_SPI2_TX;
+  nor.dma_rx_channel = DMA1_CHANNEL2;
+  nor.dmamux_rx_channel = DMA1MUX_CHANNEL2;
+  nor.dmamux_rx_req = DMAMUX_DMAREQ_ID_SPI2_RX;
+  nor.capacity = 0x1000000;
+  nor.page_size = 256;
+  nor.sector_size = 4096;
+  nor.fast_read = 0;
+}
+
+/**
+  * @brief  main function.
+  * @param  none
+  * @retval none
+  */
+int main(void)
+{
+  uint32_t index, flash_id, task_calls = 0;
+  error_status status = SUCCESS;
+
+  system_clock_config();
+  at32_board_init();
+  uart_print_init(115200);
+
+  for(index = 0; index < BUF_SIZE; index++)
+  {
+    buffer_tx[index] = (uint8_t)index;
+  }
+
+  spi_nor_config();
+  flash_id = spi_nor_init(&nor);
+  printf("flash id: %x\r\n", (unsigned int)flash_id);
+
+  /* the sector is not erased again when it is blank */
+  spi_nor_erase_sector(&nor, FLASH_TEST_ADDR);
+
+  /* blocking write, three pages issued back to back */
+  spi_nor_write(&nor, FLASH_TEST_ADDR, buffer_tx, BUF_SIZE);
+  spi_nor_read(&nor, FLASH_TEST_ADDR, buffer_rx, BUF_SIZE);
+  if(buffer_compare(buffer_rx, buffer_tx, BUF_SIZE) != SUCCESS)
+  {
+    status = ERROR;
+  }
+
+  /* the same data behind it, moved on by spi_nor_task from this loop */
+  if(spi_nor_write_start(&nor, FLASH_TEST_ADDR + BUF_SIZE, buffer_tx, BUF_SIZE) != SUCCESS)
+  {
+    status = ERROR;
+  }
+  while(spi_nor_task(&nor) == SET)
+  {
+    task_calls++;
+  }
+  spi_nor_read(&nor, FLASH_TEST_ADDR + BUF_SIZE, buffer_rx, BUF_SIZE);
+  if(buffer_compare(buffer_rx, buffer_tx, BUF_SIZE) != SUCCESS)
+  {
+    status = ERROR;
+  }
+
+  printf("sectors erased %d, skipped %d, task calls %d\r\n",
+         (int)nor.erase_count, (int)nor.erase_skipped, (int)task_calls);
+
+  if(status == SUCCESS)
+  {
+    printf("flash data read write success!\r\n");
+    at32_led_on(LED3);
+  }
+  else
+  {
+    printf("flash data read write ERROR!\r\n");
+    at32_led_on(LED2);
+  }
+
+  while(1)
+  {
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
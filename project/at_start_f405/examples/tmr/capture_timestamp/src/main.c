@@ -0,0 +1,143 @@
+/**
+  **************************************************************************
+  * @file     main.c
+  * @brief    main program
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "at32f402_405_board.h"
+#include "at32f402_405_clock.h"
+#include "tmr_capture.h"
+
+/** @addtogroup AT32F405_periph_examples
+  * @{
+  */
+
+/** @addtogroup 405_TMR_capture_timestamp TMR_capture_timestamp
+  * @{
+  */
+
+#define RING_SIZE                        64
+
+uint16_t rise_ring[RING_SIZE];
+uint16_t fall_ring[RING_SIZE];
+uint64_t rise_ts[RING_SIZE];
+uint64_t fall_ts[RING_SIZE];
+tmr_capture_type cap;
+
+/**
+  * @brief  configure the tmr3 channel 2 pin.
+  * @param  none
+  * @retval none
+  */
+static void gpio_config(void)
+{
+  gpio_init_type gpio_init_struct;
+
+  crm_periph_clock_enable(CRM_GPIOA_PERIPH_CLOCK, TRUE);
+
+  gpio_default_para_init(&gpio_init_struct);
+
+  gpio_init_struct.gpio_pins = GPIO_PINS_7;
+  gpio_init_struct.gpio_out_type = GPIO_OUTPUT_PUSH_PULL;
+  gpio_init_struct.gpio_pull = GPIO_PULL_NONE;
+  gpio_init_struct.gpio_mode = GPIO_MODE_MUX;
+  gpio_init_struct.gpio_drive_strength = GPIO_DRIVE_STRENGTH_STRONGER;
+  gpio_init(GPIOA, &gpio_init_struct);
+
+  gpio_pin_mux_config(GPIOA, GPIO_PINS_SOURCE7, GPIO_MUX_2);
+}
+
+/**
+  * @brief  main function.
+  * @param  none
+  * @retval none
+  */
+int main(void)
+{
+  tmr_capture_stat_type rise_stat, fall_stat;
+
+  system_clock_config();
+  at32_board_init();
+  uart_print_init(115200);
+
+  nvic_priority_group_config(NVIC_PRIORITY_GROUP_4);
+
+  /* dma clocks and channel table */
+  dma_app_init();
+
+  gpio_config();
+
+  /* pa7 rising edges on channel 2, falling edges on channel 1 through the
+     indirect input, channel 3 drains the rings at mid period */
+  cap.tmr_x = TMR3;
+  cap.div = 100;
+  cap.channel_num = 2;
+  cap.ch[0].channel = TMR_SELECT_CHANNEL_2;
+  cap.ch[0].polarity = TMR_INPUT_RISING_EDGE;
+  cap.ch[0].mapped = TMR_CC_CHANNEL_MAPPED_DIRECT;
+  cap.ch[0].filter = 0;
+  cap.ch[0].ring = rise_ring;
+  cap.ch[0].ring_size = RING_SIZE;
+  cap.ch[0].ts = rise_ts;
+  cap.ch[0].duty_ref = -1;
+  cap.ch[0].hdma = 0;
+  cap.ch[1].channel = TMR_SELECT_CHANNEL_1;
+  cap.ch[1].polarity = TMR_INPUT_FALLING_EDGE;
+  cap.ch[1].mapped = TMR_CC_CHANNEL_MAPPED_INDIRECT;
+  cap.ch[1].filter = 0;
+  cap.ch[1].ring = fall_ring;
+  cap.ch[1].ring_size = RING_SIZE;
+  cap.ch[1].ts = fall_ts;
+  cap.ch[1].duty_ref = 0;
+  cap.ch[1].hdma = 0;
+  cap.callback = 0;
+  cap.priority = 1;
+
+  if(tmr_capture_init(&cap) != SUCCESS)
+  {
+    at32_led_on(LED2);
+    while(1)
+    {
+    }
+  }
+  tmr_capture_start(&cap);
+  at32_led_on(LED3);
+
+  while(1)
+  {
+    delay_ms(1000);
+    at32_led_toggle(LED4);
+
+    tmr_capture_stat_get(&cap, 0, &rise_stat);
+    tmr_capture_stat_get(&cap, 1, &fall_stat);
+    printf("time %d ms, edges %d, lost %d, frequency %d hz, period %d to %d ticks, duty %d per mille\r\n",
+           (int)(tmr_capture_now(&cap) / (cap.clock / 1000)), (int)rise_stat.edges, (int)(rise_stat.lost + fall_stat.lost),
+           (int)rise_stat.frequency, (int)rise_stat.period_min, (int)rise_stat.period_max, (int)(fall_stat.duty * 1000));
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
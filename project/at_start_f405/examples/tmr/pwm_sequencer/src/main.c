@@ -0,0 +1,205 @@
+/**
+  **************************************************************************
+  * @file     main.c
+  * @brief    main program
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "at32f402_405_board.h"
+#include "at32f402_405_clock.h"
+#include "pwm_sequencer.h"
+
+/** @addtogroup AT32F405_periph_examples
+  * @{
+  */
+
+/** @addtogroup 405_TMR_pwm_sequencer TMR_pwm_sequencer
+  * @{
+  */
+
+#define CHANNEL_NUM                      2
+#define FRAME_NUM                        200
+#define PWM_PERIOD                       1200
+#define TRIANGLE_STEP                    12
+
+uint16_t pwm_ring[2 * FRAME_NUM * CHANNEL_NUM];
+pwm_seq_type seq;
+uint16_t triangle_phase = 0;
+uint16_t ramp_value = 0;
+
+/**
+  * @brief  fill one table, channel 1 follows a triangle and channel 2 a
+  *         ramp of duty cycles.
+  * @param  table: table to fill.
+  * @retval none
+  */
+static void table_fill(uint16_t *table)
+{
+  uint32_t index;
+
+  for(index = 0; index < FRAME_NUM; index++)
+  {
+    table[index * CHANNEL_NUM] = (triangle_phase < PWM_PERIOD) ? triangle_phase : (2 * PWM_PERIOD - triangle_phase);
+    table[index * CHANNEL_NUM + 1] = ramp_value;
+
+    triangle_phase += TRIANGLE_STEP;
+    if(triangle_phase >= 2 * PWM_PERIOD)
+    {
+      triangle_phase = 0;
+    }
+    ramp_value += TRIANGLE_STEP / 2;
+    if(ramp_value > PWM_PERIOD)
+    {
+      ramp_value = 0;
+    }
+  }
+}
+
+/**
+  * @brief  configure the tmr3 pins.
+  * @param  none
+  * @retval none
+  */
+static void gpio_config(void)
+{
+  gpio_init_type gpio_init_struct;
+
+  crm_periph_clock_enable(CRM_GPIOA_PERIPH_CLOCK, TRUE);
+
+  gpio_default_para_init(&gpio_init_struct);
+
+  gpio_init_struct.gpio_pins = GPIO_PINS_6 | GPIO_PINS_7;
+  gpio_init_struct.gpio_out_type = GPIO_OUTPUT_PUSH_PULL;
+  gpio_init_struct.gpio_pull = GPIO_PULL_NONE;
+  gpio_init_struct.gpio_mode = GPIO_MODE_MUX;
+  gpio_init_struct.gpio_drive_strength = GPIO_DRIVE_STRENGTH_STRONGER;
+  gpio_init(GPIOA, &gpio_init_struct);
+
+  gpio_pin_mux_config(GPIOA, GPIO_PINS_SOURCE6, GPIO_MUX_2);
+  gpio_pin_mux_config(GPIOA, GPIO_PINS_SOURCE7, GPIO_MUX_2);
+}
+
+/**
+  * @brief  tmr3 base at 20 khz, channel 1 and 2 in pwm mode a.
+  * @param  none
+  * @retval none
+  */
+static void tmr_config(void)
+{
+  crm_clocks_freq_type crm_clocks_freq_struct = {0};
+  tmr_output_config_type tmr_oc_init_structure;
+  uint16_t prescalervalue;
+
+  crm_periph_clock_enable(CRM_TMR3_PERIPH_CLOCK, TRUE);
+  crm_clocks_freq_get(&crm_clocks_freq_struct);
+
+  /* 24 mhz counter clock, 1200 counts per period */
+  prescalervalue = (uint16_t) ((crm_clocks_freq_struct.apb1_freq) / 24000000) - 1;
+  tmr_base_init(TMR3, PWM_PERIOD - 1, prescalervalue);
+  tmr_cnt_dir_set(TMR3, TMR_COUNT_UP);
+  tmr_clock_source_div_set(TMR3, TMR_CLOCK_DIV1);
+
+  tmr_output_default_para_init(&tmr_oc_init_structure);
+  tmr_oc_init_structure.oc_mode = TMR_OUTPUT_CONTROL_PWM_MODE_A;
+  tmr_oc_init_structure.oc_idle_state = FALSE;
+  tmr_oc_init_structure.oc_polarity = TMR_OUTPUT_ACTIVE_HIGH;
+  tmr_oc_init_structure.oc_output_state = TRUE;
+  tmr_output_channel_config(TMR3, TMR_SELECT_CHANNEL_1, &tmr_oc_init_structure);
+  tmr_output_channel_config(TMR3, TMR_SELECT_CHANNEL_2, &tmr_oc_init_structure);
+
+  /* the first period runs these values, the sequence follows it */
+  tmr_channel_value_set(TMR3, TMR_SELECT_CHANNEL_1, 0);
+  tmr_channel_value_set(TMR3, TMR_SELECT_CHANNEL_2, 0);
+}
+
+/**
+  * @brief  main function.
+  * @param  none
+  * @retval none
+  */
+int main(void)
+{
+  uint16_t *table;
+  uint32_t stale_count = 0, last_count = 0;
+
+  system_clock_config();
+  at32_board_init();
+  uart_print_init(115200);
+
+  nvic_priority_group_config(NVIC_PRIORITY_GROUP_4);
+
+  /* dma clocks and channel table */
+  dma_app_init();
+
+  gpio_config();
+  tmr_config();
+
+  /* both tables filled before the start, then refilled from the main loop */
+  seq.tmr_x = TMR3;
+  seq.channel_num = CHANNEL_NUM;
+  seq.frame_num = FRAME_NUM;
+  seq.ring = pwm_ring;
+  seq.callback = 0;
+  seq.priority = 1;
+  seq.hdma = 0;
+  table_fill(pwm_ring);
+  table_fill(pwm_ring + FRAME_NUM * CHANNEL_NUM);
+
+  if(pwm_seq_init(&seq) != SUCCESS)
+  {
+    at32_led_on(LED2);
+    while(1)
+    {
+    }
+  }
+  pwm_seq_start(&seq);
+  at32_led_on(LED3);
+
+  while(1)
+  {
+    table = pwm_seq_table_get(&seq);
+    if(table != 0)
+    {
+      table_fill(table);
+      if(pwm_seq_table_commit(&seq, table) != SUCCESS)
+      {
+        /* the table was swapped while it was filled */
+        stale_count++;
+      }
+    }
+
+    /* one table lasts 10 ms, report once a second */
+    if(seq.table_count - last_count >= 100)
+    {
+      last_count = seq.table_count;
+      at32_led_toggle(LED4);
+      printf("tables %d, underruns %d, stale commits %d, dma errors %d\r\n", (int)seq.table_count,
+             (int)seq.underruns, (int)stale_count, (int)seq.error_count);
+    }
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,172 @@
+/**
+  **************************************************************************
+  * @file     main.c
+  * @brief    main program
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include "at32f402_405_board.h"
+#include "at32f402_405_clock.h"
+#include "usart_stream.h"
+
+/** @addtogroup AT32F405_periph_examples
+  * @{
+  */
+
+/** @addtogroup 405_USART_stream_echo USART_stream_echo
+  * @{
+  */
+
+#define RX_RING_SIZE                     256
+
+const uint8_t echo_prefix[] = "echo: ";
+const uint8_t echo_suffix[] = "\r\n";
+
+uint8_t rx_ring[RX_RING_SIZE];
+usart_stream_type stream;
+usart_stream_seg_type tx_seg[4];
+
+/**
+  * @brief  usart2 configuration, the stream takes the dma requests.
+  * @param  none
+  * @retval none
+  */
+void usart_configuration(void)
+{
+  gpio_init_type gpio_init_struct;
+
+  /* enable the usart2 and gpio clock */
+  crm_periph_clock_enable(CRM_USART2_PERIPH_CLOCK, TRUE);
+  crm_periph_clock_enable(CRM_GPIOA_PERIPH_CLOCK, TRUE);
+
+  gpio_default_para_init(&gpio_init_struct);
+
+  /* configure the usart2 tx. rx pin */
+  gpio_init_struct.gpio_drive_strength = GPIO_DRIVE_STRENGTH_STRONGER;
+  gpio_init_struct.gpio_out_type = GPIO_OUTPUT_PUSH_PULL;
+  gpio_init_struct.gpio_mode = GPIO_MODE_MUX;
+  gpio_init_struct.gpio_pins = GPIO_PINS_2 | GPIO_PINS_3;
+  gpio_init_struct.gpio_pull = GPIO_PULL_NONE;
+  gpio_init(GPIOA, &gpio_init_struct);
+  gpio_pin_mux_config(GPIOA, GPIO_PINS_SOURCE2, GPIO_MUX_7);
+  gpio_pin_mux_config(GPIOA, GPIO_PINS_SOURCE3, GPIO_MUX_7);
+
+  nvic_irq_enable(USART2_IRQn, 1, 0);
+
+  /* configure usart2 param */
+  usart_init(USART2, 115200, USART_DATA_8BITS, USART_STOP_1_BIT);
+  usart_transmitter_enable(USART2, TRUE);
+  usart_receiver_enable(USART2, TRUE);
+  usart_enable(USART2, TRUE);
+}
+
+/**
+  * @brief  queue the echo of a frame, the ring segments are sent in place.
+  * @param  frame: received frame.
+  * @retval none
+  */
+void frame_echo(usart_stream_frame_type *frame)
+{
+  uint32_t index, count = 0;
+
+  tx_seg[count].pdata = echo_prefix;
+  tx_seg[count++].length = sizeof(echo_prefix) - 1;
+  for(index = 0; index < 2; index++)
+  {
+    if(frame->length[index] != 0)
+    {
+      tx_seg[count].pdata = frame->pdata[index];
+      tx_seg[count++].length = frame->length[index];
+    }
+  }
+  tx_seg[count].pdata = echo_suffix;
+  tx_seg[count++].length = sizeof(echo_suffix) - 1;
+
+  for(index = 0; index < count; index++)
+  {
+    tx_seg[index].callback = 0;
+    usart_stream_send(&stream, &tx_seg[index]);
+  }
+}
+
+/**
+  * @brief  main function.
+  * @param  none
+  * @retval none
+  */
+int main(void)
+{
+  usart_stream_frame_type frame;
+  uint8_t sending = 0;
+
+  system_clock_config();
+  at32_board_init();
+  uart_print_init(115200);
+
+  nvic_priority_group_config(NVIC_PRIORITY_GROUP_4);
+
+  /* dma clocks and channel table */
+  dma_app_init();
+
+  usart_configuration();
+
+  /* frames end on an idle line, the free channels are dma1 channel1 (rx) and channel2 (tx) */
+  if(usart_stream_init(&stream, USART2, DMAMUX_DMAREQ_ID_USART2_RX, DMAMUX_DMAREQ_ID_USART2_TX,
+                       rx_ring, RX_RING_SIZE, 0, 1) != SUCCESS)
+  {
+    at32_led_on(LED2);
+    while(1)
+    {
+    }
+  }
+  at32_led_on(LED3);
+
+  while(1)
+  {
+    /* the frame stays in the ring until its echo is sent */
+    if(sending == 0 && usart_stream_frame_get(&stream, &frame) == SUCCESS)
+    {
+      frame_echo(&frame);
+      sending = 1;
+    }
+
+    if(sending != 0 && usart_stream_tx_busy(&stream) == RESET)
+    {
+      usart_stream_frame_release(&stream);
+      sending = 0;
+      at32_led_toggle(LED4);
+
+      if((stream.stat.frames & 0xF) == 0)
+      {
+        printf("frames %d, bytes %d, drops %d, overruns %d, line errors %d\r\n",
+               (int)stream.stat.frames, (int)stream.stat.bytes, (int)stream.stat.frame_drops,
+               (int)stream.stat.overruns, (int)stream.stat.line_errors);
+      }
+    }
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -202,6 +202,12 @@ extern "C" {
   */
 /* #define USB_LOW_POWER_WAKUP */
 
+/**
+  * @brief usb device performance statistics enable,
+  *        interrupt count and cpu cycles are recorded in usbd_core_type perf
+  */
+/* #define USBD_PERF_STATISTICS */
+
 /**
   * @brief usb high speed support dma mode
   */
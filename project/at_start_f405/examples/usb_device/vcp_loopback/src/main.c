@@ -29,6 +29,7 @@
 #include "usbd_int.h"
 #include "cdc_class.h"
 #include "cdc_desc.h"
+#include "string.h"
 
 /** @addtogroup AT32F405_periph_examples
   * @{
@@ -48,6 +49,9 @@ void usb_clock48m_select(usb_clk48_s clk_s);
 void usb_gpio_config(void);
 void usb_low_power_wakeup_config(void);
 void usbd_user_init(otg_core_type *otg_dev);
+#ifdef USBD_CDC_STREAM_MODE
+static void vcp_stream_loopback(void);
+#endif
 
 
 /**
@@ -92,6 +96,11 @@ int main(void)
             &cdc_class_handler,
             &cdc_desc_handler);
 
+#ifdef USBD_CDC_STREAM_MODE
+  /* loopback through the cdc stream ring and report throughput */
+  vcp_stream_loopback();
+#endif
+
   while(1)
   {
     /* get usb vcp receive data */
@@ -123,6 +132,51 @@ int main(void)
   }
 }
 
+#ifdef USBD_CDC_STREAM_MODE
+/**
+  * @brief  cdc stream mode loopback, received spans are copied straight
+  *         into the tx ring, loopback throughput is printed every second
+  * @param  none
+  * @retval none
+  */
+static void vcp_stream_loopback(void)
+{
+  uint8_t *prx, *ptx;
+  uint32_t rx_len, tx_len;
+  uint32_t bytes = 0, start, cycles, kbytes;
+
+  uart_print_init(115200);
+
+  /* enable dwt cycle counter */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  start = DWT->CYCCNT;
+
+  while(1)
+  {
+    rx_len = usb_vcp_rx_peek(&otg_core_struct.dev, &prx);
+    if(rx_len > 0)
+    {
+      tx_len = MIN(usb_vcp_tx_reserve(&otg_core_struct.dev, &ptx), rx_len);
+      memcpy(ptx, prx, tx_len);
+      usb_vcp_tx_commit(&otg_core_struct.dev, tx_len);
+      usb_vcp_rx_release(&otg_core_struct.dev, tx_len);
+      bytes += tx_len;
+    }
+
+    cycles = DWT->CYCCNT - start;
+    if(cycles >= system_core_clock)
+    {
+      /* kbytes per second, printed as MB/s with three decimals */
+      kbytes = (uint32_t)((uint64_t)bytes * system_core_clock / cycles / 1000);
+      printf("vcp loopback: %d.%03d MB/s\r\n", (int)(kbytes / 1000), (int)(kbytes % 1000));
+      bytes = 0;
+      start = DWT->CYCCNT;
+    }
+  }
+}
+#endif
+
 /**
   * @brief  usb 48M clock select
   * @param  clk_s:USB_CLK_HICK, USB_CLK_HEXT
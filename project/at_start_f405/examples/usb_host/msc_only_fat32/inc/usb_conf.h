@@ -204,11 +204,29 @@ extern "C" {
   */
 /* #define USB_LOW_POWER_WAKUP */
 
+/**
+  * @brief usb host control transfer stages are advanced in the channel
+  *        interrupt, requests can have a complete callback
+  */
+/* #define USBH_CTRL_EVENT */
+
+/**
+  * @brief usb host channel scheduler, keeps channels for periodic endpoints
+  *        and limits bulk nak retries per frame
+  */
+/* #define USBH_CHANNEL_SCHEDULER */
+
 /**
   * @brief usb high speed support dma mode
   */
 /* #define OTG_USE_DMA */
 
+/**
+  * @brief usb host msc request queue, contiguous requests are merged into
+  *        one bot transfer and the data phase uses multi-packet requests
+  */
+/* #define USBH_MSC_QUEUE */
+
 #define USBH_DEBUG_ENABLE
 
 #ifdef USBH_DEBUG_ENABLE
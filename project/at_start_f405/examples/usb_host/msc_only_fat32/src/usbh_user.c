@@ -23,6 +23,10 @@
   */
 #include "usbh_user.h"
 #include "ff.h"
+#ifdef USBH_MSC_QUEUE
+#include "usb_core.h"
+#include "usbh_msc_class.h"
+#endif
 
 /** @addtogroup AT32F405_periph_examples
   * @{
@@ -44,6 +48,9 @@ static usb_sts_type usbh_user_enumeration_done(void);
 static usb_sts_type usbh_user_application(void);
 static usb_sts_type usbh_user_active_vbus(void *uhost, confirm_state state);
 static usb_sts_type usbh_user_not_support(void);
+#ifdef USBH_MSC_QUEUE
+static void usbh_msc_benchmark(void);
+#endif
 
 
 usbh_user_handler_type usbh_user_handle =
@@ -259,6 +266,9 @@ static usb_sts_type usbh_user_application(void)
           }
           f_close(&file);
         }
+#ifdef USBH_MSC_QUEUE
+        usbh_msc_benchmark();
+#endif
         f_mount(NULL, "", 0);
       }
       usr_state = USR_FINISH;
@@ -269,6 +279,111 @@ static usb_sts_type usbh_user_application(void)
   return status;
 }
 
+#ifdef USBH_MSC_QUEUE
+#define BENCH_TOTAL_SIZE                 (1024 * 1024)
+#define BENCH_BUF_SIZE                   (16 * 1024)
+#define BENCH_REQ_SIZE                   (4 * 1024)
+
+extern otg_core_type otg_core_struct;
+static uint8_t bench_buf[BENCH_BUF_SIZE];
+
+/**
+  * @brief  print throughput of a benchmark pass
+  * @param  name: pass name
+  * @param  bytes: transferred bytes
+  * @param  cycles: elapsed core cycles
+  * @retval none
+  */
+static void usbh_msc_bench_print(const char *name, uint32_t bytes, uint32_t cycles)
+{
+  /* kbytes per second, printed as MB/s with three decimals */
+  uint32_t kbytes = (uint32_t)((uint64_t)bytes * system_core_clock / (cycles ? cycles : 1) / 1000);
+  USBH_DEBUG("%s: %d.%03d MB/s", name, (int)(kbytes / 1000), (int)(kbytes % 1000));
+}
+
+/**
+  * @brief  sequential read/write throughput benchmark, a file is written
+  *         and read back through fatfs, then the first sectors of the disk
+  *         are read with queued requests that are merged into large bot
+  *         transfers
+  * @param  none
+  * @retval none
+  */
+static void usbh_msc_benchmark(void)
+{
+  usbh_core_type *puhost = &otg_core_struct.host;
+  uint8_t handle[BENCH_BUF_SIZE / BENCH_REQ_SIZE];
+  uint32_t i_index, offset, len, start;
+  uint32_t lba = 0, blk_size, req_sector;
+
+  /* enable dwt cycle counter */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  for(i_index = 0; i_index < BENCH_BUF_SIZE; i_index ++)
+  {
+    bench_buf[i_index] = (uint8_t)i_index;
+  }
+
+  if(f_open(&file, "0:BENCH.BIN", FA_CREATE_ALWAYS | FA_WRITE) == FR_OK)
+  {
+    start = DWT->CYCCNT;
+    for(offset = 0; offset < BENCH_TOTAL_SIZE; offset += BENCH_BUF_SIZE)
+    {
+      if(f_write(&file, bench_buf, BENCH_BUF_SIZE, &len) != FR_OK || len != BENCH_BUF_SIZE)
+      {
+        break;
+      }
+    }
+    f_close(&file);
+    usbh_msc_bench_print("sequential write", offset, DWT->CYCCNT - start);
+  }
+
+  if(f_open(&file, "0:BENCH.BIN", FA_READ) == FR_OK)
+  {
+    start = DWT->CYCCNT;
+    for(offset = 0; offset < BENCH_TOTAL_SIZE; offset += BENCH_BUF_SIZE)
+    {
+      if(f_read(&file, bench_buf, BENCH_BUF_SIZE, &len) != FR_OK || len != BENCH_BUF_SIZE)
+      {
+        break;
+      }
+    }
+    f_close(&file);
+    usbh_msc_bench_print("sequential read", offset, DWT->CYCCNT - start);
+  }
+
+  /* raw queued read, requests of one buffer are merged into one transfer */
+  blk_size = usbh_msc.l_unit_n[0].capacity.blk_size;
+  if(blk_size == 0 || BENCH_REQ_SIZE % blk_size != 0)
+  {
+    return;
+  }
+  req_sector = BENCH_REQ_SIZE / blk_size;
+  start = DWT->CYCCNT;
+  for(offset = 0; offset < BENCH_TOTAL_SIZE; offset += BENCH_BUF_SIZE)
+  {
+    for(i_index = 0; i_index < sizeof(handle); i_index ++)
+    {
+      if(usbh_msc_submit(puhost, USBH_MSC_DIR_READ, lba, req_sector,
+                         bench_buf + i_index * BENCH_REQ_SIZE, 0, &handle[i_index]) != USB_OK)
+      {
+        return;
+      }
+      lba += req_sector;
+    }
+    for(i_index = 0; i_index < sizeof(handle); i_index ++)
+    {
+      if(usbh_msc_wait(puhost, handle[i_index]) != USB_OK)
+      {
+        return;
+      }
+    }
+  }
+  usbh_msc_bench_print("queued read", offset, DWT->CYCCNT - start);
+}
+#endif
+
 /**
   * @brief  usb host active vbus user handler
   * @param  uhost: to the structure of usbh_core_type
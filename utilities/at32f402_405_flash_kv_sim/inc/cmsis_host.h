@@ -0,0 +1,123 @@
+/**
+  **************************************************************************
+  * @file     cmsis_host.h
+  * @brief    cmsis compiler definitions for the host build
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CMSIS_HOST_H
+#define __CMSIS_HOST_H
+
+/* the host build replaces cmsis_compiler.h, core_cm4.h includes it under this guard */
+#define __CMSIS_COMPILER_H
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @addtogroup AT32F402_405_flash_kv_sim
+  * @{
+  */
+
+/** @defgroup FLASH_kv_sim_cmsis_host
+  * @brief compiler and core intrinsics of the cortex-m4 mapped to the host,
+  *        interrupt masking only updates a host copy of primask
+  * @{
+  */
+
+#define __ASM                            __asm__
+#define __INLINE                         inline
+#define __STATIC_INLINE                  static inline
+#define __STATIC_FORCEINLINE             static inline __attribute__((always_inline))
+#define __NO_RETURN                      __attribute__((__noreturn__))
+#define __USED                           __attribute__((used))
+#define __WEAK                           __attribute__((weak))
+#define __PACKED                         __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT                  struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION                   union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)                     __attribute__((aligned(x)))
+#define __RESTRICT                       __restrict
+#define __COMPILER_BARRIER()             __asm__ volatile("" ::: "memory")
+
+extern uint32_t cmsis_host_primask;
+
+__STATIC_INLINE uint32_t __UNALIGNED_UINT32_READ(const void *addr)
+{
+  uint32_t value;
+  memcpy(&value, addr, sizeof(value));
+  return value;
+}
+
+__STATIC_INLINE void __UNALIGNED_UINT32_WRITE_HOST(void *addr, uint32_t value)
+{
+  memcpy(addr, &value, sizeof(value));
+}
+#define __UNALIGNED_UINT32_WRITE(addr, val)  __UNALIGNED_UINT32_WRITE_HOST((void *)(addr), (uint32_t)(val))
+
+__STATIC_INLINE uint16_t __UNALIGNED_UINT16_READ(const void *addr)
+{
+  uint16_t value;
+  memcpy(&value, addr, sizeof(value));
+  return value;
+}
+
+__STATIC_INLINE void __UNALIGNED_UINT16_WRITE_HOST(void *addr, uint16_t value)
+{
+  memcpy(addr, &value, sizeof(value));
+}
+#define __UNALIGNED_UINT16_WRITE(addr, val)  __UNALIGNED_UINT16_WRITE_HOST((void *)(addr), (uint16_t)(val))
+
+__STATIC_INLINE void __NOP(void) { __COMPILER_BARRIER(); }
+__STATIC_INLINE void __WFI(void) { __COMPILER_BARRIER(); }
+__STATIC_INLINE void __WFE(void) { __COMPILER_BARRIER(); }
+__STATIC_INLINE void __SEV(void) { __COMPILER_BARRIER(); }
+__STATIC_INLINE void __ISB(void) { __COMPILER_BARRIER(); }
+__STATIC_INLINE void __DSB(void) { __COMPILER_BARRIER(); }
+__STATIC_INLINE void __DMB(void) { __COMPILER_BARRIER(); }
+
+__STATIC_INLINE void __enable_irq(void) { cmsis_host_primask = 0; }
+__STATIC_INLINE void __disable_irq(void) { cmsis_host_primask = 1; }
+__STATIC_INLINE uint32_t __get_PRIMASK(void) { return cmsis_host_primask; }
+__STATIC_INLINE void __set_PRIMASK(uint32_t primask) { cmsis_host_primask = primask; }
+
+__STATIC_INLINE uint32_t __REV(uint32_t value) { return __builtin_bswap32(value); }
+__STATIC_INLINE uint32_t __REV16(uint32_t value)
+{
+  return ((value & 0xFF00FF00) >> 8) | ((value & 0x00FF00FF) << 8);
+}
+__STATIC_INLINE uint8_t __CLZ(uint32_t value) { return (value == 0) ? 32 : (uint8_t)__builtin_clz(value); }
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,91 @@
+/**
+  **************************************************************************
+  * @file     flash_kv_sim.h
+  * @brief    flash and crc model for the host build of flash_kv
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FLASH_KV_SIM_H
+#define __FLASH_KV_SIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include <setjmp.h>
+#include "at32f402_405.h"
+
+/** @addtogroup AT32F402_405_flash_kv_sim
+  * @{
+  */
+
+/** @defgroup FLASH_kv_sim_config
+  * @{
+  */
+
+#define SIM_FLASH_BASE                   ((uint32_t)0x08000000)
+#define SIM_FLASH_SIZE                   ((uint32_t)0x40000)
+#define SIM_SECTOR_SIZE                  ((uint32_t)0x800)
+#define SIM_SECTOR_NUM                   (SIM_FLASH_SIZE / SIM_SECTOR_SIZE)
+
+/**
+  * @}
+  */
+
+/** @defgroup FLASH_kv_sim_types
+  * @{
+  */
+
+/**
+  * @brief flash model state
+  */
+typedef struct
+{
+  uint32_t                               ops;                     /*!< erases and programs so far      */
+  uint32_t                               cut_at;                  /*!< power is lost at this op, 0: never */
+  uint32_t                               erases[SIM_SECTOR_NUM];  /*!< erases per sector               */
+  uint32_t                               programs;                /*!< words programmed                */
+  uint32_t                               program_errors;          /*!< programs of words not erased    */
+  uint32_t                               seed;                    /*!< random state of the partial ops */
+} sim_flash_type;
+
+/**
+  * @}
+  */
+
+extern sim_flash_type sim_flash;
+extern jmp_buf sim_cut;
+
+void     sim_flash_init                  (void);
+void     sim_flash_wipe                  (void);
+void     sim_power_loss                  (void) __NO_RETURN;
+uint32_t sim_random                      (void);
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,336 @@
+/**
+  **************************************************************************
+  * @file     flash_kv_sim.c
+  * @brief    flash and crc model for the host build of flash_kv
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include "flash_kv_sim.h"
+
+/** @addtogroup AT32F402_405_flash_kv_sim
+  * @{
+  */
+
+/** @defgroup FLASH_kv_sim_model
+  * @brief the flash array is mapped at its target address, erase and
+  *        word program follow nor rules: a program only clears bits and
+  *        is refused on a word that is not erased, except for 0. at the
+  *        op selected by cut_at the op is done in part (random bits of a
+  *        program, random words of an erase) and the power is lost.
+  *        the crc unit is computed in software from its configuration.
+  * @{
+  */
+
+sim_flash_type sim_flash;
+jmp_buf sim_cut;
+uint32_t cmsis_host_primask;
+
+static struct
+{
+  uint32_t                               poly;
+  uint32_t                               init;
+  uint32_t                               value;
+  crc_poly_size_type                     poly_size;
+  crc_reverse_input_type                 rev_in;
+  crc_reverse_output_type                rev_out;
+} sim_crc = {0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, CRC_POLY_SIZE_32B, CRC_REVERSE_INPUT_NO_AFFECTE, CRC_REVERSE_OUTPUT_NO_AFFECTE};
+
+#define SIM_WORD(addr)                   (*(volatile uint32_t *)(uintptr_t)(addr))
+
+/**
+  * @brief  xorshift random numbers for the partial ops.
+  * @param  none
+  * @retval random word.
+  */
+uint32_t sim_random(void)
+{
+  uint32_t x = sim_flash.seed;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  sim_flash.seed = x;
+
+  return x;
+}
+
+/**
+  * @brief  map the flash array and erase it.
+  * @param  none
+  * @retval none
+  */
+void sim_flash_init(void)
+{
+  void *addr;
+
+  addr = mmap((void *)(uintptr_t)SIM_FLASH_BASE, SIM_FLASH_SIZE, PROT_READ | PROT_WRITE,
+              MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+  if(addr != (void *)(uintptr_t)SIM_FLASH_BASE)
+  {
+    fprintf(stderr, "flash can not be mapped at its target address\n");
+    exit(1);
+  }
+
+  sim_flash.seed = 0x2545F491;
+  sim_flash_wipe();
+}
+
+/**
+  * @brief  erase the whole array and clear the counters.
+  * @param  none
+  * @retval none
+  */
+void sim_flash_wipe(void)
+{
+  uint32_t seed = sim_flash.seed;
+
+  memset((void *)(uintptr_t)SIM_FLASH_BASE, 0xFF, SIM_FLASH_SIZE);
+  memset(&sim_flash, 0, sizeof(sim_flash));
+  sim_flash.seed = seed;
+}
+
+/**
+  * @brief  count an op and check for the power loss.
+  * @param  none
+  * @retval 1 if the power is lost during this op.
+  */
+static int sim_op(void)
+{
+  sim_flash.ops++;
+
+  return (sim_flash.cut_at != 0 && sim_flash.ops == sim_flash.cut_at);
+}
+
+/**
+  * @brief  the power is lost, back to the setjmp of the test.
+  * @param  none
+  * @retval none
+  */
+void sim_power_loss(void)
+{
+  sim_flash.cut_at = 0;
+  longjmp(sim_cut, 1);
+}
+
+/**
+  * @brief  the model has no lock.
+  * @param  none
+  * @retval none
+  */
+void flash_unlock(void)
+{
+}
+
+/**
+  * @brief  the model has no lock.
+  * @param  none
+  * @retval none
+  */
+void flash_lock(void)
+{
+}
+
+/**
+  * @brief  erase a sector of the model.
+  * @param  sector_address: address in the sector.
+  * @retval flash status.
+  */
+flash_status_type flash_sector_erase(uint32_t sector_address)
+{
+  uint32_t base = sector_address & ~(SIM_SECTOR_SIZE - 1);
+  uint32_t i;
+
+  if(base < SIM_FLASH_BASE || base >= SIM_FLASH_BASE + SIM_FLASH_SIZE)
+  {
+    return FLASH_PROGRAM_ERROR;
+  }
+
+  if(sim_op())
+  {
+    for(i = 0; i < SIM_SECTOR_SIZE; i += 4)
+    {
+      if(sim_random() & 1)
+      {
+        SIM_WORD(base + i) = 0xFFFFFFFF;
+      }
+    }
+    sim_power_loss();
+  }
+
+  memset((void *)(uintptr_t)base, 0xFF, SIM_SECTOR_SIZE);
+  sim_flash.erases[(base - SIM_FLASH_BASE) / SIM_SECTOR_SIZE]++;
+
+  return FLASH_OPERATE_DONE;
+}
+
+/**
+  * @brief  program a word of the model.
+  * @param  address: word address.
+  * @param  data: word.
+  * @retval flash status.
+  */
+flash_status_type flash_word_program(uint32_t address, uint32_t data)
+{
+  uint32_t old;
+
+  if((address & 3) || address < SIM_FLASH_BASE || address >= SIM_FLASH_BASE + SIM_FLASH_SIZE)
+  {
+    return FLASH_PROGRAM_ERROR;
+  }
+
+  old = SIM_WORD(address);
+  if(old != 0xFFFFFFFF && data != 0)
+  {
+    sim_flash.program_errors++;
+    return FLASH_PROGRAM_ERROR;
+  }
+
+  if(sim_op())
+  {
+    SIM_WORD(address) = old & (data | sim_random());
+    sim_power_loss();
+  }
+
+  SIM_WORD(address) = old & data;
+  sim_flash.programs++;
+
+  return FLASH_OPERATE_DONE;
+}
+
+/**
+  * @brief  one crc step over a word, msb first.
+  * @param  data: word, input reversal applied.
+  * @retval none
+  */
+static void sim_crc_word(uint32_t data)
+{
+  uint32_t crc = sim_crc.value;
+  int i;
+
+  crc ^= data;
+  for(i = 0; i < 32; i++)
+  {
+    crc = (crc & 0x80000000) ? (crc << 1) ^ sim_crc.poly : (crc << 1);
+  }
+  sim_crc.value = crc;
+}
+
+/**
+  * @brief  bit reversal of a word.
+  * @param  value: word.
+  * @retval reversed word.
+  */
+static uint32_t sim_bit_reverse(uint32_t value)
+{
+  uint32_t result = 0;
+  int i;
+
+  for(i = 0; i < 32; i++)
+  {
+    result = (result << 1) | ((value >> i) & 1);
+  }
+
+  return result;
+}
+
+/**
+  * @brief  crc unit functions of the driver, on the software crc.
+  */
+void crc_data_reset(void)
+{
+  sim_crc.value = sim_crc.init;
+}
+
+uint32_t crc_block_calculate(uint32_t *pbuffer, uint32_t length)
+{
+  uint32_t data, i;
+
+  for(i = 0; i < length; i++)
+  {
+    data = pbuffer[i];
+    if(sim_crc.rev_in == CRC_REVERSE_INPUT_BY_WORD)
+    {
+      data = sim_bit_reverse(data);
+    }
+    else if(sim_crc.rev_in == CRC_REVERSE_INPUT_BY_BYTE)
+    {
+      data = __REV(sim_bit_reverse(data));
+    }
+    else if(sim_crc.rev_in == CRC_REVERSE_INPUT_BY_HALFWORD)
+    {
+      data = sim_bit_reverse(data);
+      data = (data << 16) | (data >> 16);
+    }
+    sim_crc_word(data);
+  }
+
+  return crc_data_get();
+}
+
+uint32_t crc_data_get(void)
+{
+  return (sim_crc.rev_out == CRC_REVERSE_OUTPUT_DATA) ? sim_bit_reverse(sim_crc.value) : sim_crc.value;
+}
+
+void crc_init_data_set(uint32_t value)
+{
+  sim_crc.init = value;
+}
+
+void crc_reverse_input_data_set(crc_reverse_input_type value)
+{
+  sim_crc.rev_in = value;
+}
+
+void crc_reverse_output_data_set(crc_reverse_output_type value)
+{
+  sim_crc.rev_out = value;
+}
+
+void crc_poly_value_set(uint32_t value)
+{
+  sim_crc.poly = value;
+}
+
+/**
+  * @brief  only the 32 bit polynomial is modelled.
+  * @param  size: polynomial size.
+  * @retval none
+  */
+void crc_poly_size_set(crc_poly_size_type size)
+{
+  if(size != CRC_POLY_SIZE_32B)
+  {
+    fprintf(stderr, "crc polynomial size %d not modelled\n", (int)size);
+    exit(1);
+  }
+  sim_crc.poly_size = size;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,386 @@
+/**
+  **************************************************************************
+  * @file     flash_kv_test.c
+  * @brief    endurance and power loss test of flash_kv on the flash model
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "flash_kv.h"
+#include "flash_kv_sim.h"
+
+/** @addtogroup AT32F402_405_flash_kv_sim
+  * @{
+  */
+
+/** @defgroup FLASH_kv_sim_test
+  * @brief endurance: random writes and deletes checked against a ram
+  *        model, with remounts, then the erase count of each sector.
+  *        power loss: a fixed workload is cut at every flash op in turn,
+  *        after the remount each key must hold its last written value,
+  *        the key of the cut write its old or its new value, and the
+  *        store must keep working.
+  * @{
+  */
+
+#ifndef KV_AREA_SIZE
+#define KV_AREA_SIZE                     (4 * SIM_SECTOR_SIZE)
+#endif
+#define KV_AREA0                         ((uint32_t)0x08030000)
+#define KV_AREA1                         (KV_AREA0 + KV_AREA_SIZE)
+
+#define KEY_NUM                          12
+#define VALUE_LEN_MAX                    96
+#define ENDURANCE_OPS                    200000
+#define WORKLOAD_OPS                     400
+#define GC_IDLE_EVERY                    5
+#ifndef POWER_LOSS_ROUNDS
+#define POWER_LOSS_ROUNDS                4
+#endif
+
+typedef struct
+{
+  uint8_t                                present;
+  uint16_t                               length;
+  uint8_t                                data[VALUE_LEN_MAX];
+} model_value_type;
+
+typedef struct
+{
+  uint16_t                               key;
+  uint8_t                                remove;
+  model_value_type                       value;
+} model_op_type;
+
+static flash_kv_type kv;
+static model_value_type model[KEY_NUM + 1];
+static uint32_t user_bytes;
+
+/**
+  * @brief  random numbers of the workload, apart from the model ones.
+  * @param  state: generator state.
+  * @retval random word.
+  */
+static uint32_t test_random(uint32_t *state)
+{
+  uint32_t x = *state;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+
+  return x;
+}
+
+/**
+  * @brief  make the next operation of a workload.
+  * @param  state: generator state.
+  * @param  op: operation.
+  * @retval none
+  */
+static void test_op_make(uint32_t *state, model_op_type *op)
+{
+  uint16_t i;
+
+  op->key = 1 + test_random(state) % KEY_NUM;
+  op->remove = (test_random(state) % 16) == 0;
+  op->value.present = !op->remove;
+  op->value.length = op->remove ? 0 : test_random(state) % (VALUE_LEN_MAX + 1);
+  for(i = 0; i < op->value.length; i++)
+  {
+    op->value.data[i] = (uint8_t)test_random(state);
+  }
+}
+
+/**
+  * @brief  run an operation and update the model when it is done.
+  * @param  op: operation.
+  * @retval 0 if the store behaved as expected.
+  */
+static int test_op_run(model_op_type *op)
+{
+  flash_kv_status_type status;
+
+  if(op->remove)
+  {
+    status = flash_kv_delete(&kv, op->key);
+    if(status == FLASH_KV_NOT_FOUND && !model[op->key].present)
+    {
+      return 0;
+    }
+  }
+  else
+  {
+    status = flash_kv_write(&kv, op->key, op->value.data, op->value.length);
+    user_bytes += op->value.length;
+  }
+
+  if(status != FLASH_KV_OK)
+  {
+    printf("key %d: status %d\n", op->key, (int)status);
+    return 1;
+  }
+
+  model[op->key] = op->value;
+  return 0;
+}
+
+/**
+  * @brief  compare a key with a value.
+  * @param  key: key.
+  * @param  value: expected value.
+  * @retval 0 if equal.
+  */
+static int test_key_compare(uint16_t key, const model_value_type *value)
+{
+  uint8_t data[VALUE_LEN_MAX];
+  uint16_t length = 0;
+  flash_kv_status_type status;
+
+  status = flash_kv_read(&kv, key, data, sizeof(data), &length);
+  if(!value->present)
+  {
+    return status != FLASH_KV_NOT_FOUND;
+  }
+
+  return status != FLASH_KV_OK || length != value->length || memcmp(data, value->data, length) != 0;
+}
+
+/**
+  * @brief  compare all keys with the model.
+  * @param  cut: operation cut by the power loss, 0 if none. its key may
+  *         hold the new value as well.
+  * @retval number of wrong keys.
+  */
+static int test_check(const model_op_type *cut)
+{
+  int errors = 0;
+  uint16_t key;
+
+  for(key = 1; key <= KEY_NUM; key++)
+  {
+    if(test_key_compare(key, &model[key]) == 0)
+    {
+      continue;
+    }
+    if(cut != 0 && cut->key == key && test_key_compare(key, &cut->value) == 0)
+    {
+      continue;
+    }
+    printf("key %d: wrong value\n", key);
+    errors++;
+  }
+
+  return errors;
+}
+
+/**
+  * @brief  erase the flash and start an empty store.
+  * @param  none
+  * @retval none
+  */
+static void test_format(void)
+{
+  sim_flash_wipe();
+  memset(model, 0, sizeof(model));
+  user_bytes = 0;
+
+  if(flash_kv_init(&kv, KV_AREA0, KV_AREA1, KV_AREA_SIZE, SIM_SECTOR_SIZE) != FLASH_KV_OK)
+  {
+    printf("format failed\n");
+    exit(1);
+  }
+}
+
+/**
+  * @brief  endurance test.
+  * @param  none
+  * @retval number of errors.
+  */
+static int test_endurance(void)
+{
+  uint32_t state = 0x1234567, i, min = 0xFFFFFFFF, max = 0, total = 0;
+  uint32_t first = (KV_AREA0 - SIM_FLASH_BASE) / SIM_SECTOR_SIZE;
+  uint32_t last = (KV_AREA1 + KV_AREA_SIZE - SIM_FLASH_BASE) / SIM_SECTOR_SIZE;
+  model_op_type op;
+  int errors = 0;
+
+  test_format();
+
+  for(i = 1; i <= ENDURANCE_OPS && errors == 0; i++)
+  {
+    test_op_make(&state, &op);
+    errors += test_op_run(&op);
+    errors += test_key_compare(op.key, &model[op.key]);
+
+    if(i % GC_IDLE_EVERY == 0)
+    {
+      flash_kv_gc_step(&kv);
+    }
+    if(i % 997 == 0)
+    {
+      errors += test_check(0);
+    }
+    if(i % 10007 == 0)
+    {
+      flash_kv_init(&kv, KV_AREA0, KV_AREA1, KV_AREA_SIZE, SIM_SECTOR_SIZE);
+      errors += test_check(0);
+    }
+  }
+
+  for(i = first; i < last; i++)
+  {
+    min = (sim_flash.erases[i] < min) ? sim_flash.erases[i] : min;
+    max = (sim_flash.erases[i] > max) ? sim_flash.erases[i] : max;
+    total += sim_flash.erases[i];
+  }
+
+  printf("endurance: %d ops, %d user bytes, %d words programmed, write amplification %.2f\n",
+         ENDURANCE_OPS, (int)user_bytes, (int)sim_flash.programs, (double)sim_flash.programs * 4 / user_bytes);
+  printf("endurance: %d sector erases, per sector min %d max %d, %.1f writes per erase, %d errors\n",
+         (int)total, (int)min, (int)max, (double)ENDURANCE_OPS / total, errors);
+
+  return errors;
+}
+
+/**
+  * @brief  run the power loss workload.
+  * @param  cut: set to the running operation.
+  * @retval number of errors.
+  */
+static int test_workload(model_op_type *cut)
+{
+  uint32_t state = 0x89ABCDE, i;
+  int errors = 0;
+
+  for(i = 1; i <= WORKLOAD_OPS; i++)
+  {
+    test_op_make(&state, cut);
+    errors += test_op_run(cut);
+    cut->key = 0;
+
+    if(i % GC_IDLE_EVERY == 0)
+    {
+      flash_kv_gc_step(&kv);
+    }
+  }
+
+  return errors;
+}
+
+/**
+  * @brief  power loss test, the workload is cut at every flash op, each
+  *         cut point is run in several rounds with other partial ops.
+  * @param  none
+  * @retval number of failed cuts.
+  */
+static int test_power_loss(void)
+{
+  static model_op_type cut;
+  uint32_t base, total, round, n, i, failed = 0;
+  int errors;
+
+  /* dry run for the number of flash ops */
+  test_format();
+  base = sim_flash.ops;
+  if(test_workload(&cut) != 0)
+  {
+    printf("power loss: workload failed without cut\n");
+    return 1;
+  }
+  total = sim_flash.ops - base;
+
+  for(round = 0; round < POWER_LOSS_ROUNDS * total; round++)
+  {
+    n = 1 + round % total;
+    test_format();
+    memset(&cut, 0, sizeof(cut));
+    sim_flash.cut_at = sim_flash.ops + n;
+
+    if(setjmp(sim_cut) == 0)
+    {
+      test_workload(&cut);
+      printf("power loss: cut %d not reached\n", (int)n);
+      failed++;
+      continue;
+    }
+
+    /* power back: mount, check, then the store must go on working */
+    errors = 0;
+    if(flash_kv_init(&kv, KV_AREA0, KV_AREA1, KV_AREA_SIZE, SIM_SECTOR_SIZE) != FLASH_KV_OK)
+    {
+      printf("mount failed\n");
+      errors++;
+    }
+    errors += test_check(cut.key != 0 ? &cut : 0);
+
+    for(i = 0; i < 3 * KEY_NUM && errors == 0; i++)
+    {
+      cut.key = 1 + i % KEY_NUM;
+      cut.remove = 0;
+      cut.value.present = 1;
+      cut.value.length = (uint16_t)(i * 7 % VALUE_LEN_MAX);
+      memset(cut.value.data, (int)(n + i), cut.value.length);
+      errors += test_op_run(&cut);
+    }
+    if(errors == 0)
+    {
+      flash_kv_init(&kv, KV_AREA0, KV_AREA1, KV_AREA_SIZE, SIM_SECTOR_SIZE);
+      errors += test_check(0);
+    }
+
+    if(errors != 0)
+    {
+      printf("power loss: cut at op %d of %d failed\n", (int)n, (int)total);
+      failed++;
+    }
+  }
+
+  printf("power loss: %d cut points in %d rounds, %d failed\n", (int)total, POWER_LOSS_ROUNDS, (int)failed);
+
+  return failed;
+}
+
+/**
+  * @brief  main function.
+  * @param  none
+  * @retval 0 if all tests pass.
+  */
+int main(void)
+{
+  int errors = 0;
+
+  sim_flash_init();
+
+  errors += test_endurance();
+  errors += test_power_loss();
+
+  return errors ? 1 : 0;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
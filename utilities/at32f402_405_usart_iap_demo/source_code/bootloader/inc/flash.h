@@ -46,6 +46,13 @@ extern "C" {
 #define FLASH_SIZE                       (*(uint32_t*)0x1FFFF7E0)  /* read from at32 flash capacity register(unit:kbyte) */
 #define SRAM_SIZE                        48                         /* sram size, unit:kbyte */
 
+/* download progress, kept behind the upgrade flag in the same sector so the
+   app clears it together with the flag */
+#define IAP_RESUME_SIZE_ADDR             (IAP_UPGRADE_FLAG_ADDR + 4)   /* image size of the download */
+#define IAP_RESUME_CRC_ADDR              (IAP_UPGRADE_FLAG_ADDR + 8)   /* image crc-32 of the download */
+#define IAP_RESUME_LOG_ADDR              (IAP_UPGRADE_FLAG_ADDR + 12)  /* one word per programmed block */
+#define IAP_RESUME_LOG_NUM               ((0x400 - 12) / 4)
+
 /**
   * @}
   */
@@ -56,6 +63,9 @@ extern "C" {
 
 void flash_2kb_write(uint32_t write_addr, uint8_t *pbuffer);
 flag_status flash_upgrade_flag_read(void);
+uint16_t flash_resume_block_get(uint32_t image_size, uint32_t image_crc);
+void flash_resume_block_set(uint16_t block);
+void flash_resume_clear(void);
 
 /**
   * @}
@@ -61,6 +61,25 @@ extern "C" {
 indicates that an app upgrade will follow, see iap application note for more details */
 #define IAP_UPGRADE_FLAG         0x41544B38
 
+/**
+  * @}
+  */
+
+/** @defgroup bootloader_window_definition
+  * @{
+  */
+
+/* windowed transfer, see readme.txt for the frame format.
+   the frames are received by dma into a ring of IAP_WIN_SLOT_NUM slots,
+   so up to IAP_WIN_SLOT_NUM frames can be sent before the first ack */
+#define IAP_WIN_CMD_START        0x33
+#define IAP_WIN_CMD_BLOCK        0x34
+#define IAP_WIN_SLOT_NUM         4
+#define IAP_WIN_BLOCK_SIZE       0x800
+#define IAP_WIN_FRAME_LEN        (IAP_WIN_BLOCK_SIZE + 8)
+#define IAP_WIN_RING_LEN         (IAP_WIN_SLOT_NUM * IAP_WIN_FRAME_LEN)
+#define IAP_WIN_IMAGE_DONE       0xFFFF
+
 /**
   * @}
   */
@@ -91,6 +110,8 @@ typedef enum
   CMD_DATA_CHACK,
   CMD_DATA_DONE,
   CMD_DATA_ERR,
+  CMD_WIN_PARAM,
+  CMD_WIN_START,
 } cmd_data_step_type;
 
 /**
@@ -114,8 +135,23 @@ typedef enum
   UPDATE_CLEAR_FLAG,
   UPDATE_ING,
   UPDATE_DONE,
+  UPDATE_WIN,
 } update_status_type;
 
+/**
+  * @brief  windowed transfer type
+  */
+typedef struct
+{
+  uint32_t image_size;
+  uint32_t image_crc;
+  uint16_t block_num;
+  uint16_t block_first;
+  uint16_t block_next;
+  uint16_t dma_pos;
+  uint32_t received;
+} iap_win_type;
+
 typedef void (*iapfun)(void);
 
 /**
@@ -126,6 +162,7 @@ extern cmd_data_group_type cmd_data_group_type_struct;
 extern cmd_data_step_type cmd_data_step;
 extern cmd_ctr_step_type cmd_ctr_step;
 extern update_status_type update_status;
+extern iap_win_type iap_win_struct;
 
 /** @defgroup bootloader_exported_functions
   * @{
@@ -33,6 +33,7 @@ extern "C" {
 
 extern uint8_t time_ira_cnt;
 extern uint8_t get_data_from_usart_flag;
+extern __IO uint8_t upgrade_timeout_flag;
 
 /** @addtogroup UTILITIES_examples
   * @{
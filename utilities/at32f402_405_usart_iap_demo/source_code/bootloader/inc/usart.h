@@ -75,6 +75,10 @@ extern usart_group_type usart_group_struct;
   */
 
 void uart_init(uint32_t baudrate);
+void uart_dma_receive_start(uint8_t *pbuffer, uint16_t length);
+void uart_dma_receive_stop(void);
+uint16_t uart_dma_receive_pos(void);
+void uart_data_send(uint8_t *pbuffer, uint16_t length);
 
 /**
   * @}
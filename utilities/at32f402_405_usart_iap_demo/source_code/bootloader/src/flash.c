@@ -69,6 +69,57 @@ flag_status flash_upgrade_flag_read(void)
     return RESET;
 }
 
+/**
+  * @brief  get the block to resume a windowed download from.
+  * @note   a download of another image restarts the progress log, the
+  *         upgrade flag is written again right after the sector erase.
+  * @param  image_size: image size of the download
+  * @param  image_crc: image crc-32 of the download
+  * @retval first block not yet programmed
+  */
+uint16_t flash_resume_block_get(uint32_t image_size, uint32_t image_crc)
+{
+  uint16_t block = 0;
+  if(((*(uint32_t*)IAP_RESUME_SIZE_ADDR) == image_size) && ((*(uint32_t*)IAP_RESUME_CRC_ADDR) == image_crc))
+  {
+    while((block < IAP_RESUME_LOG_NUM) && ((*(uint32_t*)(IAP_RESUME_LOG_ADDR + block * 4)) == block))
+      block++;
+    return block;
+  }
+  flash_unlock();
+  flash_sector_erase(IAP_UPGRADE_FLAG_ADDR);
+  flash_word_program(IAP_UPGRADE_FLAG_ADDR, IAP_UPGRADE_FLAG);
+  flash_word_program(IAP_RESUME_SIZE_ADDR, image_size);
+  flash_word_program(IAP_RESUME_CRC_ADDR, image_crc);
+  flash_lock();
+  return 0;
+}
+
+/**
+  * @brief  record a programmed and verified block.
+  * @param  block: block number, blocks are recorded in order
+  * @retval none
+  */
+void flash_resume_block_set(uint16_t block)
+{
+  flash_unlock();
+  flash_word_program(IAP_RESUME_LOG_ADDR + block * 4, block);
+  flash_lock();
+}
+
+/**
+  * @brief  drop the download progress, keep the upgrade flag.
+  * @param  none
+  * @retval none
+  */
+void flash_resume_clear(void)
+{
+  flash_unlock();
+  flash_sector_erase(IAP_UPGRADE_FLAG_ADDR);
+  flash_word_program(IAP_UPGRADE_FLAG_ADDR, IAP_UPGRADE_FLAG);
+  flash_lock();
+}
+
 /**
   * @}
   */
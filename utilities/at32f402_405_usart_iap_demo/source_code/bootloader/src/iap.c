@@ -26,6 +26,7 @@
 #include "usart.h"
 #include "flash.h"
 #include "tmr.h"
+#include <string.h>
 
 /** @addtogroup UTILITIES_examples
   * @{
@@ -42,6 +43,8 @@ update_status_type update_status = UPDATE_PRE;
 static uint8_t cmd_addr_cnt = 0;
 static uint32_t cmd_data_cnt = 0;
 iapfun jump_to_app;
+iap_win_type iap_win_struct;
+static uint32_t iap_win_ring[IAP_WIN_RING_LEN / 4];
 
 /* app_load don't optimize */
 #if defined (__ARMCC_VERSION)
@@ -71,6 +74,8 @@ void app_load(uint32_t app_addr)
     crm_periph_clock_enable(CRM_TMR3_PERIPH_CLOCK, FALSE);
     crm_periph_clock_enable(CRM_USART1_PERIPH_CLOCK, FALSE);
     crm_periph_clock_enable(CRM_GPIOA_PERIPH_CLOCK, FALSE);
+    crm_periph_clock_enable(CRM_DMA1_PERIPH_CLOCK, FALSE);
+    crm_periph_clock_enable(CRM_CRC_PERIPH_CLOCK, FALSE);
 
     /* disable nvic irq and clear pending */
     nvic_irq_disable(USART1_IRQn);
@@ -152,6 +157,11 @@ void command_handle(void)
           cmd_addr_cnt = 0;
           cmd_data_cnt = 0;
         }
+        if(val == IAP_WIN_CMD_START)
+        {
+          cmd_data_step = CMD_WIN_PARAM;
+          cmd_data_cnt = 0;
+        }
         if(val == 0x5A)
         {
           if(cmd_ctr_step == CMD_CTR_IDLE)
@@ -198,6 +208,15 @@ void command_handle(void)
           cmd_data_step = CMD_DATA_ERR;
         }
         break;
+      case CMD_WIN_PARAM:
+        cmd_data_group_struct.cmd_buf[cmd_data_cnt] = val;
+        cmd_data_cnt++;
+        if(cmd_data_cnt >= 8)
+        {
+          cmd_data_cnt = 0;
+          cmd_data_step = CMD_WIN_START;
+        }
+        break;
       default:
         break;
     }
@@ -239,17 +258,14 @@ void back_ok(void)
 }
 
 /**
-  * @brief  command response error.
+  * @brief  reset state machine of upgrade flow.
   * @param  none
   * @retval none
   */
-void back_err(void)
+static void iap_flow_reset(void)
 {
-  usart_data_transmit(USART1, 0xEE);
-  while(usart_flag_get(USART1, USART_TDC_FLAG) == RESET);
-  usart_data_transmit(USART1, 0xFF);
-  while(usart_flag_get(USART1, USART_TDC_FLAG) == RESET);
-  /* reset state machine of udgrade flow */
+  if(update_status == UPDATE_WIN)
+    uart_dma_receive_stop();
   cmd_data_step = CMD_DATA_IDLE;
   cmd_ctr_step = CMD_CTR_IDLE;
   update_status = UPDATE_PRE;
@@ -257,6 +273,163 @@ void back_err(void)
   cmd_data_cnt = 0;
   time_ira_cnt = 0;
   get_data_from_usart_flag = 0;
+  upgrade_timeout_flag = 0;
+}
+
+/**
+  * @brief  command response error.
+  * @param  none
+  * @retval none
+  */
+void back_err(void)
+{
+  usart_data_transmit(USART1, 0xEE);
+  while(usart_flag_get(USART1, USART_TDC_FLAG) == RESET);
+  usart_data_transmit(USART1, 0xFF);
+  while(usart_flag_get(USART1, USART_TDC_FLAG) == RESET);
+  iap_flow_reset();
+}
+
+/**
+  * @brief  windowed transfer response, 0xCCDD or 0xEEFF and the block number.
+  * @param  head: 0xCCDD for ok, 0xEEFF for error
+  * @param  block: block number, IAP_WIN_IMAGE_DONE for the image check
+  * @retval none
+  */
+static void iap_win_reply(uint16_t head, uint16_t block)
+{
+  uint8_t reply[4];
+  reply[0] = (uint8_t)(head >> 8);
+  reply[1] = (uint8_t)head;
+  reply[2] = (uint8_t)(block >> 8);
+  reply[3] = (uint8_t)block;
+  uart_data_send(reply, 4);
+}
+
+/**
+  * @brief  windowed transfer start, resumes from the last good block when
+  *         the same image was downloaded before.
+  * @param  none
+  * @retval none
+  */
+static void iap_win_start(void)
+{
+  uint8_t *param = cmd_data_group_struct.cmd_buf;
+  uint32_t image_size, image_crc, block_num;
+
+  cmd_data_step = CMD_DATA_IDLE;
+  image_size = (param[0] << 24) + (param[1] << 16) + (param[2] << 8) + param[3];
+  image_crc = (param[4] << 24) + (param[5] << 16) + (param[6] << 8) + param[7];
+  block_num = (image_size + IAP_WIN_BLOCK_SIZE - 1) / IAP_WIN_BLOCK_SIZE;
+
+  if((image_size == 0) || (image_size & 0x3) || (block_num > IAP_RESUME_LOG_NUM) || \
+     (APP_START_ADDR + image_size > FLASH_BASE + 1024 * FLASH_SIZE))
+  {
+    back_err();
+    return;
+  }
+
+  crm_periph_clock_enable(CRM_CRC_PERIPH_CLOCK, TRUE);
+
+  iap_win_struct.image_size = image_size;
+  iap_win_struct.image_crc = image_crc;
+  iap_win_struct.block_num = (uint16_t)block_num;
+  iap_win_struct.block_first = flash_resume_block_get(image_size, image_crc);
+  if(iap_win_struct.block_first > iap_win_struct.block_num)
+    iap_win_struct.block_first = iap_win_struct.block_num;
+  iap_win_struct.block_next = iap_win_struct.block_first;
+  iap_win_struct.dma_pos = 0;
+  iap_win_struct.received = 0;
+
+  /* dma runs before the reply, the first frame may follow it at once */
+  uart_dma_receive_start((uint8_t *)iap_win_ring, IAP_WIN_RING_LEN);
+  update_status = UPDATE_WIN;
+  iap_win_reply(0xCCDD, iap_win_struct.block_first);
+}
+
+/**
+  * @brief  windowed transfer end, checks the programmed image against the
+  *         crc-32 of the start command and returns to the command flow.
+  * @param  none
+  * @retval none
+  */
+static void iap_win_finish(void)
+{
+  uart_dma_receive_stop();
+  if(crc_stream_calculate(&crc_preset_crc32, (void *)APP_START_ADDR, iap_win_struct.image_size) == iap_win_struct.image_crc)
+  {
+    update_status = UPDATE_ING;
+    cmd_data_step = CMD_DATA_IDLE;
+    iap_win_reply(0xCCDD, IAP_WIN_IMAGE_DONE);
+  }
+  else
+  {
+    /* the next download starts from the first block */
+    flash_resume_clear();
+    iap_win_reply(0xEEFF, IAP_WIN_IMAGE_DONE);
+    iap_flow_reset();
+  }
+}
+
+/**
+  * @brief  windowed transfer handle. frames are programmed while the next
+  *         ones are received by dma, each block is acked once programmed
+  *         and verified, so the host keeps up to IAP_WIN_SLOT_NUM frames
+  *         in flight.
+  * @param  none
+  * @retval none
+  */
+static void iap_win_handle(void)
+{
+  uint8_t *frame;
+  uint16_t pos, block, frame_cnt;
+  uint32_t write_addr, frame_crc;
+
+  if(iap_win_struct.block_next >= iap_win_struct.block_num)
+  {
+    iap_win_finish();
+    return;
+  }
+
+  /* the host window keeps the dma less than one ring ahead */
+  pos = uart_dma_receive_pos();
+  if(pos != iap_win_struct.dma_pos)
+  {
+    iap_win_struct.received += (pos + IAP_WIN_RING_LEN - iap_win_struct.dma_pos) % IAP_WIN_RING_LEN;
+    iap_win_struct.dma_pos = pos;
+    time_ira_cnt = 0;
+  }
+
+  /* frame n of the session is in slot n % IAP_WIN_SLOT_NUM */
+  frame_cnt = iap_win_struct.block_next - iap_win_struct.block_first;
+  if(iap_win_struct.received < (uint32_t)(frame_cnt + 1) * IAP_WIN_FRAME_LEN)
+    return;
+
+  frame = (uint8_t *)iap_win_ring + (frame_cnt % IAP_WIN_SLOT_NUM) * IAP_WIN_FRAME_LEN;
+  block = (frame[2] << 8) + frame[3];
+  frame_crc = (frame[IAP_WIN_FRAME_LEN - 4] << 24) + (frame[IAP_WIN_FRAME_LEN - 3] << 16) + \
+              (frame[IAP_WIN_FRAME_LEN - 2] << 8) + frame[IAP_WIN_FRAME_LEN - 1];
+  write_addr = APP_START_ADDR + block * IAP_WIN_BLOCK_SIZE;
+
+  if((frame[0] != IAP_WIN_CMD_BLOCK) || (frame[1] != 0x00) || (block != iap_win_struct.block_next) || \
+     (crc_stream_calculate(&crc_preset_crc32, frame, IAP_WIN_FRAME_LEN - 4) != frame_crc))
+  {
+    iap_win_reply(0xEEFF, iap_win_struct.block_next);
+    iap_flow_reset();
+    return;
+  }
+
+  flash_2kb_write(write_addr, &frame[4]);
+  if(memcmp((void *)write_addr, &frame[4], IAP_WIN_BLOCK_SIZE) != 0)
+  {
+    iap_win_reply(0xEEFF, iap_win_struct.block_next);
+    iap_flow_reset();
+    return;
+  }
+
+  flash_resume_block_set(block);
+  iap_win_struct.block_next++;
+  iap_win_reply(0xCCDD, block);
 }
 
 /**
@@ -314,6 +487,14 @@ void app_update_handle(void)
       cmd_data_step = CMD_DATA_IDLE;
       back_err();
     }
+    else if(cmd_data_step == CMD_WIN_START)
+    {
+      iap_win_start();
+    }
+  }
+  else if(update_status == UPDATE_WIN)
+  {
+    iap_win_handle();
   }
   else if(update_status == UPDATE_DONE)
   {
@@ -348,6 +529,12 @@ void app_update_handle(void)
   */
 void iap_upgrade_app_handle(void)
 {
+  /* set by the tmr3 interrupt, the reply and the flow reset run here */
+  if(upgrade_timeout_flag)
+  {
+    back_err();
+  }
+
   command_handle();
   app_update_handle();
 }
@@ -36,6 +36,7 @@
 
 uint8_t time_ira_cnt=0;
 uint8_t get_data_from_usart_flag = 0;  /* flag for timer out in upgrade flow */
+__IO uint8_t upgrade_timeout_flag = 0; /* upgrade flow timed out, handled in the main loop */
 
 /**
   * @brief  init tmr.
@@ -81,7 +82,7 @@ void TMR3_GLOBAL_IRQHandler(void)
       if((++time_ira_cnt) == 0x00)
         time_ira_cnt = 0xFF;
       if(time_ira_cnt > 2)
-        back_err();
+        upgrade_timeout_flag = 1;
       if(time_ira_cnt > 5)
         crm_periph_clock_enable(LED2_GPIO_CRM_CLK, FALSE);
     }
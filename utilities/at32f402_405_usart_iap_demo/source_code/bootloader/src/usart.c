@@ -34,6 +34,7 @@
   */
 
 usart_group_type usart_group_struct;
+static uint16_t dma_ring_length = 0;
 
 /**
   * @brief  init usart.
@@ -71,6 +72,86 @@ void uart_init(uint32_t baudrate)
   usart_enable(USART1, TRUE);
 }
 
+/**
+  * @brief  receive into a ring by circular dma, the rdbf interrupt is
+  *         disabled until uart_dma_receive_stop.
+  * @param  pbuffer: ring buffer
+  * @param  length: ring length
+  * @retval none
+  */
+void uart_dma_receive_start(uint8_t *pbuffer, uint16_t length)
+{
+  dma_init_type dma_init_struct;
+
+  crm_periph_clock_enable(CRM_DMA1_PERIPH_CLOCK, TRUE);
+  dmamux_enable(DMA1, TRUE);
+
+  usart_interrupt_enable(USART1, USART_RDBF_INT, FALSE);
+  dma_ring_length = length;
+
+  dma_reset(DMA1_CHANNEL1);
+  dma_default_para_init(&dma_init_struct);
+  dma_init_struct.buffer_size = length;
+  dma_init_struct.direction = DMA_DIR_PERIPHERAL_TO_MEMORY;
+  dma_init_struct.memory_base_addr = (uint32_t)pbuffer;
+  dma_init_struct.memory_data_width = DMA_MEMORY_DATA_WIDTH_BYTE;
+  dma_init_struct.memory_inc_enable = TRUE;
+  dma_init_struct.peripheral_base_addr = (uint32_t)&USART1->dt;
+  dma_init_struct.peripheral_data_width = DMA_PERIPHERAL_DATA_WIDTH_BYTE;
+  dma_init_struct.peripheral_inc_enable = FALSE;
+  dma_init_struct.priority = DMA_PRIORITY_VERY_HIGH;
+  dma_init_struct.loop_mode_enable = TRUE;
+  dma_init(DMA1_CHANNEL1, &dma_init_struct);
+  dmamux_init(DMA1MUX_CHANNEL1, DMAMUX_DMAREQ_ID_USART1_RX);
+
+  dma_channel_enable(DMA1_CHANNEL1, TRUE);
+  usart_dma_receiver_enable(USART1, TRUE);
+}
+
+/**
+  * @brief  stop the dma reception and go back to the rdbf interrupt.
+  * @param  none
+  * @retval none
+  */
+void uart_dma_receive_stop(void)
+{
+  usart_dma_receiver_enable(USART1, FALSE);
+  dma_channel_enable(DMA1_CHANNEL1, FALSE);
+
+  usart_group_struct.count = 0;
+  usart_group_struct.head = 0;
+  usart_group_struct.tail = 0;
+  usart_interrupt_enable(USART1, USART_RDBF_INT, TRUE);
+}
+
+/**
+  * @brief  get the dma write position in the ring.
+  * @param  none
+  * @retval position
+  */
+uint16_t uart_dma_receive_pos(void)
+{
+  uint16_t pos = dma_ring_length - (uint16_t)DMA1_CHANNEL1->dtcnt;
+  if(pos >= dma_ring_length)
+    pos = 0;
+  return pos;
+}
+
+/**
+  * @brief  send data by polling.
+  * @param  pbuffer: data
+  * @param  length: data length
+  * @retval none
+  */
+void uart_data_send(uint8_t *pbuffer, uint16_t length)
+{
+  while(length--)
+  {
+    usart_data_transmit(USART1, *pbuffer++);
+    while(usart_flag_get(USART1, USART_TDC_FLAG) == RESET);
+  }
+}
+
 /**
   * @brief  usart1 interrupt handler.
   * @param  none
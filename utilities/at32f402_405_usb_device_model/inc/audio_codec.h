@@ -0,0 +1,89 @@
+/**
+  **************************************************************************
+  * @file     audio_codec.h
+  * @brief    usb device model audio codec stand-in header file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* define to prevent recursive inclusion -------------------------------------*/
+#ifndef __AUDIO_CODEC_H
+#define __AUDIO_CODEC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "usb_conf.h"
+
+/** @addtogroup AT32F402_405_usb_device_model
+  * @{
+  */
+
+/** @addtogroup USB_device_model_audio
+  * @{
+  */
+
+/**
+  * @brief codec stand-in, counts speaker bytes and returns silence for the
+  *        microphone at the nominal rate
+  */
+typedef struct
+{
+  uint32_t spk_bytes;
+  uint32_t mic_bytes;
+  uint32_t spk_freq;
+  uint32_t mic_freq;
+  uint16_t spk_volume;
+  uint16_t mic_volume;
+  uint8_t  spk_mute;
+  uint8_t  mic_mute;
+  uint8_t  spk_alt;
+  uint8_t  mic_alt;
+} audio_codec_type;
+
+extern audio_codec_type audio_codec;
+
+error_status audio_codec_init(void);
+void audio_codec_spk_fifo_write(uint8_t *data, uint32_t len);
+uint32_t audio_codec_mic_get_data(uint8_t *buffer);
+uint8_t audio_codec_spk_feedback(uint8_t *feedback);
+void audio_codec_spk_alt_setting(uint32_t alt_seting);
+void audio_codec_mic_alt_setting(uint32_t alt_seting);
+void audio_codec_set_mic_mute(uint8_t mute);
+void audio_codec_set_spk_mute(uint8_t mute);
+void audio_codec_set_mic_volume(uint16_t volume);
+void audio_codec_set_spk_volume(uint16_t volume);
+void audio_codec_set_mic_freq(uint32_t freq);
+void audio_codec_set_spk_freq(uint32_t freq);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
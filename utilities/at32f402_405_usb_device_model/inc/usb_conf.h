@@ -0,0 +1,131 @@
+/**
+  **************************************************************************
+  * @file     usb_conf.h
+  * @brief    usb config header file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* define to prevent recursive inclusion -------------------------------------*/
+#ifndef __USB_CONF_H
+#define __USB_CONF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "at32f402_405_usb.h"
+#include "at32f402_405.h"
+#include "stdio.h"
+
+/** @addtogroup AT32F402_405_usb_device_model
+  * @{
+  */
+
+/**
+  * @brief enable usb device mode
+  */
+#define USE_OTG_DEVICE_MODE
+
+/**
+  * @brief otgfs define, selected by the makefile
+  */
+#ifdef USB_OTG_FS
+#define USB_ID                           USB_OTG1_ID
+#define USB_SPEED_CORE_ID                USB_FULL_SPEED_CORE_ID
+#endif
+
+/**
+  * @brief otghs define, selected by the makefile
+  */
+#ifdef USB_OTG_HS
+#define USB_ID                           USB_OTG2_ID
+#define USB_SPEED_CORE_ID                USB_HIGH_SPEED_CORE_ID
+#endif
+
+/**
+  * @brief usb device mode config
+  */
+#ifdef USE_OTG_DEVICE_MODE
+/**
+  * @brief usb device mode fifo, same as the at_start usb device examples
+  */
+/* otg fs device fifo
+   otg fs fifo size is 1280 byte
+*/
+#define USBD_RX_SIZE                     128  /*this value is in terms of 4 bytes*/
+#define USBD_EP0_TX_SIZE                 24   /*this value is in terms of 4 bytes*/
+#ifdef USB_MODEL_AUDIO
+#define USBD_EP1_TX_SIZE                 64   /*this value is in terms of 4 bytes*/
+#else
+#define USBD_EP1_TX_SIZE                 20   /*this value is in terms of 4 bytes*/
+#endif
+#define USBD_EP2_TX_SIZE                 20   /*this value is in terms of 4 bytes*/
+#define USBD_EP3_TX_SIZE                 20   /*this value is in terms of 4 bytes*/
+#define USBD_EP4_TX_SIZE                 20   /*this value is in terms of 4 bytes*/
+#define USBD_EP5_TX_SIZE                 20   /*this value is in terms of 4 bytes*/
+#define USBD_EP6_TX_SIZE                 20   /*this value is in terms of 4 bytes*/
+#define USBD_EP7_TX_SIZE                 20   /*this value is in terms of 4 bytes*/
+
+/* otg hs device fifo
+   otg hs fifo size is 4096 byte
+*/
+#define USBD2_RX_SIZE                    256  /*this value is in terms of 4 bytes*/
+#define USBD2_EP0_TX_SIZE                64   /*this value is in terms of 4 bytes*/
+#define USBD2_EP1_TX_SIZE                256  /*this value is in terms of 4 bytes*/
+#define USBD2_EP2_TX_SIZE                20   /*this value is in terms of 4 bytes*/
+#define USBD2_EP3_TX_SIZE                20   /*this value is in terms of 4 bytes*/
+#define USBD2_EP4_TX_SIZE                20   /*this value is in terms of 4 bytes*/
+#define USBD2_EP5_TX_SIZE                20   /*this value is in terms of 4 bytes*/
+#define USBD2_EP6_TX_SIZE                20   /*this value is in terms of 4 bytes*/
+#define USBD2_EP7_TX_SIZE                20   /*this value is in terms of 4 bytes*/
+
+/**
+  * @brief usb endpoint max num define
+  */
+#ifndef USB_EPT_MAX_NUM
+#define USB_EPT_MAX_NUM                   8
+#endif
+#endif
+
+/**
+  * @brief usb vbus ignore, not use vbus pin
+  */
+#define USB_VBUS_IGNORE
+
+/**
+  * @brief usb device performance statistics, the model counts host cpu
+  *        instructions (or time stamp counter cycles) instead of the dwt
+  */
+#define USBD_PERF_STATISTICS
+#define USBD_PERF_CYCLES()               usb_model_cycles()
+
+uint32_t usb_model_cycles(void);
+void usb_delay_ms(uint32_t ms);
+void usb_delay_us(uint32_t us);
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
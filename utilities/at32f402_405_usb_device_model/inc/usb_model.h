@@ -0,0 +1,132 @@
+/**
+  **************************************************************************
+  * @file     usb_model.h
+  * @brief    usb otg device register model header file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* define to prevent recursive inclusion -------------------------------------*/
+#ifndef __USB_MODEL_H
+#define __USB_MODEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "usb_core.h"
+
+/** @addtogroup AT32F402_405_usb_device_model
+  * @{
+  */
+
+/** @defgroup USB_device_model_config
+  * @{
+  */
+
+#define USB_MODEL_PKT_MAX                1024        /*!< largest packet of the model fifo */
+#define USB_MODEL_TXQ_NUM                8           /*!< packets queued in one tx fifo */
+#define USB_MODEL_RXQ_NUM                32          /*!< entries queued in the rx fifo */
+#define USB_MODEL_IRQ_LIMIT              100000      /*!< interrupts in one service call before a storm is reported */
+#define USB_MODEL_RETRY                  100000      /*!< naked transactions before a transfer times out */
+
+#define USB_MODEL_NAK                    (-1)        /*!< transaction naked */
+#define USB_MODEL_STALL                  (-2)        /*!< transaction stalled */
+#define USB_MODEL_TIMEOUT                (-3)        /*!< transfer not finished after USB_MODEL_RETRY naks */
+#define USB_MODEL_ERROR                  (-4)        /*!< protocol or data error */
+#define USB_MODEL_UNKNOWN                (-5)        /*!< script command not handled by the class */
+
+/**
+  * @}
+  */
+
+/** @defgroup USB_device_model_types
+  * @{
+  */
+
+/**
+  * @brief statistics of the model, accumulated until usb_model_stat_reset
+  */
+typedef struct
+{
+  uint32_t                               ops;                     /*!< class operations, counted by the scripts */
+  uint32_t                               irq_count;               /*!< usbd_irq_handler calls           */
+  uint32_t                               irq_max_cycles;          /*!< longest usbd_irq_handler call    */
+  uint64_t                               irq_cycles;              /*!< cycles in usbd_irq_handler       */
+  uint64_t                               app_cycles;              /*!< cycles in the application poll   */
+  uint64_t                               bytes_out;               /*!< out data bytes, setup excluded   */
+  uint64_t                               bytes_in;                /*!< in data bytes                    */
+  uint32_t                               naks;                    /*!< naked transactions               */
+  uint32_t                               irq_idle;                /*!< handler calls without progress   */
+} usb_model_stat_type;
+
+/**
+  * @brief application poll, the main loop work of the example, returns
+  *        non zero while it made progress
+  */
+typedef uint32_t (*usb_model_poll_type)(void);
+
+/**
+  * @}
+  */
+
+/** @defgroup USB_device_model_exported_functions
+  * @{
+  */
+
+extern usb_model_stat_type usb_model_stat;
+
+void         usb_model_init              (void);
+void         usb_model_attach            (otg_core_type *otgdev, usb_model_poll_type poll);
+const char  *usb_model_counter_name      (void);
+uint32_t     usb_model_cycles            (void);
+void         usb_model_stat_reset        (void);
+void         usb_model_service           (void);
+void         usb_model_bus_reset         (void);
+void         usb_model_sof               (void);
+uint16_t     usb_model_mps               (uint8_t ept_addr);
+int32_t      usb_model_setup             (const uint8_t *setup);
+int32_t      usb_model_out               (uint8_t ept_num, const uint8_t *data, uint16_t len);
+int32_t      usb_model_in                (uint8_t ept_num, uint8_t *data, uint16_t len);
+int32_t      usb_model_control           (uint8_t type, uint8_t request, uint16_t value, uint16_t index,
+                                          uint16_t length, uint8_t *data);
+int32_t      usb_model_bulk_out          (uint8_t ept_num, const uint8_t *data, uint32_t len);
+int32_t      usb_model_bulk_in           (uint8_t ept_num, uint8_t *data, uint32_t len);
+int32_t      usb_model_enumerate         (void);
+
+/* provided by the class application of each model program */
+extern otg_core_type otg_core_struct;
+const char  *usb_model_app_name          (void);
+void         usb_model_app_init          (void);
+int32_t      usb_model_app_command       (const char *cmd, uint32_t *arg, uint32_t argc);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
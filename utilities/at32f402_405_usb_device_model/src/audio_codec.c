@@ -0,0 +1,177 @@
+/**
+  **************************************************************************
+  * @file     audio_codec.c
+  * @brief    usb device model audio codec stand-in
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "audio_codec.h"
+#include "audio_conf.h"
+
+/** @addtogroup AT32F402_405_usb_device_model
+  * @{
+  */
+
+/** @addtogroup USB_device_model_audio
+  * @{
+  */
+
+audio_codec_type audio_codec;
+
+/**
+  * @brief  codec init
+  * @param  none
+  * @retval SUCCESS
+  */
+error_status audio_codec_init(void)
+{
+  memset(&audio_codec, 0, sizeof(audio_codec));
+  audio_codec.spk_freq = AUDIO_DEFAULT_FREQ;
+  audio_codec.mic_freq = AUDIO_DEFAULT_FREQ;
+  return SUCCESS;
+}
+
+/**
+  * @brief  speaker data from usb
+  * @param  data: speaker data
+  * @param  len: data length
+  * @retval none
+  */
+void audio_codec_spk_fifo_write(uint8_t *data, uint32_t len)
+{
+  audio_codec.spk_bytes += len;
+}
+
+/**
+  * @brief  microphone data of one frame
+  * @param  buffer: data buffer
+  * @retval data length
+  */
+uint32_t audio_codec_mic_get_data(uint8_t *buffer)
+{
+  uint32_t len = audio_codec.mic_freq / 1000 * AUDIO_MIC_CHANEL_NUM * (AUDIO_MIC_DEFAULT_BITW / 8);
+  memset(buffer, 0, len);
+  audio_codec.mic_bytes += len;
+  return len;
+}
+
+/**
+  * @brief  speaker feedback, the nominal rate in 10.14 format
+  * @param  feedback: feedback buffer
+  * @retval feedback length
+  */
+uint8_t audio_codec_spk_feedback(uint8_t *feedback)
+{
+  uint32_t value = (audio_codec.spk_freq / 1000) << 14;
+  feedback[0] = (uint8_t)value;
+  feedback[1] = (uint8_t)(value >> 8);
+  feedback[2] = (uint8_t)(value >> 16);
+  return 3;
+}
+
+/**
+  * @brief  speaker alternate setting
+  * @param  alt_seting: alternate setting
+  * @retval none
+  */
+void audio_codec_spk_alt_setting(uint32_t alt_seting)
+{
+  audio_codec.spk_alt = (uint8_t)alt_seting;
+}
+
+/**
+  * @brief  microphone alternate setting
+  * @param  alt_seting: alternate setting
+  * @retval none
+  */
+void audio_codec_mic_alt_setting(uint32_t alt_seting)
+{
+  audio_codec.mic_alt = (uint8_t)alt_seting;
+}
+
+/**
+  * @brief  microphone mute
+  * @param  mute: mute state
+  * @retval none
+  */
+void audio_codec_set_mic_mute(uint8_t mute)
+{
+  audio_codec.mic_mute = mute;
+}
+
+/**
+  * @brief  speaker mute
+  * @param  mute: mute state
+  * @retval none
+  */
+void audio_codec_set_spk_mute(uint8_t mute)
+{
+  audio_codec.spk_mute = mute;
+}
+
+/**
+  * @brief  microphone volume
+  * @param  volume: volume
+  * @retval none
+  */
+void audio_codec_set_mic_volume(uint16_t volume)
+{
+  audio_codec.mic_volume = volume;
+}
+
+/**
+  * @brief  speaker volume
+  * @param  volume: volume
+  * @retval none
+  */
+void audio_codec_set_spk_volume(uint16_t volume)
+{
+  audio_codec.spk_volume = volume;
+}
+
+/**
+  * @brief  microphone sample rate
+  * @param  freq: sample rate
+  * @retval none
+  */
+void audio_codec_set_mic_freq(uint32_t freq)
+{
+  audio_codec.mic_freq = freq;
+}
+
+/**
+  * @brief  speaker sample rate
+  * @param  freq: sample rate
+  * @retval none
+  */
+void audio_codec_set_spk_freq(uint32_t freq)
+{
+  audio_codec.spk_freq = freq;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
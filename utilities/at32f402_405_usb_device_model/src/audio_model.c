@@ -0,0 +1,163 @@
+/**
+  **************************************************************************
+  * @file     audio_model.c
+  * @brief    usb device model audio streaming application
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "usb_model.h"
+#include "audio_class.h"
+#include "audio_desc.h"
+#include "audio_codec.h"
+
+/** @addtogroup AT32F402_405_usb_device_model
+  * @{
+  */
+
+/** @defgroup USB_device_model_audio
+  * @brief speaker and microphone streaming against the audio class and a
+  *        codec stand-in
+  *
+  *        audio_start                    select alternate setting 1 of the
+  *                                       speaker and microphone interfaces
+  *        audio_frames <n>               n frames of sof, speaker out,
+  *                                       microphone in and feedback in
+  * @{
+  */
+
+otg_core_type otg_core_struct;
+
+/**
+  * @brief  application name
+  * @param  none
+  * @retval name
+  */
+const char *usb_model_app_name(void)
+{
+  return "audio";
+}
+
+/**
+  * @brief  init the audio device as the example does
+  * @param  none
+  * @retval none
+  */
+void usb_model_app_init(void)
+{
+  audio_codec_init();
+  usbd_init(&otg_core_struct,
+            USB_SPEED_CORE_ID,
+            USB_ID,
+            &audio_class_handler,
+            &audio_desc_handler);
+  usb_model_attach(&otg_core_struct, 0);
+}
+
+/**
+  * @brief  start both streaming interfaces
+  * @param  none
+  * @retval negative on failure
+  */
+static int32_t audio_start(void)
+{
+  int32_t ret;
+
+  ret = usb_model_control(0x01, USB_STD_REQ_SET_INTERFACE, 1, AUDIO_SPK_INTERFACE_NUMBER, 0, 0);
+  if(ret < 0)
+  {
+    return ret;
+  }
+  return usb_model_control(0x01, USB_STD_REQ_SET_INTERFACE, 1, AUDIO_MIC_INTERFACE_NUMBER, 0, 0);
+}
+
+/**
+  * @brief  isochronous frames, one transaction per endpoint and frame, a
+  *         transaction the device is not ready for counts as a nak
+  * @param  frames: number of frames
+  * @retval negative on failure
+  */
+static int32_t audio_frames(uint32_t frames)
+{
+  uint8_t spk[AUDIO_SPK_OUT_MAXPACKET_SIZE], pkt[USB_MODEL_PKT_MAX];
+  uint32_t i_index, spk_len = AUDIO_DEFAULT_FREQ / 1000 * AUDIO_SPK_CHANEL_NUM * (AUDIO_SPK_DEFAULT_BITW / 8);
+  int32_t ret;
+
+  memset(spk, 0x5A, sizeof(spk));
+  for(i_index = 0; i_index < frames; i_index ++)
+  {
+    usb_model_sof();
+    ret = usb_model_out(USBD_AUDIO_SPK_OUT_EPT, spk, (uint16_t)spk_len);
+    if(ret < 0 && ret != USB_MODEL_NAK)
+    {
+      return ret;
+    }
+    usb_model_service();
+    ret = usb_model_in(USBD_AUDIO_MIC_IN_EPT & 0x7F, pkt, sizeof(pkt));
+    if(ret < 0 && ret != USB_MODEL_NAK)
+    {
+      return ret;
+    }
+    usb_model_service();
+    ret = usb_model_in(USBD_AUDIO_FEEDBACK_EPT & 0x7F, pkt, sizeof(pkt));
+    if(ret < 0 && ret != USB_MODEL_NAK)
+    {
+      return ret;
+    }
+    usb_model_service();
+    usb_model_stat.ops ++;
+  }
+  return 0;
+}
+
+/**
+  * @brief  class script commands
+  * @param  cmd: command
+  * @param  arg: numeric arguments
+  * @param  argc: number of arguments
+  * @retval negative on failure
+  */
+int32_t usb_model_app_command(const char *cmd, uint32_t *arg, uint32_t argc)
+{
+  if(strcmp(cmd, "audio_start") == 0)
+  {
+    return audio_start();
+  }
+  if(strcmp(cmd, "audio_frames") == 0 && argc == 1)
+  {
+    return audio_frames(arg[0]);
+  }
+  if(strcmp(cmd, "audio_check") == 0)
+  {
+    printf("audio codec: speaker %u bytes, microphone %u bytes\n", audio_codec.spk_bytes, audio_codec.mic_bytes);
+    return audio_codec.spk_bytes != 0 && audio_codec.mic_bytes != 0 ? 0 : USB_MODEL_ERROR;
+  }
+  return USB_MODEL_UNKNOWN;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,234 @@
+/**
+  **************************************************************************
+  * @file     cdc_model.c
+  * @brief    usb device model cdc vcp loopback application
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "usb_model.h"
+#include "cdc_class.h"
+#include "cdc_desc.h"
+
+/** @addtogroup AT32F402_405_usb_device_model
+  * @{
+  */
+
+/** @defgroup USB_device_model_cdc
+  * @brief vcp loopback application, the poll is the main loop of the
+  *        vcp_loopback example without the busy wait on a full in endpoint
+  *
+  *        loopback <len> <count>     count transfers of len bytes out on
+  *                                   ep 0x01 and back in on ep 0x81
+  * @{
+  */
+
+otg_core_type otg_core_struct;
+
+#ifndef USBD_CDC_STREAM_MODE
+static uint8_t usb_buffer[USBD_HS_CDC_MAXPACKET_SIZE];
+static uint16_t pending_len;
+static uint8_t pending;
+static uint8_t send_zero_packet;
+#endif
+
+/**
+  * @brief  application name
+  * @param  none
+  * @retval name
+  */
+const char *usb_model_app_name(void)
+{
+#ifdef USBD_CDC_STREAM_MODE
+  return "cdc stream";
+#else
+  return "cdc";
+#endif
+}
+
+/**
+  * @brief  vcp loopback main loop work
+  * @param  none
+  * @retval non zero when data moved
+  */
+static uint32_t cdc_poll(void)
+{
+#ifdef USBD_CDC_STREAM_MODE
+  uint8_t *prx, *ptx;
+  uint32_t rx_len, tx_len;
+
+  rx_len = usb_vcp_rx_peek(&otg_core_struct.dev, &prx);
+  if(rx_len == 0)
+  {
+    return 0;
+  }
+  tx_len = MIN(usb_vcp_tx_reserve(&otg_core_struct.dev, &ptx), rx_len);
+  if(tx_len == 0)
+  {
+    return 0;
+  }
+  memcpy(ptx, prx, tx_len);
+  usb_vcp_tx_commit(&otg_core_struct.dev, tx_len);
+  usb_vcp_rx_release(&otg_core_struct.dev, tx_len);
+  return 1;
+#else
+  if(pending == 0)
+  {
+    pending_len = usb_vcp_get_rxdata(&otg_core_struct.dev, usb_buffer);
+    if(pending_len > 0)
+    {
+      send_zero_packet = 1;
+      pending = 1;
+    }
+    else if(send_zero_packet == 1)
+    {
+      send_zero_packet = 0;
+      pending = 1;
+    }
+  }
+  if(pending && usb_vcp_send_data(&otg_core_struct.dev, usb_buffer, pending_len) == SUCCESS)
+  {
+    pending = 0;
+    return 1;
+  }
+  return 0;
+#endif
+}
+
+/**
+  * @brief  init the vcp device as the example does
+  * @param  none
+  * @retval none
+  */
+void usb_model_app_init(void)
+{
+  usbd_init(&otg_core_struct,
+            USB_SPEED_CORE_ID,
+            USB_ID,
+            &cdc_class_handler,
+            &cdc_desc_handler);
+  usb_model_attach(&otg_core_struct, cdc_poll);
+}
+
+/**
+  * @brief  loopback transfers, out packets are sent while the device takes
+  *         them and the echo is read back in between. a transfer of a
+  *         multiple of the packet size ends with a zero length packet.
+  * @param  len: transfer length
+  * @param  count: number of transfers
+  * @retval negative on failure
+  */
+static int32_t cdc_loopback(uint32_t len, uint32_t count)
+{
+  static uint8_t tx[65536], rx[65536];
+  uint8_t pkt[USB_MODEL_PKT_MAX];
+  uint32_t i_index, tx_off, tx_zlp, rx_off, idle, mps = usb_model_mps(USBD_CDC_BULK_OUT_EPT);
+  int32_t ret;
+
+  if(len > sizeof(tx))
+  {
+    return USB_MODEL_ERROR;
+  }
+  for(i_index = 0; i_index < count; i_index ++)
+  {
+    for(tx_off = 0; tx_off < len; tx_off ++)
+    {
+      tx[tx_off] = (uint8_t)(tx_off * 7 + i_index);
+    }
+    tx_off = 0;
+    tx_zlp = (len % mps) == 0;
+    rx_off = 0;
+    idle = 0;
+    while(rx_off < len)
+    {
+      if(++ idle > USB_MODEL_RETRY)
+      {
+        return USB_MODEL_TIMEOUT;
+      }
+      if(tx_off < len || tx_zlp)
+      {
+        ret = usb_model_out(USBD_CDC_BULK_OUT_EPT, tx + tx_off, (uint16_t)MIN(mps, len - tx_off));
+        if(ret >= 0)
+        {
+          if(ret == 0)
+          {
+            tx_zlp = 0;
+          }
+          tx_off += ret;
+          idle = 0;
+        }
+        else if(ret != USB_MODEL_NAK)
+        {
+          return ret;
+        }
+        usb_model_service();
+      }
+      ret = usb_model_in(USBD_CDC_BULK_IN_EPT & 0x7F, pkt, sizeof(pkt));
+      if(ret >= 0)
+      {
+        if(rx_off + ret > len)
+        {
+          return USB_MODEL_ERROR;
+        }
+        memcpy(rx + rx_off, pkt, ret);
+        rx_off += ret;
+        idle = 0;
+      }
+      else if(ret != USB_MODEL_NAK)
+      {
+        return ret;
+      }
+      usb_model_service();
+    }
+    if(memcmp(tx, rx, len) != 0)
+    {
+      printf("loopback data mismatch\n");
+      return USB_MODEL_ERROR;
+    }
+    usb_model_stat.ops ++;
+  }
+  return 0;
+}
+
+/**
+  * @brief  class script commands
+  * @param  cmd: command
+  * @param  arg: numeric arguments
+  * @param  argc: number of arguments
+  * @retval negative on failure
+  */
+int32_t usb_model_app_command(const char *cmd, uint32_t *arg, uint32_t argc)
+{
+  if(strcmp(cmd, "loopback") == 0 && argc == 2)
+  {
+    return cdc_loopback(arg[0], arg[1]);
+  }
+  return USB_MODEL_UNKNOWN;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
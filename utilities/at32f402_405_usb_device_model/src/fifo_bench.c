@@ -0,0 +1,117 @@
+/**
+  **************************************************************************
+  * @file     fifo_bench.c
+  * @brief    usb driver fifo copy benchmark
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include "usb_model.h"
+
+/** @addtogroup AT32F402_405_usb_device_model
+  * @{
+  */
+
+/** @defgroup USB_device_model_fifo_bench
+  * @brief cycles per byte of the driver fifo copy, word aligned buffer
+  *        (four word burst) against a byte offset buffer (unaligned word
+  *        loop). the driver functions run against the mapped fifo window,
+  *        numbers are host cycles, the ratio of the two paths is what to
+  *        compare.
+  * @{
+  */
+
+#define FIFO_BENCH_LOOP                  20000
+
+/* the driver versions, renamed by the makefile */
+void usb_hw_write_packet(otg_global_type *usbx, uint8_t *pusr_buf, uint16_t num, uint16_t nbytes);
+void usb_hw_read_packet(otg_global_type *usbx, uint8_t *pusr_buf, uint16_t num, uint16_t nbytes);
+
+static uint32_t bench_buf[(USB_MODEL_PKT_MAX + 8) / 4];
+
+/**
+  * @brief  cycles of one fifo copy, the minimum over FIFO_BENCH_LOOP calls
+  * @param  write: usb_write_packet when non zero, usb_read_packet otherwise
+  * @param  offset: byte offset of the user buffer
+  * @param  len: packet length
+  * @retval cycles
+  */
+static uint32_t fifo_bench_run(uint8_t write, uint32_t offset, uint16_t len)
+{
+  uint8_t *pbuf = (uint8_t *)bench_buf + offset;
+  uint32_t i_index, cycles, best = 0xFFFFFFFF;
+
+  for(i_index = 0; i_index < FIFO_BENCH_LOOP; i_index ++)
+  {
+    cycles = usb_model_cycles();
+    if(write)
+    {
+      usb_hw_write_packet(OTG1_GLOBAL, pbuf, 1, len);
+    }
+    else
+    {
+      usb_hw_read_packet(OTG1_GLOBAL, pbuf, 1, len);
+    }
+    cycles = usb_model_cycles() - cycles;
+    if(cycles < best)
+    {
+      best = cycles;
+    }
+  }
+  return best;
+}
+
+/**
+  * @brief  fifo copy benchmark
+  * @param  none
+  * @retval exit status
+  */
+int main(void)
+{
+  static const uint16_t len[] = {64, 512, 1023};
+  uint32_t i_index, empty, cycles[4];
+
+  usb_model_init();
+  empty = fifo_bench_run(1, 0, 0);
+  printf("fifo copy, counter: %s, call overhead %u\n", usb_model_counter_name(), empty);
+  printf("%-6s %14s %14s %14s %14s\n", "bytes", "write aligned", "write offset 1", "read aligned", "read offset 1");
+  for(i_index = 0; i_index < sizeof(len) / sizeof(len[0]); i_index ++)
+  {
+    cycles[0] = fifo_bench_run(1, 0, len[i_index]) - empty;
+    cycles[1] = fifo_bench_run(1, 1, len[i_index]) - empty;
+    cycles[2] = fifo_bench_run(0, 0, len[i_index]) - empty;
+    cycles[3] = fifo_bench_run(0, 1, len[i_index]) - empty;
+    printf("%-6u %8u %2u.%02u %8u %2u.%02u %8u %2u.%02u %8u %2u.%02u   (cycles, cycles/byte)\n", len[i_index],
+           cycles[0], cycles[0] / len[i_index], cycles[0] * 100 / len[i_index] % 100,
+           cycles[1], cycles[1] / len[i_index], cycles[1] * 100 / len[i_index] % 100,
+           cycles[2], cycles[2] / len[i_index], cycles[2] * 100 / len[i_index] % 100,
+           cycles[3], cycles[3] / len[i_index], cycles[3] * 100 / len[i_index] % 100);
+  }
+  return 0;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
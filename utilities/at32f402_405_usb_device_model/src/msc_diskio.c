@@ -0,0 +1,230 @@
+/**
+  **************************************************************************
+  * @file     msc_diskio.c
+  * @brief    usb device model msc ram disk
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "msc_diskio.h"
+#include "msc_bot_scsi.h"
+
+/** @addtogroup AT32F402_405_usb_device_model
+  * @{
+  */
+
+/** @addtogroup USB_device_model_msc
+  * @{
+  */
+
+static uint8_t ram_disk[RAM_DISK_BLOCK_NUM * RAM_DISK_BLOCK_SIZE];
+
+#ifdef MSC_ASYNC_STORAGE
+/**
+  * @brief asynchronous access started by msc_disk_read_start or
+  *        msc_disk_write_start, finished by msc_disk_poll
+  */
+static struct
+{
+  uint8_t busy;
+  uint8_t write;
+  uint64_t addr;
+  uint8_t *buf;
+  uint32_t len;
+} ram_disk_job;
+#endif
+
+uint8_t scsi_inquiry[MSC_SUPPORT_MAX_LUN][SCSI_INQUIRY_DATA_LENGTH] =
+{
+  /* lun = 0 */
+  {
+    0x00,         /* peripheral device type (direct-access device) */
+    0x80,         /* removable media bit */
+    0x00,         /* ansi version, ecma version, iso version */
+    0x01,         /* respond data format */
+    SCSI_INQUIRY_DATA_LENGTH - 5, /* additional length */
+    0x00, 0x00, 0x00, /* reserved */
+    'A', 'T', '3', '2', ' ', ' ', ' ', ' ', /* vendor information "AT32" */
+    'R', 'a', 'm', 'D', 'i', 's', 'k', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', /* Product identification "RamDisk" */
+    '2', '.', '0', '0'  /* product revision level */
+  }
+};
+
+/**
+  * @brief  get disk inquiry
+  * @param  lun: logical units number
+  * @retval inquiry string
+  */
+uint8_t *get_inquiry(uint8_t lun)
+{
+  if(lun < MSC_SUPPORT_MAX_LUN)
+    return (uint8_t *)scsi_inquiry[lun];
+  else
+    return NULL;
+}
+
+/**
+  * @brief  disk read
+  * @param  lun: logical units number
+  * @param  addr: logical address
+  * @param  read_buf: pointer to read buffer
+  * @param  len: read length
+  * @retval status of usb_sts_type
+  */
+usb_sts_type msc_disk_read(uint8_t lun, uint64_t addr, uint8_t *read_buf, uint32_t len)
+{
+  if(lun != RAM_DISK_LUN || addr + len > sizeof(ram_disk))
+  {
+    return USB_FAIL;
+  }
+  memcpy(read_buf, &ram_disk[addr], len);
+  return USB_OK;
+}
+
+/**
+  * @brief  disk write
+  * @param  lun: logical units number
+  * @param  addr: logical address
+  * @param  buf: pointer to write buffer
+  * @param  len: write length
+  * @retval status of usb_sts_type
+  */
+usb_sts_type msc_disk_write(uint8_t lun, uint64_t addr, uint8_t *buf, uint32_t len)
+{
+  if(lun != RAM_DISK_LUN || addr + len > sizeof(ram_disk))
+  {
+    return USB_FAIL;
+  }
+  memcpy(&ram_disk[addr], buf, len);
+  return USB_OK;
+}
+
+/**
+  * @brief  disk unmap, the unmapped blocks read as zeros
+  * @param  lun: logical units number
+  * @param  addr: logical address
+  * @param  len: unmap length
+  * @retval status of usb_sts_type
+  */
+usb_sts_type msc_disk_unmap(uint8_t lun, uint64_t addr, uint32_t len)
+{
+  if(lun != RAM_DISK_LUN || addr + len > sizeof(ram_disk))
+  {
+    return USB_FAIL;
+  }
+  memset(&ram_disk[addr], 0, len);
+  return USB_OK;
+}
+
+/**
+  * @brief  disk capacity
+  * @param  lun: logical units number
+  * @param  blk_nbr: pointer to number of block
+  * @param  blk_size: pointer to block size
+  * @retval status of usb_sts_type
+  */
+usb_sts_type msc_disk_capacity(uint8_t lun, uint32_t *blk_nbr, uint32_t *blk_size)
+{
+  *blk_nbr = RAM_DISK_BLOCK_NUM;
+  *blk_size = RAM_DISK_BLOCK_SIZE;
+  return USB_OK;
+}
+
+#ifdef MSC_ASYNC_STORAGE
+/**
+  * @brief  start a disk read, finished by msc_disk_poll
+  * @param  lun: logical units number
+  * @param  addr: logical address
+  * @param  read_buf: pointer to read buffer
+  * @param  len: read length
+  * @retval status of usb_sts_type
+  */
+usb_sts_type msc_disk_read_start(uint8_t lun, uint64_t addr, uint8_t *read_buf, uint32_t len)
+{
+  if(lun != RAM_DISK_LUN || ram_disk_job.busy)
+  {
+    return USB_FAIL;
+  }
+  ram_disk_job.write = 0;
+  ram_disk_job.addr = addr;
+  ram_disk_job.buf = read_buf;
+  ram_disk_job.len = len;
+  ram_disk_job.busy = 1;
+  return USB_OK;
+}
+
+/**
+  * @brief  start a disk write, finished by msc_disk_poll
+  * @param  lun: logical units number
+  * @param  addr: logical address
+  * @param  buf: pointer to write buffer
+  * @param  len: write length
+  * @retval status of usb_sts_type
+  */
+usb_sts_type msc_disk_write_start(uint8_t lun, uint64_t addr, uint8_t *buf, uint32_t len)
+{
+  if(lun != RAM_DISK_LUN || ram_disk_job.busy)
+  {
+    return USB_FAIL;
+  }
+  ram_disk_job.write = 1;
+  ram_disk_job.addr = addr;
+  ram_disk_job.buf = buf;
+  ram_disk_job.len = len;
+  ram_disk_job.busy = 1;
+  return USB_OK;
+}
+
+/**
+  * @brief  finish the started access, stands for the storage completion
+  *         interrupt of the target
+  * @param  udev: to the structure of usbd_core_type
+  * @retval non zero when an access finished
+  */
+uint32_t msc_disk_poll(void *udev)
+{
+  usb_sts_type status;
+
+  if(ram_disk_job.busy == 0)
+  {
+    return 0;
+  }
+  ram_disk_job.busy = 0;
+  if(ram_disk_job.write)
+  {
+    status = msc_disk_write(RAM_DISK_LUN, ram_disk_job.addr, ram_disk_job.buf, ram_disk_job.len);
+  }
+  else
+  {
+    status = msc_disk_read(RAM_DISK_LUN, ram_disk_job.addr, ram_disk_job.buf, ram_disk_job.len);
+  }
+  bot_scsi_storage_done(udev, status);
+  return 1;
+}
+#endif
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
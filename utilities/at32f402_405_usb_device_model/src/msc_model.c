@@ -0,0 +1,504 @@
+/**
+  **************************************************************************
+  * @file     msc_model.c
+  * @brief    usb device model msc bulk only transport application
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "usb_model.h"
+#include "msc_class.h"
+#include "msc_desc.h"
+#include "msc_bot_scsi.h"
+#include "msc_diskio.h"
+
+/** @addtogroup AT32F402_405_usb_device_model
+  * @{
+  */
+
+/** @defgroup USB_device_model_msc
+  * @brief bulk only transport traffic against the msc class and a ram
+  *        disk, the block size comes from read capacity
+  *
+  *        msc_capacity                   read capacity(10)
+  *        msc_write <lba> <blocks> <count>  count write(10) commands
+  *        msc_read <lba> <blocks> <count>   count read(10) commands
+  *        0 blocks sends commands without data stage, msc_write12,
+  *        msc_read12, msc_write16 and msc_read16 use the longer commands
+  *        msc_disk_check <lba> <blocks>  written pattern in the ram disk
+  *        msc_sync                       synchronize cache(10) and (16)
+  *        msc_unmap <lba> <blocks>       unmap and read back zeros
+  *        msc_vpd <page> <length>        inquiry of a vpd page
+  * @{
+  */
+
+#define MSC_MODEL_XFER_MAX               (64 * 1024)
+
+otg_core_type otg_core_struct;
+
+static uint32_t msc_tag;
+static uint32_t msc_blk_size;
+static uint32_t msc_blk_nbr;
+static uint8_t msc_data[MSC_MODEL_XFER_MAX];
+
+/**
+  * @brief  application name
+  * @param  none
+  * @retval name
+  */
+const char *usb_model_app_name(void)
+{
+#ifdef MSC_ASYNC_STORAGE
+  return "msc async";
+#elif defined(MSC_BOT_PINGPONG)
+  return "msc pingpong";
+#else
+  return "msc";
+#endif
+}
+
+#ifdef MSC_ASYNC_STORAGE
+/**
+  * @brief  storage completion of the asynchronous ram disk
+  * @param  none
+  * @retval non zero when an access finished
+  */
+static uint32_t msc_poll(void)
+{
+  return msc_disk_poll(&otg_core_struct.dev);
+}
+#endif
+
+/**
+  * @brief  init the msc device as the example does
+  * @param  none
+  * @retval none
+  */
+void usb_model_app_init(void)
+{
+  usbd_init(&otg_core_struct,
+            USB_SPEED_CORE_ID,
+            USB_ID,
+            &msc_class_handler,
+            &msc_desc_handler);
+#ifdef MSC_ASYNC_STORAGE
+  usb_model_attach(&otg_core_struct, msc_poll);
+#else
+  usb_model_attach(&otg_core_struct, 0);
+#endif
+}
+
+/**
+  * @brief  one bulk only transport command, the residue of the status must
+  *         match the data the device moved
+  * @param  cb: command block
+  * @param  cb_len: command block length, 10, 12 or 16
+  * @param  data: data stage buffer
+  * @param  len: data stage length
+  * @param  dir_in: data stage direction is in
+  * @retval data bytes moved, negative on failure
+  */
+static int32_t msc_command(const uint8_t *cb, uint8_t cb_len, uint8_t *data, uint32_t len, uint8_t dir_in)
+{
+  uint8_t cbw[CBW_CMD_LENGTH], csw[CSW_CMD_LENGTH];
+  uint32_t residue;
+  int32_t ret, moved = 0;
+
+  memset(cbw, 0, sizeof(cbw));
+  msc_tag ++;
+  cbw[0] = 0x55; cbw[1] = 0x53; cbw[2] = 0x42; cbw[3] = 0x43;
+  memcpy(&cbw[4], &msc_tag, 4);
+  memcpy(&cbw[8], &len, 4);
+  cbw[12] = dir_in ? 0x80 : 0x00;
+  cbw[13] = 0;
+  cbw[14] = cb_len;
+  memcpy(&cbw[15], cb, cb_len);
+
+  ret = usb_model_bulk_out(USBD_MSC_BULK_OUT_EPT, cbw, sizeof(cbw));
+  if(ret < 0)
+  {
+    return ret;
+  }
+  if(len != 0)
+  {
+    ret = dir_in ? usb_model_bulk_in(USBD_MSC_BULK_IN_EPT & 0x7F, data, len) :
+                   usb_model_bulk_out(USBD_MSC_BULK_OUT_EPT, data, len);
+    if(ret < 0)
+    {
+      return ret;
+    }
+    if(dir_in == 0 && (uint32_t)ret != len)
+    {
+      return USB_MODEL_ERROR;
+    }
+    moved = ret;
+  }
+  ret = usb_model_bulk_in(USBD_MSC_BULK_IN_EPT & 0x7F, csw, sizeof(csw));
+  if(ret < 0)
+  {
+    return ret;
+  }
+  if(ret != CSW_CMD_LENGTH || csw[0] != 0x55 || csw[3] != 0x53 || memcmp(&csw[4], &msc_tag, 4) != 0 || csw[12] != 0)
+  {
+    printf("msc csw error, status %d\n", ret == CSW_CMD_LENGTH ? csw[12] : -1);
+    return USB_MODEL_ERROR;
+  }
+  memcpy(&residue, &csw[8], 4);
+  if(residue != len - moved)
+  {
+    printf("msc csw residue %u, expected %u\n", residue, len - moved);
+    return USB_MODEL_ERROR;
+  }
+  return moved;
+}
+
+/**
+  * @brief  read capacity(10)
+  * @param  none
+  * @retval negative on failure
+  */
+static int32_t msc_capacity(void)
+{
+  uint8_t cb[10] = {MSC_CMD_READ_CAPACITY};
+  int32_t ret = msc_command(cb, sizeof(cb), msc_data, 8, 1);
+  if(ret < 0)
+  {
+    return ret;
+  }
+  msc_blk_nbr = ((msc_data[0] << 24) | (msc_data[1] << 16) | (msc_data[2] << 8) | msc_data[3]) + 1;
+  msc_blk_size = (msc_data[4] << 24) | (msc_data[5] << 16) | (msc_data[6] << 8) | msc_data[7];
+  printf("msc capacity: %u blocks of %u bytes\n", msc_blk_nbr, msc_blk_size);
+  usb_model_stat.ops ++;
+  return 0;
+}
+
+/**
+  * @brief  pattern byte the writes store and the reads check
+  * @param  lba: first block of the transfer
+  * @param  offset: byte offset in the transfer
+  * @retval pattern byte
+  */
+static uint8_t msc_pattern(uint32_t lba, uint32_t offset)
+{
+  return (uint8_t)(lba + offset / msc_blk_size + offset);
+}
+
+/**
+  * @brief  read or write commands of 10, 12 or 16 bytes, written data is a
+  *         pattern of the lba that reads check
+  * @param  write: write command when non zero
+  * @param  cb_len: command block length, 10, 12 or 16
+  * @param  lba: first block
+  * @param  blocks: blocks per command
+  * @param  count: number of commands
+  * @retval negative on failure
+  */
+static int32_t msc_rw(uint8_t write, uint8_t cb_len, uint32_t lba, uint32_t blocks, uint32_t count)
+{
+  uint8_t cb[16];
+  uint32_t i_index, j_index, len;
+  int32_t ret;
+
+  if(msc_blk_size == 0 && (ret = msc_capacity()) < 0)
+  {
+    return ret;
+  }
+  len = blocks * msc_blk_size;
+  /* 0 blocks is a command without data stage */
+  if(len > sizeof(msc_data) || lba + blocks > msc_blk_nbr)
+  {
+    return USB_MODEL_ERROR;
+  }
+  for(i_index = 0; i_index < count; i_index ++)
+  {
+    memset(cb, 0, sizeof(cb));
+    if(cb_len == 16)
+    {
+      cb[0] = write ? MSC_CMD_WRITE_16 : MSC_CMD_READ_16;
+      cb[6] = (uint8_t)(lba >> 24);
+      cb[7] = (uint8_t)(lba >> 16);
+      cb[8] = (uint8_t)(lba >> 8);
+      cb[9] = (uint8_t)lba;
+      cb[10] = (uint8_t)(blocks >> 24);
+      cb[11] = (uint8_t)(blocks >> 16);
+      cb[12] = (uint8_t)(blocks >> 8);
+      cb[13] = (uint8_t)blocks;
+    }
+    else
+    {
+      cb[0] = (cb_len == 12) ? (write ? MSC_CMD_WRITE_12 : MSC_CMD_READ_12) :
+                               (write ? MSC_CMD_WRITE_10 : MSC_CMD_READ_10);
+      cb[2] = (uint8_t)(lba >> 24);
+      cb[3] = (uint8_t)(lba >> 16);
+      cb[4] = (uint8_t)(lba >> 8);
+      cb[5] = (uint8_t)lba;
+      if(cb_len == 12)
+      {
+        cb[6] = (uint8_t)(blocks >> 24);
+        cb[7] = (uint8_t)(blocks >> 16);
+        cb[8] = (uint8_t)(blocks >> 8);
+        cb[9] = (uint8_t)blocks;
+      }
+      else
+      {
+        cb[7] = (uint8_t)(blocks >> 8);
+        cb[8] = (uint8_t)blocks;
+      }
+    }
+    if(write)
+    {
+      for(j_index = 0; j_index < len; j_index ++)
+      {
+        msc_data[j_index] = msc_pattern(lba, j_index);
+      }
+    }
+    ret = msc_command(cb, cb_len, msc_data, len, !write);
+    if(ret < 0)
+    {
+      return ret;
+    }
+    if((uint32_t)ret != len)
+    {
+      return USB_MODEL_ERROR;
+    }
+    if(!write)
+    {
+      for(j_index = 0; j_index < len; j_index ++)
+      {
+        if(msc_data[j_index] != msc_pattern(lba, j_index))
+        {
+          printf("msc read data mismatch at lba %u\n", lba + j_index / msc_blk_size);
+          return USB_MODEL_ERROR;
+        }
+      }
+    }
+    usb_model_stat.ops ++;
+  }
+  return 0;
+}
+
+/**
+  * @brief  check the written pattern in the ram disk itself, past the
+  *         write cache of the class
+  * @param  lba: first block
+  * @param  blocks: blocks to check
+  * @retval negative on failure
+  */
+static int32_t msc_disk_check(uint32_t lba, uint32_t blocks)
+{
+  uint32_t j_index, len = blocks * msc_blk_size;
+
+  if(msc_blk_size == 0 || len > sizeof(msc_data) ||
+     msc_disk_read(RAM_DISK_LUN, (uint64_t)lba * msc_blk_size, msc_data, len) != USB_OK)
+  {
+    return USB_MODEL_ERROR;
+  }
+  for(j_index = 0; j_index < len; j_index ++)
+  {
+    if(msc_data[j_index] != msc_pattern(lba, j_index))
+    {
+      printf("msc disk data not written back at lba %u\n", lba + j_index / msc_blk_size);
+      return USB_MODEL_ERROR;
+    }
+  }
+  return 0;
+}
+
+/**
+  * @brief  synchronize cache(10) and synchronize cache(16) of the whole
+  *         medium
+  * @param  none
+  * @retval negative on failure
+  */
+static int32_t msc_sync(void)
+{
+  uint8_t cb[16];
+  int32_t ret;
+
+  memset(cb, 0, sizeof(cb));
+  cb[0] = MSC_CMD_SYNCHRONIZE_CACHE10;
+  if((ret = msc_command(cb, 10, msc_data, 0, 0)) < 0)
+  {
+    return ret;
+  }
+  cb[0] = MSC_CMD_SYNCHRONIZE_CACHE16;
+  if((ret = msc_command(cb, 16, msc_data, 0, 0)) < 0)
+  {
+    return ret;
+  }
+  usb_model_stat.ops += 2;
+  return 0;
+}
+
+/**
+  * @brief  unmap a range and read it back as zeros. the block descriptor
+  *         data length covers one descriptor while the parameter list and
+  *         dCBWDataTransferLength carry a second, out of range one that
+  *         must be ignored.
+  * @param  lba: first block
+  * @param  blocks: blocks to unmap
+  * @retval negative on failure
+  */
+static int32_t msc_unmap(uint32_t lba, uint32_t blocks)
+{
+  uint8_t cb[10], list[MSC_UNMAP_HEADER_LEN + 2 * MSC_UNMAP_DESC_LEN];
+  uint32_t j_index;
+  int32_t ret;
+
+  if(msc_blk_size == 0 || blocks * msc_blk_size > sizeof(msc_data))
+  {
+    return USB_MODEL_ERROR;
+  }
+  memset(list, 0, sizeof(list));
+  list[1] = sizeof(list) - 2;
+  list[3] = MSC_UNMAP_DESC_LEN;
+  list[MSC_UNMAP_HEADER_LEN + 4] = (uint8_t)(lba >> 24);
+  list[MSC_UNMAP_HEADER_LEN + 5] = (uint8_t)(lba >> 16);
+  list[MSC_UNMAP_HEADER_LEN + 6] = (uint8_t)(lba >> 8);
+  list[MSC_UNMAP_HEADER_LEN + 7] = (uint8_t)lba;
+  list[MSC_UNMAP_HEADER_LEN + 8] = (uint8_t)(blocks >> 24);
+  list[MSC_UNMAP_HEADER_LEN + 9] = (uint8_t)(blocks >> 16);
+  list[MSC_UNMAP_HEADER_LEN + 10] = (uint8_t)(blocks >> 8);
+  list[MSC_UNMAP_HEADER_LEN + 11] = (uint8_t)blocks;
+  memset(&list[MSC_UNMAP_HEADER_LEN + MSC_UNMAP_DESC_LEN], 0xFF, MSC_UNMAP_DESC_LEN);
+
+  memset(cb, 0, sizeof(cb));
+  cb[0] = MSC_CMD_UNMAP;
+  cb[8] = sizeof(list);
+  if((ret = msc_command(cb, sizeof(cb), list, sizeof(list), 0)) < 0)
+  {
+    return ret;
+  }
+
+  memset(cb, 0, sizeof(cb));
+  cb[0] = MSC_CMD_READ_10;
+  cb[2] = (uint8_t)(lba >> 24);
+  cb[3] = (uint8_t)(lba >> 16);
+  cb[4] = (uint8_t)(lba >> 8);
+  cb[5] = (uint8_t)lba;
+  cb[7] = (uint8_t)(blocks >> 8);
+  cb[8] = (uint8_t)blocks;
+  if((ret = msc_command(cb, sizeof(cb), msc_data, blocks * msc_blk_size, 1)) < 0)
+  {
+    return ret;
+  }
+  for(j_index = 0; j_index < blocks * msc_blk_size; j_index ++)
+  {
+    if(msc_data[j_index] != 0)
+    {
+      printf("msc unmapped data not zero at lba %u\n", lba + j_index / msc_blk_size);
+      return USB_MODEL_ERROR;
+    }
+  }
+  usb_model_stat.ops += 2;
+  return 0;
+}
+
+/**
+  * @brief  inquiry of a vital product data page, the page code and the
+  *         page length of the answer are checked
+  * @param  page: page code
+  * @param  len: allocation length, the full page
+  * @retval negative on failure
+  */
+static int32_t msc_vpd(uint8_t page, uint32_t len)
+{
+  uint8_t cb[10];
+  uint32_t j_index;
+  int32_t ret;
+
+  if(len < 4 || len > 255)
+  {
+    return USB_MODEL_ERROR;
+  }
+  memset(cb, 0, sizeof(cb));
+  cb[0] = MSC_CMD_INQUIRY;
+  cb[1] = 0x01;
+  cb[2] = page;
+  cb[4] = (uint8_t)len;
+  if((ret = msc_command(cb, 6, msc_data, len, 1)) < 0)
+  {
+    return ret;
+  }
+  if((uint32_t)ret < 4 || msc_data[1] != page || (uint32_t)((msc_data[2] << 8 | msc_data[3]) + 4) != (uint32_t)ret)
+  {
+    printf("msc vpd page 0x%02X bad header, %d bytes\n", page, ret);
+    return USB_MODEL_ERROR;
+  }
+  printf("msc vpd page 0x%02X:", page);
+  for(j_index = 4; j_index < (uint32_t)ret && page == 0x00; j_index ++)
+  {
+    printf(" 0x%02X", msc_data[j_index]);
+  }
+  printf(" %d bytes\n", ret);
+  usb_model_stat.ops ++;
+  return 0;
+}
+
+/**
+  * @brief  class script commands
+  * @param  cmd: command
+  * @param  arg: numeric arguments
+  * @param  argc: number of arguments
+  * @retval negative on failure
+  */
+int32_t usb_model_app_command(const char *cmd, uint32_t *arg, uint32_t argc)
+{
+  if(strcmp(cmd, "msc_capacity") == 0)
+  {
+    return msc_capacity();
+  }
+  if(strncmp(cmd, "msc_write", 9) == 0 && argc == 3)
+  {
+    return msc_rw(1, cmd[9] ? (uint8_t)atoi(&cmd[9]) : 10, arg[0], arg[1], arg[2]);
+  }
+  if(strncmp(cmd, "msc_read", 8) == 0 && argc == 3)
+  {
+    return msc_rw(0, cmd[8] ? (uint8_t)atoi(&cmd[8]) : 10, arg[0], arg[1], arg[2]);
+  }
+  if(strcmp(cmd, "msc_disk_check") == 0 && argc == 2)
+  {
+    return msc_disk_check(arg[0], arg[1]);
+  }
+  if(strcmp(cmd, "msc_sync") == 0)
+  {
+    return msc_sync();
+  }
+  if(strcmp(cmd, "msc_unmap") == 0 && argc == 2)
+  {
+    return msc_unmap(arg[0], arg[1]);
+  }
+  if(strcmp(cmd, "msc_vpd") == 0 && argc == 2)
+  {
+    return msc_vpd((uint8_t)arg[0], arg[1]);
+  }
+  return USB_MODEL_UNKNOWN;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,1182 @@
+/**
+  **************************************************************************
+  * @file     usb_model.c
+  * @brief    usb otg device register model, the stack runs unchanged on
+  *           the host against a memory image of the otg registers
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "usb_model.h"
+#include "usbd_int.h"
+
+/** @addtogroup AT32F402_405_usb_device_model
+  * @{
+  */
+
+/** @defgroup USB_device_model
+  * @brief the model owns the otg register image: interrupt and fifo state
+  *        lives in the model and is copied to the image before the stack
+  *        reads it. the driver functions that access the fifo or clear
+  *        interrupt flags are replaced by the model, everything else in
+  *        the driver and in the stack is the target code.
+  * @{
+  */
+
+/* endpoint control bits the core consumes */
+#define MODEL_EPTCTL_STALL               ((uint32_t)0x00200000)
+#define MODEL_EPTCTL_NAKSTS              ((uint32_t)0x00020000)
+#define MODEL_EPTCTL_CNAK                ((uint32_t)0x04000000)
+#define MODEL_EPTCTL_SNAK                ((uint32_t)0x08000000)
+#define MODEL_EPTCTL_SETD0PID            ((uint32_t)0x10000000)
+#define MODEL_EPTCTL_SETD1PID            ((uint32_t)0x20000000)
+#define MODEL_EPTCTL_EPTDIS              ((uint32_t)0x40000000)
+#define MODEL_EPTCTL_EPTENA              ((uint32_t)0x80000000)
+#define MODEL_EPTCTL_ACTION              (MODEL_EPTCTL_CNAK | MODEL_EPTCTL_SNAK | MODEL_EPTCTL_SETD0PID | \
+                                          MODEL_EPTCTL_SETD1PID | MODEL_EPTCTL_EPTDIS)
+
+#define MODEL_RXSTS(ept, len, sts)       ((uint32_t)(ept) | ((uint32_t)(len) << 4) | ((uint32_t)(sts) << 17))
+
+/**
+  * @brief register regions mapped at the target addresses
+  */
+static const struct
+{
+  uint32_t base;
+  uint32_t size;
+} model_region[] =
+{
+  {PERIPH_BASE,     0x00080000},  /* apb, ahb1 and the otghs core */
+  {AHBPERIPH2_BASE, 0x00040000},  /* otgfs core */
+  {SCS_BASE & 0xFFF00000, 0x00100000}, /* dwt, coredebug and nvic */
+  {0x1FFF0000,      0x00010000},  /* system memory, device id */
+};
+
+/**
+  * @brief one packet of a tx fifo
+  */
+typedef struct
+{
+  uint16_t len;
+  uint8_t  data[USB_MODEL_PKT_MAX];
+} usb_model_pkt_type;
+
+/**
+  * @brief tx fifo of one in endpoint
+  */
+typedef struct
+{
+  usb_model_pkt_type pkt[USB_MODEL_TXQ_NUM];
+  uint32_t rd;
+  uint32_t num;
+  uint32_t words;
+} usb_model_txq_type;
+
+/**
+  * @brief rx fifo entry, status word and packet data
+  */
+typedef struct
+{
+  uint32_t sts;
+  uint16_t len;
+  uint16_t offset;
+  uint8_t  data[USB_MODEL_PKT_MAX];
+} usb_model_rx_type;
+
+/**
+  * @brief model state
+  */
+static struct
+{
+  otg_core_type *otgdev;
+  otg_global_type *usbx;
+  usb_model_poll_type poll;
+  uint32_t events;
+  uint32_t gintsts_wr;
+  uint32_t intsts;
+  uint32_t diepint[USB_EPT_MAX_NUM];
+  uint32_t diepint_wr[USB_EPT_MAX_NUM];
+  uint32_t doepint[USB_EPT_MAX_NUM];
+  uint32_t doepint_wr[USB_EPT_MAX_NUM];
+  uint8_t in_nak[USB_EPT_MAX_NUM];
+  uint8_t out_nak[USB_EPT_MAX_NUM];
+  uint8_t out_done[USB_EPT_MAX_NUM];
+  usb_model_txq_type txq[USB_EPT_MAX_NUM];
+  usb_model_rx_type rxq[USB_MODEL_RXQ_NUM];
+  uint32_t rx_rd;
+  uint32_t rx_num;
+  uint32_t rx_words;
+  uint16_t frame;
+  int perf_fd;
+} model;
+
+uint32_t cmsis_host_primask;
+usb_model_stat_type usb_model_stat;
+
+/**
+  * @brief  report a model error and stop, the stack drove the core into a
+  *         state the hardware does not support
+  * @param  msg: error text
+  * @retval none
+  */
+static void model_fatal(const char *msg)
+{
+  fprintf(stderr, "usb model: %s\n", msg);
+  exit(2);
+}
+
+/**
+  * @brief  tx fifo depth of an in endpoint in words
+  * @param  ept_num: endpoint number
+  * @retval depth
+  */
+static uint32_t model_tx_depth(uint32_t ept_num)
+{
+  if(ept_num == 0)
+  {
+    return model.usbx->gnptxfsiz_ept0tx >> 16;
+  }
+  return model.usbx->dieptxfn[ept_num - 1] >> 16;
+}
+
+/**
+  * @brief  flush the tx fifo of one or all in endpoints
+  * @param  fifo_num: endpoint number, 0x10 flushes all
+  * @retval none
+  */
+static void model_tx_flush(uint32_t fifo_num)
+{
+  uint32_t i_index;
+  for(i_index = 0; i_index < USB_EPT_MAX_NUM; i_index ++)
+  {
+    if(fifo_num == 0x10 || fifo_num == i_index)
+    {
+      model.txq[i_index].rd = 0;
+      model.txq[i_index].num = 0;
+      model.txq[i_index].words = 0;
+    }
+  }
+}
+
+/**
+  * @brief  flush the rx fifo
+  * @param  none
+  * @retval none
+  */
+static void model_rx_flush(void)
+{
+  model.rx_rd = 0;
+  model.rx_num = 0;
+  model.rx_words = 0;
+}
+
+/**
+  * @brief  push one entry to the rx fifo
+  * @param  sts: status word read from grxstsp
+  * @param  data: packet data
+  * @param  len: packet length
+  * @retval none
+  */
+static void model_rx_push(uint32_t sts, const uint8_t *data, uint16_t len)
+{
+  usb_model_rx_type *rx = &model.rxq[(model.rx_rd + model.rx_num) % USB_MODEL_RXQ_NUM];
+  rx->sts = sts;
+  rx->len = len;
+  rx->offset = 0;
+  if(len != 0)
+  {
+    memcpy(rx->data, data, len);
+  }
+  model.rx_num ++;
+  model.rx_words += 1 + (len + 3) / 4;
+}
+
+/**
+  * @brief  check that the rx fifo takes a packet and a completion entry
+  * @param  len: packet length
+  * @retval non zero when there is room
+  */
+static uint32_t model_rx_room(uint16_t len)
+{
+  uint32_t words = 2 + (len + 3) / 4;
+  return (model.rx_num + 2 <= USB_MODEL_RXQ_NUM) &&
+         (model.rx_words + words <= (model.usbx->grxfsiz & 0xFFFF));
+}
+
+/**
+  * @brief  pop the rx fifo entry the last interrupt reported, a completion
+  *         entry raises the endpoint interrupt when it is popped
+  * @param  none
+  * @retval none
+  */
+static void model_rx_pop(void)
+{
+  usb_model_rx_type *rx = &model.rxq[model.rx_rd];
+  uint32_t ept_num = rx->sts & USB_OTG_GRXSTSP_EPTNUM;
+  uint32_t pktsts = (rx->sts & USB_OTG_GRXSTSP_PKTSTS) >> 17;
+
+  model.rx_words -= 1 + (rx->len + 3) / 4;
+  model.rx_rd = (model.rx_rd + 1) % USB_MODEL_RXQ_NUM;
+  model.rx_num --;
+
+  if(pktsts == USB_OUT_STS_COMP)
+  {
+    model.doepint[ept_num] |= USB_OTG_DOEPINT_XFERC_FLAG;
+    USB_OUTEPT(model.usbx, ept_num)->doepctl &= ~MODEL_EPTCTL_EPTENA;
+    model.out_done[ept_num] = 0;
+  }
+  else if(pktsts == USB_SETUP_STS_COMP)
+  {
+    model.doepint[0] |= USB_OTG_DOEPINT_SETUP_FLAG;
+  }
+}
+
+/**
+  * @brief  apply the register writes of the stack and copy the model state
+  *         to the register image. a status register that reads back other
+  *         than the model wrote it was written by the stack, the written
+  *         value clears flags (write one to clear).
+  * @param  none
+  * @retval none
+  */
+static void model_update(void)
+{
+  otg_global_type *usbx = model.usbx;
+  otg_device_type *dev = OTG_DEVICE(usbx);
+  otg_eptin_type *ept_in;
+  otg_eptout_type *ept_out;
+  uint32_t i_index, value, depth, free, daint = 0;
+
+  value = usbx->gintsts;
+  if(value != model.gintsts_wr)
+  {
+    model.events &= ~value;
+  }
+
+  /* reset and flush finish at once */
+  value = usbx->grstctl;
+  if(value & 0x20)
+  {
+    model_tx_flush((value >> 6) & 0x1F);
+  }
+  if(value & 0x10)
+  {
+    model_rx_flush();
+  }
+  usbx->grstctl = (value & ~0x37UL) | 0x80000000;
+
+  for(i_index = 0; i_index < USB_EPT_MAX_NUM; i_index ++)
+  {
+    ept_in = USB_INEPT(usbx, i_index);
+    value = ept_in->diepint;
+    if(value != model.diepint_wr[i_index])
+    {
+      model.diepint[i_index] &= ~value;
+    }
+    value = ept_in->diepctl;
+    if(value & MODEL_EPTCTL_CNAK)
+    {
+      model.in_nak[i_index] = 0;
+    }
+    if(value & MODEL_EPTCTL_SNAK)
+    {
+      model.in_nak[i_index] = 1;
+    }
+    if((value & MODEL_EPTCTL_EPTDIS) && (value & MODEL_EPTCTL_EPTENA))
+    {
+      value &= ~MODEL_EPTCTL_EPTENA;
+      model.diepint[i_index] |= USB_OTG_DIEPINT_EPTDISD_FLAG;
+    }
+    value &= ~(MODEL_EPTCTL_ACTION | MODEL_EPTCTL_NAKSTS);
+    if(model.in_nak[i_index])
+    {
+      value |= MODEL_EPTCTL_NAKSTS;
+    }
+    ept_in->diepctl = value;
+
+    /* tx fifo empty level is half empty */
+    depth = model_tx_depth(i_index);
+    free = depth > model.txq[i_index].words ? depth - model.txq[i_index].words : 0;
+    ept_in->dtxfsts = free;
+    if(depth != 0 && free * 2 >= depth)
+    {
+      model.diepint[i_index] |= USB_OTG_DIEPINT_TXFEMP_FLAG;
+    }
+    else
+    {
+      model.diepint[i_index] &= ~USB_OTG_DIEPINT_TXFEMP_FLAG;
+    }
+    ept_in->diepint = model.diepint[i_index];
+    model.diepint_wr[i_index] = model.diepint[i_index];
+    if(model.diepint[i_index] & (dev->diepmsk | (((dev->diepempmsk >> i_index) & 1) << 7)))
+    {
+      daint |= 1 << i_index;
+    }
+
+    ept_out = USB_OUTEPT(usbx, i_index);
+    value = ept_out->doepint;
+    if(value != model.doepint_wr[i_index])
+    {
+      model.doepint[i_index] &= ~value;
+    }
+    value = ept_out->doepctl;
+    if(value & MODEL_EPTCTL_CNAK)
+    {
+      model.out_nak[i_index] = 0;
+    }
+    if(value & MODEL_EPTCTL_SNAK)
+    {
+      model.out_nak[i_index] = 1;
+    }
+    if((value & MODEL_EPTCTL_EPTDIS) && (value & MODEL_EPTCTL_EPTENA))
+    {
+      value &= ~MODEL_EPTCTL_EPTENA;
+      model.doepint[i_index] |= USB_OTG_DOEPINT_EPTDISD_FLAG;
+    }
+    value &= ~(MODEL_EPTCTL_ACTION | MODEL_EPTCTL_NAKSTS);
+    if(model.out_nak[i_index])
+    {
+      value |= MODEL_EPTCTL_NAKSTS;
+    }
+    ept_out->doepctl = value;
+    ept_out->doepint = model.doepint[i_index];
+    model.doepint_wr[i_index] = model.doepint[i_index];
+    if(model.doepint[i_index] & dev->doepmsk)
+    {
+      daint |= 1 << (i_index + 16);
+    }
+  }
+  dev->daint = daint;
+  dev->dsts_bit.soffn = model.frame;
+
+  value = model.events;
+  if(model.rx_num != 0)
+  {
+    value |= USB_OTG_RXFLVL_FLAG;
+    usbx->grxstsp = model.rxq[model.rx_rd].sts;
+  }
+  if(daint & dev->daintmsk & 0xFFFF)
+  {
+    value |= USB_OTG_IEPT_FLAG;
+  }
+  if((daint & dev->daintmsk) >> 16)
+  {
+    value |= USB_OTG_OEPT_FLAG;
+  }
+  usbx->gintsts = value;
+  model.gintsts_wr = value;
+}
+
+/**
+  * @brief  fingerprint of the interrupt state, a handler call that leaves
+  *         it unchanged made no progress
+  * @param  none
+  * @retval fingerprint
+  */
+static uint32_t model_state_sum(void)
+{
+  uint32_t i_index, sum = model.events ^ (model.rx_num << 24) ^ model.usbx->gintmsk;
+  for(i_index = 0; i_index < USB_EPT_MAX_NUM; i_index ++)
+  {
+    sum = sum * 31 + model.diepint[i_index];
+    sum = sum * 31 + model.doepint[i_index];
+    sum = sum * 31 + model.txq[i_index].words;
+  }
+  return sum * 31 + OTG_DEVICE(model.usbx)->diepempmsk;
+}
+
+/**
+  * @brief  the driver functions below replace the ones of
+  *         at32f402_405_usb.c that touch the fifo or clear interrupt
+  *         flags, the makefile renames the driver versions
+  */
+
+/**
+  * @brief  get all global core interrupt flag
+  * @param  usbx: to select the otgfs peripheral.
+  * @retval intterupt flag
+  */
+uint32_t usb_global_get_all_interrupt(otg_global_type *usbx)
+{
+  model.intsts = usbx->gintsts & usbx->gintmsk;
+  return model.intsts;
+}
+
+/**
+  * @brief  clear the global interrupt flag
+  * @param  usbx: to select the otgfs peripheral.
+  * @param  flag: interrupt flag
+  * @retval none
+  */
+void usb_global_clear_interrupt(otg_global_type *usbx, uint32_t flag)
+{
+  model.events &= ~flag;
+  usbx->gintsts &= ~flag;
+  model.gintsts_wr = usbx->gintsts;
+}
+
+/**
+  * @brief  clear in endpoint interrupt flag
+  * @param  usbx: to select the otgfs peripheral.
+  * @param  eptn: endpoint number
+  * @param  flag: interrupt flag
+  * @retval none
+  */
+void usb_ept_in_clear(otg_global_type *usbx, uint32_t eptn, uint32_t flag)
+{
+  model.diepint[eptn] &= ~flag;
+  USB_INEPT(usbx, eptn)->diepint = model.diepint[eptn];
+  model.diepint_wr[eptn] = model.diepint[eptn];
+}
+
+/**
+  * @brief  clear out endpoint interrupt flag
+  * @param  usbx: to select the otgfs peripheral.
+  * @param  eptn: endpoint number
+  * @param  flag: interrupt flag
+  * @retval none
+  */
+void usb_ept_out_clear(otg_global_type *usbx, uint32_t eptn, uint32_t flag)
+{
+  model.doepint[eptn] &= ~flag;
+  USB_OUTEPT(usbx, eptn)->doepint = model.doepint[eptn];
+  model.doepint_wr[eptn] = model.doepint[eptn];
+}
+
+/**
+  * @brief  flush tx fifo
+  * @param  usbx: to select the otgfs peripheral.
+  * @param  fifo_num: tx fifo num,when fifo_num=16,flush all tx fifo
+  * @retval none
+  */
+void usb_flush_tx_fifo(otg_global_type *usbx, uint32_t fifo_num)
+{
+  /* the stack flushes after it disabled the endpoint, apply that first */
+  if(model.usbx != 0)
+  {
+    model_update();
+  }
+  model_tx_flush(fifo_num);
+}
+
+/**
+  * @brief  flush rx fifo
+  * @param  usbx: to select the otgfs peripheral.
+  * @retval none
+  */
+void usb_flush_rx_fifo(otg_global_type *usbx)
+{
+  model_rx_flush();
+}
+
+/**
+  * @brief  write data from user memory to usb buffer
+  * @param  usbx: to select the otgfs peripheral.
+  * @param  pusr_buf: point to user buffer
+  * @param  num: endpoint number
+  * @param  nbytes: number of bytes count
+  * @retval none
+  */
+void usb_write_packet(otg_global_type *usbx, uint8_t *pusr_buf, uint16_t num, uint16_t nbytes)
+{
+  usb_model_txq_type *txq = &model.txq[num];
+  usb_model_pkt_type *pkt;
+  uint32_t words = (nbytes + 3) / 4;
+
+  if(txq->num == USB_MODEL_TXQ_NUM || nbytes > USB_MODEL_PKT_MAX ||
+     txq->words + words > model_tx_depth(num))
+  {
+    model_fatal("tx fifo overflow");
+  }
+  pkt = &txq->pkt[(txq->rd + txq->num) % USB_MODEL_TXQ_NUM];
+  memcpy(pkt->data, pusr_buf, nbytes);
+  pkt->len = nbytes;
+  txq->num ++;
+  txq->words += words;
+  USB_INEPT(usbx, num)->dtxfsts = model_tx_depth(num) - txq->words;
+}
+
+/**
+  * @brief  read data from usb buffer to user buffer
+  * @param  usbx: to select the otgfs peripheral.
+  * @param  pusr_buf: point to user buffer
+  * @param  num: endpoint number
+  * @param  nbytes: number of bytes count
+  * @retval none
+  */
+void usb_read_packet(otg_global_type *usbx, uint8_t *pusr_buf, uint16_t num, uint16_t nbytes)
+{
+  usb_model_rx_type *rx = &model.rxq[model.rx_rd];
+
+  if(model.rx_num == 0 || rx->offset + nbytes > rx->len)
+  {
+    model_fatal("read beyond the rx fifo entry");
+  }
+  memcpy(pusr_buf, rx->data + rx->offset, nbytes);
+  rx->offset += nbytes;
+}
+
+/**
+  * @brief  name of the counter behind usb_model_cycles
+  * @param  none
+  * @retval counter name
+  */
+const char *usb_model_counter_name(void)
+{
+  if(model.perf_fd >= 0)
+  {
+    return "instructions";
+  }
+#if defined(__x86_64__) || defined(__i386__)
+  return "tsc cycles";
+#else
+  return "ns";
+#endif
+}
+
+/**
+  * @brief  read the host counter, retired user instructions when the
+  *         kernel provides them, the time stamp counter otherwise
+  * @param  none
+  * @retval counter value
+  */
+uint32_t usb_model_cycles(void)
+{
+  uint64_t count;
+#if !defined(__x86_64__) && !defined(__i386__)
+  struct timespec ts;
+#endif
+
+  if(model.perf_fd >= 0 && read(model.perf_fd, &count, sizeof(count)) == sizeof(count))
+  {
+    return (uint32_t)count;
+  }
+#if defined(__x86_64__) || defined(__i386__)
+  count = __rdtsc();
+#else
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  count = (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+#endif
+  return (uint32_t)count;
+}
+
+/**
+  * @brief  usb delay, the model core finishes everything at once
+  * @param  ms: delay number in milliseconds
+  * @retval none
+  */
+void usb_delay_ms(uint32_t ms)
+{
+  (void)ms;
+}
+
+/**
+  * @brief  usb delay, the model core finishes everything at once
+  * @param  us: delay number in microseconds
+  * @retval none
+  */
+void usb_delay_us(uint32_t us)
+{
+  (void)us;
+}
+
+/**
+  * @brief  map the register regions and open the counter, called before
+  *         any driver code runs
+  * @param  none
+  * @retval none
+  */
+void usb_model_init(void)
+{
+  uint32_t i_index;
+  void *addr;
+
+  for(i_index = 0; i_index < sizeof(model_region) / sizeof(model_region[0]); i_index ++)
+  {
+    addr = mmap((void *)(uintptr_t)model_region[i_index].base, model_region[i_index].size,
+                PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if(addr != (void *)(uintptr_t)model_region[i_index].base)
+    {
+      model_fatal("register region can not be mapped at its target address");
+    }
+  }
+
+  model.perf_fd = -1;
+#ifdef __linux__
+  {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    if(getenv("USB_MODEL_TSC") == NULL)
+    {
+      model.perf_fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+  }
+#endif
+}
+
+/**
+  * @brief  attach the model to the core the application initialized
+  * @param  otgdev: to the structure of otg_core_type
+  * @param  poll: application main loop work, may be 0
+  * @retval none
+  */
+void usb_model_attach(otg_core_type *otgdev, usb_model_poll_type poll)
+{
+  model.otgdev = otgdev;
+  model.usbx = otgdev->usb_reg;
+  model.poll = poll;
+  model_update();
+}
+
+/**
+  * @brief  clear the model and the stack statistics
+  * @param  none
+  * @retval none
+  */
+void usb_model_stat_reset(void)
+{
+  memset(&usb_model_stat, 0, sizeof(usb_model_stat));
+  usbd_perf_reset(&model.otgdev->dev);
+}
+
+/**
+  * @brief  run the interrupt handler while an unmasked interrupt is
+  *         pending, then the application poll, until both are idle
+  * @param  none
+  * @retval none
+  */
+void usb_model_service(void)
+{
+  otg_global_type *usbx = model.usbx;
+  uint32_t loop, cycles, sum, busy;
+
+  for(loop = 0; loop < USB_MODEL_IRQ_LIMIT; loop ++)
+  {
+    model_update();
+    if(usbx->gahbcfg_bit.glbintmsk && cmsis_host_primask == 0 &&
+       (usbx->gintsts & usbx->gintmsk) != 0)
+    {
+      sum = model_state_sum();
+      model.intsts = 0;
+      cycles = usb_model_cycles();
+      usbd_irq_handler(model.otgdev);
+      cycles = usb_model_cycles() - cycles;
+      usb_model_stat.irq_count ++;
+      usb_model_stat.irq_cycles += cycles;
+      if(cycles > usb_model_stat.irq_max_cycles)
+      {
+        usb_model_stat.irq_max_cycles = cycles;
+      }
+      if(model.intsts & USB_OTG_RXFLVL_FLAG)
+      {
+        model_rx_pop();
+      }
+      else if(sum == model_state_sum())
+      {
+        /* a level interrupt the stack can not serve until the host moves
+           data, the target would repeat it until then */
+        usb_model_stat.irq_idle ++;
+        model_update();
+        return;
+      }
+      continue;
+    }
+    if(model.poll != 0)
+    {
+      cycles = usb_model_cycles();
+      busy = model.poll();
+      usb_model_stat.app_cycles += usb_model_cycles() - cycles;
+      if(busy)
+      {
+        continue;
+      }
+    }
+    return;
+  }
+  model_fatal("interrupt storm");
+}
+
+/**
+  * @brief  bus reset and enumeration done, full speed on the otgfs core,
+  *         high speed on the otghs core
+  * @param  none
+  * @retval none
+  */
+void usb_model_bus_reset(void)
+{
+  uint32_t i_index;
+
+  model_tx_flush(0x10);
+  model_rx_flush();
+  for(i_index = 0; i_index < USB_EPT_MAX_NUM; i_index ++)
+  {
+    model.out_done[i_index] = 0;
+  }
+  model.events |= USB_OTG_USBRST_FLAG;
+  usb_model_service();
+
+  OTG_DEVICE(model.usbx)->dsts_bit.enumspd = (model.otgdev->cfg.core_id == USB_HIGH_SPEED_CORE_ID) ? 0 : 3;
+  model.events |= USB_OTG_ENUMDONE_FLAG;
+  usb_model_service();
+}
+
+/**
+  * @brief  start of frame
+  * @param  none
+  * @retval none
+  */
+void usb_model_sof(void)
+{
+  model.frame = (model.frame + 1) & 0x3FFF;
+  model.events |= USB_OTG_SOF_FLAG;
+  usb_model_service();
+}
+
+/**
+  * @brief  max packet size of an endpoint as the stack configured it
+  * @param  ept_addr: endpoint address
+  * @retval max packet size
+  */
+uint16_t usb_model_mps(uint8_t ept_addr)
+{
+  uint8_t ept_num = ept_addr & 0x7F;
+  uint32_t mps;
+
+  if(ept_addr & 0x80)
+  {
+    mps = USB_INEPT(model.usbx, ept_num)->diepctl_bit.mps;
+  }
+  else
+  {
+    mps = USB_OUTEPT(model.usbx, ept_num)->doepctl_bit.mps;
+  }
+  if(ept_num == 0)
+  {
+    return 64 >> (mps & 0x3);
+  }
+  return (uint16_t)mps;
+}
+
+/**
+  * @brief  setup transaction on endpoint 0
+  * @param  setup: 8 byte setup packet
+  * @retval 8
+  */
+int32_t usb_model_setup(const uint8_t *setup)
+{
+  usb_model_service();
+  if(model.rx_num + 2 > USB_MODEL_RXQ_NUM)
+  {
+    return USB_MODEL_ERROR;
+  }
+  USB_INEPT(model.usbx, 0)->diepctl &= ~MODEL_EPTCTL_STALL;
+  USB_OUTEPT(model.usbx, 0)->doepctl &= ~MODEL_EPTCTL_STALL;
+  model_rx_push(MODEL_RXSTS(0, 8, USB_SETUP_STS_DATA), setup, 8);
+  model_rx_push(MODEL_RXSTS(0, 0, USB_SETUP_STS_COMP), 0, 0);
+  usb_model_service();
+  return 8;
+}
+
+/**
+  * @brief  out transaction
+  * @param  ept_num: endpoint number
+  * @param  data: packet data
+  * @param  len: packet length
+  * @retval length, or USB_MODEL_NAK, USB_MODEL_STALL, USB_MODEL_ERROR
+  */
+int32_t usb_model_out(uint8_t ept_num, const uint8_t *data, uint16_t len)
+{
+  otg_eptout_type *ept_out = USB_OUTEPT(model.usbx, ept_num);
+  uint32_t pktcnt, xfersize, mps = usb_model_mps(ept_num);
+
+  model_update();
+  if(ept_out->doepctl & MODEL_EPTCTL_STALL)
+  {
+    return USB_MODEL_STALL;
+  }
+  if(len > mps)
+  {
+    return USB_MODEL_ERROR;
+  }
+  if(!(ept_out->doepctl & MODEL_EPTCTL_EPTENA) || model.out_nak[ept_num] ||
+     model.out_done[ept_num] || !model_rx_room(len))
+  {
+    usb_model_stat.naks ++;
+    return USB_MODEL_NAK;
+  }
+
+  model_rx_push(MODEL_RXSTS(ept_num, len, USB_OUT_STS_DATA), data, len);
+  pktcnt = ept_out->doeptsiz_bit.pktcnt;
+  xfersize = ept_out->doeptsiz_bit.xfersize;
+  if(pktcnt != 0)
+  {
+    pktcnt --;
+  }
+  xfersize = xfersize > len ? xfersize - len : 0;
+  ept_out->doeptsiz_bit.pktcnt = pktcnt;
+  ept_out->doeptsiz_bit.xfersize = xfersize;
+  if(pktcnt == 0 || len < mps)
+  {
+    model_rx_push(MODEL_RXSTS(ept_num, 0, USB_OUT_STS_COMP), 0, 0);
+    model.out_done[ept_num] = 1;
+  }
+  usb_model_stat.bytes_out += len;
+  model_update();
+  return len;
+}
+
+/**
+  * @brief  in transaction
+  * @param  ept_num: endpoint number
+  * @param  data: buffer of the packet
+  * @param  len: buffer length
+  * @retval length, or USB_MODEL_NAK, USB_MODEL_STALL, USB_MODEL_ERROR
+  */
+int32_t usb_model_in(uint8_t ept_num, uint8_t *data, uint16_t len)
+{
+  otg_eptin_type *ept_in = USB_INEPT(model.usbx, ept_num);
+  usb_model_txq_type *txq = &model.txq[ept_num];
+  usb_model_pkt_type *pkt = &txq->pkt[txq->rd];
+  uint32_t pktcnt, xfersize, plen = 0;
+
+  model_update();
+  if(ept_in->diepctl & MODEL_EPTCTL_STALL)
+  {
+    return USB_MODEL_STALL;
+  }
+  if(!(ept_in->diepctl & MODEL_EPTCTL_EPTENA) || model.in_nak[ept_num])
+  {
+    usb_model_stat.naks ++;
+    return USB_MODEL_NAK;
+  }
+  xfersize = ept_in->dieptsiz_bit.xfersize;
+  pktcnt = ept_in->dieptsiz_bit.pktcnt;
+  if(txq->num == 0 && xfersize != 0)
+  {
+    usb_model_stat.naks ++;
+    return USB_MODEL_NAK;
+  }
+  if(txq->num != 0 && (xfersize != 0 || pkt->len == 0))
+  {
+    plen = pkt->len;
+    if(plen > len)
+    {
+      return USB_MODEL_ERROR;
+    }
+    memcpy(data, pkt->data, plen);
+    txq->rd = (txq->rd + 1) % USB_MODEL_TXQ_NUM;
+    txq->num --;
+    txq->words -= (plen + 3) / 4;
+  }
+
+  xfersize = xfersize > plen ? xfersize - plen : 0;
+  if(pktcnt != 0)
+  {
+    pktcnt --;
+  }
+  ept_in->dieptsiz_bit.xfersize = xfersize;
+  ept_in->dieptsiz_bit.pktcnt = pktcnt;
+  if(pktcnt == 0)
+  {
+    ept_in->diepctl &= ~MODEL_EPTCTL_EPTENA;
+    model.diepint[ept_num] |= USB_OTG_DIEPINT_XFERC_FLAG;
+  }
+  usb_model_stat.bytes_in += plen;
+  model_update();
+  return plen;
+}
+
+/**
+  * @brief  print the endpoint state of a transfer that timed out
+  * @param  ept_addr: endpoint address
+  * @retval USB_MODEL_TIMEOUT
+  */
+static int32_t model_timeout(uint8_t ept_addr)
+{
+  uint8_t ept_num = ept_addr & 0x7F;
+
+  if(ept_addr & 0x80)
+  {
+    fprintf(stderr, "usb model: in %d timeout, diepctl 0x%08x dieptsiz 0x%08x diepint 0x%08x, %u packets queued\n",
+            ept_num, USB_INEPT(model.usbx, ept_num)->diepctl, USB_INEPT(model.usbx, ept_num)->dieptsiz,
+            model.diepint[ept_num], model.txq[ept_num].num);
+  }
+  else
+  {
+    fprintf(stderr, "usb model: out %d timeout, doepctl 0x%08x doeptsiz 0x%08x doepint 0x%08x, %u rx entries\n",
+            ept_num, USB_OUTEPT(model.usbx, ept_num)->doepctl, USB_OUTEPT(model.usbx, ept_num)->doeptsiz,
+            model.doepint[ept_num], model.rx_num);
+  }
+  return USB_MODEL_TIMEOUT;
+}
+
+/**
+  * @brief  out transaction, repeated while the endpoint naks
+  * @param  ept_num: endpoint number
+  * @param  data: packet data
+  * @param  len: packet length
+  * @retval length or error
+  */
+static int32_t model_out_retry(uint8_t ept_num, const uint8_t *data, uint16_t len)
+{
+  uint32_t retry;
+  int32_t ret;
+
+  for(retry = 0; retry < USB_MODEL_RETRY; retry ++)
+  {
+    usb_model_service();
+    ret = usb_model_out(ept_num, data, len);
+    if(ret != USB_MODEL_NAK)
+    {
+      usb_model_service();
+      return ret;
+    }
+  }
+  return model_timeout(ept_num);
+}
+
+/**
+  * @brief  in transaction, repeated while the endpoint naks
+  * @param  ept_num: endpoint number
+  * @param  data: buffer of the packet
+  * @param  len: buffer length
+  * @retval length or error
+  */
+static int32_t model_in_retry(uint8_t ept_num, uint8_t *data, uint16_t len)
+{
+  uint32_t retry;
+  int32_t ret;
+
+  for(retry = 0; retry < USB_MODEL_RETRY; retry ++)
+  {
+    usb_model_service();
+    ret = usb_model_in(ept_num, data, len);
+    if(ret != USB_MODEL_NAK)
+    {
+      usb_model_service();
+      return ret;
+    }
+  }
+  return model_timeout(ept_num | 0x80);
+}
+
+/**
+  * @brief  control transfer on endpoint 0
+  * @param  type: bmrequesttype
+  * @param  request: brequest
+  * @param  value: wvalue
+  * @param  index: windex
+  * @param  length: wlength
+  * @param  data: data stage buffer
+  * @retval data stage length or error
+  */
+int32_t usb_model_control(uint8_t type, uint8_t request, uint16_t value, uint16_t index,
+                          uint16_t length, uint8_t *data)
+{
+  uint8_t setup[8], pkt[USB_MODEL_PKT_MAX];
+  uint32_t offset = 0, mps, size;
+  int32_t ret;
+
+  setup[0] = type;
+  setup[1] = request;
+  setup[2] = (uint8_t)value;
+  setup[3] = (uint8_t)(value >> 8);
+  setup[4] = (uint8_t)index;
+  setup[5] = (uint8_t)(index >> 8);
+  setup[6] = (uint8_t)length;
+  setup[7] = (uint8_t)(length >> 8);
+  ret = usb_model_setup(setup);
+  if(ret < 0)
+  {
+    return ret;
+  }
+  mps = usb_model_mps(0x80);
+
+  if(type & 0x80)
+  {
+    while(offset < length)
+    {
+      ret = model_in_retry(0, pkt, sizeof(pkt));
+      if(ret < 0)
+      {
+        return ret;
+      }
+      size = (uint32_t)ret < length - offset ? (uint32_t)ret : length - offset;
+      memcpy(data + offset, pkt, size);
+      offset += size;
+      if((uint32_t)ret < mps)
+      {
+        break;
+      }
+    }
+    ret = model_out_retry(0, 0, 0);
+  }
+  else
+  {
+    while(offset < length)
+    {
+      size = length - offset < mps ? length - offset : mps;
+      ret = model_out_retry(0, data + offset, (uint16_t)size);
+      if(ret < 0)
+      {
+        return ret;
+      }
+      offset += size;
+    }
+    ret = model_in_retry(0, pkt, sizeof(pkt));
+  }
+  return ret < 0 ? ret : (int32_t)offset;
+}
+
+/**
+  * @brief  bulk out transfer, split in max packet size packets, a
+  *         transfer of a multiple of the packet size ends without a zlp
+  * @param  ept_num: endpoint number
+  * @param  data: transfer data
+  * @param  len: transfer length, 0 sends a zlp
+  * @retval length or error
+  */
+int32_t usb_model_bulk_out(uint8_t ept_num, const uint8_t *data, uint32_t len)
+{
+  uint32_t offset = 0, size, mps = usb_model_mps(ept_num);
+  int32_t ret;
+
+  do
+  {
+    size = len - offset < mps ? len - offset : mps;
+    ret = model_out_retry(ept_num, data + offset, (uint16_t)size);
+    if(ret < 0)
+    {
+      return ret;
+    }
+    offset += size;
+  } while(offset < len);
+  return (int32_t)offset;
+}
+
+/**
+  * @brief  bulk in transfer, ends at len bytes or at a short packet
+  * @param  ept_num: endpoint number
+  * @param  data: buffer
+  * @param  len: buffer length
+  * @retval length or error
+  */
+int32_t usb_model_bulk_in(uint8_t ept_num, uint8_t *data, uint32_t len)
+{
+  uint8_t pkt[USB_MODEL_PKT_MAX];
+  uint32_t offset = 0, mps = usb_model_mps(ept_num | 0x80);
+  int32_t ret;
+
+  while(offset < len)
+  {
+    ret = model_in_retry(ept_num, pkt, sizeof(pkt));
+    if(ret < 0)
+    {
+      return ret;
+    }
+    if(offset + (uint32_t)ret > len)
+    {
+      return USB_MODEL_ERROR;
+    }
+    memcpy(data + offset, pkt, ret);
+    offset += ret;
+    if((uint32_t)ret < mps)
+    {
+      break;
+    }
+  }
+  return (int32_t)offset;
+}
+
+/**
+  * @brief  bus reset and the standard requests of a host enumeration
+  * @param  none
+  * @retval configuration descriptor length or error
+  */
+int32_t usb_model_enumerate(void)
+{
+  uint8_t desc[512];
+  uint16_t total;
+  int32_t ret;
+
+  usb_model_bus_reset();
+  ret = usb_model_control(0x80, USB_STD_REQ_GET_DESCRIPTOR, USB_DESCIPTOR_TYPE_DEVICE << 8, 0, 64, desc);
+  if(ret < 18)
+  {
+    return ret < 0 ? ret : USB_MODEL_ERROR;
+  }
+  ret = usb_model_control(0x00, USB_STD_REQ_SET_ADDRESS, 1, 0, 0, 0);
+  if(ret < 0)
+  {
+    return ret;
+  }
+  ret = usb_model_control(0x80, USB_STD_REQ_GET_DESCRIPTOR, USB_DESCIPTOR_TYPE_CONFIGURATION << 8, 0, 9, desc);
+  if(ret != 9)
+  {
+    return ret < 0 ? ret : USB_MODEL_ERROR;
+  }
+  total = desc[2] | (desc[3] << 8);
+  if(total > sizeof(desc))
+  {
+    return USB_MODEL_ERROR;
+  }
+  ret = usb_model_control(0x80, USB_STD_REQ_GET_DESCRIPTOR, USB_DESCIPTOR_TYPE_CONFIGURATION << 8, 0, total, desc);
+  if(ret != total)
+  {
+    return ret < 0 ? ret : USB_MODEL_ERROR;
+  }
+  ret = usb_model_control(0x80, USB_STD_REQ_GET_DESCRIPTOR, USB_DESCIPTOR_TYPE_STRING << 8, 0, 255, desc);
+  if(ret < 0)
+  {
+    return ret;
+  }
+  ret = usb_model_control(0x00, USB_STD_REQ_SET_CONFIGURATION, 1, 0, 0, 0);
+  if(ret < 0)
+  {
+    return ret;
+  }
+  return total;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,209 @@
+/**
+  **************************************************************************
+  * @file     usb_model_script.c
+  * @brief    usb device model traffic script and report
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "usb_model.h"
+
+/** @addtogroup AT32F402_405_usb_device_model
+  * @{
+  */
+
+/** @defgroup USB_device_model_script
+  * @brief traffic script, one command per line, '#' starts a comment
+  *
+  *        reset                          bus reset and enumeration done
+  *        enumerate                      bus reset and standard enumeration
+  *        sof <n>                        n start of frames
+  *        control <type> <req> <value> <index> <length>
+  *                                       control transfer, in data dropped
+  *        stats <label>                  print and clear the statistics
+  *        echo <text>                    print text
+  *
+  *        every other command goes to the class application, numbers are
+  *        decimal or 0x hex.
+  * @{
+  */
+
+#define SCRIPT_LINE_MAX                  256
+#define SCRIPT_ARG_MAX                   8
+
+/**
+  * @brief  print the statistics since the last stats command and clear them
+  * @param  label: line label
+  * @retval none
+  */
+static void script_stats(const char *label)
+{
+  usb_model_stat_type *stat = &usb_model_stat;
+  usbd_perf_type *perf = &otg_core_struct.dev.perf;
+  uint64_t cycles = stat->irq_cycles + stat->app_cycles;
+  uint64_t bytes = stat->bytes_out + stat->bytes_in;
+  uint32_t ops = stat->ops ? stat->ops : 1;
+  uint64_t per_byte = bytes ? cycles * 100 / bytes : 0;
+
+  printf("%-20s ops %6u bytes %9llu irqs %7u irqs/op %5u cycles/op %9llu irq/op %9llu cycles/byte %5llu.%02llu "
+         "max irq %6u naks %6u idle %5u rxflvl %6u inept %6u outept %6u sof %5u\n",
+         label, stat->ops, (unsigned long long)bytes, stat->irq_count, stat->irq_count / ops,
+         (unsigned long long)(cycles / ops), (unsigned long long)(stat->irq_cycles / ops),
+         (unsigned long long)(per_byte / 100), (unsigned long long)(per_byte % 100),
+         stat->irq_max_cycles, stat->naks, stat->irq_idle,
+         perf->rxflvl_count, perf->inept_count, perf->outept_count, perf->sof_count);
+  usb_model_stat_reset();
+}
+
+/**
+  * @brief  run one script command
+  * @param  cmd: command
+  * @param  rest: text after the command
+  * @param  arg: numeric arguments
+  * @param  argc: number of arguments
+  * @retval negative on failure
+  */
+static int32_t script_command(const char *cmd, const char *rest, uint32_t *arg, uint32_t argc)
+{
+  uint8_t data[512];
+  uint32_t i_index;
+  int32_t ret = 0;
+
+  if(strcmp(cmd, "reset") == 0)
+  {
+    usb_model_bus_reset();
+  }
+  else if(strcmp(cmd, "enumerate") == 0)
+  {
+    ret = usb_model_enumerate();
+  }
+  else if(strcmp(cmd, "sof") == 0)
+  {
+    for(i_index = 0; i_index < (argc ? arg[0] : 1); i_index ++)
+    {
+      usb_model_sof();
+    }
+  }
+  else if(strcmp(cmd, "control") == 0)
+  {
+    if(argc < 5 || arg[4] > sizeof(data))
+    {
+      return USB_MODEL_ERROR;
+    }
+    memset(data, 0, sizeof(data));
+    ret = usb_model_control((uint8_t)arg[0], (uint8_t)arg[1], (uint16_t)arg[2], (uint16_t)arg[3],
+                            (uint16_t)arg[4], data);
+  }
+  else if(strcmp(cmd, "stats") == 0)
+  {
+    script_stats(rest);
+  }
+  else if(strcmp(cmd, "echo") == 0)
+  {
+    printf("%s\n", rest);
+  }
+  else
+  {
+    ret = usb_model_app_command(cmd, arg, argc);
+  }
+  return ret;
+}
+
+/**
+  * @brief  model program, runs the script named on the command line or
+  *         read from stdin against the class application
+  * @param  argc: argument count
+  * @param  argv: arguments
+  * @retval exit status
+  */
+int main(int argc, char **argv)
+{
+  char line[SCRIPT_LINE_MAX], *cmd, *rest, *token;
+  uint32_t arg[SCRIPT_ARG_MAX], num, line_num = 0;
+  FILE *fp = stdin;
+  int32_t ret;
+
+  if(argc > 1 && (fp = fopen(argv[1], "r")) == NULL)
+  {
+    perror(argv[1]);
+    return 1;
+  }
+
+  usb_model_init();
+  usb_model_app_init();
+  usb_model_stat_reset();
+  printf("%s model, %s core, counter: %s\n", usb_model_app_name(),
+         otg_core_struct.cfg.core_id == USB_HIGH_SPEED_CORE_ID ? "otghs" : "otgfs",
+         usb_model_counter_name());
+
+  while(fgets(line, sizeof(line), fp) != NULL)
+  {
+    line_num ++;
+    if((token = strchr(line, '#')) != NULL)
+    {
+      *token = 0;
+    }
+    line[strcspn(line, "\r\n")] = 0;
+    cmd = line + strspn(line, " \t");
+    if(*cmd == 0)
+    {
+      continue;
+    }
+    rest = cmd + strcspn(cmd, " \t");
+    if(*rest != 0)
+    {
+      *rest ++ = 0;
+      rest += strspn(rest, " \t");
+    }
+
+    num = 0;
+    if(strcmp(cmd, "echo") != 0 && strcmp(cmd, "stats") != 0)
+    {
+      for(token = strtok(rest, " \t"); token != NULL && num < SCRIPT_ARG_MAX; token = strtok(NULL, " \t"))
+      {
+        arg[num ++] = (uint32_t)strtoul(token, NULL, 0);
+      }
+    }
+
+    ret = script_command(cmd, rest, arg, num);
+    if(ret == USB_MODEL_UNKNOWN)
+    {
+      fprintf(stderr, "line %u: unknown command %s\n", line_num, cmd);
+      return 1;
+    }
+    if(ret < 0)
+    {
+      fprintf(stderr, "line %u: %s failed (%d)\n", line_num, cmd, ret);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,104 @@
+/**
+  **************************************************************************
+  * @file     usb_conf.h
+  * @brief    usb config header file for the host model build
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* define to prevent recursive inclusion -------------------------------------*/
+#ifndef __USB_CONF_H
+#define __USB_CONF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "at32f402_405_usb.h"
+#include "at32f402_405.h"
+#include "stdio.h"
+
+/** @addtogroup AT32F402_405_usb_host_model
+  * @{
+  */
+
+/**
+  * @brief enable usb host mode
+  */
+#define USE_OTG_HOST_MODE
+
+/**
+  * @brief otgfs define, the model only has the full speed host port
+  */
+#define USB_ID                           USB_OTG1_ID
+#define USB_SPEED_CORE_ID                USB_FULL_SPEED_CORE_ID
+
+/**
+  * @brief usb host mode config
+  */
+#ifdef USE_OTG_HOST_MODE
+#ifndef USB_HOST_CHANNEL_NUM
+#define USB_HOST_CHANNEL_NUM             16
+#endif
+
+/**
+  * @brief usb host mode fifo, same as the at_start usb host examples
+  */
+/* otg1 host fifo
+   otg fs fifo size is 1280 byte
+*/
+#define USBH_RX_FIFO_SIZE                128  /*this value is in terms of 4 bytes*/
+#define USBH_NP_TX_FIFO_SIZE             96   /*this value is in terms of 4 bytes*/
+#define USBH_P_TX_FIFO_SIZE              96   /*this value is in terms of 4 bytes*/
+
+/* otg2 host fifo
+   otg hs fifo size is 4096 byte
+*/
+#define USBH2_RX_FIFO_SIZE               256  /*this value is in terms of 4 bytes*/
+#define USBH2_NP_TX_FIFO_SIZE            256  /*this value is in terms of 4 bytes*/
+#define USBH2_P_TX_FIFO_SIZE             256  /*this value is in terms of 4 bytes*/
+#endif
+
+/**
+  * @brief usb vbus ignore, not use vbus pin
+  */
+#define USB_VBUS_IGNORE
+
+/**
+  * @brief usb host debug output, make EXTRA=-DUSBH_MODEL_DEBUG
+  */
+#ifdef USBH_MODEL_DEBUG
+#define USBH_DEBUG(...) printf(__VA_ARGS__);\
+                        printf("\r\n");
+#else
+#define USBH_DEBUG(...)
+#endif
+
+void usb_delay_ms(uint32_t ms);
+void usb_delay_us(uint32_t us);
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
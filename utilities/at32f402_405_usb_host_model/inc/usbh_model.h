@@ -0,0 +1,125 @@
+/**
+  **************************************************************************
+  * @file     usbh_model.h
+  * @brief    usb otg host register model header file
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* define to prevent recursive inclusion -------------------------------------*/
+#ifndef __USBH_MODEL_H
+#define __USBH_MODEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "usb_core.h"
+
+/** @addtogroup AT32F402_405_usb_host_model
+  * @{
+  */
+
+/** @defgroup USB_host_model_config
+  * @{
+  */
+
+#define USBH_MODEL_PKT_MAX               64          /*!< largest packet, full speed bulk and control */
+#define USBH_MODEL_RXQ_NUM               32          /*!< entries queued in the rx fifo */
+#define USBH_MODEL_TX_MAX                1024        /*!< out data queued on one channel */
+#define USBH_MODEL_EVENT_NUM             8           /*!< channel interrupts queued on one channel */
+#define USBH_MODEL_IRQ_LIMIT             100000      /*!< interrupts in one service call before a storm is reported */
+#define USBH_MODEL_IDLE_STEPS            64          /*!< service calls without bus traffic that end the frame */
+#define USBH_MODEL_FRAME_BYTES           1500        /*!< full speed frame, 12 mbit/s for 1 ms */
+#define USBH_MODEL_XACT_OVERHEAD         13          /*!< full speed bulk transaction overhead in bytes */
+
+#ifndef USBH_MODEL_BLOCK_SIZE
+#define USBH_MODEL_BLOCK_SIZE            512         /*!< block size of the simulated disk */
+#endif
+#define USBH_MODEL_DISK_SIZE             (4 * 1024 * 1024) /*!< bytes of the simulated disk */
+
+#define USBH_MODEL_NAK                   (-1)        /*!< device naked the transaction */
+#define USBH_MODEL_STALL                 (-2)        /*!< device stalled the transaction */
+
+/**
+  * @}
+  */
+
+/** @defgroup USB_host_model_types
+  * @{
+  */
+
+/**
+  * @brief statistics of the model, accumulated until usbh_model_stat_reset
+  */
+typedef struct
+{
+  uint32_t                               irq_count;               /*!< usbh_irq_handler calls           */
+  uint32_t                               irq_max_cycles;          /*!< longest usbh_irq_handler call    */
+  uint64_t                               irq_cycles;              /*!< cycles in usbh_irq_handler       */
+  uint64_t                               model_cycles;            /*!< cycles in the model itself       */
+  uint64_t                               bytes_out;               /*!< out data bytes, setup included   */
+  uint64_t                               bytes_in;                /*!< in data bytes                    */
+  uint64_t                               bus_bytes;               /*!< bus bytes with the overhead      */
+  uint32_t                               xacts;                   /*!< bus transactions                 */
+  uint32_t                               frames;                  /*!< frames ended                     */
+  uint32_t                               idle_frames;             /*!< frames ended without traffic     */
+} usbh_model_stat_type;
+
+/**
+  * @}
+  */
+
+/** @defgroup USB_host_model_exported_functions
+  * @{
+  */
+
+extern usbh_model_stat_type usbh_model_stat;
+extern uint8_t usbh_model_disk[USBH_MODEL_DISK_SIZE];
+
+void         usbh_model_init             (void);
+void         usbh_model_attach           (otg_core_type *otgdev);
+void         usbh_model_connect          (void);
+const char  *usbh_model_counter_name     (void);
+uint32_t     usbh_model_cycles           (void);
+void         usbh_model_stat_reset       (void);
+void         usbh_model_service          (void);
+urb_sts_type usbh_model_urb_status       (usbh_core_type *uhost, uint8_t ch_num);
+
+/* provided by the simulated device */
+void         usbh_model_dev_reset        (void);
+uint8_t      usbh_model_dev_address      (void);
+int32_t      usbh_model_dev_setup        (const uint8_t *setup);
+int32_t      usbh_model_dev_in           (uint8_t ept_num, uint8_t *data, uint16_t mps);
+int32_t      usbh_model_dev_out          (uint8_t ept_num, const uint8_t *data, uint16_t len);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,1024 @@
+/**
+  **************************************************************************
+  * @file     usbh_model.c
+  * @brief    usb otg host register model, the host stack runs on a linux host
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "usbh_model.h"
+#include "usbh_int.h"
+
+/** @addtogroup AT32F402_405_usb_host_model
+  * @{
+  */
+
+/** @defgroup USB_host_model
+  * @brief the model owns the otg host register image: port, channel
+  *        interrupt and fifo state lives in the model and is copied to the
+  *        image before the stack reads it. the driver functions that access
+  *        the fifo or clear global interrupt flags are replaced by the
+  *        model, everything else in the driver and in the stack is the
+  *        target code. the channels move data to and from the simulated
+  *        device one transaction at a time.
+  * @{
+  */
+
+/* host port change bits, write one to clear */
+#define MODEL_HPRT_CHG                   (USB_OTG_HPRT_PRTCONDET | USB_OTG_HPRT_PRTENCHNG | USB_OTG_HPRT_PRTOVRCCHNG)
+/* host port bits the core owns */
+#define MODEL_HPRT_CORE                  (USB_OTG_HPRT_PRTCONSTS | USB_OTG_HPRT_PRTENA | USB_OTG_HPRT_PRTOVRCACT | \
+                                          USB_OTG_HPRT_PRTLNSTS | USB_OTG_HPRT_PRTSPD | MODEL_HPRT_CHG)
+
+/* marks the channel interrupt value the model wrote, the stack clears
+   flags by writing them, any other value means the stack wrote */
+#define MODEL_HCINT_MARK                 ((uint32_t)0x80000000)
+
+#define MODEL_RXSTS(chn, len, sts)       ((uint32_t)(chn) | ((uint32_t)(len) << 4) | ((uint32_t)(sts) << 17))
+
+/**
+  * @brief register regions mapped at the target addresses
+  */
+static const struct
+{
+  uint32_t base;
+  uint32_t size;
+} model_region[] =
+{
+  {PERIPH_BASE,     0x00080000},  /* apb, ahb1 and the otghs core */
+  {AHBPERIPH2_BASE, 0x00040000},  /* otgfs core */
+  {SCS_BASE & 0xFFF00000, 0x00100000}, /* dwt, coredebug and nvic */
+  {0x1FFF0000,      0x00010000},  /* system memory, device id */
+};
+
+/**
+  * @brief channel state of the model
+  */
+typedef enum
+{
+  MODEL_CH_IDLE,                         /*!< halted or never enabled */
+  MODEL_CH_ACTIVE,                       /*!< enabled, issues transactions */
+  MODEL_CH_PAUSED,                       /*!< in packet received, waits for the stack to enable again */
+  MODEL_CH_DONE                          /*!< transfer finished, waits for the halt */
+} usbh_model_ch_state_type;
+
+/**
+  * @brief one host channel
+  */
+typedef struct
+{
+  usbh_model_ch_state_type state;
+  uint32_t event[USBH_MODEL_EVENT_NUM];
+  uint32_t ev_rd;
+  uint32_t ev_num;
+  uint32_t hcint_wr;
+  uint8_t  tx[USBH_MODEL_TX_MAX];
+  uint32_t tx_rd;
+  uint32_t tx_len;
+  uint32_t tx_words;
+} usbh_model_ch_type;
+
+/**
+  * @brief rx fifo entry, status word and packet data
+  */
+typedef struct
+{
+  uint32_t sts;
+  uint16_t len;
+  uint16_t offset;
+  uint8_t  data[USBH_MODEL_PKT_MAX];
+} usbh_model_rx_type;
+
+/**
+  * @brief model state
+  */
+static struct
+{
+  otg_core_type *otgdev;
+  otg_global_type *usbx;
+  uint32_t events;
+  uint32_t gintsts_wr;
+  uint32_t intsts;
+  uint32_t hprt_wr;
+  uint32_t hprt_chg;
+  uint8_t port_conn;
+  uint8_t port_ena;
+  uint8_t port_rst;
+  uint8_t in_service;
+  usbh_model_ch_type ch[USB_HOST_CHANNEL_NUM];
+  uint32_t ch_next;
+  uint32_t tx_words;
+  usbh_model_rx_type rxq[USBH_MODEL_RXQ_NUM];
+  uint32_t rx_rd;
+  uint32_t rx_num;
+  uint32_t rx_words;
+  uint16_t frame;
+  uint32_t frame_bytes;
+  uint32_t idle_steps;
+  int perf_fd;
+} model;
+
+uint32_t cmsis_host_primask;
+usbh_model_stat_type usbh_model_stat;
+
+/**
+  * @brief  report a model error and stop, the stack drove the core into a
+  *         state the hardware does not support
+  * @param  msg: error text
+  * @retval none
+  */
+static void model_fatal(const char *msg)
+{
+  fprintf(stderr, "usb host model: %s\n", msg);
+  exit(2);
+}
+
+/**
+  * @brief  drop the out data queued on one channel
+  * @param  chn: channel number
+  * @retval none
+  */
+static void model_tx_drop(uint32_t chn)
+{
+  usbh_model_ch_type *ch = &model.ch[chn];
+  model.tx_words -= ch->tx_words;
+  ch->tx_words = 0;
+  ch->tx_rd = 0;
+  ch->tx_len = 0;
+}
+
+/**
+  * @brief  flush the rx fifo
+  * @param  none
+  * @retval none
+  */
+static void model_rx_flush(void)
+{
+  model.rx_rd = 0;
+  model.rx_num = 0;
+  model.rx_words = 0;
+}
+
+/**
+  * @brief  push one entry to the rx fifo
+  * @param  sts: status word read from grxstsp
+  * @param  data: packet data
+  * @param  len: packet length
+  * @retval none
+  */
+static void model_rx_push(uint32_t sts, const uint8_t *data, uint16_t len)
+{
+  usbh_model_rx_type *rx = &model.rxq[(model.rx_rd + model.rx_num) % USBH_MODEL_RXQ_NUM];
+  rx->sts = sts;
+  rx->len = len;
+  rx->offset = 0;
+  if(len != 0)
+  {
+    memcpy(rx->data, data, len);
+  }
+  model.rx_num ++;
+  model.rx_words += 1 + (len + 3) / 4;
+}
+
+/**
+  * @brief  check that the rx fifo takes a packet and a completion entry
+  * @param  len: packet length
+  * @retval non zero when there is room
+  */
+static uint32_t model_rx_room(uint16_t len)
+{
+  uint32_t words = 2 + (len + 3) / 4;
+  return (model.rx_num + 2 <= USBH_MODEL_RXQ_NUM) &&
+         (model.rx_words + words <= (model.usbx->grxfsiz & 0xFFFF));
+}
+
+/**
+  * @brief  queue a channel interrupt, flags the stack masked are dropped
+  *         as the stack never clears them
+  * @param  chn: channel number
+  * @param  flag: channel interrupt flag
+  * @retval none
+  */
+static void model_ch_event(uint32_t chn, uint32_t flag)
+{
+  usbh_model_ch_type *ch = &model.ch[chn];
+
+  if((USB_CHL(model.usbx, chn)->hcintmsk & flag) == 0)
+  {
+    return;
+  }
+  if(ch->ev_num == USBH_MODEL_EVENT_NUM)
+  {
+    model_fatal("channel interrupt queue overflow");
+  }
+  ch->event[(ch->ev_rd + ch->ev_num) % USBH_MODEL_EVENT_NUM] = flag;
+  ch->ev_num ++;
+}
+
+/**
+  * @brief  pop the rx fifo entry the last interrupt reported, a transfer
+  *         completed entry raises the channel interrupt when it is popped
+  * @param  none
+  * @retval none
+  */
+static void model_rx_pop(void)
+{
+  usbh_model_rx_type *rx = &model.rxq[model.rx_rd];
+  uint32_t chn = rx->sts & USB_OTG_GRXSTSP_CHNUM;
+  uint32_t pktsts = (rx->sts & USB_OTG_GRXSTSP_PKTSTS) >> 17;
+
+  model.rx_words -= 1 + (rx->len + 3) / 4;
+  model.rx_rd = (model.rx_rd + 1) % USBH_MODEL_RXQ_NUM;
+  model.rx_num --;
+
+  if(pktsts == PKTSTS_IN_TRANSFER_COMPLETE)
+  {
+    model_ch_event(chn, USB_OTG_HC_XFERC_FLAG);
+  }
+}
+
+/**
+  * @brief  end the current frame, the start of frame interrupt of the next
+  *         one is raised
+  * @param  none
+  * @retval none
+  */
+static void model_frame_end(void)
+{
+  if(model.frame_bytes == 0)
+  {
+    usbh_model_stat.idle_frames ++;
+  }
+  usbh_model_stat.frames ++;
+  model.frame = (model.frame + 1) & 0x3FFF;
+  model.frame_bytes = 0;
+  model.idle_steps = 0;
+  model.events |= USB_OTG_SOF_FLAG;
+}
+
+/**
+  * @brief  apply the port register writes of the stack, the change bits
+  *         are write one to clear, the end of a port reset enables the port
+  * @param  none
+  * @retval none
+  */
+static void model_port_update(void)
+{
+  otg_host_type *host = OTG_HOST(model.usbx);
+  uint32_t value = host->hprt;
+
+  if(value != model.hprt_wr)
+  {
+    model.hprt_chg &= ~(value & MODEL_HPRT_CHG);
+    if(value & USB_OTG_HPRT_PRTENA)
+    {
+      model.port_ena = 0;
+    }
+    if(value & USB_OTG_HPRT_PRTRST)
+    {
+      model.port_rst = 1;
+      model.port_ena = 0;
+    }
+    else if(model.port_rst)
+    {
+      model.port_rst = 0;
+      if(model.port_conn)
+      {
+        model.port_ena = 1;
+        model.hprt_chg |= USB_OTG_HPRT_PRTENCHNG;
+        usbh_model_dev_reset();
+      }
+    }
+  }
+
+  value = (value & ~MODEL_HPRT_CORE) | model.hprt_chg;
+  if(model.port_conn)
+  {
+    value |= USB_OTG_HPRT_PRTCONSTS | ((uint32_t)USB_PRTSPD_FULL_SPEED << 17);
+  }
+  if(model.port_ena)
+  {
+    value |= USB_OTG_HPRT_PRTENA;
+  }
+  host->hprt = value;
+  model.hprt_wr = value;
+}
+
+/**
+  * @brief  the port handler writes back the change bits it read, a write
+  *         of the value the model wrote is not visible in the image, so the
+  *         change bits clear once the handler took the port interrupt
+  * @param  none
+  * @retval none
+  */
+static void model_port_ack(void)
+{
+  otg_host_type *host = OTG_HOST(model.usbx);
+
+  if(host->hprt == model.hprt_wr)
+  {
+    model.hprt_chg &= ~(model.hprt_wr & MODEL_HPRT_CHG);
+  }
+}
+
+/**
+  * @brief  apply the channel register writes of the stack: a written
+  *         interrupt value clears the reported flag, channel enable starts
+  *         or resumes the transfer and channel disable halts it
+  * @param  chn: channel number
+  * @retval none
+  */
+static void model_ch_update(uint32_t chn)
+{
+  otg_hchannel_type *hch = USB_CHL(model.usbx, chn);
+  usbh_model_ch_type *ch = &model.ch[chn];
+  uint32_t value;
+
+  value = hch->hcint;
+  if(value != ch->hcint_wr)
+  {
+    if(value == 0xFFFFFFFF)
+    {
+      ch->ev_num = 0;
+    }
+    else if(ch->ev_num != 0)
+    {
+      ch->ev_rd = (ch->ev_rd + 1) % USBH_MODEL_EVENT_NUM;
+      ch->ev_num --;
+    }
+  }
+
+  value = hch->hcchar;
+  if((value & USB_OTG_HCCHAR_CHENA) && (value & USB_OTG_HCCHAR_CHDIS))
+  {
+    ch->state = MODEL_CH_IDLE;
+    model_tx_drop(chn);
+    model_ch_event(chn, USB_OTG_HC_CHHLTD_FLAG);
+  }
+  else if(value & USB_OTG_HCCHAR_CHENA)
+  {
+    if(ch->state != MODEL_CH_ACTIVE && (hch->hctsiz & USB_OTG_HCTSIZ_PKTCNT) != 0)
+    {
+      ch->state = MODEL_CH_ACTIVE;
+    }
+  }
+  value &= ~(USB_OTG_HCCHAR_CHENA | USB_OTG_HCCHAR_CHDIS);
+  if(ch->state == MODEL_CH_ACTIVE)
+  {
+    value |= USB_OTG_HCCHAR_CHENA;
+  }
+  hch->hcchar = value;
+
+  value = ch->ev_num ? (ch->event[ch->ev_rd] | MODEL_HCINT_MARK) : 0;
+  hch->hcint = value;
+  ch->hcint_wr = value;
+}
+
+/**
+  * @brief  apply the register writes of the stack and copy the model state
+  *         to the register image. a status register that reads back other
+  *         than the model wrote it was written by the stack, the written
+  *         value clears flags (write one to clear).
+  * @param  none
+  * @retval none
+  */
+static void model_update(void)
+{
+  otg_global_type *usbx = model.usbx;
+  otg_host_type *host = OTG_HOST(usbx);
+  uint32_t i_index, value, haint = 0;
+
+  value = usbx->gintsts;
+  if(value != model.gintsts_wr)
+  {
+    model.events &= ~value;
+  }
+
+  /* reset and flush finish at once */
+  value = usbx->grstctl;
+  if(value & 0x20)
+  {
+    for(i_index = 0; i_index < USB_HOST_CHANNEL_NUM; i_index ++)
+    {
+      model_tx_drop(i_index);
+    }
+  }
+  if(value & 0x10)
+  {
+    model_rx_flush();
+  }
+  usbx->grstctl = (value & ~0x37UL) | 0x80000000;
+
+  model_port_update();
+
+  for(i_index = 0; i_index < USB_HOST_CHANNEL_NUM; i_index ++)
+  {
+    model_ch_update(i_index);
+    if(model.ch[i_index].ev_num != 0)
+    {
+      haint |= 1 << i_index;
+    }
+  }
+  host->haint = haint;
+  host->hfnum = model.frame;
+
+  /* non-periodic tx fifo space in words and free request queue entries */
+  value = usbx->gnptxfsiz_ept0tx >> 16;
+  value = value > model.tx_words ? value - model.tx_words : 0;
+  usbx->gnptxsts = value | (8 << 16);
+
+  value = model.events | 1;
+  if(model.rx_num != 0)
+  {
+    value |= USB_OTG_RXFLVL_FLAG;
+    usbx->grxstsp = model.rxq[model.rx_rd].sts;
+  }
+  if(haint & host->haintmsk)
+  {
+    value |= USB_OTG_HCH_FLAG;
+  }
+  if(model.hprt_chg)
+  {
+    value |= USB_OTG_PRT_FLAG;
+  }
+  usbx->gintsts = value;
+  model.gintsts_wr = value;
+}
+
+/**
+  * @brief  check that a transaction fits the rest of the frame, a
+  *         transaction that does not fit ends it
+  * @param  len: largest data bytes of the transaction
+  * @retval non zero when the transaction fits the current frame
+  */
+static uint32_t model_bus_fit(uint32_t len)
+{
+  if(model.frame_bytes + len + USBH_MODEL_XACT_OVERHEAD > USBH_MODEL_FRAME_BYTES)
+  {
+    model_frame_end();
+    return 0;
+  }
+  return 1;
+}
+
+/**
+  * @brief  account one transaction on the bus
+  * @param  len: data bytes of the transaction
+  * @retval none
+  */
+static void model_bus_add(uint32_t len)
+{
+  model.frame_bytes += len + USBH_MODEL_XACT_OVERHEAD;
+  usbh_model_stat.bus_bytes += len + USBH_MODEL_XACT_OVERHEAD;
+  usbh_model_stat.xacts ++;
+}
+
+/**
+  * @brief  end a channel transfer with a flag, the channel waits for the
+  *         halt of the stack
+  * @param  chn: channel number
+  * @param  flag: channel interrupt flag, 0 when it comes from the rx fifo
+  * @retval none
+  */
+static void model_ch_finish(uint32_t chn, uint32_t flag)
+{
+  model.ch[chn].state = MODEL_CH_DONE;
+  model_tx_drop(chn);
+  if(flag != 0)
+  {
+    model_ch_event(chn, flag);
+  }
+}
+
+/**
+  * @brief  one in transaction of a channel, the packet goes to the rx
+  *         fifo, the last one with the transfer completed entry
+  * @param  chn: channel number
+  * @retval non zero when the bus moved
+  */
+static uint32_t model_ch_in(uint32_t chn)
+{
+  otg_hchannel_type *hch = USB_CHL(model.usbx, chn);
+  uint32_t hcchar = hch->hcchar, hctsiz = hch->hctsiz;
+  uint32_t mps = hcchar & USB_OTG_HCCHAR_MPS;
+  uint32_t pktcnt = (hctsiz & USB_OTG_HCTSIZ_PKTCNT) >> 19;
+  uint32_t xfersize = hctsiz & USB_OTG_HCTSIZ_XFERSIZE;
+  uint8_t data[USBH_MODEL_PKT_MAX];
+  int32_t len;
+
+  if(mps > USBH_MODEL_PKT_MAX)
+  {
+    model_fatal("channel max packet size above the full speed limit");
+  }
+  if(!model_rx_room((uint16_t)mps))
+  {
+    return 0;
+  }
+  if(!model_bus_fit(mps))
+  {
+    return 1;
+  }
+
+  len = usbh_model_dev_in((uint8_t)((hcchar & USB_OTG_HCCHAR_EPTNUM) >> 11), data, (uint16_t)mps);
+  model_bus_add(len > 0 ? (uint32_t)len : 0);
+  if(len == USBH_MODEL_NAK || len == USBH_MODEL_STALL)
+  {
+    model_ch_finish(chn, len == USBH_MODEL_NAK ? USB_OTG_HC_NAK_FLAG : USB_OTG_HC_STALL_FLAG);
+    return 1;
+  }
+  if((uint32_t)len > xfersize)
+  {
+    model_fatal("device sent more than the channel transfer size");
+  }
+
+  usbh_model_stat.bytes_in += len;
+  pktcnt --;
+  xfersize -= len;
+  /* a short packet ends the transfer */
+  if((uint32_t)len < mps)
+  {
+    pktcnt = 0;
+  }
+  hch->hctsiz = (hctsiz & ~(USB_OTG_HCTSIZ_PKTCNT | USB_OTG_HCTSIZ_XFERSIZE)) | (pktcnt << 19) | xfersize;
+
+  model_rx_push(MODEL_RXSTS(chn, len, PKTSTS_IN_DATA_PACKET_RECV), data, (uint16_t)len);
+  if(pktcnt == 0)
+  {
+    model_rx_push(MODEL_RXSTS(chn, 0, PKTSTS_IN_TRANSFER_COMPLETE), 0, 0);
+    model_ch_finish(chn, 0);
+  }
+  else
+  {
+    model.ch[chn].state = MODEL_CH_PAUSED;
+  }
+  return 1;
+}
+
+/**
+  * @brief  one out or setup transaction of a channel, the data comes from
+  *         the tx fifo the stack wrote
+  * @param  chn: channel number
+  * @retval non zero when the bus moved
+  */
+static uint32_t model_ch_out(uint32_t chn)
+{
+  otg_hchannel_type *hch = USB_CHL(model.usbx, chn);
+  usbh_model_ch_type *ch = &model.ch[chn];
+  uint32_t hcchar = hch->hcchar, hctsiz = hch->hctsiz;
+  uint32_t mps = hcchar & USB_OTG_HCCHAR_MPS;
+  uint32_t pktcnt = (hctsiz & USB_OTG_HCTSIZ_PKTCNT) >> 19;
+  uint32_t xfersize = hctsiz & USB_OTG_HCTSIZ_XFERSIZE;
+  uint32_t len = xfersize < mps ? xfersize : mps;
+  int32_t ret;
+
+  /* the stack writes the fifo after it enabled the channel */
+  if(ch->tx_len - ch->tx_rd < len)
+  {
+    return 0;
+  }
+  if(!model_bus_fit(len))
+  {
+    return 1;
+  }
+  model_bus_add(len);
+
+  if(((hctsiz & USB_OTG_HCTSIZ_PID) >> 29) == HCH_PID_SETUP &&
+     ((hcchar & USB_OTG_HCCHAR_EPTYPE) >> 18) == EPT_CONTROL_TYPE)
+  {
+    if(len != 8)
+    {
+      model_fatal("setup packet is not 8 bytes");
+    }
+    ret = usbh_model_dev_setup(&ch->tx[ch->tx_rd]);
+  }
+  else
+  {
+    ret = usbh_model_dev_out((uint8_t)((hcchar & USB_OTG_HCCHAR_EPTNUM) >> 11), &ch->tx[ch->tx_rd], (uint16_t)len);
+  }
+  if(ret == USBH_MODEL_NAK || ret == USBH_MODEL_STALL)
+  {
+    model_ch_finish(chn, ret == USBH_MODEL_NAK ? USB_OTG_HC_NAK_FLAG : USB_OTG_HC_STALL_FLAG);
+    return 1;
+  }
+
+  usbh_model_stat.bytes_out += len;
+  ch->tx_rd += len;
+  pktcnt --;
+  xfersize -= len;
+  hch->hctsiz = (hctsiz & ~(USB_OTG_HCTSIZ_PKTCNT | USB_OTG_HCTSIZ_XFERSIZE)) | (pktcnt << 19) | xfersize;
+  if(pktcnt == 0)
+  {
+    model_ch_finish(chn, USB_OTG_HC_XFERC_FLAG);
+  }
+  return 1;
+}
+
+/**
+  * @brief  one transaction of the next active channel, round robin
+  * @param  none
+  * @retval non zero when the bus moved
+  */
+static uint32_t model_bus_step(void)
+{
+  otg_hchannel_type *hch;
+  uint32_t i_index, chn;
+
+  if(!model.port_ena)
+  {
+    return 0;
+  }
+  for(i_index = 0; i_index < USB_HOST_CHANNEL_NUM; i_index ++)
+  {
+    chn = (model.ch_next + i_index) % USB_HOST_CHANNEL_NUM;
+    if(model.ch[chn].state != MODEL_CH_ACTIVE)
+    {
+      continue;
+    }
+    hch = USB_CHL(model.usbx, chn);
+    if(((hch->hcchar & USB_OTG_HCCHAR_DEVADDR) >> 22) != usbh_model_dev_address())
+    {
+      model_fatal("token to an address the device does not have");
+    }
+    if((hch->hcchar & USB_OTG_HCCHAR_EPTDIR) ? model_ch_in(chn) : model_ch_out(chn))
+    {
+      model.ch_next = chn + 1;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+  * @brief  the driver functions below replace the ones of
+  *         at32f402_405_usb.c that touch the fifo or clear global interrupt
+  *         flags, the makefile renames the driver versions
+  */
+
+/**
+  * @brief  get all global core interrupt flag
+  * @param  usbx: to select the otgfs peripheral.
+  * @retval intterupt flag
+  */
+uint32_t usb_global_get_all_interrupt(otg_global_type *usbx)
+{
+  uint32_t intsts = usbx->gintsts & usbx->gintmsk;
+  /* the flags the handler saw in this call, the service pops the rx fifo
+     entry when the rx level interrupt was among them */
+  model.intsts |= intsts;
+  return intsts;
+}
+
+/**
+  * @brief  clear the global interrupt flag
+  * @param  usbx: to select the otgfs peripheral.
+  * @param  flag: interrupt flag
+  * @retval none
+  */
+void usb_global_clear_interrupt(otg_global_type *usbx, uint32_t flag)
+{
+  model.events &= ~flag;
+  usbx->gintsts &= ~flag;
+  model.gintsts_wr = usbx->gintsts;
+}
+
+/**
+  * @brief  flush tx fifo
+  * @param  usbx: to select the otgfs peripheral.
+  * @param  fifo_num: tx fifo num,when fifo_num=16,flush all tx fifo
+  * @retval none
+  */
+void usb_flush_tx_fifo(otg_global_type *usbx, uint32_t fifo_num)
+{
+  uint32_t i_index;
+  (void)fifo_num;
+  for(i_index = 0; i_index < USB_HOST_CHANNEL_NUM; i_index ++)
+  {
+    model_tx_drop(i_index);
+  }
+}
+
+/**
+  * @brief  flush rx fifo
+  * @param  usbx: to select the otgfs peripheral.
+  * @retval none
+  */
+void usb_flush_rx_fifo(otg_global_type *usbx)
+{
+  model_rx_flush();
+}
+
+/**
+  * @brief  write data from user memory to usb buffer, the host writes the
+  *         data of a channel to the non-periodic tx fifo
+  * @param  usbx: to select the otgfs peripheral.
+  * @param  pusr_buf: point to user buffer
+  * @param  num: channel number
+  * @param  nbytes: number of bytes count
+  * @retval none
+  */
+void usb_write_packet(otg_global_type *usbx, uint8_t *pusr_buf, uint16_t num, uint16_t nbytes)
+{
+  usbh_model_ch_type *ch = &model.ch[num];
+  uint32_t words = (nbytes + 3) / 4;
+
+  if(num >= USB_HOST_CHANNEL_NUM || ch->tx_len + nbytes > USBH_MODEL_TX_MAX ||
+     model.tx_words + words > (usbx->gnptxfsiz_ept0tx >> 16))
+  {
+    model_fatal("tx fifo overflow");
+  }
+  memcpy(&ch->tx[ch->tx_len], pusr_buf, nbytes);
+  ch->tx_len += nbytes;
+  ch->tx_words += words;
+  model.tx_words += words;
+}
+
+/**
+  * @brief  read data from usb buffer to user buffer
+  * @param  usbx: to select the otgfs peripheral.
+  * @param  pusr_buf: point to user buffer
+  * @param  num: channel number
+  * @param  nbytes: number of bytes count
+  * @retval none
+  */
+void usb_read_packet(otg_global_type *usbx, uint8_t *pusr_buf, uint16_t num, uint16_t nbytes)
+{
+  usbh_model_rx_type *rx = &model.rxq[model.rx_rd];
+
+  if(model.rx_num == 0 || rx->offset + nbytes > rx->len)
+  {
+    model_fatal("read beyond the rx fifo entry");
+  }
+  memcpy(pusr_buf, rx->data + rx->offset, nbytes);
+  rx->offset += nbytes;
+}
+
+/**
+  * @brief  name of the counter behind usbh_model_cycles
+  * @param  none
+  * @retval counter name
+  */
+const char *usbh_model_counter_name(void)
+{
+  if(model.perf_fd >= 0)
+  {
+    return "instructions";
+  }
+#if defined(__x86_64__) || defined(__i386__)
+  return "tsc cycles";
+#else
+  return "ns";
+#endif
+}
+
+/**
+  * @brief  read the host counter, retired user instructions when the
+  *         kernel provides them, the time stamp counter otherwise
+  * @param  none
+  * @retval counter value
+  */
+uint32_t usbh_model_cycles(void)
+{
+  uint64_t count;
+#if !defined(__x86_64__) && !defined(__i386__)
+  struct timespec ts;
+#endif
+
+  if(model.perf_fd >= 0 && read(model.perf_fd, &count, sizeof(count)) == sizeof(count))
+  {
+    return (uint32_t)count;
+  }
+#if defined(__x86_64__) || defined(__i386__)
+  count = __rdtsc();
+#else
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  count = (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+#endif
+  return (uint32_t)count;
+}
+
+/**
+  * @brief  usb delay, the model applies the register writes so a port
+  *         reset is seen between set and clear
+  * @param  ms: delay number in milliseconds
+  * @retval none
+  */
+void usb_delay_ms(uint32_t ms)
+{
+  (void)ms;
+  if(model.usbx != 0)
+  {
+    model_update();
+  }
+}
+
+/**
+  * @brief  usb delay, the model core finishes everything at once
+  * @param  us: delay number in microseconds
+  * @retval none
+  */
+void usb_delay_us(uint32_t us)
+{
+  (void)us;
+}
+
+/**
+  * @brief  map the register regions and open the counter, called before
+  *         any driver code runs
+  * @param  none
+  * @retval none
+  */
+void usbh_model_init(void)
+{
+  uint32_t i_index;
+  void *addr;
+
+  for(i_index = 0; i_index < sizeof(model_region) / sizeof(model_region[0]); i_index ++)
+  {
+    addr = mmap((void *)(uintptr_t)model_region[i_index].base, model_region[i_index].size,
+                PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if(addr != (void *)(uintptr_t)model_region[i_index].base)
+    {
+      model_fatal("register region can not be mapped at its target address");
+    }
+  }
+
+  model.perf_fd = -1;
+#ifdef __linux__
+  {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    if(getenv("USB_MODEL_TSC") == NULL)
+    {
+      model.perf_fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+  }
+#endif
+}
+
+/**
+  * @brief  attach the model to the core the application initialized
+  * @param  otgdev: to the structure of otg_core_type
+  * @retval none
+  */
+void usbh_model_attach(otg_core_type *otgdev)
+{
+  model.otgdev = otgdev;
+  model.usbx = otgdev->usb_reg;
+  model_update();
+}
+
+/**
+  * @brief  plug the simulated device into the host port
+  * @param  none
+  * @retval none
+  */
+void usbh_model_connect(void)
+{
+  model.port_conn = 1;
+  model.hprt_chg |= USB_OTG_HPRT_PRTCONDET;
+  usbh_model_dev_reset();
+}
+
+/**
+  * @brief  clear the statistics, the bus time starts with a new frame
+  * @param  none
+  * @retval none
+  */
+void usbh_model_stat_reset(void)
+{
+  if(model.frame_bytes != 0)
+  {
+    model_frame_end();
+  }
+  memset(&usbh_model_stat, 0, sizeof(usbh_model_stat));
+}
+
+/**
+  * @brief  run the interrupt handler while an unmasked interrupt is
+  *         pending and the channels while they move data, until both are
+  *         idle. calls without traffic count towards the end of the frame
+  *         so the stack timers run while it waits.
+  * @param  none
+  * @retval none
+  */
+void usbh_model_service(void)
+{
+  otg_global_type *usbx = model.usbx;
+  uint32_t loop, start, cycles, irq_cycles = 0, busy = 0;
+
+  if(model.in_service)
+  {
+    return;
+  }
+  model.in_service = 1;
+  start = usbh_model_cycles();
+
+  for(loop = 0; loop < USBH_MODEL_IRQ_LIMIT; loop ++)
+  {
+    model_update();
+    if(usbx->gahbcfg_bit.glbintmsk && cmsis_host_primask == 0 &&
+       (usbx->gintsts & usbx->gintmsk) != 0)
+    {
+      model.intsts = 0;
+      cycles = usbh_model_cycles();
+      usbh_irq_handler(model.otgdev);
+      cycles = usbh_model_cycles() - cycles;
+      irq_cycles += cycles;
+      usbh_model_stat.irq_count ++;
+      usbh_model_stat.irq_cycles += cycles;
+      if(cycles > usbh_model_stat.irq_max_cycles)
+      {
+        usbh_model_stat.irq_max_cycles = cycles;
+      }
+      if(model.intsts & USB_OTG_RXFLVL_FLAG)
+      {
+        model_rx_pop();
+      }
+      if(model.intsts & USB_OTG_PRT_FLAG)
+      {
+        model_port_ack();
+      }
+      busy = 1;
+      continue;
+    }
+    if(model_bus_step())
+    {
+      busy = 1;
+      continue;
+    }
+    break;
+  }
+  if(loop == USBH_MODEL_IRQ_LIMIT)
+  {
+    model_fatal("interrupt storm");
+  }
+
+  if(busy)
+  {
+    model.idle_steps = 0;
+  }
+  else if(++ model.idle_steps >= USBH_MODEL_IDLE_STEPS)
+  {
+    model_frame_end();
+  }
+
+  usbh_model_stat.model_cycles += (uint32_t)(usbh_model_cycles() - start) - irq_cycles;
+  model.in_service = 0;
+}
+
+/**
+  * @brief  usbh_get_urb_status of the class drivers, the makefile renames
+  *         their calls to this one. the stack polls the status in busy
+  *         loops where the target takes interrupts, the model runs there.
+  * @param  uhost: to the structure of usbh_core_type
+  * @param  ch_num: channel number
+  * @retval urb_sts_type
+  */
+urb_sts_type usbh_model_urb_status(usbh_core_type *uhost, uint8_t ch_num)
+{
+  usbh_model_service();
+  return usbh_get_urb_status(uhost, ch_num);
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
@@ -0,0 +1,347 @@
+/**
+  **************************************************************************
+  * @file     usbh_model_bench.c
+  * @brief    throughput and cycles of the host stack and the msc class against the simulated disk
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "usbh_model.h"
+#include "usbh_core.h"
+#include "usbh_msc_class.h"
+
+/** @addtogroup AT32F402_405_usb_host_model
+  * @{
+  */
+
+/** @defgroup USB_host_model_bench
+  * @brief enumerates the simulated disk with the host stack and the msc
+  *        class, then writes and reads it back in requests of
+  *        BENCH_REQ_SIZE bytes. with USBH_MSC_QUEUE the same data also
+  *        goes through usbh_msc_submit with BENCH_QUEUE_NUM requests in
+  *        flight.
+  * @{
+  */
+
+#define BENCH_REQ_SIZE                   (4 * 1024)
+#define BENCH_TOTAL_SIZE                 (1024 * 1024)
+#define BENCH_QUEUE_NUM                  USBH_MSC_QUEUE_DEPTH
+#define BENCH_ENUM_LOOPS                 1000000
+
+static usb_sts_type bench_user_ok(void);
+static usb_sts_type bench_user_speed(uint8_t speed);
+static usb_sts_type bench_user_string(void *string);
+static usb_sts_type bench_user_active_vbus(void *uhost, confirm_state state);
+
+static usbh_user_handler_type bench_user_handle =
+{
+  bench_user_ok,
+  bench_user_ok,
+  bench_user_ok,
+  bench_user_ok,
+  bench_user_speed,
+  bench_user_string,
+  bench_user_string,
+  bench_user_string,
+  bench_user_ok,
+  bench_user_ok,
+  bench_user_active_vbus,
+  bench_user_ok,
+};
+
+otg_core_type otg_core_struct;
+
+static uint8_t bench_buf[BENCH_TOTAL_SIZE];
+static uint32_t bench_blk_size;
+static uint32_t bench_start;
+
+/**
+  * @brief  usb host user handler, nothing to do on the host
+  * @param  none
+  * @retval usb_sts_type
+  */
+static usb_sts_type bench_user_ok(void)
+{
+  return USB_OK;
+}
+
+/**
+  * @brief  usb host speed user handler
+  * @param  speed: port speed
+  * @retval usb_sts_type
+  */
+static usb_sts_type bench_user_speed(uint8_t speed)
+{
+  (void)speed;
+  return USB_OK;
+}
+
+/**
+  * @brief  usb host string user handler
+  * @param  string: string
+  * @retval usb_sts_type
+  */
+static usb_sts_type bench_user_string(void *string)
+{
+  (void)string;
+  return USB_OK;
+}
+
+/**
+  * @brief  usb host vbus user handler
+  * @param  uhost: to the structure of usbh_core_type
+  * @param  state: vbus state
+  * @retval usb_sts_type
+  */
+static usb_sts_type bench_user_active_vbus(void *uhost, confirm_state state)
+{
+  (void)uhost;
+  (void)state;
+  return USB_OK;
+}
+
+/**
+  * @brief  fill the buffer with a pattern that depends on the pass
+  * @param  seed: pass number
+  * @retval none
+  */
+static void bench_fill(uint32_t seed)
+{
+  uint32_t i_index;
+  for(i_index = 0; i_index < BENCH_TOTAL_SIZE; i_index ++)
+  {
+    bench_buf[i_index] = (uint8_t)((i_index >> 2) * 7 + i_index + seed * 13);
+  }
+}
+
+/**
+  * @brief  check the buffer and the disk against the pattern
+  * @param  seed: pass number
+  * @param  name: benchmark name
+  * @retval 0 when the data matches
+  */
+static int32_t bench_check(uint32_t seed, const char *name)
+{
+  uint32_t i_index;
+  uint8_t value;
+  for(i_index = 0; i_index < BENCH_TOTAL_SIZE; i_index ++)
+  {
+    value = (uint8_t)((i_index >> 2) * 7 + i_index + seed * 13);
+    if(bench_buf[i_index] != value || usbh_model_disk[i_index] != value)
+    {
+      printf("%s: data mismatch at byte %u\n", name, i_index);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/**
+  * @brief  start a measurement
+  * @param  none
+  * @retval none
+  */
+static void bench_begin(void)
+{
+  usbh_model_stat_reset();
+  bench_start = usbh_model_cycles();
+}
+
+/**
+  * @brief  print the statistics since bench_begin
+  * @param  name: benchmark name
+  * @param  bytes: data bytes the benchmark moved
+  * @retval none
+  */
+static void bench_report(const char *name, uint32_t bytes)
+{
+  usbh_model_stat_type *stat = &usbh_model_stat;
+  uint64_t total = (uint32_t)(usbh_model_cycles() - bench_start);
+  uint64_t stack = total > stat->model_cycles ? total - stat->model_cycles : 0;
+  double ms = stat->frames;
+
+  /* a run shorter than one frame counts by its bus bytes */
+  if(stat->frames == 0)
+  {
+    ms = (double)stat->bus_bytes / USBH_MODEL_FRAME_BYTES;
+  }
+  printf("%-14s %8u bytes %6u frames %5u idle %6.3f MB/s bus %7u irqs %7.1f cycles/byte %7.1f irq/byte\n",
+         name, bytes, stat->frames, stat->idle_frames,
+         ms > 0 ? bytes / ms / 1000.0 : 0.0, stat->irq_count,
+         (double)stack / bytes, (double)stat->irq_cycles / bytes);
+}
+
+/**
+  * @brief  sequential write and read with the blocking class calls
+  * @param  none
+  * @retval 0 when the data verified
+  */
+static int32_t bench_sync(void)
+{
+  uint32_t offset, blocks = BENCH_REQ_SIZE / bench_blk_size;
+
+  bench_fill(1);
+  bench_begin();
+  for(offset = 0; offset < BENCH_TOTAL_SIZE; offset += BENCH_REQ_SIZE)
+  {
+    if(usbh_msc_write(&otg_core_struct.host, offset / bench_blk_size, blocks, &bench_buf[offset], 0) != USB_OK)
+    {
+      printf("sync write: failed at byte %u\n", offset);
+      return -1;
+    }
+  }
+  bench_report("sync write", BENCH_TOTAL_SIZE);
+
+  memset(bench_buf, 0, sizeof(bench_buf));
+  bench_begin();
+  for(offset = 0; offset < BENCH_TOTAL_SIZE; offset += BENCH_REQ_SIZE)
+  {
+    if(usbh_msc_read(&otg_core_struct.host, offset / bench_blk_size, blocks, &bench_buf[offset], 0) != USB_OK)
+    {
+      printf("sync read: failed at byte %u\n", offset);
+      return -1;
+    }
+  }
+  bench_report("sync read", BENCH_TOTAL_SIZE);
+  return bench_check(1, "sync");
+}
+
+#ifdef USBH_MSC_QUEUE
+/**
+  * @brief  write or read the buffer with BENCH_QUEUE_NUM requests in
+  *         flight, contiguous requests merge into one bot transfer
+  * @param  dir: USBH_MSC_DIR_READ or USBH_MSC_DIR_WRITE
+  * @retval 0 when every request completed
+  */
+static int32_t bench_queue_pass(uint8_t dir)
+{
+  uint8_t handle[BENCH_QUEUE_NUM];
+  uint32_t offset, num, i_index, blocks = BENCH_REQ_SIZE / bench_blk_size;
+
+  for(offset = 0; offset < BENCH_TOTAL_SIZE; offset += num * BENCH_REQ_SIZE)
+  {
+    for(num = 0; num < BENCH_QUEUE_NUM && offset + num * BENCH_REQ_SIZE < BENCH_TOTAL_SIZE; num ++)
+    {
+      if(usbh_msc_submit(&otg_core_struct.host, dir, (offset + num * BENCH_REQ_SIZE) / bench_blk_size,
+                         blocks, &bench_buf[offset + num * BENCH_REQ_SIZE], 0, &handle[num]) != USB_OK)
+      {
+        printf("queue submit: failed at byte %u\n", offset + num * BENCH_REQ_SIZE);
+        return -1;
+      }
+    }
+    for(i_index = 0; i_index < num; i_index ++)
+    {
+      if(usbh_msc_wait(&otg_core_struct.host, handle[i_index]) != USB_OK)
+      {
+        printf("queue wait: failed at byte %u\n", offset + i_index * BENCH_REQ_SIZE);
+        return -1;
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+  * @brief  pipelined write and read through the request queue
+  * @param  none
+  * @retval 0 when the data verified
+  */
+static int32_t bench_queue(void)
+{
+  bench_fill(2);
+  bench_begin();
+  if(bench_queue_pass(USBH_MSC_DIR_WRITE) != 0)
+  {
+    return -1;
+  }
+  bench_report("queue write", BENCH_TOTAL_SIZE);
+
+  memset(bench_buf, 0, sizeof(bench_buf));
+  bench_begin();
+  if(bench_queue_pass(USBH_MSC_DIR_READ) != 0)
+  {
+    return -1;
+  }
+  bench_report("queue read", BENCH_TOTAL_SIZE);
+  return bench_check(2, "queue");
+}
+#endif
+
+/**
+  * @brief  main function.
+  * @param  none
+  * @retval exit code
+  */
+int main(void)
+{
+  usbh_core_type *uhost = &otg_core_struct.host;
+  uint32_t loop;
+
+  usbh_model_init();
+  usbh_init(&otg_core_struct, USB_SPEED_CORE_ID, USB_ID, &uhost_msc_class_handler, &bench_user_handle);
+  usbh_model_attach(&otg_core_struct);
+  usbh_model_connect();
+
+  bench_begin();
+  for(loop = 0; uhost->global_state != USBH_CLASS || usbh_msc.state != USBH_MSC_IDLE; loop ++)
+  {
+    if(loop == BENCH_ENUM_LOOPS || uhost->global_state == USBH_ERROR_STATE ||
+       uhost->global_state == USBH_UNSUPPORT)
+    {
+      printf("enumeration failed, host state %u msc state %u\n", uhost->global_state, usbh_msc.state);
+      return 1;
+    }
+    usbh_loop_handler(uhost);
+    usbh_model_service();
+  }
+  bench_blk_size = usbh_msc.l_unit_n[0].capacity.blk_size;
+  printf("counter: %s, disk %u blocks of %u bytes, %u byte requests\n", usbh_model_counter_name(),
+         usbh_msc.l_unit_n[0].capacity.blk_nbr, bench_blk_size, BENCH_REQ_SIZE);
+  bench_report("enumeration", (uint32_t)usbh_model_stat.bytes_in + (uint32_t)usbh_model_stat.bytes_out);
+
+  if(bench_blk_size == 0 || BENCH_REQ_SIZE % bench_blk_size != 0)
+  {
+    printf("block size %u does not divide the request size\n", bench_blk_size);
+    return 1;
+  }
+  if(bench_sync() != 0)
+  {
+    return 1;
+  }
+#ifdef USBH_MSC_QUEUE
+  if(bench_queue() != 0)
+  {
+    return 1;
+  }
+#endif
+  printf("data verified\n");
+  return 0;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
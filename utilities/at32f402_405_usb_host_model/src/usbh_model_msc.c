@@ -0,0 +1,539 @@
+/**
+  **************************************************************************
+  * @file     usbh_model_msc.c
+  * @brief    simulated bulk only transport device on the host model bus
+  **************************************************************************
+  *                       Copyright notice & Disclaimer
+  *
+  * The software Board Support Package (BSP) that is made available to
+  * download from Artery official website is the copyrighted work of Artery.
+  * Artery authorizes customers to use, copy, and distribute the BSP
+  * software and its related documentation for the purpose of design and
+  * development in conjunction with Artery microcontrollers. Use of the
+  * software is governed by this copyright notice and the following disclaimer.
+  *
+  * THIS SOFTWARE IS PROVIDED ON "AS IS" BASIS WITHOUT WARRANTIES,
+  * GUARANTEES OR REPRESENTATIONS OF ANY KIND. ARTERY EXPRESSLY DISCLAIMS,
+  * TO THE FULLEST EXTENT PERMITTED BY LAW, ALL EXPRESS, IMPLIED OR
+  * STATUTORY OR OTHER WARRANTIES, GUARANTEES OR REPRESENTATIONS,
+  * INCLUDING BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, OR NON-INFRINGEMENT.
+  *
+  **************************************************************************
+  */
+
+/* includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "usbh_model.h"
+
+/** @addtogroup AT32F402_405_usb_host_model
+  * @{
+  */
+
+/** @defgroup USB_host_model_msc_device
+  * @brief full speed bulk only transport device with one lun on a ram disk,
+  *        the target of the host model. it answers the standard requests of
+  *        the enumeration, get max lun and the scsi commands of the host msc
+  *        class, it never naks.
+  * @{
+  */
+
+#define DEV_MPS0                         64
+#define DEV_MPS                          64
+#define DEV_EPT_IN                       1           /*!< bulk in endpoint 0x81 */
+#define DEV_EPT_OUT                      2           /*!< bulk out endpoint 0x02 */
+#define DEV_BLK_NBR                      (USBH_MODEL_DISK_SIZE / USBH_MODEL_BLOCK_SIZE)
+
+#define DEV_CBW_LEN                      31
+#define DEV_CSW_LEN                      13
+
+#if (USBH_MODEL_DISK_SIZE % USBH_MODEL_BLOCK_SIZE) != 0
+#error "USBH_MODEL_BLOCK_SIZE must divide the disk size"
+#endif
+
+/**
+  * @brief control endpoint stage
+  */
+typedef enum
+{
+  DEV_CTRL_IDLE,
+  DEV_CTRL_DATA_IN,
+  DEV_CTRL_STATUS_IN,
+  DEV_CTRL_STATUS_OUT,
+  DEV_CTRL_STALL
+} dev_ctrl_state_type;
+
+/**
+  * @brief bulk only transport stage
+  */
+typedef enum
+{
+  DEV_BOT_CBW,
+  DEV_BOT_DATA_IN,
+  DEV_BOT_DATA_OUT,
+  DEV_BOT_CSW
+} dev_bot_state_type;
+
+static const uint8_t dev_desc[18] =
+{
+  18, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00, DEV_MPS0,
+  0x3C, 0x2E, 0x20, 0x57, 0x00, 0x01, 1, 2, 3, 1
+};
+
+static const uint8_t dev_cfg_desc[32] =
+{
+  9, 0x02, 32, 0, 1, 1, 0, 0xC0, 0x32,
+  9, 0x04, 0, 0, 2, 0x08, 0x06, 0x50, 0,
+  7, 0x05, 0x80 | DEV_EPT_IN, 0x02, DEV_MPS, 0, 0,
+  7, 0x05, DEV_EPT_OUT, 0x02, DEV_MPS, 0, 0
+};
+
+static const char *const dev_string[] = {"Artery", "AT32 Host Model Disk", "000000000001"};
+
+uint8_t usbh_model_disk[USBH_MODEL_DISK_SIZE];
+
+/**
+  * @brief device state
+  */
+static struct
+{
+  uint8_t address;
+  uint8_t new_address;
+  uint8_t config;
+  dev_ctrl_state_type ctrl_state;
+  uint8_t ctrl_buf[256];
+  uint16_t ctrl_len;
+  uint16_t ctrl_pos;
+  uint16_t ctrl_wlength;
+  dev_bot_state_type bot_state;
+  uint8_t cbw[DEV_CBW_LEN];
+  uint8_t csw[DEV_CSW_LEN];
+  uint8_t resp[36];
+  uint8_t *data;
+  uint32_t data_len;
+  uint32_t residue;
+  uint8_t status;
+  uint8_t sense_key;
+  uint8_t asc;
+} dev;
+
+/**
+  * @brief  report a protocol error of the host and stop
+  * @param  msg: error text
+  * @retval none
+  */
+static void dev_fatal(const char *msg)
+{
+  fprintf(stderr, "usb host model device: %s\n", msg);
+  exit(2);
+}
+
+/**
+  * @brief  big endian field of a command block
+  * @param  buf: field
+  * @param  len: field bytes
+  * @retval value
+  */
+static uint32_t dev_get_be(const uint8_t *buf, uint32_t len)
+{
+  uint32_t value = 0;
+  while(len --)
+  {
+    value = (value << 8) | *buf ++;
+  }
+  return value;
+}
+
+/**
+  * @brief  store a big endian field
+  * @param  buf: field
+  * @param  value: value
+  * @retval none
+  */
+static void dev_put_be32(uint8_t *buf, uint32_t value)
+{
+  buf[0] = (uint8_t)(value >> 24);
+  buf[1] = (uint8_t)(value >> 16);
+  buf[2] = (uint8_t)(value >> 8);
+  buf[3] = (uint8_t)value;
+}
+
+/**
+  * @brief  bus reset, the device goes back to the default address
+  * @param  none
+  * @retval none
+  */
+void usbh_model_dev_reset(void)
+{
+  dev.address = 0;
+  dev.new_address = 0;
+  dev.config = 0;
+  dev.ctrl_state = DEV_CTRL_IDLE;
+  dev.bot_state = DEV_BOT_CBW;
+}
+
+/**
+  * @brief  device address the tokens must carry
+  * @param  none
+  * @retval address
+  */
+uint8_t usbh_model_dev_address(void)
+{
+  return dev.address;
+}
+
+/**
+  * @brief  prepare the data stage of a control read
+  * @param  data: data
+  * @param  len: data length, cut to wlength
+  * @retval none
+  */
+static void dev_ctrl_in(const uint8_t *data, uint32_t len)
+{
+  if(len > dev.ctrl_wlength)
+  {
+    len = dev.ctrl_wlength;
+  }
+  memcpy(dev.ctrl_buf, data, len);
+  dev.ctrl_len = (uint16_t)len;
+  dev.ctrl_pos = 0;
+  dev.ctrl_state = DEV_CTRL_DATA_IN;
+}
+
+/**
+  * @brief  string descriptor, index 0 is the language id
+  * @param  index: string index
+  * @retval none
+  */
+static void dev_string_desc(uint8_t index)
+{
+  uint8_t buf[64];
+  const char *str;
+  uint32_t i_index;
+
+  if(index == 0)
+  {
+    buf[0] = 4;
+    buf[1] = 0x03;
+    buf[2] = 0x09;
+    buf[3] = 0x04;
+    dev_ctrl_in(buf, 4);
+    return;
+  }
+  str = dev_string[(index - 1) % (sizeof(dev_string) / sizeof(dev_string[0]))];
+  for(i_index = 0; str[i_index] != 0 && i_index < 31; i_index ++)
+  {
+    buf[2 + i_index * 2] = (uint8_t)str[i_index];
+    buf[3 + i_index * 2] = 0;
+  }
+  buf[0] = (uint8_t)(2 + i_index * 2);
+  buf[1] = 0x03;
+  dev_ctrl_in(buf, buf[0]);
+}
+
+/**
+  * @brief  setup packet of the control endpoint, the device always takes
+  *         it, an unsupported request stalls the next stage
+  * @param  setup: 8 bytes setup packet
+  * @retval 0
+  */
+int32_t usbh_model_dev_setup(const uint8_t *setup)
+{
+  uint8_t type = setup[0], request = setup[1];
+  uint16_t value = setup[2] | (setup[3] << 8);
+  uint8_t max_lun = 0;
+
+  dev.ctrl_wlength = setup[6] | (setup[7] << 8);
+  dev.ctrl_state = DEV_CTRL_STALL;
+
+  if(type == 0x80 && request == USB_STD_REQ_GET_DESCRIPTOR)
+  {
+    switch(value >> 8)
+    {
+      case USB_DESCIPTOR_TYPE_DEVICE:
+        dev_ctrl_in(dev_desc, sizeof(dev_desc));
+        break;
+      case USB_DESCIPTOR_TYPE_CONFIGURATION:
+        dev_ctrl_in(dev_cfg_desc, sizeof(dev_cfg_desc));
+        break;
+      case USB_DESCIPTOR_TYPE_STRING:
+        dev_string_desc((uint8_t)value);
+        break;
+      default:
+        break;
+    }
+  }
+  else if(type == 0x00 && request == USB_STD_REQ_SET_ADDRESS)
+  {
+    dev.new_address = (uint8_t)(value & 0x7F);
+    dev.ctrl_state = DEV_CTRL_STATUS_IN;
+  }
+  else if(type == 0x00 && request == USB_STD_REQ_SET_CONFIGURATION)
+  {
+    dev.config = (uint8_t)value;
+    dev.ctrl_state = DEV_CTRL_STATUS_IN;
+  }
+  else if(type == 0x02 && request == USB_STD_REQ_CLEAR_FEATURE)
+  {
+    dev.ctrl_state = DEV_CTRL_STATUS_IN;
+  }
+  else if(type == 0xA1 && request == 0xFE)
+  {
+    /* get max lun */
+    dev_ctrl_in(&max_lun, 1);
+  }
+  return 0;
+}
+
+/**
+  * @brief  fill the command status wrapper
+  * @param  none
+  * @retval none
+  */
+static void dev_bot_csw(void)
+{
+  memcpy(dev.csw, "USBS", 4);
+  memcpy(&dev.csw[4], &dev.cbw[4], 4);
+  dev.csw[8] = (uint8_t)dev.residue;
+  dev.csw[9] = (uint8_t)(dev.residue >> 8);
+  dev.csw[10] = (uint8_t)(dev.residue >> 16);
+  dev.csw[11] = (uint8_t)(dev.residue >> 24);
+  dev.csw[12] = dev.status;
+  dev.bot_state = DEV_BOT_CSW;
+}
+
+/**
+  * @brief  fail the command with sense data, the data stage is padded or
+  *         dropped by the device
+  * @param  key: sense key
+  * @param  asc: additional sense code
+  * @retval none
+  */
+static void dev_bot_fail(uint8_t key, uint8_t asc)
+{
+  dev.status = 1;
+  dev.sense_key = key;
+  dev.asc = asc;
+  dev.data = 0;
+}
+
+/**
+  * @brief  decode the command block of a received command block wrapper
+  * @param  none
+  * @retval none
+  */
+static void dev_bot_command(void)
+{
+  const uint8_t *cb = &dev.cbw[15];
+  uint32_t xfer_len, lba, blocks, resp_len = 0;
+  uint8_t dir_in = (dev.cbw[12] & 0x80) != 0;
+
+  /* dCBWDataTransferLength is little endian */
+  xfer_len = dev.cbw[8] | (dev.cbw[9] << 8) | (dev.cbw[10] << 16) | ((uint32_t)dev.cbw[11] << 24);
+  dev.status = 0;
+  dev.data = 0;
+
+  switch(cb[0])
+  {
+    case 0x00:
+      /* test unit ready */
+      break;
+    case 0x12:
+      /* inquiry */
+      memset(dev.resp, 0, sizeof(dev.resp));
+      dev.resp[2] = 0x02;
+      dev.resp[3] = 0x02;
+      dev.resp[4] = 31;
+      memcpy(&dev.resp[8], "Artery  ", 8);
+      memcpy(&dev.resp[16], "Host Model Disk ", 16);
+      memcpy(&dev.resp[32], "1.00", 4);
+      dev.data = dev.resp;
+      resp_len = 36;
+      break;
+    case 0x25:
+      /* read capacity(10) */
+      dev_put_be32(&dev.resp[0], DEV_BLK_NBR - 1);
+      dev_put_be32(&dev.resp[4], USBH_MODEL_BLOCK_SIZE);
+      dev.data = dev.resp;
+      resp_len = 8;
+      break;
+    case 0x03:
+      /* request sense, fixed format */
+      memset(dev.resp, 0, 18);
+      dev.resp[0] = 0x70;
+      dev.resp[2] = dev.sense_key;
+      dev.resp[7] = 10;
+      dev.resp[12] = dev.asc;
+      dev.sense_key = 0;
+      dev.asc = 0;
+      dev.data = dev.resp;
+      resp_len = 18;
+      break;
+    case 0x28:
+    case 0x2A:
+      /* read(10) and write(10) */
+      lba = dev_get_be(&cb[2], 4);
+      blocks = dev_get_be(&cb[7], 2);
+      if(lba > DEV_BLK_NBR || blocks > DEV_BLK_NBR - lba)
+      {
+        dev_bot_fail(0x05, 0x21);
+      }
+      else if(xfer_len != blocks * USBH_MODEL_BLOCK_SIZE || dir_in != (cb[0] == 0x28))
+      {
+        /* the host and the command disagree on the data stage */
+        dev_bot_fail(0x05, 0x24);
+      }
+      else
+      {
+        dev.data = &usbh_model_disk[lba * USBH_MODEL_BLOCK_SIZE];
+        resp_len = xfer_len;
+      }
+      break;
+    default:
+      dev_bot_fail(0x05, 0x20);
+      break;
+  }
+
+  dev.data_len = resp_len < xfer_len ? resp_len : xfer_len;
+  dev.residue = xfer_len;
+  if(xfer_len == 0)
+  {
+    dev_bot_csw();
+  }
+  else
+  {
+    dev.bot_state = dir_in ? DEV_BOT_DATA_IN : DEV_BOT_DATA_OUT;
+  }
+}
+
+/**
+  * @brief  in token
+  * @param  ept_num: endpoint number
+  * @param  data: packet data
+  * @param  mps: max packet size of the channel
+  * @retval packet length, USBH_MODEL_STALL when the endpoint stalls
+  */
+int32_t usbh_model_dev_in(uint8_t ept_num, uint8_t *data, uint16_t mps)
+{
+  uint32_t len;
+
+  if(ept_num == 0)
+  {
+    if(dev.ctrl_state == DEV_CTRL_DATA_IN)
+    {
+      len = dev.ctrl_len - dev.ctrl_pos;
+      len = len < mps ? len : mps;
+      memcpy(data, &dev.ctrl_buf[dev.ctrl_pos], len);
+      dev.ctrl_pos += len;
+      if(len < mps || dev.ctrl_pos == dev.ctrl_wlength)
+      {
+        dev.ctrl_state = DEV_CTRL_STATUS_OUT;
+      }
+      return (int32_t)len;
+    }
+    if(dev.ctrl_state == DEV_CTRL_STATUS_IN)
+    {
+      dev.address = dev.new_address;
+      dev.ctrl_state = DEV_CTRL_IDLE;
+      return 0;
+    }
+    return USBH_MODEL_STALL;
+  }
+
+  if(ept_num != DEV_EPT_IN || dev.config == 0)
+  {
+    dev_fatal("in token to an endpoint the device does not have");
+  }
+  if(dev.bot_state == DEV_BOT_CSW)
+  {
+    memcpy(data, dev.csw, DEV_CSW_LEN);
+    dev.bot_state = DEV_BOT_CBW;
+    return DEV_CSW_LEN;
+  }
+  if(dev.bot_state != DEV_BOT_DATA_IN)
+  {
+    dev_fatal("in token outside of a data in stage");
+  }
+
+  len = dev.data_len < mps ? dev.data_len : mps;
+  if(dev.data != 0)
+  {
+    memcpy(data, dev.data, len);
+    dev.data += len;
+  }
+  else
+  {
+    /* failed command, the data stage is padded */
+    len = dev.residue < mps ? dev.residue : mps;
+    memset(data, 0, len);
+    dev.data_len = dev.residue;
+  }
+  dev.data_len -= len;
+  dev.residue -= len;
+  if(dev.residue == 0 || len < mps)
+  {
+    dev_bot_csw();
+  }
+  return (int32_t)len;
+}
+
+/**
+  * @brief  out token
+  * @param  ept_num: endpoint number
+  * @param  data: packet data
+  * @param  len: packet length
+  * @retval 0 when the packet is taken, USBH_MODEL_STALL when the endpoint stalls
+  */
+int32_t usbh_model_dev_out(uint8_t ept_num, const uint8_t *data, uint16_t len)
+{
+  if(ept_num == 0)
+  {
+    if(dev.ctrl_state == DEV_CTRL_STATUS_OUT && len == 0)
+    {
+      dev.ctrl_state = DEV_CTRL_IDLE;
+      return 0;
+    }
+    return USBH_MODEL_STALL;
+  }
+
+  if(ept_num != DEV_EPT_OUT || dev.config == 0)
+  {
+    dev_fatal("out token to an endpoint the device does not have");
+  }
+  if(dev.bot_state == DEV_BOT_CBW)
+  {
+    if(len != DEV_CBW_LEN || memcmp(data, "USBC", 4) != 0)
+    {
+      dev_fatal("invalid command block wrapper");
+    }
+    memcpy(dev.cbw, data, DEV_CBW_LEN);
+    dev_bot_command();
+    return 0;
+  }
+  if(dev.bot_state != DEV_BOT_DATA_OUT || len > dev.residue)
+  {
+    dev_fatal("out data outside of a data out stage");
+  }
+
+  if(dev.data != 0)
+  {
+    memcpy(dev.data, data, len);
+    dev.data += len;
+  }
+  dev.residue -= len;
+  if(dev.residue == 0)
+  {
+    dev_bot_csw();
+  }
+  return 0;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */